@@ -0,0 +1,193 @@
+#include "Cloth.h"
+#include "ClothBatchSolver.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 打包求解检查：关闭提前结束后，同一组布料分别逐块更新和打包求解，检查粒子位置一致，且打包求解填写了每块布料的求解统计
+// 打包求解每个子步固定迭代iteratorCount次、不使用休眠且乘子冷启动，关闭休眠、残差容差和停滞判断后两条路径的迭代次数相同，
+// 只有约束的着色和求解顺序不同
+// 用法：
+//   ClothBatchSolverCheck
+// 返回0表示全部通过
+
+// 打包的布料数
+static const uint32_t kClothCount = 3;
+
+// 模拟的帧数：布料在第47帧左右接触球体，包含碰撞约束开始生效后的一段时间
+static const uint32_t kFrameCount = 60;
+
+// 允许的最大位置偏差（米），实测约为1e-5
+static const float kTolerance = 1e-3f;
+
+// 工作线程数，打包求解的每种颜色跨越所有布料并行求解
+static const uint32_t kWorkerThreadCount = 4;
+
+std::mutex logMutex;
+
+void logDebug(const std::string& message)
+{
+    if (message.compare(0, 7, "[DEBUG]") == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    printf("%s\n", message.c_str());
+}
+
+// 20x20的布料从球体上方落下，关闭休眠和迭代的提前结束
+static Cloth* CreateCloth()
+{
+    Cloth* cloth = new Cloth(20, 20, 10.0f, 1.0f, ClothParticleMassMode::FixedParticleMass, ClothMeshAndContraintMode::Full);
+    cloth->SetPosition(dx::XMFLOAT3(-5.0f, 10.0f, -5.0f));
+    cloth->SetSleepEnabled(false);
+    cloth->SetResidualTolerance(0.0f);
+    cloth->SetResidualStagnationRatio(0.0f);
+    cloth->SetMinIteratorCount(UINT32_MAX);
+
+    if (!cloth->InitializeSimulation())
+    {
+        delete cloth;
+        return nullptr;
+    }
+
+    cloth->InitializeSphereCollisionConstraints(dx::XMFLOAT3(0.0f, 5.0f, 0.0f), 2.0f);
+    return cloth;
+}
+
+int main()
+{
+    TaskScheduler::Get().Initialize(kWorkerThreadCount);
+
+    std::vector<Cloth*> instanceCloths;
+    std::vector<Cloth*> packedCloths;
+    bool passed = true;
+
+    for (uint32_t i = 0; i < kClothCount; ++i)
+    {
+        Cloth* instanceCloth = CreateCloth();
+        Cloth* packedCloth = CreateCloth();
+
+        if (instanceCloth != nullptr)
+        {
+            instanceCloths.push_back(instanceCloth);
+        }
+
+        if (packedCloth != nullptr)
+        {
+            packedCloths.push_back(packedCloth);
+        }
+    }
+
+    if (instanceCloths.size() != kClothCount || packedCloths.size() != kClothCount)
+    {
+        logDebug("FAILED: could not create the cloths");
+        passed = false;
+    }
+    else if (!ClothBatchSolver::IsSupported(packedCloths.front()))
+    {
+        logDebug("FAILED: the cloth is not supported by ClothBatchSolver");
+        passed = false;
+    }
+    else
+    {
+        ClothBatchSolver batchSolver;
+
+        for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+        {
+            for (Cloth* cloth : instanceCloths)
+            {
+                cloth->Update(nullptr, 1.0f / 60.0f);
+            }
+
+            batchSolver.Step(packedCloths, 1.0f / 60.0f);
+        }
+
+        if (batchSolver.GetClothCount() != kClothCount)
+        {
+            logDebug("FAILED: the cloths were not packed");
+            passed = false;
+        }
+
+        float maxDeviation = 0.0f;
+
+        for (uint32_t i = 0; i < kClothCount; ++i)
+        {
+            const std::vector<Particle>& instanceParticles = instanceCloths[i]->GetParticles();
+            const std::vector<Particle>& packedParticles = packedCloths[i]->GetParticles();
+
+            for (size_t p = 0; p < instanceParticles.size() && p < packedParticles.size(); ++p)
+            {
+                const dx::XMFLOAT3& a = instanceParticles[p].position;
+                const dx::XMFLOAT3& b = packedParticles[p].position;
+                const float deviation = (std::max)((std::max)(std::fabs(a.x - b.x), std::fabs(a.y - b.y)), std::fabs(a.z - b.z));
+
+                // NaN也视为超出容差
+                if (!(deviation <= maxDeviation))
+                {
+                    maxDeviation = deviation;
+                }
+            }
+
+            // 打包求解的统计：固定的迭代次数，以及最后一次迭代的约束残差
+            const ClothSolverStats& instanceStats = instanceCloths[i]->GetSolverStats();
+            const ClothSolverStats& packedStats = packedCloths[i]->GetSolverStats();
+
+            char buffer[256];
+            snprintf(buffer, sizeof(buffer), "cloth %u: iterations %u/%u (instance %u/%u), distance rms %.3g (instance %.3g), collision constraints %u (instance %u)"
+                , i
+                , packedStats.iterationCount
+                , packedStats.iterationBudget
+                , instanceStats.iterationCount
+                , instanceStats.iterationBudget
+                , packedStats.distance.rmsError
+                , instanceStats.distance.rmsError
+                , packedStats.collision.constraintCount
+                , instanceStats.collision.constraintCount);
+            logDebug(buffer);
+
+            if (packedStats.iterationCount != instanceStats.iterationCount
+                || packedStats.iterationBudget != instanceStats.iterationBudget
+                || packedStats.distance.constraintCount != instanceStats.distance.constraintCount
+                || packedStats.lra.constraintCount != instanceStats.lra.constraintCount
+                || packedStats.collision.constraintCount != instanceStats.collision.constraintCount
+                || packedStats.distance.constraintCount == 0
+                || !std::isfinite(packedStats.rmsError)
+                || packedStats.maxError < packedStats.rmsError)
+            {
+                logDebug("FAILED: packed solver stats do not match the instance update");
+                passed = false;
+            }
+        }
+
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "instance vs packed: max deviation %.3g (tolerance %.3g)", maxDeviation, kTolerance);
+        logDebug(buffer);
+
+        if (!(maxDeviation <= kTolerance))
+        {
+            logDebug("FAILED: packed positions differ from the instance update");
+            passed = false;
+        }
+    }
+
+    for (Cloth* cloth : instanceCloths)
+    {
+        delete cloth;
+    }
+
+    for (Cloth* cloth : packedCloths)
+    {
+        delete cloth;
+    }
+
+    logDebug(std::string("ClothBatchSolver check ") + (passed ? "passed" : "FAILED"));
+
+    return passed ? 0 : 1;
+}
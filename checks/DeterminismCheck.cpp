@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "Cloth.h"
+#include "SolverPrecision.h"
+#include "TaskScheduler.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+// 确定性检查：分别用1、2、8和32个线程模拟同一块布料，检查粒子状态的哈希相同，且与参考哈希相同
+// 用法：
+//   DeterminismCheck <目录>            与<目录>/determinism_<精度>.hash中的参考哈希对比
+//   DeterminismCheck <目录> --update   重新录制参考哈希
+// 哈希逐位依赖浮点运算的结果，编译器、浮点选项或DirectXMath的实现不同时需要重新录制参考哈希
+// 返回0表示全部通过
+
+// 模拟的帧数：布料在第47帧左右接触球体，包含碰撞约束开始生效后的一段时间
+static const uint32_t kFrameCount = 90;
+
+std::mutex logMutex;
+
+void logDebug(const std::string& message)
+{
+    if (message.compare(0, 7, "[DEBUG]") == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    printf("%s\n", message.c_str());
+}
+
+// 40x40的布料从球体上方落下，与程序的默认场景相同
+static Cloth* CreateCloth()
+{
+    Cloth* cloth = new Cloth(40, 40, 10.0f, 1.0f, ClothParticleMassMode::FixedParticleMass, ClothMeshAndContraintMode::Full);
+    cloth->SetPosition(dx::XMFLOAT3(-5.0f, 10.0f, -5.0f));
+
+    if (!cloth->InitializeSimulation())
+    {
+        delete cloth;
+        return nullptr;
+    }
+
+    cloth->InitializeSphereCollisionConstraints(dx::XMFLOAT3(0.0f, 5.0f, 0.0f), 2.0f);
+    return cloth;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3 || (argc == 3 && strcmp(argv[2], "--update") != 0))
+    {
+        logDebug("usage: DeterminismCheck <directory> [--update]");
+        return 1;
+    }
+
+    const bool update = argc == 3;
+    const std::string hashPath = std::string(argv[1]) + "/determinism_" + SolverPrecision::kName + ".hash";
+
+    TaskScheduler::Get().Initialize(1);
+
+    const std::vector<uint32_t> threadCounts = GetDefaultDeterminismThreadCounts();
+    std::vector<DeterminismResult> results = RunDeterminismBenchmark(CreateCloth, threadCounts, kFrameCount, 1.0f / 60.0f);
+
+    if (results.size() != threadCounts.size())
+    {
+        logDebug("FAILED: the simulation did not run for every thread count");
+        return 1;
+    }
+
+    if (update)
+    {
+        // 只在各线程数的结果一致时录制
+        if (!LogDeterminismResults(results, ""))
+        {
+            return 1;
+        }
+
+        char hash[32];
+        snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)results.front().hash);
+
+        std::ofstream file(hashPath, std::ios::trunc);
+        if (!(file << hash << "\n"))
+        {
+            logDebug("FAILED: could not write " + hashPath);
+            return 1;
+        }
+
+        logDebug("Recorded reference hash " + std::string(hash) + " to " + hashPath);
+        return 0;
+    }
+
+    std::string goldenHash;
+    std::ifstream file(hashPath);
+    if (!(file >> goldenHash))
+    {
+        logDebug("FAILED: missing reference hash " + hashPath + ", run with --update to record it");
+        return 1;
+    }
+
+    const bool passed = LogDeterminismResults(results, goldenHash);
+
+    logDebug(std::string("Determinism check ") + (passed ? "passed" : "FAILED"));
+
+    return passed ? 0 : 1;
+}
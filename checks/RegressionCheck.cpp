@@ -0,0 +1,131 @@
+#include "Benchmark.h"
+#include "ClothSceneLoader.h"
+#include "SolverPrecision.h"
+#include "TaskScheduler.h"
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+// 回归检查：默认场景以及简化网格、只有二面角弯曲约束和关闭LRA约束三个变体与提交的参考轨迹逐帧对比
+// 用法：
+//   RegressionCheck <目录>            与<目录>/<精度>中的参考文件对比，缺少参考文件时失败
+//   RegressionCheck <目录> --update   重新录制参考文件
+// 各阶段耗时与运行的机器有关，性能回退只输出到日志，不作为失败
+// 返回0表示全部通过
+
+// 录制的帧数：布料在第47帧左右接触球体，包含碰撞约束开始生效后的一段时间
+static const uint32_t kFrameCount = 90;
+
+// 允许的最大位置偏差（米），与-trajectoryTolerance的默认值相同
+static const float kTolerance = 1e-3f;
+
+// 允许的耗时增加比例，与-perfThreshold的默认值相同
+static const float kPerfThreshold = 0.25f;
+
+std::mutex logMutex;
+
+void logDebug(const std::string& message)
+{
+    // 创建布料时逐项输出的参数不输出，只输出检查结果
+    if (message.compare(0, 7, "[DEBUG]") == 0 || message.compare(0, 6, "Cloth ") == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    printf("%s\n", message.c_str());
+}
+
+// 与不带参数运行程序时的默认场景相同（布料落到球体上），布料分辨率降为20x20以减小参考文件
+static ClothSceneDescription CreateDefaultScene()
+{
+    ClothSceneCloth cloth;
+    cloth.name = "cloth";
+    cloth.widthResolution = 20;
+    cloth.heightResolution = 20;
+    cloth.size = 10.0f;
+    cloth.position = dx::XMFLOAT3(-5.0f, 10.0f, -5.0f);
+    cloth.meshAndContraintMode = ClothMeshAndContraintMode::Full;
+    cloth.particleOrdering = ClothParticleOrdering::None;
+    cloth.pinsSpecified = false;
+
+    cloth.diffuseColor = dx::XMFLOAT3(1.0f, 0.1f, 0.1f);
+    cloth.mass = 1.0f;
+    cloth.massMode = ClothParticleMassMode::FixedParticleMass;
+    cloth.addLRAConstraints = true;
+    cloth.addBendingConstraints = true;
+    cloth.addDihedralBendingConstraints = false;
+    cloth.addIsometricBendingConstraints = false;
+    cloth.addDiagonalConstraints = true;
+    cloth.distanceCompliance = 1e-8f;
+    cloth.distanceDamping = 0.01f;
+    cloth.lraCompliance = 1e-8f;
+    cloth.lraDamping = 0.01f;
+    cloth.lraMaxStretch = 0.01f;
+    cloth.bendingCompliance = 1e-5f;
+    cloth.bendingDamping = 0.001f;
+    cloth.dihedralBendingCompliance = 1.0f;
+    cloth.dihedralBendingDamping = 1.0f;
+    cloth.isometricBendingCompliance = 1.0f;
+    cloth.isometricBendingDamping = 1.0f;
+
+    cloth.solverType = ClothSolverType::XPBD;
+    cloth.scheduleMode = XPBDScheduleMode::Iterative;
+    cloth.iteratorCount = 20;
+    cloth.subIteratorCount = 1;
+    cloth.minIteratorCount = 2;
+    cloth.lambdaWarmStartFactor = 0.0f;
+    cloth.residualTolerance = 1e-4f;
+    cloth.residualStagnationRatio = 0.01f;
+    cloth.chebyshevAcceleration = false;
+    cloth.chebyshevSpectralRadius = 0.0f;
+    cloth.overRelaxationFactor = 1.0f;
+    cloth.sleepEnabled = true;
+    cloth.sleepVelocityThreshold = 0.05f;
+    cloth.sleepDisplacementThreshold = 0.01f;
+    cloth.sleepFrameCount = 30;
+    cloth.velocityDamping = 0.0f;
+    cloth.multigridLevelCount = 0;
+    cloth.multigridIterationCount = 4;
+    cloth.distanceSolveMode = XPBDDistanceSolveMode::Iterative;
+    cloth.directSolveIterationCount = 2;
+
+    ClothSceneSphere sphere;
+    sphere.center = dx::XMFLOAT3(0.0f, 5.0f, 0.0f);
+    sphere.radius = 2.0f;
+    sphere.diffuseColor = dx::XMFLOAT3(1.0f, 0.1f, 0.1f);
+
+    ClothSceneDescription scene;
+    scene.cloths.push_back(cloth);
+    scene.spheres.push_back(sphere);
+    return scene;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3 || (argc == 3 && strcmp(argv[2], "--update") != 0))
+    {
+        logDebug("usage: RegressionCheck <directory> [--update]");
+        return 1;
+    }
+
+    const bool update = argc == 3;
+
+    // float和double构建的轨迹不逐位一致，各自使用一组参考文件
+    const std::string goldenDirectory = std::string(argv[1]) + "/" + SolverPrecision::kName;
+
+    // 单线程模拟，各阶段耗时不受机器核数影响
+    TaskScheduler::Get().Initialize(1);
+
+    const ClothSceneDescription scene = CreateDefaultScene();
+    std::vector<RegressionResult> results = RunRegressionBenchmark(GetRegressionScenes(scene), goldenDirectory,
+        kFrameCount, 1.0f / 60.0f, kTolerance, kPerfThreshold, update);
+
+    const int exitCode = LogRegressionResults(results, kTolerance, kPerfThreshold);
+    const bool passed = results.size() == 4 && exitCode != 1;
+
+    logDebug(std::string("Regression check ") + (passed ? "passed" : "FAILED"));
+
+    return passed ? 0 : 1;
+}
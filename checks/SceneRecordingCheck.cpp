@@ -0,0 +1,274 @@
+#include "Scene.h"
+#include "Sphere.h"
+#include "NullRALDevice.h"
+#include "TaskScheduler.h"
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 场景录制检查：在NullRALDevice上用不同的录制线程数执行Scene的几何Pass，检查
+//   1. 并行录制的命令列表按录制顺序提交，提交后的绘制序列与单线程录制完全一致
+//   2. 在已关闭的命令列表上继续录制会被拒绝，并计入设备的录制错误
+// 不依赖D3D12，可以在Linux上构建运行；返回0表示全部通过
+
+// 球体数量，半径各不相同，每个球体是一个独立的批次，保证8个录制线程时每个线程也能分到足够的批次
+static const uint32_t kSphereCount = 160;
+
+// 工作线程数（包含主线程）
+static const uint32_t kWorkerThreadCount = 4;
+
+// 需要检查的录制线程数，1为串行录制的参考结果
+static const uint32_t kRecordingThreadCounts[] = { 1, 2, 3, 4, 8 };
+
+std::mutex logMutex;
+
+void logDebug(const std::string& message)
+{
+    // 场景和设备内部的调试信息不输出，只输出检查结果
+    if (message.compare(0, 7, "[DEBUG]") == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    printf("%s\n", message.c_str());
+}
+
+// 几何Pass中的一次间接绘制，以及绘制时命令列表上绑定的状态
+struct GeometryDraw
+{
+    const void* pipelineState;
+    const void* vertexBuffer;
+    const void* indexBuffer;
+    uint64_t instanceBase;      // 根常量中的实例基址
+    uint64_t argumentOffset;    // 间接绘制参数在缓冲区中的偏移
+
+    bool operator==(const GeometryDraw& other) const
+    {
+        return pipelineState == other.pipelineState && vertexBuffer == other.vertexBuffer && indexBuffer == other.indexBuffer
+            && instanceBase == other.instanceBase && argumentOffset == other.argumentOffset;
+    }
+};
+
+// 按提交顺序提取一帧中所有的间接绘制
+// 每个命令列表单独跟踪绑定状态，新命令列表不继承上一个命令列表的状态
+static std::vector<GeometryDraw> CollectGeometryDraws(const std::vector<std::vector<NullRALCommand>>& submission)
+{
+    std::vector<GeometryDraw> draws;
+
+    for (const std::vector<NullRALCommand>& commands : submission)
+    {
+        GeometryDraw state = {};
+
+        for (const NullRALCommand& command : commands)
+        {
+            switch (command.type)
+            {
+            case NullRALCommandType::SetPipelineState:
+                state.pipelineState = command.object;
+                break;
+            case NullRALCommandType::SetVertexBuffers:
+                state.vertexBuffer = command.object;
+                break;
+            case NullRALCommandType::SetIndexBuffer:
+                state.indexBuffer = command.object;
+                break;
+            case NullRALCommandType::SetGraphicsRootConstants:
+                // 根参数1是实例基址
+                if (command.values[0] == 1)
+                {
+                    state.instanceBase = command.values[3];
+                }
+                break;
+            case NullRALCommandType::DrawIndexedIndirect:
+                state.argumentOffset = command.values[0];
+                draws.push_back(state);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return draws;
+}
+
+// 录制并提交一帧，返回提交的绘制序列
+static std::vector<GeometryDraw> RenderFrame(NullRALDevice& device, Scene& scene, uint32_t recordingThreadCount)
+{
+    scene.SetParallelRecordingThreadCount(recordingThreadCount);
+
+    device.BeginFrame();
+    scene.Update(0.0f);
+    scene.Render(dx::XMMatrixIdentity(), dx::XMMatrixIdentity());
+    device.EndFrame();
+
+    return CollectGeometryDraws(device.GetLastFrameSubmission());
+}
+
+// 检查并行录制的提交顺序
+static bool CheckRecordingOrder(NullRALDevice& device, Scene& scene)
+{
+    bool passed = true;
+
+    const std::vector<GeometryDraw> serialDraws = RenderFrame(device, scene, 1);
+    const size_t serialCommandListCount = device.GetLastFrameSubmission().size();
+
+    if (serialDraws.size() != kSphereCount)
+    {
+        logDebug("FAILED: serial recording produced " + std::to_string(serialDraws.size()) + " draws, expected " + std::to_string(kSphereCount));
+        return false;
+    }
+
+    for (uint32_t recordingThreadCount : kRecordingThreadCounts)
+    {
+        const std::vector<GeometryDraw> draws = RenderFrame(device, scene, recordingThreadCount);
+        const size_t commandListCount = device.GetLastFrameSubmission().size();
+        const uint32_t errorCount = device.GetLastFrameErrorCount();
+
+        // 并行录制时提交顺序为：主命令列表 -> 每个线程一个命令列表 -> 新的主命令列表
+        const size_t expectedCommandListCount = recordingThreadCount > 1 ? serialCommandListCount + recordingThreadCount + 1 : serialCommandListCount;
+
+        bool ordered = draws.size() == serialDraws.size();
+        for (size_t i = 0; ordered && i < draws.size(); ++i)
+        {
+            // 第i个批次的间接绘制参数在缓冲区的第i个位置，偏移递增说明批次按录制顺序提交
+            ordered = draws[i] == serialDraws[i] && draws[i].argumentOffset == i * sizeof(RALDrawIndexedArguments);
+        }
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%u recording threads: %zu command lists, %zu draws, %u recording errors",
+            recordingThreadCount, commandListCount, draws.size(), errorCount);
+        logDebug(buffer);
+
+        if (commandListCount != expectedCommandListCount)
+        {
+            logDebug("FAILED: expected " + std::to_string(expectedCommandListCount) + " submitted command lists");
+            passed = false;
+        }
+
+        if (!ordered)
+        {
+            logDebug("FAILED: submitted draws differ from serial recording order");
+            passed = false;
+        }
+
+        if (errorCount != 0)
+        {
+            logDebug("FAILED: recording errors in a valid frame");
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+// 检查已关闭的命令列表拒绝继续录制
+static bool CheckClosedCommandListRejected(NullRALDevice& device)
+{
+    bool passed = true;
+
+    device.BeginFrame();
+
+    IRALGraphicsCommandList* commandLists[2] = {};
+    if (!device.AcquireParallelGraphicsCommandLists(2, commandLists))
+    {
+        logDebug("FAILED: could not acquire parallel command lists");
+        device.EndFrame();
+        return false;
+    }
+
+    NullRALGraphicsCommandList* closedCommandList = static_cast<NullRALGraphicsCommandList*>(commandLists[0]);
+    const size_t commandCountBeforeClose = closedCommandList->GetCommands().size();
+
+    // 交给设备管理的命令列表不应该由调用者关闭，关闭之后的绘制不能进入命令列表
+    closedCommandList->Close();
+    closedCommandList->DrawIndexed(3, 1, 0, 0, 0);
+    commandLists[1]->DrawIndexed(3, 1, 0, 0, 0);
+
+    if (closedCommandList->GetCommands().size() != commandCountBeforeClose || closedCommandList->GetInvalidCommandCount() != 1)
+    {
+        logDebug("FAILED: closed command list accepted a draw");
+        passed = false;
+    }
+
+    device.EndFrame();
+
+    // 一次由调用者关闭，一次在关闭后录制
+    const uint32_t errorCount = device.GetLastFrameErrorCount();
+    if (errorCount != 2)
+    {
+        logDebug("FAILED: expected 2 recording errors for the closed command list, got " + std::to_string(errorCount));
+        passed = false;
+    }
+
+    // 提交顺序：主命令列表、两个并行命令列表、新的主命令列表，只有第二个并行命令列表中有绘制
+    const std::vector<std::vector<NullRALCommand>>& submission = device.GetLastFrameSubmission();
+    std::vector<uint32_t> drawCounts(submission.size(), 0);
+    for (size_t i = 0; i < submission.size(); ++i)
+    {
+        for (const NullRALCommand& command : submission[i])
+        {
+            if (command.type == NullRALCommandType::DrawIndexed)
+            {
+                drawCounts[i]++;
+            }
+        }
+    }
+
+    if (drawCounts != std::vector<uint32_t>({ 0, 0, 1, 0 }))
+    {
+        logDebug("FAILED: unexpected submission after recording into a closed command list");
+        passed = false;
+    }
+
+    logDebug(std::string("Closed command list check ") + (passed ? "passed" : "FAILED"));
+
+    return passed;
+}
+
+int main()
+{
+    TaskScheduler::Get().Initialize(kWorkerThreadCount);
+
+    NullRALDevice device(640, 480);
+    if (!device.Initialize())
+    {
+        logDebug("FAILED: could not initialize the null device");
+        return 1;
+    }
+
+    bool passed = true;
+    std::vector<Sphere*> spheres;
+
+    {
+        Scene scene;
+        if (!scene.Initialize(&device))
+        {
+            logDebug("FAILED: could not initialize the scene");
+            return 1;
+        }
+
+        // 半径不同的球体不共享Mesh，每个球体是一个批次
+        for (uint32_t i = 0; i < kSphereCount; ++i)
+        {
+            Sphere* sphere = new Sphere(0.5f + 0.01f * i, 8, 8);
+            sphere->SetPosition(dx::XMFLOAT3((float)(i % 16), 0.0f, (float)(i / 16)));
+            scene.AddPrimitive(sphere);
+            spheres.push_back(sphere);
+        }
+
+        passed = CheckRecordingOrder(device, scene) && passed;
+        passed = CheckClosedCommandListRejected(device) && passed;
+    }
+
+    for (Sphere* sphere : spheres)
+    {
+        delete sphere;
+    }
+
+    logDebug(std::string("Scene recording check ") + (passed ? "passed" : "FAILED"));
+
+    return passed ? 0 : 1;
+}
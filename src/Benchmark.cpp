@@ -0,0 +1,1781 @@
+#include "Benchmark.h"
+#include "Cloth.h"
+#include "ClothCheckpoint.h"
+#include "TaskScheduler.h"
+#include "ClothBatchSolver.h"
+#include "DihedralBendingConstraint.h"
+#include "IsometricBendingConstraint.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+extern void logDebug(const std::string& message);
+
+namespace
+{
+    // 轨迹文件头，之后依次存放每帧所有粒子的位置
+    struct TrajectoryHeader
+    {
+        char magic[8];
+        uint32_t particleCount;
+        uint32_t frameCount;
+        uint32_t solverRealSize;    // 录制时SolverReal的字节数
+        float deltaTime;
+    };
+
+    const char kTrajectoryMagic[8] = "CLTRAJ1";
+
+    // 回归测试的各阶段耗时参考文件
+    struct PerfBaseline
+    {
+        char magic[8];
+        uint32_t frameCount;        // 计时的帧数
+        uint32_t solverRealSize;    // 录制时SolverReal的字节数
+        ClothSolverPhaseTimes phaseTimes; // 每帧各阶段的平均耗时（毫秒）
+        double frameMilliseconds;   // 每帧的平均总耗时（毫秒）
+    };
+
+    const char kPerfBaselineMagic[8] = "CLPERF1";
+
+    // 求解器阶段的名称和对应的耗时字段
+    struct SolverPhase
+    {
+        const char* name;
+        double ClothSolverPhaseTimes::* milliseconds;
+    };
+
+    const SolverPhase kSolverPhases[] =
+    {
+        { "setup", &ClothSolverPhaseTimes::setup },
+        { "integrate", &ClothSolverPhaseTimes::integrate },
+        { "globalSolve", &ClothSolverPhaseTimes::globalSolve },
+        { "constraints", &ClothSolverPhaseTimes::constraints },
+        { "sleeping", &ClothSolverPhaseTimes::sleeping },
+    };
+
+    // 低于该耗时（毫秒）的增加视为计时噪声，不算性能回退
+    const double kMinRegressionMilliseconds = 0.02;
+
+    // 模拟frameCount帧，统计每帧各阶段和总的平均耗时
+    bool MeasureSolverPhases(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime,
+        ClothSolverPhaseTimes& phaseTimes, double& frameMilliseconds)
+    {
+        memset(&phaseTimes, 0, sizeof(phaseTimes));
+        frameMilliseconds = 0.0;
+
+        Cloth* cloth = createCloth();
+        if (!cloth)
+        {
+            return false;
+        }
+
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cloth->Update(nullptr, deltaTime);
+            auto end = std::chrono::steady_clock::now();
+
+            frameMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+
+            const ClothSolverPhaseTimes& framePhaseTimes = cloth->GetSolverStats().phaseTimes;
+            for (const SolverPhase& phase : kSolverPhases)
+            {
+                phaseTimes.*phase.milliseconds += framePhaseTimes.*phase.milliseconds;
+            }
+        }
+
+        delete cloth;
+
+        for (const SolverPhase& phase : kSolverPhases)
+        {
+            phaseTimes.*phase.milliseconds /= frameCount;
+        }
+        frameMilliseconds /= frameCount;
+        return true;
+    }
+
+    // 取出所有粒子的位置
+    void GatherPositions(const Cloth* cloth, std::vector<dx::XMFLOAT3>& positions)
+    {
+        const std::vector<Particle>& particles = cloth->GetParticles();
+        positions.resize(particles.size());
+
+        for (size_t i = 0; i < particles.size(); ++i)
+        {
+            positions[i] = particles[i].position;
+        }
+    }
+
+    // 所有粒子位置和速度的哈希，Particle的填充字节没有初始化，不能直接对粒子数组求哈希
+    uint64_t ComputeParticleStateHash(const Cloth* cloth)
+    {
+        const std::vector<Particle>& particles = cloth->GetParticles();
+        std::vector<dx::XMFLOAT3> state;
+        state.reserve(particles.size() * 2);
+        for (const Particle& particle : particles)
+        {
+            state.push_back(particle.position);
+            state.push_back(particle.velocity);
+        }
+
+        return ClothCheckpoint::ComputeChecksum((const char*)state.data(), state.size() * sizeof(dx::XMFLOAT3));
+    }
+
+    // 创建一组布料，全部创建成功时返回true，失败时删除已创建的布料
+    bool CreateCloths(const ClothFactory& createCloth, uint32_t clothCount, std::vector<Cloth*>& cloths)
+    {
+        cloths.clear();
+        for (uint32_t i = 0; i < clothCount; ++i)
+        {
+            Cloth* cloth = createCloth();
+            if (!cloth)
+            {
+                for (Cloth* created : cloths)
+                {
+                    delete created;
+                }
+                cloths.clear();
+                return false;
+            }
+            cloths.push_back(cloth);
+        }
+        return true;
+    }
+
+    // 一组布料距离约束平均相对误差的平均值
+    float ComputeMeanStrain(const std::vector<Cloth*>& cloths)
+    {
+        double sum = 0.0;
+        for (const Cloth* cloth : cloths)
+        {
+            float meanStrain = 0.0f;
+            float maxStrain = 0.0f;
+            cloth->ComputeDistanceConstraintError(meanStrain, maxStrain);
+            sum += meanStrain;
+        }
+        return cloths.empty() ? 0.0f : (float)(sum / cloths.size());
+    }
+
+    // 布料所有粒子的位置是否都是有限值
+    bool AreParticlePositionsFinite(const Cloth* cloth)
+    {
+        for (const Particle& particle : cloth->GetParticles())
+        {
+            if (!std::isfinite(particle.position.x) || !std::isfinite(particle.position.y) || !std::isfinite(particle.position.z))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 与完整结构布料相同的相邻三角形对：每个格子的对角线，以及格子右侧和下方的边
+    // 每组4个粒子索引，前两个为公共边
+    void BuildBendingQuads(int width, int height, std::vector<uint32_t>& quads)
+    {
+        quads.clear();
+
+        for (int h = 0; h < height - 1; ++h)
+        {
+            for (int w = 0; w < width - 1; ++w)
+            {
+                const uint32_t diagonal[4] = { (uint32_t)(h * width + w), (uint32_t)((h + 1) * width + w + 1),
+                    (uint32_t)(h * width + w + 1), (uint32_t)((h + 1) * width + w) };
+                quads.insert(quads.end(), diagonal, diagonal + 4);
+
+                if (w + 2 < width)
+                {
+                    const uint32_t right[4] = { (uint32_t)(h * width + w + 1), (uint32_t)((h + 1) * width + w + 1),
+                        (uint32_t)(h * width + w), (uint32_t)((h + 1) * width + w + 2) };
+                    quads.insert(quads.end(), right, right + 4);
+                }
+
+                if (h + 2 < height)
+                {
+                    const uint32_t below[4] = { (uint32_t)((h + 1) * width + w), (uint32_t)((h + 1) * width + w + 1),
+                        (uint32_t)(h * width + w), (uint32_t)((h + 2) * width + w + 1) };
+                    quads.insert(quads.end(), below, below + 4);
+                }
+            }
+        }
+    }
+
+    // Mesh模式下的相邻三角形对：每条内部边
+    void BuildMeshBendingQuads(const ClothMeshTopology& topology, std::vector<uint32_t>& quads)
+    {
+        quads.clear();
+
+        for (const ClothMeshEdge& edge : topology.GetEdges())
+        {
+            if (edge.triangleCount == 2)
+            {
+                const uint32_t quad[4] = { edge.vertices[0], edge.vertices[1], edge.opposites[0], edge.opposites[1] };
+                quads.insert(quads.end(), quad, quad + 4);
+            }
+        }
+    }
+
+    // LRU组相联缓存模型，只统计缺失数
+    class SetAssociativeCache
+    {
+    public:
+        SetAssociativeCache(uint32_t sizeBytes, uint32_t wayCount, uint32_t lineSize)
+            : m_wayCount(wayCount)
+            , m_lineSize(lineSize)
+            , m_setCount((std::max)(1u, sizeBytes / (wayCount * lineSize)))
+            , m_tags((size_t)m_setCount * wayCount, UINT64_MAX)
+            , m_lastUse((size_t)m_setCount * wayCount, 0)
+            , m_time(0)
+            , m_missCount(0)
+        {
+        }
+
+        // 访问[address, address + size)覆盖的所有缓存行
+        void Access(uint64_t address, uint32_t size)
+        {
+            for (uint64_t line = address / m_lineSize; line <= (address + size - 1) / m_lineSize; ++line)
+            {
+                AccessLine(line);
+            }
+        }
+
+        uint64_t GetMissCount() const
+        {
+            return m_missCount;
+        }
+
+    private:
+        void AccessLine(uint64_t line)
+        {
+            uint64_t* tags = &m_tags[(size_t)(line % m_setCount) * m_wayCount];
+            uint64_t* lastUse = &m_lastUse[(size_t)(line % m_setCount) * m_wayCount];
+            ++m_time;
+
+            uint32_t victim = 0;
+            for (uint32_t way = 0; way < m_wayCount; ++way)
+            {
+                if (tags[way] == line)
+                {
+                    lastUse[way] = m_time;
+                    return;
+                }
+
+                if (lastUse[way] < lastUse[victim])
+                {
+                    victim = way;
+                }
+            }
+
+            tags[victim] = line;
+            lastUse[victim] = m_time;
+            ++m_missCount;
+        }
+
+        uint32_t m_wayCount;
+        uint32_t m_lineSize;
+        uint32_t m_setCount;
+        std::vector<uint64_t> m_tags;
+        std::vector<uint64_t> m_lastUse;
+        uint64_t m_time;
+        uint64_t m_missCount;
+    };
+
+    // 与求解器相同的贪心着色（按存储顺序为每个约束选第一个不冲突的颜色，固定粒子不参与冲突判断），
+    // 然后按颜色、颜色内按存储顺序追加约束访问的粒子索引
+    template<typename ConstraintT>
+    void AppendColoredParticleAccesses(const std::vector<ConstraintT>& constraints, const std::vector<Particle>& particles,
+        std::vector<uint32_t>& accesses)
+    {
+        const uint32_t maxColorCount = 64;
+        const Particle* particlesBegin = particles.data();
+
+        std::vector<uint64_t> usedColors(particles.size(), 0);
+        std::vector<std::vector<uint32_t>> colors(maxColorCount + 1);
+
+        for (uint32_t c = 0; c < (uint32_t)constraints.size(); ++c)
+        {
+            const Particle** constraintParticles = constraints[c].GetParticles();
+            const uint32_t count = constraints[c].GetParticlesCount();
+
+            uint64_t used = 0;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (!constraintParticles[i]->isStatic)
+                {
+                    used |= usedColors[constraintParticles[i] - particlesBegin];
+                }
+            }
+
+            uint32_t color = 0;
+            while (color < maxColorCount && (used & (1ull << color)))
+            {
+                ++color;
+            }
+
+            if (color < maxColorCount)
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    if (!constraintParticles[i]->isStatic)
+                    {
+                        usedColors[constraintParticles[i] - particlesBegin] |= (1ull << color);
+                    }
+                }
+            }
+
+            colors[color].push_back(c);
+        }
+
+        for (const std::vector<uint32_t>& color : colors)
+        {
+            for (uint32_t c : color)
+            {
+                const Particle** constraintParticles = constraints[c].GetParticles();
+                for (uint32_t i = 0; i < constraints[c].GetParticlesCount(); ++i)
+                {
+                    accesses.push_back((uint32_t)(constraintParticles[i] - particlesBegin));
+                }
+            }
+        }
+    }
+
+    // 反复计算一类约束的约束值和梯度并计时
+    template<typename ConstraintT>
+    BendingConstraintCost MeasureConstraintCost(const char* name, const std::vector<ConstraintT>& constraints, uint32_t repeatCount)
+    {
+        dx::XMFLOAT3 gradients[ConstraintT::kArity];
+
+        // 累加结果，避免计算被优化掉
+        volatile float sink = 0.0f;
+        float sum = 0.0f;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t repeat = 0; repeat < repeatCount; ++repeat)
+        {
+            for (const ConstraintT& constraint : constraints)
+            {
+                sum += constraint.ConstraintT::ComputeConstraintAndGradient(gradients);
+                sum += gradients[ConstraintT::kArity - 1].y;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        sink = sum;
+
+        double constraintSum = 0.0;
+        for (const ConstraintT& constraint : constraints)
+        {
+            constraintSum += std::abs(constraint.ConstraintT::ComputeConstraintAndGradient(gradients));
+        }
+
+        BendingConstraintCost cost;
+        cost.name = name;
+        cost.constraintCount = (uint32_t)constraints.size();
+        cost.nanosecondsPerConstraint = constraints.empty() ? 0.0
+            : std::chrono::duration<double, std::nano>(end - start).count() / ((double)repeatCount * constraints.size());
+        cost.meanConstraint = constraints.empty() ? 0.0f : (float)(constraintSum / constraints.size());
+
+        // 计时循环中累加的结果不是有限值时，说明约束计算出现了NaN或无穷大，报告在约束值中
+        float accumulated = sink;
+        if (!std::isfinite(accumulated))
+        {
+            cost.meanConstraint = accumulated;
+        }
+        return cost;
+    }
+
+    // 运行一个参数扫描配置，在调用线程上完成创建、模拟和统计
+    void RunParameterSweepConfig(const ParameterSweepConfig& config, uint32_t frameCount, float deltaTime, ParameterSweepResult& result)
+    {
+        result.name = config.name;
+        result.values = config.values;
+        result.succeeded = false;
+        result.particleCount = 0;
+        result.millisecondsPerFrame = 0.0;
+        result.averageIterationCount = 0.0f;
+        result.finalRMSResidual = 0.0f;
+        result.finalMaxResidual = 0.0f;
+        result.finalMeanStrain = 0.0f;
+        result.maxStrain = 0.0f;
+        result.trajectoryHash = 0;
+
+        Cloth* cloth = config.createCloth();
+        if (!cloth)
+        {
+            logDebug("RunParameterSweep: failed to create cloth for " + config.name);
+            return;
+        }
+
+        double totalSeconds = 0.0;
+        uint64_t iterationSum = 0;
+        std::vector<dx::XMFLOAT3> positions;
+        std::vector<uint64_t> frameHashes;
+        frameHashes.reserve(frameCount);
+
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cloth->Update(nullptr, deltaTime);
+            auto end = std::chrono::steady_clock::now();
+
+            totalSeconds += std::chrono::duration<double>(end - start).count();
+            iterationSum += cloth->GetSolverStats().iterationCount;
+
+            float frameMaxStrain = 0.0f;
+            cloth->ComputeDistanceConstraintError(result.finalMeanStrain, frameMaxStrain);
+            result.maxStrain = (std::max)(result.maxStrain, frameMaxStrain);
+
+            // 每帧的位置哈希再整体求哈希，轨迹中任何一帧不同都会改变结果
+            GatherPositions(cloth, positions);
+            frameHashes.push_back(ClothCheckpoint::ComputeChecksum((const char*)positions.data(), positions.size() * sizeof(dx::XMFLOAT3)));
+        }
+
+        const ClothSolverStats& stats = cloth->GetSolverStats();
+        result.succeeded = true;
+        result.particleCount = (uint32_t)cloth->GetParticles().size();
+        result.millisecondsPerFrame = frameCount > 0 ? totalSeconds * 1000.0 / frameCount : 0.0;
+        result.averageIterationCount = frameCount > 0 ? (float)iterationSum / frameCount : 0.0f;
+        result.finalRMSResidual = stats.rmsError;
+        result.finalMaxResidual = stats.maxError;
+        result.trajectoryHash = ClothCheckpoint::ComputeChecksum((const char*)frameHashes.data(), frameHashes.size() * sizeof(uint64_t));
+
+        delete cloth;
+    }
+
+    // CSV字段中含有逗号、引号或换行时加引号，引号写两次
+    std::string EscapeCSVField(const std::string& field)
+    {
+        if (field.find_first_of(",\"\r\n") == std::string::npos)
+        {
+            return field;
+        }
+
+        std::string escaped = "\"";
+        for (char c : field)
+        {
+            escaped += c;
+            if (c == '"')
+            {
+                escaped += '"';
+            }
+        }
+        return escaped + "\"";
+    }
+}
+
+std::vector<SolverScheduleConfig> GetDefaultSolverScheduleConfigs(uint32_t iteratorCount, uint32_t subIteratorCount)
+{
+    std::vector<SolverScheduleConfig> configs;
+
+    // 第一个配置作为基准
+    configs.push_back({ "Iterative(current)", XPBDScheduleMode::Iterative, subIteratorCount, iteratorCount, false, 0, ClothSolverType::XPBD });
+    configs.push_back({ "Iterative(20x1)", XPBDScheduleMode::Iterative, 1, 20, false, 0, ClothSolverType::XPBD });
+
+    // Chebyshev加速：用更少的迭代达到相当的误差
+    configs.push_back({ "Chebyshev(6x1)", XPBDScheduleMode::Iterative, 1, 6, true, 0, ClothSolverType::XPBD });
+    configs.push_back({ "Chebyshev(8x1)", XPBDScheduleMode::Iterative, 1, 8, true, 0, ClothSolverType::XPBD });
+
+    // 多层级求解：当前的迭代布局加上粗网格，层级数按网格大小自动减少
+    configs.push_back({ "Multigrid(current)", XPBDScheduleMode::Iterative, subIteratorCount, iteratorCount, false, 6, ClothSolverType::XPBD });
+
+    // Projective Dynamics：局部投影完全并行，全局步只做预分解矩阵的回代
+    configs.push_back({ "PD(current)", XPBDScheduleMode::Iterative, subIteratorCount, iteratorCount, false, 0, ClothSolverType::ProjectiveDynamics });
+    configs.push_back({ "PD+Chebyshev(current)", XPBDScheduleMode::Iterative, subIteratorCount, iteratorCount, true, 0, ClothSolverType::ProjectiveDynamics });
+
+    // 小步长配置：子步数与迭代布局的总迭代次数相当或更少
+    const uint32_t smallStepCounts[] = { 5, 10, 15, 20 };
+    for (uint32_t substeps : smallStepCounts)
+    {
+        configs.push_back({ "SmallSteps(1x" + std::to_string(substeps) + ")", XPBDScheduleMode::SmallSteps, substeps, 1, false, 0, ClothSolverType::XPBD });
+    }
+
+    return configs;
+}
+
+std::vector<SolverScheduleResult> RunSolverScheduleBenchmark(const ClothFactory& createCloth,
+    const std::vector<SolverScheduleConfig>& configs, uint32_t frameCount, float deltaTime)
+{
+    std::vector<SolverScheduleResult> results;
+
+    for (const SolverScheduleConfig& config : configs)
+    {
+        Cloth* cloth = createCloth();
+        if (!cloth)
+        {
+            logDebug("RunSolverScheduleBenchmark: failed to create cloth for " + config.name);
+            continue;
+        }
+
+        cloth->SetSolverType(config.solverType);
+        cloth->SetScheduleMode(config.scheduleMode);
+        cloth->SetSubIteratorCount(config.subIteratorCount);
+        cloth->SetIteratorCount(config.iteratorCount);
+        cloth->SetChebyshevAcceleration(config.chebyshevAcceleration);
+        cloth->SetMultigridLevelCount(config.multigridLevelCount);
+
+        double totalSeconds = 0.0;
+        double strainSum = 0.0;
+        float maxStrain = 0.0f;
+        uint64_t iterationSum = 0;
+
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cloth->Update(nullptr, deltaTime);
+            auto end = std::chrono::steady_clock::now();
+
+            totalSeconds += std::chrono::duration<double>(end - start).count();
+            iterationSum += cloth->GetSolverStats().iterationCount;
+
+            float frameMeanStrain = 0.0f;
+            float frameMaxStrain = 0.0f;
+            cloth->ComputeDistanceConstraintError(frameMeanStrain, frameMaxStrain);
+
+            strainSum += frameMeanStrain;
+            maxStrain = (std::max)(maxStrain, frameMaxStrain);
+        }
+
+        SolverScheduleResult result;
+        result.config = config;
+        result.millisecondsPerFrame = frameCount > 0 ? totalSeconds * 1000.0 / frameCount : 0.0;
+        result.meanStrain = frameCount > 0 ? (float)(strainSum / frameCount) : 0.0f;
+        result.maxStrain = maxStrain;
+        result.averageIterationCount = frameCount > 0 ? (float)iterationSum / frameCount : 0.0f;
+        results.push_back(result);
+
+        delete cloth;
+    }
+
+    return results;
+}
+
+void LogSolverScheduleResults(const std::vector<SolverScheduleResult>& results)
+{
+    if (results.empty())
+    {
+        return;
+    }
+
+    const SolverScheduleResult& baseline = results.front();
+
+    logDebug("Solver schedule benchmark (baseline: " + baseline.config.name + ")");
+    logDebug("config                      ms/frame  iterations   meanStrain   maxStrain    relTime  relStrain  strain*ms");
+
+    for (const SolverScheduleResult& result : results)
+    {
+        double relativeTime = baseline.millisecondsPerFrame > 0.0 ? result.millisecondsPerFrame / baseline.millisecondsPerFrame : 0.0;
+        double relativeStrain = baseline.meanStrain > 0.0f ? result.meanStrain / baseline.meanStrain : 0.0;
+
+        // 误差与耗时的乘积，越小表示单位CPU时间的收敛越好
+        double strainTimesCost = result.meanStrain * result.millisecondsPerFrame;
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%-26s %9.3f %11.2f %12.6f %11.6f %10.3f %10.3f %10.6f"
+            , result.config.name.c_str()
+            , result.millisecondsPerFrame
+            , result.averageIterationCount
+            , result.meanStrain
+            , result.maxStrain
+            , relativeTime
+            , relativeStrain
+            , strainTimesCost);
+        logDebug(buffer);
+    }
+}
+
+std::vector<BendingConstraintCost> RunBendingConstraintBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime)
+{
+    std::vector<BendingConstraintCost> costs;
+
+    Cloth* cloth = createCloth();
+    if (!cloth)
+    {
+        logDebug("RunBendingConstraintBenchmark: failed to create cloth");
+        return costs;
+    }
+
+    // 约束引用这份粒子副本，静止状态（等距弯曲约束的模板权重、静止二面角）取自初始的平面布料
+    std::vector<Particle> particles = cloth->GetParticles();
+
+    std::vector<uint32_t> quads;
+    if (cloth->HasGridTopology())
+    {
+        BuildBendingQuads(cloth->GetWidthResolution(), cloth->GetHeightResolution(), quads);
+    }
+    else
+    {
+        BuildMeshBendingQuads(cloth->GetMeshTopology(), quads);
+    }
+
+    std::vector<DihedralBendingConstraint> dihedralConstraints;
+    std::vector<IsometricBendingConstraint> isometricConstraints;
+    dihedralConstraints.reserve(quads.size() / 4);
+    isometricConstraints.reserve(quads.size() / 4);
+
+    for (size_t q = 0; q + 3 < quads.size(); q += 4)
+    {
+        Particle* p1 = &particles[quads[q]];
+        Particle* p2 = &particles[quads[q + 1]];
+        Particle* p3 = &particles[quads[q + 2]];
+        Particle* p4 = &particles[quads[q + 3]];
+
+        dihedralConstraints.emplace_back(p1, p2, p3, p4, 1e-6f, 0.0f);
+        isometricConstraints.emplace_back(p1, p2, p3, p4, 1e-6f, 0.0f);
+    }
+
+    // 模拟得到变形（弯曲）后的位置，避免只测到平面状态下的快速分支
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        cloth->Update(nullptr, deltaTime);
+    }
+
+    const std::vector<Particle>& deformed = cloth->GetParticles();
+    for (size_t i = 0; i < particles.size() && i < deformed.size(); ++i)
+    {
+        particles[i].position = deformed[i].position;
+    }
+
+    delete cloth;
+
+    // 每类约束至少计算约一百万次
+    const uint32_t repeatCount = (uint32_t)(std::max)((size_t)1, (size_t)1000000 / (std::max)((size_t)1, dihedralConstraints.size()));
+
+    costs.push_back(MeasureConstraintCost("DihedralBending", dihedralConstraints, repeatCount));
+    costs.push_back(MeasureConstraintCost("IsometricBending", isometricConstraints, repeatCount));
+
+    return costs;
+}
+
+void LogBendingConstraintCosts(const std::vector<BendingConstraintCost>& costs)
+{
+    if (costs.empty())
+    {
+        return;
+    }
+
+    const BendingConstraintCost& baseline = costs.front();
+
+    logDebug("Bending constraint benchmark (baseline: " + baseline.name + ")");
+    logDebug("constraint           count   ns/constraint    relTime   mean|C|");
+
+    for (const BendingConstraintCost& cost : costs)
+    {
+        double relativeTime = baseline.nanosecondsPerConstraint > 0.0 ? cost.nanosecondsPerConstraint / baseline.nanosecondsPerConstraint : 0.0;
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%-18s %7u %15.2f %10.3f %9.6f"
+            , cost.name.c_str()
+            , cost.constraintCount
+            , cost.nanosecondsPerConstraint
+            , relativeTime
+            , cost.meanConstraint);
+        logDebug(buffer);
+    }
+}
+
+std::vector<ParticleOrderingResult> RunParticleOrderingBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime)
+{
+    std::vector<ParticleOrderingResult> results;
+
+    const struct
+    {
+        const char* name;
+        ClothParticleOrdering ordering;
+    } orderings[] =
+    {
+        { "Creation", ClothParticleOrdering::None },
+        { "Morton", ClothParticleOrdering::Morton },
+        { "ReverseCuthillMcKee", ClothParticleOrdering::ReverseCuthillMcKee },
+    };
+
+    for (const auto& entry : orderings)
+    {
+        Cloth* cloth = createCloth();
+        if (!cloth)
+        {
+            logDebug(std::string("RunParticleOrderingBenchmark: failed to create cloth for ") + entry.name);
+            continue;
+        }
+
+        cloth->ReorderParticles(entry.ordering);
+
+        // 一次完整迭代按求解顺序访问的粒子：距离约束、弯曲约束、LRA约束
+        const std::vector<Particle>& particles = cloth->GetParticles();
+        std::vector<uint32_t> accesses;
+        AppendColoredParticleAccesses(cloth->GetDistanceConstraints(), particles, accesses);
+        AppendColoredParticleAccesses(cloth->GetDihedralBendingConstraints(), particles, accesses);
+        AppendColoredParticleAccesses(cloth->GetIsometricBendingConstraints(), particles, accesses);
+        AppendColoredParticleAccesses(cloth->GetLRAConstraints(), particles, accesses);
+
+        const size_t constraintCount = cloth->GetDistanceConstraints().size() + cloth->GetDihedralBendingConstraints().size()
+            + cloth->GetIsometricBendingConstraints().size() + cloth->GetLRAConstraints().size();
+
+        // 连续两次迭代，只统计第二次，排除冷启动缺失
+        SetAssociativeCache l1(32 * 1024, 8, 64);
+        SetAssociativeCache l2(256 * 1024, 8, 64);
+        uint64_t l1Warm = 0;
+        uint64_t l2Warm = 0;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            l1Warm = l1.GetMissCount();
+            l2Warm = l2.GetMissCount();
+
+            for (uint32_t particle : accesses)
+            {
+                l1.Access((uint64_t)particle * sizeof(Particle), sizeof(Particle));
+                l2.Access((uint64_t)particle * sizeof(Particle), sizeof(Particle));
+            }
+        }
+
+        double totalSeconds = 0.0;
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cloth->Update(nullptr, deltaTime);
+            auto end = std::chrono::steady_clock::now();
+
+            totalSeconds += std::chrono::duration<double>(end - start).count();
+        }
+
+        double constraintSpanSum = 0.0;
+        for (const DistanceConstraint& constraint : cloth->GetDistanceConstraints())
+        {
+            const Particle** constraintParticles = constraint.GetParticles();
+            constraintSpanSum += std::abs((double)(constraintParticles[0] - constraintParticles[1]));
+        }
+
+        ParticleOrderingResult result;
+        result.name = entry.name;
+        result.meanConstraintSpan = cloth->GetDistanceConstraints().empty() ? 0.0f : (float)(constraintSpanSum / cloth->GetDistanceConstraints().size());
+        result.l1MissesPerConstraint = constraintCount > 0 ? (double)(l1.GetMissCount() - l1Warm) / constraintCount : 0.0;
+        result.l2MissesPerConstraint = constraintCount > 0 ? (double)(l2.GetMissCount() - l2Warm) / constraintCount : 0.0;
+        result.millisecondsPerFrame = frameCount > 0 ? totalSeconds * 1000.0 / frameCount : 0.0;
+        results.push_back(result);
+
+        delete cloth;
+    }
+
+    return results;
+}
+
+void LogParticleOrderingResults(const std::vector<ParticleOrderingResult>& results)
+{
+    if (results.empty())
+    {
+        return;
+    }
+
+    const ParticleOrderingResult& baseline = results.front();
+
+    logDebug("Particle ordering benchmark (baseline: " + baseline.name + ", " + std::to_string(sizeof(Particle)) + " bytes per particle)");
+    logDebug("ordering              span   L1miss/c   L2miss/c   ms/frame   relL1   relL2  relTime");
+
+    for (const ParticleOrderingResult& result : results)
+    {
+        double relativeL1 = baseline.l1MissesPerConstraint > 0.0 ? result.l1MissesPerConstraint / baseline.l1MissesPerConstraint : 0.0;
+        double relativeL2 = baseline.l2MissesPerConstraint > 0.0 ? result.l2MissesPerConstraint / baseline.l2MissesPerConstraint : 0.0;
+        double relativeTime = baseline.millisecondsPerFrame > 0.0 ? result.millisecondsPerFrame / baseline.millisecondsPerFrame : 0.0;
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%-19s %7.1f %10.3f %10.3f %10.3f %7.3f %7.3f %8.3f"
+            , result.name.c_str()
+            , result.meanConstraintSpan
+            , result.l1MissesPerConstraint
+            , result.l2MissesPerConstraint
+            , result.millisecondsPerFrame
+            , relativeL1
+            , relativeL2
+            , relativeTime);
+        logDebug(buffer);
+    }
+}
+
+std::vector<FrameCacheResult> RunFrameCacheBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime, const std::string& path)
+{
+    struct FormatEntry
+    {
+        const char* name;
+        ClothFrameCacheFormat format;
+    };
+
+    const FormatEntry formats[] =
+    {
+        { "Float32", ClothFrameCacheFormat::Float32 },
+        { "Quantized16", ClothFrameCacheFormat::Quantized16 },
+        { "CompressedNormal16", ClothFrameCacheFormat::CompressedNormal16 },
+        { "CompressedNormal8", ClothFrameCacheFormat::CompressedNormal8 },
+    };
+
+    // 最多抽样16帧保存模拟结果用于对比，避免保存所有帧
+    const uint32_t sampleStride = (std::max)(1u, frameCount / 16);
+
+    std::vector<FrameCacheResult> results;
+
+    for (const FormatEntry& entry : formats)
+    {
+        Cloth* cloth = createCloth();
+        if (!cloth)
+        {
+            logDebug("RunFrameCacheBenchmark: failed to create cloth");
+            return results;
+        }
+
+        const std::string formatPath = path + "." + entry.name;
+        if (!cloth->StartFrameCacheRecording(formatPath, entry.format))
+        {
+            delete cloth;
+            return results;
+        }
+
+        // 第frame + 1帧为第frame次Update后的状态
+        std::vector<uint32_t> sampleFrames;
+        std::vector<dx::XMFLOAT3> samplePositions;
+        std::vector<dx::XMFLOAT3> sampleNormals;
+
+        double bakeSeconds = 0.0;
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cloth->Update(nullptr, deltaTime);
+            auto end = std::chrono::steady_clock::now();
+
+            bakeSeconds += std::chrono::duration<double>(end - start).count();
+
+            if (frame % sampleStride == 0)
+            {
+                sampleFrames.push_back(frame + 1);
+                samplePositions.insert(samplePositions.end(), cloth->GetPositions().begin(), cloth->GetPositions().end());
+                sampleNormals.insert(sampleNormals.end(), cloth->GetNormals().begin(), cloth->GetNormals().end());
+            }
+        }
+
+        delete cloth;
+
+        ClothFrameCacheReader reader;
+        if (!reader.Open(formatPath))
+        {
+            return results;
+        }
+
+        const uint32_t cachedFrameCount = reader.GetFrameCount();
+        const uint32_t vertexCount = reader.GetVertexCount();
+        std::vector<float> vertexData((size_t)vertexCount * 6);
+
+        auto sequentialStart = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < cachedFrameCount; ++frame)
+        {
+            reader.DecodeFrame(frame, vertexData.data());
+        }
+        auto sequentialEnd = std::chrono::steady_clock::now();
+
+        // 固定种子的随机顺序，每帧访问一次
+        std::vector<uint32_t> randomFrames(cachedFrameCount);
+        for (uint32_t frame = 0; frame < cachedFrameCount; ++frame)
+        {
+            randomFrames[frame] = frame;
+        }
+        std::mt19937 random(12345);
+        std::shuffle(randomFrames.begin(), randomFrames.end(), random);
+
+        auto randomStart = std::chrono::steady_clock::now();
+        for (uint32_t frame : randomFrames)
+        {
+            reader.DecodeFrame(frame, vertexData.data());
+        }
+        auto randomEnd = std::chrono::steady_clock::now();
+
+        FrameCacheResult result;
+        result.name = entry.name;
+        result.frameCount = cachedFrameCount;
+        result.maxPositionError = 0.0f;
+        result.maxNormalError = 0.0f;
+
+        for (size_t sample = 0; sample < sampleFrames.size(); ++sample)
+        {
+            reader.DecodeFrame(sampleFrames[sample], vertexData.data());
+
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                const float* vertex = &vertexData[(size_t)v * 6];
+                const dx::XMFLOAT3& position = samplePositions[sample * vertexCount + v];
+                const dx::XMFLOAT3& normal = sampleNormals[sample * vertexCount + v];
+
+                result.maxPositionError = (std::max)(result.maxPositionError, std::abs(vertex[0] - position.x));
+                result.maxPositionError = (std::max)(result.maxPositionError, std::abs(vertex[1] - position.y));
+                result.maxPositionError = (std::max)(result.maxPositionError, std::abs(vertex[2] - position.z));
+                result.maxNormalError = (std::max)(result.maxNormalError, std::abs(vertex[3] - normal.x));
+                result.maxNormalError = (std::max)(result.maxNormalError, std::abs(vertex[4] - normal.y));
+                result.maxNormalError = (std::max)(result.maxNormalError, std::abs(vertex[5] - normal.z));
+            }
+        }
+
+        std::ifstream file(formatPath, std::ios::binary | std::ios::ate);
+        double fileBytes = (double)file.tellg();
+
+        result.megabytes = fileBytes / (1024.0 * 1024.0);
+        result.bytesPerFrame = cachedFrameCount > 0 ? fileBytes / cachedFrameCount : 0.0;
+        result.bakeMillisecondsPerFrame = frameCount > 0 ? bakeSeconds * 1000.0 / frameCount : 0.0;
+        result.sequentialMillisecondsPerFrame = std::chrono::duration<double>(sequentialEnd - sequentialStart).count() * 1000.0 / cachedFrameCount;
+        result.randomMillisecondsPerFrame = std::chrono::duration<double>(randomEnd - randomStart).count() * 1000.0 / cachedFrameCount;
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+void LogFrameCacheResults(const std::vector<FrameCacheResult>& results)
+{
+    if (results.empty())
+    {
+        return;
+    }
+
+    const FrameCacheResult& baseline = results.front();
+
+    logDebug("Frame cache benchmark (baseline: " + baseline.name + ", " + std::to_string(baseline.frameCount) + " frames)");
+    logDebug("format                 MB   bytes/frame  bake ms/f  seq ms/f  rand ms/f  maxPosErr  maxNrmErr  relSize");
+
+    for (const FrameCacheResult& result : results)
+    {
+        double relativeSize = baseline.megabytes > 0.0 ? result.megabytes / baseline.megabytes : 0.0;
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%-18s %8.2f %13.0f %10.3f %9.4f %10.4f %10.6f %10.6f %8.3f"
+            , result.name.c_str()
+            , result.megabytes
+            , result.bytesPerFrame
+            , result.bakeMillisecondsPerFrame
+            , result.sequentialMillisecondsPerFrame
+            , result.randomMillisecondsPerFrame
+            , result.maxPositionError
+            , result.maxNormalError
+            , relativeSize);
+        logDebug(buffer);
+    }
+}
+
+CheckpointResult RunCheckpointBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime, const std::string& path)
+{
+    CheckpointResult result;
+    result.frameCount = frameCount;
+    result.checkpointFrame = frameCount / 2;
+    result.kilobytes = 0.0;
+    result.captureMilliseconds = 0.0;
+    result.writeWaitMilliseconds = 0.0;
+    result.restoreMilliseconds = 0.0;
+    result.bitExact = false;
+    result.maxPositionDeviation = 0.0f;
+
+    // 1. 不中断地模拟，中间保存检查点，写入与剩余帧的模拟并行
+    Cloth* cloth = createCloth();
+    if (!cloth)
+    {
+        logDebug("RunCheckpointBenchmark: failed to create cloth");
+        return result;
+    }
+
+    ClothCheckpointWriter writer;
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        if (frame == result.checkpointFrame)
+        {
+            std::vector<char> checkpoint;
+
+            auto start = std::chrono::steady_clock::now();
+            cloth->SaveCheckpoint(checkpoint);
+            auto end = std::chrono::steady_clock::now();
+
+            result.captureMilliseconds = std::chrono::duration<double>(end - start).count() * 1000.0;
+            result.kilobytes = checkpoint.size() / 1024.0;
+            writer.WriteAsync(path, std::move(checkpoint));
+        }
+
+        cloth->Update(nullptr, deltaTime);
+    }
+
+    auto waitStart = std::chrono::steady_clock::now();
+    bool written = writer.Wait();
+    auto waitEnd = std::chrono::steady_clock::now();
+    result.writeWaitMilliseconds = std::chrono::duration<double>(waitEnd - waitStart).count() * 1000.0;
+
+    const std::vector<Particle> expected = cloth->GetParticles();
+    delete cloth;
+
+    if (!written)
+    {
+        return result;
+    }
+
+    // 2. 新布料从检查点恢复后模拟剩余的帧
+    cloth = createCloth();
+    if (!cloth)
+    {
+        logDebug("RunCheckpointBenchmark: failed to create cloth");
+        return result;
+    }
+
+    auto restoreStart = std::chrono::steady_clock::now();
+    std::vector<char> checkpoint;
+    bool restored = ClothCheckpoint::ReadFile(path, checkpoint) && cloth->LoadCheckpoint(checkpoint.data(), checkpoint.size());
+    auto restoreEnd = std::chrono::steady_clock::now();
+    result.restoreMilliseconds = std::chrono::duration<double>(restoreEnd - restoreStart).count() * 1000.0;
+
+    if (!restored)
+    {
+        delete cloth;
+        return result;
+    }
+
+    for (uint32_t frame = result.checkpointFrame; frame < frameCount; ++frame)
+    {
+        cloth->Update(nullptr, deltaTime);
+    }
+
+    // 3. 逐位对比位置、速度和休眠状态
+    const std::vector<Particle>& actual = cloth->GetParticles();
+    result.bitExact = true;
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        const Particle& a = expected[i];
+        const Particle& b = actual[i];
+
+        result.bitExact = result.bitExact
+            && memcmp(&a.position, &b.position, sizeof(a.position)) == 0
+            && memcmp(&a.oldPosition, &b.oldPosition, sizeof(a.oldPosition)) == 0
+            && memcmp(&a.velocity, &b.velocity, sizeof(a.velocity)) == 0
+            && a.isSleeping == b.isSleeping;
+
+        result.maxPositionDeviation = (std::max)(result.maxPositionDeviation, std::abs(a.position.x - b.position.x));
+        result.maxPositionDeviation = (std::max)(result.maxPositionDeviation, std::abs(a.position.y - b.position.y));
+        result.maxPositionDeviation = (std::max)(result.maxPositionDeviation, std::abs(a.position.z - b.position.z));
+    }
+
+    delete cloth;
+    return result;
+}
+
+void LogCheckpointResult(const CheckpointResult& result)
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Checkpoint benchmark: saved at frame %u of %u, %.1f KB, capture %.3f ms, write wait %.3f ms, restore %.3f ms"
+        , result.checkpointFrame
+        , result.frameCount
+        , result.kilobytes
+        , result.captureMilliseconds
+        , result.writeWaitMilliseconds
+        , result.restoreMilliseconds);
+    logDebug(buffer);
+
+    snprintf(buffer, sizeof(buffer), "Checkpoint restore %s (max position deviation %g)"
+        , result.bitExact ? "is bit-exact" : "DIVERGED"
+        , result.maxPositionDeviation);
+    logDebug(buffer);
+}
+
+std::vector<uint32_t> GetDefaultDeterminismThreadCounts()
+{
+    return { 1, 2, 8, 32 };
+}
+
+std::vector<DeterminismResult> RunDeterminismBenchmark(const ClothFactory& createCloth, const std::vector<uint32_t>& threadCounts,
+    uint32_t frameCount, float deltaTime)
+{
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    const uint32_t originalWorkerCount = scheduler.GetWorkerCount();
+
+    std::vector<DeterminismResult> results;
+
+    for (uint32_t threadCount : threadCounts)
+    {
+        scheduler.Initialize(threadCount);
+
+        Cloth* cloth = createCloth();
+        if (!cloth)
+        {
+            logDebug("RunDeterminismBenchmark: failed to create cloth");
+            break;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            cloth->Update(nullptr, deltaTime);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        DeterminismResult result;
+        result.threadCount = scheduler.GetWorkerCount();
+        result.hash = ComputeParticleStateHash(cloth);
+        result.millisecondsPerFrame = std::chrono::duration<double>(end - start).count() * 1000.0 / frameCount;
+        results.push_back(result);
+
+        delete cloth;
+    }
+
+    scheduler.Initialize(originalWorkerCount);
+    return results;
+}
+
+bool LogDeterminismResults(const std::vector<DeterminismResult>& results, const std::string& goldenHash)
+{
+    if (results.empty())
+    {
+        return false;
+    }
+
+    logDebug("Determinism benchmark (baseline: " + std::to_string(results.front().threadCount) + " threads)");
+    logDebug("threads  hash              ms/frame");
+
+    bool identical = true;
+    for (const DeterminismResult& result : results)
+    {
+        identical = identical && result.hash == results.front().hash;
+
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "%7u  %016llx %9.3f"
+            , result.threadCount
+            , (unsigned long long)result.hash
+            , result.millisecondsPerFrame);
+        logDebug(buffer);
+    }
+
+    logDebug(identical ? "Determinism check passed: all thread counts produced identical particle state"
+        : "Determinism check FAILED: particle state depends on the thread count");
+
+    if (goldenHash.empty())
+    {
+        return identical;
+    }
+
+    const uint64_t expected = strtoull(goldenHash.c_str(), nullptr, 16);
+    const bool matchesGolden = results.front().hash == expected;
+    logDebug(matchesGolden ? "Golden hash check passed" : "Golden hash check FAILED: expected " + goldenHash);
+
+    return identical && matchesGolden;
+}
+
+bool RecordTrajectory(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime, const std::string& path)
+{
+    Cloth* cloth = createCloth();
+    if (!cloth)
+    {
+        logDebug("RecordTrajectory: failed to create cloth");
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        logDebug("RecordTrajectory: failed to open " + path);
+        delete cloth;
+        return false;
+    }
+
+    TrajectoryHeader header;
+    memcpy(header.magic, kTrajectoryMagic, sizeof(header.magic));
+    header.particleCount = (uint32_t)cloth->GetParticles().size();
+    header.frameCount = frameCount;
+    header.solverRealSize = sizeof(SolverReal);
+    header.deltaTime = deltaTime;
+    file.write((const char*)&header, sizeof(header));
+
+    std::vector<dx::XMFLOAT3> positions;
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        cloth->Update(nullptr, deltaTime);
+
+        GatherPositions(cloth, positions);
+        file.write((const char*)positions.data(), sizeof(dx::XMFLOAT3) * positions.size());
+    }
+
+    delete cloth;
+
+    if (!file)
+    {
+        logDebug("RecordTrajectory: failed to write " + path);
+        return false;
+    }
+
+    logDebug("Recorded " + std::to_string(frameCount) + " frames of " + std::to_string(header.particleCount) + " particles ("
+        + SolverPrecision::kName + " solver) to " + path);
+    return true;
+}
+
+bool CompareTrajectory(const ClothFactory& createCloth, const std::string& path, float tolerance, TrajectoryComparison& comparison)
+{
+    comparison.frameCount = 0;
+    comparison.particleCount = 0;
+    comparison.maxDeviation = 0.0f;
+    comparison.finalRMSDeviation = 0.0f;
+    comparison.firstExceedingFrame = -1;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        logDebug("CompareTrajectory: failed to open " + path);
+        return false;
+    }
+
+    TrajectoryHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, kTrajectoryMagic, sizeof(header.magic)) != 0)
+    {
+        logDebug("CompareTrajectory: " + path + " is not a trajectory file");
+        return false;
+    }
+
+    Cloth* cloth = createCloth();
+    if (!cloth)
+    {
+        logDebug("CompareTrajectory: failed to create cloth");
+        return false;
+    }
+
+    if (cloth->GetParticles().size() != header.particleCount)
+    {
+        logDebug("CompareTrajectory: particle count " + std::to_string(cloth->GetParticles().size())
+            + " does not match the reference " + std::to_string(header.particleCount));
+        delete cloth;
+        return false;
+    }
+
+    comparison.particleCount = header.particleCount;
+    comparison.referencePrecision = header.solverRealSize == sizeof(double) ? "double" : "float";
+
+    std::vector<dx::XMFLOAT3> positions;
+    std::vector<dx::XMFLOAT3> referencePositions(header.particleCount);
+
+    for (uint32_t frame = 0; frame < header.frameCount; ++frame)
+    {
+        if (!file.read((char*)referencePositions.data(), sizeof(dx::XMFLOAT3) * referencePositions.size()))
+        {
+            logDebug("CompareTrajectory: reference ends at frame " + std::to_string(frame));
+            break;
+        }
+
+        cloth->Update(nullptr, header.deltaTime);
+        GatherPositions(cloth, positions);
+
+        float frameMaxDeviation = 0.0f;
+        double sumSquares = 0.0;
+        for (uint32_t i = 0; i < header.particleCount; ++i)
+        {
+            dx::XMVECTOR diff = dx::XMVectorSubtract(dx::XMLoadFloat3(&positions[i]), dx::XMLoadFloat3(&referencePositions[i]));
+            float deviation = dx::XMVectorGetX(dx::XMVector3Length(diff));
+
+            frameMaxDeviation = (std::max)(frameMaxDeviation, deviation);
+            sumSquares += (double)deviation * deviation;
+        }
+
+        comparison.frameCount = frame + 1;
+        comparison.maxDeviation = (std::max)(comparison.maxDeviation, frameMaxDeviation);
+        comparison.finalRMSDeviation = header.particleCount > 0 ? (float)std::sqrt(sumSquares / header.particleCount) : 0.0f;
+
+        if (comparison.firstExceedingFrame < 0 && frameMaxDeviation > tolerance)
+        {
+            comparison.firstExceedingFrame = (int)frame;
+        }
+    }
+
+    delete cloth;
+    return comparison.frameCount > 0;
+}
+
+bool LogTrajectoryComparison(const TrajectoryComparison& comparison, float tolerance)
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Trajectory comparison (%s solver vs %s reference): %u frames, %u particles, max deviation %.6g, final rms deviation %.6g, tolerance %.6g"
+        , SolverPrecision::kName
+        , comparison.referencePrecision.c_str()
+        , comparison.frameCount
+        , comparison.particleCount
+        , comparison.maxDeviation
+        , comparison.finalRMSDeviation
+        , tolerance);
+    logDebug(buffer);
+
+    if (comparison.firstExceedingFrame >= 0)
+    {
+        logDebug("Trajectory comparison FAILED: deviation exceeds tolerance from frame " + std::to_string(comparison.firstExceedingFrame));
+        return false;
+    }
+
+    logDebug("Trajectory comparison passed");
+    return true;
+}
+
+std::vector<RegressionScene> GetRegressionScenes(const ClothSceneDescription& scene)
+{
+    std::vector<RegressionScene> scenes;
+    if (scene.cloths.empty())
+    {
+        return scenes;
+    }
+
+    const ClothSceneCloth& defaultCloth = scene.cloths[0];
+
+    ClothSceneCloth simplifiedCloth = defaultCloth;
+    simplifiedCloth.meshAndContraintMode = ClothMeshAndContraintMode::Simplified;
+
+    ClothSceneCloth dihedralOnlyCloth = defaultCloth;
+    dihedralOnlyCloth.addBendingConstraints = false;
+    dihedralOnlyCloth.addDihedralBendingConstraints = true;
+
+    ClothSceneCloth noLRACloth = defaultCloth;
+    noLRACloth.addLRAConstraints = false;
+
+    // 按布料描述创建布料，与场景中的所有球体碰撞
+    auto createFactory = [&scene](const ClothSceneCloth& description) -> ClothFactory
+    {
+        return [description, scene]() -> Cloth*
+        {
+            Cloth* cloth = ClothSceneLoader::CreateCloth(description);
+            if (!ClothSceneLoader::InitializeSimulation(cloth, scene))
+            {
+                delete cloth;
+                return nullptr;
+            }
+            return cloth;
+        };
+    };
+
+    scenes.push_back({ "default", createFactory(defaultCloth) });
+    scenes.push_back({ "simplified", createFactory(simplifiedCloth) });
+    scenes.push_back({ "dihedralOnly", createFactory(dihedralOnlyCloth) });
+    scenes.push_back({ "noLRA", createFactory(noLRACloth) });
+    return scenes;
+}
+
+std::vector<RegressionResult> RunRegressionBenchmark(const std::vector<RegressionScene>& scenes, const std::string& goldenDirectory,
+    uint32_t frameCount, float deltaTime, float tolerance, float perfThreshold, bool updateGolden)
+{
+    std::vector<RegressionResult> results;
+
+    if (updateGolden)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(goldenDirectory, error);
+        if (error)
+        {
+            logDebug("RunRegressionBenchmark: failed to create " + goldenDirectory);
+            return results;
+        }
+    }
+
+    for (const RegressionScene& scene : scenes)
+    {
+        const std::string trajectoryPath = goldenDirectory + "/" + scene.name + ".traj";
+        const std::string perfPath = goldenDirectory + "/" + scene.name + ".perf";
+
+        RegressionResult result;
+        result.name = scene.name;
+        result.recorded = updateGolden;
+        result.goldenMissing = !updateGolden && (!std::filesystem::exists(trajectoryPath) || !std::filesystem::exists(perfPath));
+        result.trajectoryPassed = false;
+        result.trajectory = TrajectoryComparison();
+        result.trajectory.firstExceedingFrame = -1;
+        result.phaseTimes = ClothSolverPhaseTimes();
+        result.frameMilliseconds = 0.0;
+        result.baselinePhaseTimes = ClothSolverPhaseTimes();
+        result.baselineFrameMilliseconds = 0.0;
+
+        // 缺少参考文件时不录制，避免把未经确认的结果当作参考
+        if (result.goldenMissing)
+        {
+            logDebug("RunRegressionBenchmark: missing golden files for scene " + scene.name + " in " + goldenDirectory
+                + ", record them before comparing");
+            results.push_back(result);
+            continue;
+        }
+
+        // 1. 轨迹：录制参考或逐帧对比
+        if (result.recorded)
+        {
+            result.trajectoryPassed = RecordTrajectory(scene.createCloth, frameCount, deltaTime, trajectoryPath);
+        }
+        else if (CompareTrajectory(scene.createCloth, trajectoryPath, tolerance, result.trajectory))
+        {
+            result.trajectoryPassed = result.trajectory.firstExceedingFrame < 0;
+        }
+
+        // 2. 各阶段耗时：单独模拟一次计时，不计入轨迹对比的开销
+        if (!MeasureSolverPhases(scene.createCloth, frameCount, deltaTime, result.phaseTimes, result.frameMilliseconds))
+        {
+            logDebug("RunRegressionBenchmark: failed to create cloth for scene " + scene.name);
+            result.trajectoryPassed = false;
+            results.push_back(result);
+            continue;
+        }
+
+        PerfBaseline baseline;
+        if (result.recorded)
+        {
+            memcpy(baseline.magic, kPerfBaselineMagic, sizeof(baseline.magic));
+            baseline.frameCount = frameCount;
+            baseline.solverRealSize = sizeof(SolverReal);
+            baseline.phaseTimes = result.phaseTimes;
+            baseline.frameMilliseconds = result.frameMilliseconds;
+
+            std::ofstream file(perfPath, std::ios::binary | std::ios::trunc);
+            if (!file.write((const char*)&baseline, sizeof(baseline)))
+            {
+                logDebug("RunRegressionBenchmark: failed to write " + perfPath);
+                result.trajectoryPassed = false;
+            }
+
+            result.baselinePhaseTimes = result.phaseTimes;
+            result.baselineFrameMilliseconds = result.frameMilliseconds;
+        }
+        else
+        {
+            std::ifstream file(perfPath, std::ios::binary);
+            if (!file.read((char*)&baseline, sizeof(baseline)) || memcmp(baseline.magic, kPerfBaselineMagic, sizeof(baseline.magic)) != 0)
+            {
+                logDebug("RunRegressionBenchmark: " + perfPath + " is not a performance baseline");
+            }
+            else
+            {
+                result.baselinePhaseTimes = baseline.phaseTimes;
+                result.baselineFrameMilliseconds = baseline.frameMilliseconds;
+
+                for (const SolverPhase& phase : kSolverPhases)
+                {
+                    const double current = result.phaseTimes.*phase.milliseconds;
+                    const double reference = result.baselinePhaseTimes.*phase.milliseconds;
+                    if (current > reference * (1.0 + perfThreshold) && current - reference > kMinRegressionMilliseconds)
+                    {
+                        result.regressedPhases.push_back(phase.name);
+                    }
+                }
+
+                if (result.frameMilliseconds > result.baselineFrameMilliseconds * (1.0 + perfThreshold)
+                    && result.frameMilliseconds - result.baselineFrameMilliseconds > kMinRegressionMilliseconds)
+                {
+                    result.regressedPhases.push_back("frame");
+                }
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+int LogRegressionResults(const std::vector<RegressionResult>& results, float tolerance, float perfThreshold)
+{
+    if (results.empty())
+    {
+        return 1;
+    }
+
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer), "Regression benchmark (%s solver): trajectory tolerance %.6g, performance threshold +%.0f%%"
+        , SolverPrecision::kName
+        , tolerance
+        , perfThreshold * 100.0f);
+    logDebug(buffer);
+    logDebug("scene              trajectory  maxDev      setup  integrate  global  constraints  sleeping   frame ms  baseline  regressed");
+
+    bool goldenMissing = false;
+    bool trajectoriesPassed = true;
+    bool performancePassed = true;
+
+    for (const RegressionResult& result : results)
+    {
+        std::string regressed;
+        for (const std::string& phase : result.regressedPhases)
+        {
+            regressed += (regressed.empty() ? "" : ",") + phase;
+        }
+
+        snprintf(buffer, sizeof(buffer), "%-18s %-11s %-10.4g %7.3f %10.3f %7.3f %12.3f %9.3f %10.3f %9.3f  %s"
+            , result.name.c_str()
+            , result.goldenMissing ? "MISSING" : result.recorded ? (result.trajectoryPassed ? "recorded" : "FAILED") : (result.trajectoryPassed ? "passed" : "FAILED")
+            , result.trajectory.maxDeviation
+            , result.phaseTimes.setup
+            , result.phaseTimes.integrate
+            , result.phaseTimes.globalSolve
+            , result.phaseTimes.constraints
+            , result.phaseTimes.sleeping
+            , result.frameMilliseconds
+            , result.baselineFrameMilliseconds
+            , regressed.empty() ? "-" : regressed.c_str());
+        logDebug(buffer);
+
+        if (!result.recorded && result.trajectory.firstExceedingFrame >= 0)
+        {
+            logDebug("  " + result.name + ": deviation exceeds tolerance from frame " + std::to_string(result.trajectory.firstExceedingFrame));
+        }
+
+        goldenMissing = goldenMissing || result.goldenMissing;
+        trajectoriesPassed = trajectoriesPassed && result.trajectoryPassed;
+        performancePassed = performancePassed && result.regressedPhases.empty();
+    }
+
+    if (goldenMissing)
+    {
+        logDebug("Regression check FAILED: golden files are missing");
+        return 1;
+    }
+
+    if (!trajectoriesPassed)
+    {
+        logDebug("Regression check FAILED: trajectories differ from the golden files");
+        return 1;
+    }
+
+    if (!performancePassed)
+    {
+        logDebug("Regression check FAILED: performance regressed beyond the threshold");
+        return 2;
+    }
+
+    logDebug("Regression check passed");
+    return 0;
+}
+
+BatchUpdateResult RunBatchUpdateBenchmark(const ClothFactory& createCloth, uint32_t clothCount, uint32_t frameCount, float deltaTime)
+{
+    BatchUpdateResult result;
+    result.clothCount = clothCount;
+    result.particlesPerCloth = 0;
+    result.batchUpdateSupported = false;
+    result.serialMillisecondsPerFrame = 0.0;
+    result.batchMillisecondsPerFrame = 0.0;
+    result.bitExact = false;
+    result.batchMeanStrain = 0.0f;
+    result.packedSupported = false;
+    result.packedMillisecondsPerFrame = 0.0;
+    result.packedMeanStrain = 0.0f;
+    result.packedFinite = false;
+
+    // 1. 逐个更新
+    std::vector<Cloth*> cloths;
+    if (clothCount == 0 || !CreateCloths(createCloth, clothCount, cloths))
+    {
+        logDebug("RunBatchUpdateBenchmark: failed to create cloths");
+        return result;
+    }
+
+    result.particlesPerCloth = (uint32_t)cloths.front()->GetParticles().size();
+    result.batchUpdateSupported = cloths.front()->IsBatchUpdateSupported();
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        for (Cloth* cloth : cloths)
+        {
+            cloth->Update(nullptr, deltaTime);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.serialMillisecondsPerFrame = std::chrono::duration<double>(end - start).count() * 1000.0 / frameCount;
+
+    std::vector<uint64_t> serialHashes;
+    for (Cloth* cloth : cloths)
+    {
+        serialHashes.push_back(ComputeParticleStateHash(cloth));
+        delete cloth;
+    }
+
+    // 2. 批量更新，与场景的批量更新路径相同
+    if (!CreateCloths(createCloth, clothCount, cloths))
+    {
+        logDebug("RunBatchUpdateBenchmark: failed to create cloths");
+        return result;
+    }
+
+    std::vector<Primitive*> primitives(cloths.begin(), cloths.end());
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        Primitive::UpdateBatch(primitives, deltaTime);
+    }
+    end = std::chrono::steady_clock::now();
+    result.batchMillisecondsPerFrame = std::chrono::duration<double>(end - start).count() * 1000.0 / frameCount;
+
+    result.bitExact = true;
+    result.batchMeanStrain = ComputeMeanStrain(cloths);
+    for (size_t i = 0; i < cloths.size(); ++i)
+    {
+        result.bitExact = result.bitExact && ComputeParticleStateHash(cloths[i]) == serialHashes[i];
+        delete cloths[i];
+    }
+
+    // 3. 打包求解，与场景开启打包求解时的路径相同
+    if (!CreateCloths(createCloth, clothCount, cloths))
+    {
+        logDebug("RunBatchUpdateBenchmark: failed to create cloths");
+        return result;
+    }
+
+    // 同一个回调创建的布料参数相同，满足打包条件时可以全部打包在一起
+    result.packedSupported = ClothBatchSolver::IsSupported(cloths.front());
+    if (result.packedSupported)
+    {
+        ClothBatchSolver batchSolver;
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            batchSolver.Step(cloths, deltaTime);
+        }
+        end = std::chrono::steady_clock::now();
+        result.packedMillisecondsPerFrame = std::chrono::duration<double>(end - start).count() * 1000.0 / frameCount;
+
+        result.packedMeanStrain = ComputeMeanStrain(cloths);
+        result.packedFinite = true;
+        for (const Cloth* cloth : cloths)
+        {
+            result.packedFinite = result.packedFinite && AreParticlePositionsFinite(cloth);
+        }
+    }
+
+    for (Cloth* cloth : cloths)
+    {
+        delete cloth;
+    }
+
+    return result;
+}
+
+void LogBatchUpdateResult(const BatchUpdateResult& result)
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Batch update benchmark: %u cloths x %u particles, %u workers, scene %s batch these cloths"
+        , result.clothCount
+        , result.particlesPerCloth
+        , TaskScheduler::Get().GetWorkerCount()
+        , result.batchUpdateSupported ? "would" : "would not");
+    logDebug(buffer);
+
+    snprintf(buffer, sizeof(buffer), "serial %.3f ms/frame, batched %.3f ms/frame, speedup %.2fx"
+        , result.serialMillisecondsPerFrame
+        , result.batchMillisecondsPerFrame
+        , result.batchMillisecondsPerFrame > 0.0 ? result.serialMillisecondsPerFrame / result.batchMillisecondsPerFrame : 0.0);
+    logDebug(buffer);
+
+    logDebug(result.bitExact ? "Batch update check passed: batched cloths match the serial update bit for bit"
+        : "Batch update check FAILED: batched cloths differ from the serial update");
+
+    if (!result.packedSupported)
+    {
+        logDebug("Packed solver: these cloths cannot be packed (see ClothBatchSolver::IsSupported)");
+        return;
+    }
+
+    snprintf(buffer, sizeof(buffer), "packed %.3f ms/frame, speedup %.2fx over batched; mean strain batched %.6f, packed %.6f"
+        , result.packedMillisecondsPerFrame
+        , result.packedMillisecondsPerFrame > 0.0 ? result.batchMillisecondsPerFrame / result.packedMillisecondsPerFrame : 0.0
+        , result.batchMeanStrain
+        , result.packedMeanStrain);
+    logDebug(buffer);
+
+    logDebug(result.packedFinite ? "Packed solver check passed: all particle positions are finite"
+        : "Packed solver check FAILED: packed cloths have non-finite particle positions");
+}
+
+std::vector<ParameterSweepResult> RunParameterSweep(const std::vector<ParameterSweepConfig>& configs, uint32_t frameCount, float deltaTime)
+{
+    std::vector<ParameterSweepResult> results(configs.size());
+
+    // 每个配置是一个块，空闲的工作线程动态领取下一个配置
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)configs.size(), 1, [&configs, &results, frameCount, deltaTime](uint32_t begin, uint32_t end)
+    {
+        SerialTaskScope serialScope;
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            RunParameterSweepConfig(configs[index], frameCount, deltaTime, results[index]);
+        }
+    });
+
+    return results;
+}
+
+bool WriteParameterSweepCSV(const std::vector<std::string>& axes, const std::vector<ParameterSweepResult>& results, const std::string& path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file)
+    {
+        logDebug("WriteParameterSweepCSV: failed to open " + path);
+        return false;
+    }
+
+    for (const std::string& axis : axes)
+    {
+        file << EscapeCSVField(axis) << ",";
+    }
+    file << "succeeded,particles,msPerFrame,iterationsPerFrame,finalRMSResidual,finalMaxResidual,finalMeanStrain,maxStrain,trajectoryHash\n";
+
+    for (const ParameterSweepResult& result : results)
+    {
+        for (size_t axis = 0; axis < axes.size(); ++axis)
+        {
+            file << (axis < result.values.size() ? EscapeCSVField(result.values[axis]) : "") << ",";
+        }
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%d,%u,%.6f,%.3f,%.9g,%.9g,%.9g,%.9g,%016llx"
+            , result.succeeded ? 1 : 0
+            , result.particleCount
+            , result.millisecondsPerFrame
+            , result.averageIterationCount
+            , result.finalRMSResidual
+            , result.finalMaxResidual
+            , result.finalMeanStrain
+            , result.maxStrain
+            , (unsigned long long)result.trajectoryHash);
+        file << buffer << "\n";
+    }
+
+    if (!file.flush())
+    {
+        logDebug("WriteParameterSweepCSV: failed to write " + path);
+        return false;
+    }
+
+    logDebug("Parameter sweep results written to " + path);
+    return true;
+}
+
+bool LogParameterSweepResults(const std::vector<ParameterSweepResult>& results)
+{
+    logDebug("Parameter sweep (" + std::to_string(results.size()) + " configurations, "
+        + std::to_string(TaskScheduler::Get().GetWorkerCount()) + " workers)");
+    logDebug("ms/frame  iterations  rmsResidual   maxStrain  hash              config");
+
+    uint32_t failedCount = 0;
+    for (const ParameterSweepResult& result : results)
+    {
+        if (!result.succeeded)
+        {
+            ++failedCount;
+            logDebug("  FAILED                                                    " + result.name);
+            continue;
+        }
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%8.3f %11.2f %12.6g %11.6f  %016llx  "
+            , result.millisecondsPerFrame
+            , result.averageIterationCount
+            , result.finalRMSResidual
+            , result.maxStrain
+            , (unsigned long long)result.trajectoryHash);
+        logDebug(buffer + result.name);
+    }
+
+    if (failedCount > 0)
+    {
+        logDebug("Parameter sweep: " + std::to_string(failedCount) + " configurations failed");
+        return false;
+    }
+    return true;
+}
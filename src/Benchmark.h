@@ -0,0 +1,341 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "XPBDSolver.h"
+#include "SolverPrecision.h"
+#include "ClothFrameCache.h"
+#include "ClothSceneLoader.h"
+
+class Cloth;
+
+// 创建布料的回调，返回已完成InitializeSimulation的布料，调用者负责删除
+typedef std::function<Cloth*()> ClothFactory;
+
+// 求解器调度配置
+struct SolverScheduleConfig
+{
+    std::string name;               // 配置名称
+    XPBDScheduleMode scheduleMode;  // 调度模式
+    uint32_t subIteratorCount;      // 子步数
+    uint32_t iteratorCount;         // 每个子步的迭代次数（SmallSteps模式下忽略）
+    bool chebyshevAcceleration;     // 是否启用Chebyshev加速（SmallSteps模式下忽略）
+    uint32_t multigridLevelCount;   // 粗网格层级数，0表示不使用多层级求解
+    ClothSolverType solverType;     // 求解器类型（Projective Dynamics忽略调度模式和粗网格）
+};
+
+// 单个调度配置的测试结果
+struct SolverScheduleResult
+{
+    SolverScheduleConfig config;
+    double millisecondsPerFrame;    // 每帧平均耗时（毫秒）
+    float meanStrain;               // 距离约束平均相对误差（所有帧的平均值）
+    float maxStrain;                // 距离约束最大相对误差（所有帧中的最大值）
+    float averageIterationCount;    // 每帧平均实际迭代次数（残差提前结束后的迭代总数）
+};
+
+// 轨迹对比结果
+struct TrajectoryComparison
+{
+    uint32_t frameCount;            // 对比的帧数
+    uint32_t particleCount;         // 粒子数
+    std::string referencePrecision; // 参考轨迹的求解器精度
+    float maxDeviation;             // 所有帧中粒子位置的最大偏差
+    float finalRMSDeviation;        // 最后一帧粒子位置的均方根偏差
+    int firstExceedingFrame;        // 第一个最大偏差超出容差的帧，-1表示全部在容差内
+};
+
+// 单类弯曲约束的求解开销
+struct BendingConstraintCost
+{
+    std::string name;               // 约束类型
+    uint32_t constraintCount;       // 约束数量
+    double nanosecondsPerConstraint;// 每个约束每次计算约束值和梯度的平均耗时（纳秒）
+    float meanConstraint;           // 变形状态下约束值|C|的平均值
+};
+
+// 单个粒子重排序方式的测试结果
+struct ParticleOrderingResult
+{
+    std::string name;               // 重排序方式
+    float meanConstraintSpan;       // 距离约束两端粒子索引之差的平均值
+    double l1MissesPerConstraint;   // 模拟的32KB 8路组相联缓存中，每个约束的平均缓存行缺失数
+    double l2MissesPerConstraint;   // 模拟的256KB 8路组相联缓存中，每个约束的平均缓存行缺失数
+    double millisecondsPerFrame;    // 每帧平均耗时（毫秒）
+};
+
+// 单个帧缓存格式的测试结果
+struct FrameCacheResult
+{
+    std::string name;               // 帧数据格式
+    uint32_t frameCount;            // 缓存的帧数（含第0帧的初始状态）
+    double megabytes;               // 文件大小（MB）
+    double bytesPerFrame;           // 每帧平均字节数（含对齐填充）
+    double bakeMillisecondsPerFrame;// 录制时每帧平均耗时（模拟+编码+写入，毫秒）
+    double sequentialMillisecondsPerFrame; // 顺序解码每帧的平均耗时（毫秒）
+    double randomMillisecondsPerFrame; // 随机顺序解码每帧的平均耗时（毫秒）
+    float maxPositionError;         // 抽样帧中解码位置与模拟结果的最大偏差
+    float maxNormalError;           // 抽样帧中解码法线与模拟结果的最大分量偏差
+};
+
+// 检查点保存和恢复的测试结果
+struct CheckpointResult
+{
+    uint32_t frameCount;            // 模拟的总帧数
+    uint32_t checkpointFrame;       // 保存检查点时已模拟的帧数
+    double kilobytes;               // 检查点文件大小（KB）
+    double captureMilliseconds;     // 模拟线程复制状态的耗时（毫秒）
+    double writeWaitMilliseconds;   // 模拟完剩余帧后仍需等待后台写入的耗时（毫秒）
+    double restoreMilliseconds;     // 读取文件并恢复状态的耗时（毫秒）
+    bool bitExact;                  // 恢复后继续模拟的结果是否与不中断时逐位一致
+    float maxPositionDeviation;     // 恢复后继续模拟的最终位置与不中断时的最大偏差
+};
+
+// 单个线程数下的确定性测试结果
+struct DeterminismResult
+{
+    uint32_t threadCount;           // 工作线程数（包含主线程）
+    uint64_t hash;                  // 模拟结束后所有粒子位置和速度的FNV-1a哈希
+    double millisecondsPerFrame;    // 每帧平均耗时（毫秒）
+};
+
+// 批量更新的测试结果
+struct BatchUpdateResult
+{
+    uint32_t clothCount;            // 布料数量
+    uint32_t particlesPerCloth;     // 每块布料的粒子数
+    bool batchUpdateSupported;      // 场景是否会批量更新这种布料（粒子数不超过批量更新的上限）
+    double serialMillisecondsPerFrame;  // 逐个更新所有布料每帧的平均耗时（毫秒）
+    double batchMillisecondsPerFrame;   // 批量更新所有布料每帧的平均耗时（毫秒）
+    bool bitExact;                  // 两种方式模拟后所有布料的粒子位置和速度是否逐位一致
+    float batchMeanStrain;          // 批量更新结束时所有布料距离约束的平均相对误差
+    bool packedSupported;           // 布料是否满足打包求解的条件（ClothBatchSolver::IsSupported）
+    double packedMillisecondsPerFrame;  // 打包求解所有布料每帧的平均耗时（毫秒）
+    float packedMeanStrain;         // 打包求解结束时所有布料距离约束的平均相对误差
+    bool packedFinite;              // 打包求解后所有粒子的位置是否都是有限值
+};
+
+// 回归测试场景
+struct RegressionScene
+{
+    std::string name;               // 场景名称，也是参考文件的文件名
+    ClothFactory createCloth;       // 创建场景布料的回调
+};
+
+// 单个场景的回归测试结果
+struct RegressionResult
+{
+    std::string name;               // 场景名称
+    bool recorded;                  // 本次录制了参考文件（要求更新），没有对比
+    bool goldenMissing;             // 参考文件不存在且没有要求更新，视为失败
+    bool trajectoryPassed;          // 轨迹是否在容差内
+    TrajectoryComparison trajectory;// 与参考轨迹的对比结果
+    ClothSolverPhaseTimes phaseTimes;           // 每帧各阶段的平均耗时（毫秒）
+    double frameMilliseconds;                   // 每帧的平均总耗时，包括法线计算（毫秒）
+    ClothSolverPhaseTimes baselinePhaseTimes;   // 参考文件中每帧各阶段的平均耗时
+    double baselineFrameMilliseconds;           // 参考文件中每帧的平均总耗时
+    std::vector<std::string> regressedPhases;   // 耗时超出阈值的阶段
+};
+
+// 参数扫描的一个配置
+struct ParameterSweepConfig
+{
+    std::string name;               // 配置名称，只用于日志
+    std::vector<std::string> values;// 每个扫描维度的取值
+    ClothFactory createCloth;       // 创建该配置布料的回调，在工作线程上调用
+};
+
+// 单个参数扫描配置的结果
+struct ParameterSweepResult
+{
+    std::string name;               // 配置名称
+    std::vector<std::string> values;// 每个扫描维度的取值
+    bool succeeded;                 // 是否成功创建布料并完成模拟
+    uint32_t particleCount;         // 粒子数
+    double millisecondsPerFrame;    // 单线程模拟每帧的平均耗时（毫秒）
+    float averageIterationCount;    // 每帧平均实际迭代次数
+    float finalRMSResidual;         // 最后一帧所有约束的均方根残差
+    float finalMaxResidual;         // 最后一帧所有约束的最大残差
+    float finalMeanStrain;          // 最后一帧距离约束的平均相对误差
+    float maxStrain;                // 所有帧中距离约束的最大相对误差（最大拉伸）
+    uint64_t trajectoryHash;        // 所有帧粒子位置的FNV-1a哈希，与线程数和配置的执行顺序无关
+};
+
+// 获取默认的对比配置：当前的迭代布局、Projective Dynamics以及若干小步长配置
+// 参数：
+//   iteratorCount - 当前布局的迭代次数
+//   subIteratorCount - 当前布局的子步数
+std::vector<SolverScheduleConfig> GetDefaultSolverScheduleConfigs(uint32_t iteratorCount, uint32_t subIteratorCount);
+
+// 对比不同调度配置的收敛性和耗时
+// 每个配置从相同的初始状态模拟frameCount帧，误差统计不计入耗时
+// 参数：
+//   createCloth - 创建布料的回调
+//   configs - 要对比的配置
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+std::vector<SolverScheduleResult> RunSolverScheduleBenchmark(const ClothFactory& createCloth,
+    const std::vector<SolverScheduleConfig>& configs, uint32_t frameCount, float deltaTime);
+
+// 将测试结果输出到日志，以第一个配置为基准给出相对耗时和误差
+void LogSolverScheduleResults(const std::vector<SolverScheduleResult>& results);
+
+// 对比二面角约束和等距弯曲约束单个约束的计算开销
+// 在平面静止状态下为布料的每对相邻三角形创建两类约束，模拟frameCount帧得到变形后的粒子位置，
+// 然后在同一组位置上反复计算约束值和梯度（与求解器一样按具体类型调用），只计时约束本身的计算
+// 参数：
+//   createCloth - 创建布料的回调
+//   frameCount - 计时前模拟的帧数
+//   deltaTime - 每帧时间步长
+std::vector<BendingConstraintCost> RunBendingConstraintBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime);
+
+// 将弯曲约束开销输出到日志，以第一类约束为基准给出相对耗时
+void LogBendingConstraintCosts(const std::vector<BendingConstraintCost>& costs);
+
+// 对比粒子重排序方式对访存局部性和耗时的影响
+// 依次用创建顺序、Morton和reverse Cuthill-McKee重排同一块布料，按求解器的方式对约束贪心着色，
+// 把按颜色遍历约束时访问的粒子缓存行送入LRU组相联缓存模型统计缺失数，再模拟frameCount帧计时
+// 参数：
+//   createCloth - 创建布料的回调
+//   frameCount - 计时模拟的帧数
+//   deltaTime - 每帧时间步长
+std::vector<ParticleOrderingResult> RunParticleOrderingBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime);
+
+// 将粒子重排序测试结果输出到日志，以创建顺序为基准给出相对缺失数和耗时
+void LogParticleOrderingResults(const std::vector<ParticleOrderingResult>& results);
+
+// 对比帧缓存格式的文件大小、录制和读取耗时以及精度
+// 每种格式录制frameCount帧到path加上格式名后缀的文件，然后映射文件分别按顺序和随机顺序解码所有帧，
+// 并与录制时抽样保存的模拟结果对比
+// 参数：
+//   createCloth - 创建布料的回调
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+//   path - 缓存文件路径
+std::vector<FrameCacheResult> RunFrameCacheBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime, const std::string& path);
+
+// 将帧缓存测试结果输出到日志，以第一种格式为基准给出相对大小
+void LogFrameCacheResults(const std::vector<FrameCacheResult>& results);
+
+// 测试检查点的保存、后台写入和恢复
+// 模拟frameCount帧，在中间一帧保存检查点并交给后台线程写入path，然后用新创建的布料读取检查点，
+// 模拟剩余的帧，与不中断的模拟逐位对比最终的粒子状态
+// 参数：
+//   createCloth - 创建布料的回调
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+//   path - 检查点文件路径
+CheckpointResult RunCheckpointBenchmark(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime, const std::string& path);
+
+// 将检查点测试结果输出到日志
+void LogCheckpointResult(const CheckpointResult& result);
+
+// 获取默认的确定性测试线程数：1、2、8和32
+std::vector<uint32_t> GetDefaultDeterminismThreadCounts();
+
+// 检查模拟结果与线程数无关
+// 依次用每个线程数重新初始化全局任务调度器，从相同的初始状态模拟frameCount帧并计算粒子状态的哈希，
+// 完成后恢复调度器原来的线程数
+// 参数：
+//   createCloth - 创建布料的回调
+//   threadCounts - 要测试的线程数
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+std::vector<DeterminismResult> RunDeterminismBenchmark(const ClothFactory& createCloth, const std::vector<uint32_t>& threadCounts,
+    uint32_t frameCount, float deltaTime);
+
+// 将确定性测试结果输出到日志
+// 参数：
+//   results - 测试结果
+//   goldenHash - 参考哈希（十六进制），为空表示只检查各线程数的结果是否一致
+// 返回：所有线程数的哈希是否一致且与参考哈希相同
+bool LogDeterminismResults(const std::vector<DeterminismResult>& results, const std::string& goldenHash);
+
+// 模拟frameCount帧并把每帧的粒子位置写入文件，作为轨迹对比的参考
+// 文件头记录粒子数、帧数、时间步长和求解器精度（SolverReal）
+// 参数：
+//   createCloth - 创建布料的回调
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+//   path - 输出文件路径
+// 返回：是否成功
+bool RecordTrajectory(const ClothFactory& createCloth, uint32_t frameCount, float deltaTime, const std::string& path);
+
+// 用相同的布料重新模拟参考文件中的帧数，逐帧对比粒子位置
+// 用于检查float和double精度构建（XPBD_SOLVER_DOUBLE）的轨迹是否一致，以及修改求解器后结果是否变化
+// 参数：
+//   createCloth - 创建布料的回调，参数必须与录制时一致
+//   path - 参考文件路径
+//   tolerance - 允许的最大位置偏差
+//   comparison - 输出对比结果
+// 返回：是否成功读取参考文件并完成对比（不表示在容差内）
+bool CompareTrajectory(const ClothFactory& createCloth, const std::string& path, float tolerance, TrajectoryComparison& comparison);
+
+// 将轨迹对比结果输出到日志
+// 返回：所有帧是否都在容差内
+bool LogTrajectoryComparison(const TrajectoryComparison& comparison, float tolerance);
+
+// 获取回归测试的场景：场景中的第一块布料，以及简化网格、只有二面角弯曲约束和关闭LRA约束三个变体
+// 每个场景的布料都与场景中的所有球体碰撞
+// 参数：
+//   scene - 场景描述，至少有一块布料
+std::vector<RegressionScene> GetRegressionScenes(const ClothSceneDescription& scene);
+
+// 运行回归测试：每个场景与参考目录中的轨迹逐帧对比，并与参考的各阶段耗时对比
+// 参考文件为<goldenDirectory>/<场景名>.traj（轨迹）和<场景名>.perf（各阶段耗时），只在updateGolden为true时录制，
+// 否则参考文件不存在的场景视为失败
+// 参数：
+//   scenes - 测试场景
+//   goldenDirectory - 参考文件目录，录制时不存在则创建
+//   frameCount - 录制的帧数和计时的帧数（对比使用参考文件中的帧数）
+//   deltaTime - 每帧时间步长
+//   tolerance - 轨迹允许的最大位置偏差
+//   perfThreshold - 允许的耗时增加比例，例如0.25表示比参考慢25%以上视为回退
+//   updateGolden - 是否重新录制所有参考文件
+std::vector<RegressionResult> RunRegressionBenchmark(const std::vector<RegressionScene>& scenes, const std::string& goldenDirectory,
+    uint32_t frameCount, float deltaTime, float tolerance, float perfThreshold, bool updateGolden);
+
+// 将回归测试结果输出到日志
+// 返回：0表示全部通过，1表示有场景的轨迹超出容差或无法完成测试，2表示轨迹全部通过但有性能回退
+int LogRegressionResults(const std::vector<RegressionResult>& results, float tolerance, float perfThreshold);
+
+// 参数扫描：每个配置的布料在一个工作线程上单线程模拟frameCount帧，不同配置分布到所有工作线程上并行运行
+// 配置内部的并行循环在SerialTaskScope中顺序执行，因此耗时是单线程耗时，结果与单独运行该配置逐位一致
+// 误差统计和哈希不计入耗时
+// 参数：
+//   configs - 要运行的配置
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+std::vector<ParameterSweepResult> RunParameterSweep(const std::vector<ParameterSweepConfig>& configs, uint32_t frameCount, float deltaTime);
+
+// 对比逐个更新、批量更新和打包求解大量小块布料的耗时
+// 创建clothCount块布料逐个调用Update模拟frameCount帧（场景原来的更新方式，每块布料内部并行），
+// 再创建同样的一组布料用Primitive::UpdateBatch模拟相同的帧数，对比耗时和最终的粒子状态；
+// 布料满足打包条件时再用ClothBatchSolver模拟相同的帧数，打包求解的迭代方式不同，只对比耗时和最终的平均拉伸
+// 参数：
+//   createCloth - 创建布料的回调
+//   clothCount - 布料数量
+//   frameCount - 模拟帧数
+//   deltaTime - 每帧时间步长
+BatchUpdateResult RunBatchUpdateBenchmark(const ClothFactory& createCloth, uint32_t clothCount, uint32_t frameCount, float deltaTime);
+
+// 将批量更新测试结果输出到日志
+void LogBatchUpdateResult(const BatchUpdateResult& result);
+
+// 将参数扫描结果写入CSV文件，每个扫描维度一列，之后是测量结果
+// 参数：
+//   axes - 扫描维度名称
+//   results - 扫描结果
+//   path - 输出文件路径
+// 返回：是否成功
+bool WriteParameterSweepCSV(const std::vector<std::string>& axes, const std::vector<ParameterSweepResult>& results, const std::string& path);
+
+// 将参数扫描结果输出到日志
+// 返回：是否所有配置都完成了模拟
+bool LogParameterSweepResults(const std::vector<ParameterSweepResult>& results);
+
+#endif // BENCHMARK_H
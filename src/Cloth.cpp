@@ -2,13 +2,157 @@
 #include <iostream>
 #include <DirectXMath.h>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <queue>
 #include "SphereCollisionConstraint.h"
+#include "ClothMeshLoader.h"
+#include "ClothCheckpoint.h"
+#include "ParticleReordering.h"
+#include "TaskScheduler.h"
+#include "ProjectiveDynamicsSolver.h"
 
 extern void logDebug(const std::string& message);
 
 // 为了方便使用，定义一个简化的命名空间别名
 namespace dx = DirectX;
 
+// 法线计算时每个任务处理的行数
+static const int kNormalRowBandSize = 16;
+
+// Mesh模式法线计算时每个任务处理的三角形数或顶点数
+static const uint32_t kMeshNormalGrainSize = 1024;
+
+// 批量更新的最大粒子数：更小的布料在求解器内部只能切出少数几个并行块，
+// 任务调度的开销和颜色之间的同步占主要部分，整块布料放在一个线程上更新更快
+static const size_t kBatchUpdateMaxParticleCount = 4096;
+
+// 每个格子的两个三角形对四个角的贡献，bit0为第一个三角形，bit1为第二个三角形
+// 角的编号：0=(w,h) 1=(w+1,h) 2=(w,h+1) 3=(w+1,h+1)
+// [0]：对角线为(w,h)-(w+1,h+1)的格子（完整结构的所有格子，简化结构中w+h为偶数的格子）
+// [1]：对角线为(w+1,h)-(w,h+1)的格子（简化结构中w+h为奇数的格子）
+static const uint8_t kCellCornerTriangleMask[2][4] =
+{
+    { 0x3, 0x1, 0x2, 0x3 },
+    { 0x1, 0x3, 0x3, 0x2 },
+};
+
+// 把约束引用的粒子指针从旧粒子数组映射到重排后的新粒子数组
+template<typename ConstraintT>
+static void RemapConstraintParticles(std::vector<ConstraintT>& constraints, const Particle* oldParticles, Particle* newParticles,
+    const std::vector<uint32_t>& newIndices)
+{
+    for (ConstraintT& constraint : constraints)
+    {
+        Particle** particles = constraint.GetParticles();
+        for (uint32_t i = 0; i < constraint.GetParticlesCount(); ++i)
+        {
+            particles[i] = &newParticles[newIndices[particles[i] - oldParticles]];
+        }
+    }
+}
+
+// 约束引用的最小粒子索引
+template<typename ConstraintT>
+static uint32_t GetMinParticleIndex(const ConstraintT& constraint, const Particle* particlesBegin)
+{
+    const Particle** particles = constraint.GetParticles();
+    const Particle* minParticle = particles[0];
+    for (uint32_t i = 1; i < constraint.GetParticlesCount(); ++i)
+    {
+        minParticle = (std::min)(minParticle, particles[i]);
+    }
+    return (uint32_t)(minParticle - particlesBegin);
+}
+
+// 按最小粒子索引稳定排序，着色保持同一颜色内的存储顺序，求解时每种颜色内基本顺序访问粒子数组
+template<typename ConstraintT>
+static void SortConstraintsByMinParticle(std::vector<ConstraintT>& constraints, const Particle* particlesBegin)
+{
+    std::stable_sort(constraints.begin(), constraints.end(), [particlesBegin](const ConstraintT& a, const ConstraintT& b)
+    {
+        return GetMinParticleIndex(a, particlesBegin) < GetMinParticleIndex(b, particlesBegin);
+    });
+}
+
+// 把约束涉及的每对粒子作为约束图的边
+template<typename ConstraintT>
+static void AppendConstraintEdges(const std::vector<ConstraintT>& constraints, const Particle* particlesBegin, std::vector<uint32_t>& edges)
+{
+    for (const ConstraintT& constraint : constraints)
+    {
+        const Particle** particles = constraint.GetParticles();
+        const uint32_t count = constraint.GetParticlesCount();
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            for (uint32_t j = i + 1; j < count; ++j)
+            {
+                edges.push_back((uint32_t)(particles[i] - particlesBegin));
+                edges.push_back((uint32_t)(particles[j] - particlesBegin));
+            }
+        }
+    }
+}
+
+// 一类约束的静止参数占用的字节数，同一类约束的参数个数相同
+template<typename ConstraintT>
+static uint64_t GetRestParameterBytes(const std::vector<ConstraintT>& constraints)
+{
+    if (constraints.empty())
+    {
+        return 0;
+    }
+
+    return (uint64_t)constraints.size() * constraints[0].GetRestParameterCount() * sizeof(float);
+}
+
+template<typename ConstraintT>
+static void AppendRestParameters(const std::vector<ConstraintT>& constraints, std::vector<char>& data)
+{
+    if (constraints.empty())
+    {
+        return;
+    }
+
+    std::vector<float> parameters(constraints[0].GetRestParameterCount());
+    for (const ConstraintT& constraint : constraints)
+    {
+        constraint.GetRestParameters(parameters.data());
+        ClothCheckpoint::Append(data, parameters.data(), parameters.size() * sizeof(float));
+    }
+}
+
+// 调用前已经检查过数据长度
+template<typename ConstraintT>
+static void ReadRestParameters(std::vector<ConstraintT>& constraints, const char* data, size_t size, size_t& position)
+{
+    if (constraints.empty())
+    {
+        return;
+    }
+
+    std::vector<float> parameters(constraints[0].GetRestParameterCount());
+    for (ConstraintT& constraint : constraints)
+    {
+        ClothCheckpoint::Read(data, size, position, parameters.data(), parameters.size() * sizeof(float));
+        constraint.SetRestParameters(parameters.data());
+    }
+}
+
+// 距离约束两端粒子索引之差的平均值，衡量求解时访问粒子数组的跨度
+static float ComputeMeanConstraintSpan(const std::vector<DistanceConstraint>& constraints)
+{
+    double spanSum = 0.0;
+    for (const DistanceConstraint& constraint : constraints)
+    {
+        const Particle** particles = constraint.GetParticles();
+        spanSum += std::abs((double)(particles[0] - particles[1]));
+    }
+    return constraints.empty() ? 0.0f : (float)(spanSum / constraints.size());
+}
+
 Cloth::Cloth(int widthResolution, int heightResolution, float size, float mass, 
     ClothParticleMassMode massMode, ClothMeshAndContraintMode meshAndContraintMode)
     : Mesh()
@@ -24,18 +168,48 @@ Cloth::Cloth(int widthResolution, int heightResolution, float size, float mass,
     , m_addBendingConstraints(true)
     , m_bendingConstraintCompliance(1e-5f)
     , m_bendingConstraintDamping(1e-3f)
-    , m_addDihedralBendingConstraints(false)
-    , m_dihedralBendingConstraintCompliance(1e-8f)
-    , m_dihedralBendingConstraintDamping(1e-2f)
     , m_addLRAConstraints(true)
     , m_LRAConstraintCompliance(1e-8f)
     , m_LRAConstraintDamping(1e-2f)
     , m_LRAMaxStrech(0.01f)
+    , m_addDihedralBendingConstraints(false)
+    , m_dihedralBendingConstraintCompliance(1e-8f)
+    , m_dihedralBendingConstraintDamping(1e-2f)
+    , m_addIsometricBendingConstraints(false)
+    , m_isometricBendingConstraintCompliance(1e-8f)
+    , m_isometricBendingConstraintDamping(1e-2f)
     , m_sphereCollisionConstraintCompliance(1e-9f)
     , m_sphereCollisionConstraintDamping(1e-2f)
+    , m_solverType(ClothSolverType::XPBD)
+    , m_solver(new XPBDSolver(this))
+    , m_pinnedParticlesSpecified(false)
+    , m_particleOrdering(ClothParticleOrdering::None)
+    , m_particlesReordered(false)
+    , m_frameCacheWriter(nullptr)
+    , m_frameCacheRecordingTime(0.0f)
+    , m_frameCacheReader(nullptr)
+    , m_frameCacheFrame(0)
+    , m_frameCachePlaybackTime(0.0f)
+    , m_frameCacheVertexData(nullptr)
     , m_iteratorCount(20)
     , m_subIteratorCount(1)
-    , m_solver(this)
+    , m_minIteratorCount(2)
+    , m_residualTolerance(1e-4f)
+    , m_residualStagnationRatio(0.01f)
+    , m_chebyshevAcceleration(false)
+    , m_chebyshevSpectralRadius(0.0f)
+    , m_overRelaxationFactor(1.0f)
+    , m_sleepEnabled(true)
+    , m_sleepVelocityThreshold(0.05f)
+    , m_sleepDisplacementThreshold(0.01f)
+    , m_sleepFrameCount(30)
+    , m_velocityDamping(0.0f)
+    , m_multigridLevelCount(0)
+    , m_multigridIterationCount(4)
+    , m_distanceSolveMode(XPBDDistanceSolveMode::Iterative)
+    , m_directSolveIterationCount(2)
+    , m_lambdaWarmStartFactor(0.0f)
+    , m_scheduleMode(XPBDScheduleMode::Iterative)
 {
     // 设置重力为标准地球重力
     m_gravity = dx::XMFLOAT3(0.0f, -9.8f, 0.0f);
@@ -45,6 +219,37 @@ Cloth::~Cloth()
 {
     // 清除球体碰撞约束
     ClearSphereCollisionConstraints();
+
+    // 结束录制时写入帧表
+    StopFrameCacheRecording();
+    delete m_frameCacheReader;
+
+    delete m_solver;
+}
+
+void Cloth::SetSolverType(ClothSolverType type)
+{
+    if (type == m_solverType)
+    {
+        return;
+    }
+
+    // 新的求解器不一定支持休眠，切换前唤醒所有粒子
+    m_solver->WakeAll();
+    delete m_solver;
+
+    switch (type)
+    {
+    case ClothSolverType::ProjectiveDynamics:
+        m_solver = new ProjectiveDynamicsSolver(this);
+        break;
+    case ClothSolverType::XPBD:
+    default:
+        m_solver = new XPBDSolver(this);
+        break;
+    }
+
+    m_solverType = type;
 }
 
 bool Cloth::Initialize(IRALDevice* device)
@@ -56,7 +261,29 @@ bool Cloth::Initialize(IRALDevice* device)
         return false;
     }
 
-    if (m_meshAndContraintMode == ClothMeshAndContraintMode::Full)
+    // 回放帧缓存时不创建粒子和约束
+    if (!m_frameCachePlaybackFile.empty())
+    {
+        return InitializeFrameCachePlayback();
+    }
+
+    return InitializeSimulation();
+}
+
+bool Cloth::InitializeSimulation()
+{
+    if (m_meshAndContraintMode == ClothMeshAndContraintMode::Mesh)
+    {
+        // 从三角网格文件创建粒子
+        if (!CreateMeshParticles())
+        {
+            return false;
+        }
+
+        // 按网格拓扑创建约束
+        CreateMeshConstraints();
+    }
+    else if (m_meshAndContraintMode == ClothMeshAndContraintMode::Full)
     {
         // 创建完整结构的布料的粒子
         CreateFullStructuredParticles();
@@ -73,12 +300,16 @@ bool Cloth::Initialize(IRALDevice* device)
         CreateSimplifiedStructuredConstraints();
     }
 
-    char buffer[128];
-    sprintf_s(buffer, "Particles:%d, DistanceConstraints:%d, LRAConstraints:%d, DihedralBendingConstraints:%d, CollisionConstraints:%d"
+    // 按设置重排粒子，None时保持创建顺序
+    ReorderParticles(m_particleOrdering);
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Particles:%d, DistanceConstraints:%d, LRAConstraints:%d, DihedralBendingConstraints:%d, IsometricBendingConstraints:%d, CollisionConstraints:%d"
         , (int)m_particles.size()
         , (int)m_distanceConstraints.size()
         , (int)m_lraConstraints.size()
         , (int)m_dihedralBendingConstraints.size()
+        , (int)m_isometricBendingConstraints.size()
         , (int)m_CollisionConstraints.size());
 
     logDebug(buffer);
@@ -88,30 +319,16 @@ bool Cloth::Initialize(IRALDevice* device)
 
 void Cloth::OnSetupMesh(IRALDevice* device, PrimitiveMesh& mesh)
 {
-    // 生成顶点数据（位置和法线）
-    std::vector<float> vertexData;
-    vertexData.reserve(m_particles.size() * 6);
-
-    for (size_t i = 0; i < m_particles.size(); ++i)
-    {
-        // 添加顶点位置
-        vertexData.push_back(m_particles[i].position.x);
-        vertexData.push_back(m_particles[i].position.y);
-        vertexData.push_back(m_particles[i].position.z);
-
-        // 添加顶点法线
-        vertexData.push_back(m_normals[i].x);
-        vertexData.push_back(m_normals[i].y);
-        vertexData.push_back(m_normals[i].z);
-    }
+    // 顶点数据（位置和法线）在ComputeNormals中已经打包好，回放时为当前帧的数据
+    const float* vertexData = IsPlayingFrameCache() ? m_frameCacheVertexData : m_vertexData.data();
 
     // 创建顶点缓冲区
-    size_t vertexBufferSize = vertexData.size() * sizeof(float);
+    size_t vertexBufferSize = IsPlayingFrameCache() ? (size_t)m_frameCacheReader->GetVertexCount() * 6 * sizeof(float) : m_vertexData.size() * sizeof(float);
     mesh.vertexBuffer = device->CreateVertexBuffer(
         vertexBufferSize,
         6 * sizeof(float),// 顶点 stride（3个位置分量 + 3个法线分量）
         true,
-        vertexData.data(),
+        vertexData,
         L"ClothVB"
     );
 
@@ -128,27 +345,19 @@ void Cloth::OnSetupMesh(IRALDevice* device, PrimitiveMesh& mesh)
 
 void Cloth::OnUpdateMesh(IRALDevice* device, PrimitiveMesh& mesh)
 {
-    // 生成顶点数据（位置和法线）
-    std::vector<float> vertexData;
-    vertexData.reserve(m_particles.size() * 6);
-
-    for (size_t i = 0; i < m_particles.size(); ++i)
+    if (IsPlayingFrameCache())
     {
-        // 添加顶点位置
-        vertexData.push_back(m_particles[i].position.x);
-        vertexData.push_back(m_particles[i].position.y);
-        vertexData.push_back(m_particles[i].position.z);
-
-        // 添加顶点法线
-        vertexData.push_back(m_normals[i].x);
-        vertexData.push_back(m_normals[i].y);
-        vertexData.push_back(m_normals[i].z);
+        // Float32格式的帧直接从映射内存上传，不经过解析和复制
+        size_t vertexBufferSize = (size_t)m_frameCacheReader->GetVertexCount() * 6 * sizeof(float);
+        device->UploadBuffer(mesh.vertexBuffer.Get(), (const char*)m_frameCacheVertexData, vertexBufferSize);
+        return;
     }
 
-    size_t vertexBufferSize = vertexData.size() * sizeof(float);
+    // 顶点数据（位置和法线）在Update中已经并行打包好，直接上传
+    size_t vertexBufferSize = m_vertexData.size() * sizeof(float);
 
     // 上传顶点数据
-    device->UploadBuffer(mesh.vertexBuffer.Get(), (const char*)vertexData.data(), vertexBufferSize);
+    device->UploadBuffer(mesh.vertexBuffer.Get(), (const char*)m_vertexData.data(), vertexBufferSize);
 }
 
 void Cloth::InitializeSphereCollisionConstraints(const dx::XMFLOAT3& sphereCenter, float sphereRadius)
@@ -161,51 +370,477 @@ void Cloth::InitializeSphereCollisionConstraints(const dx::XMFLOAT3& sphereCente
     {
         if (!particle.isStatic)
         {
-            SphereCollisionConstraint* constraint = new SphereCollisionConstraint(
+            m_CollisionConstraints.emplace_back(
                 &particle, 
                 relativeCenter, 
                 sphereRadius, 
                 m_sphereCollisionConstraintCompliance, 
                 m_sphereCollisionConstraintDamping);
-            m_CollisionConstraints.push_back(constraint);
         }
     }
+
+    // 新的碰撞体只影响与它相交的区域，只唤醒这些休眠岛屿
+    m_solver->WakeInSphere(relativeCenter, sphereRadius);
+    m_solver->InvalidateConstraints();
+}
+
+void Cloth::ComputeDistanceConstraintError(float& meanError, float& maxError) const
+{
+    double sum = 0.0;
+    meanError = 0.0f;
+    maxError = 0.0f;
+
+    for (const DistanceConstraint& constraint : m_distanceConstraints)
+    {
+        const Particle** particles = constraint.GetParticles();
+        dx::XMVECTOR diff = dx::XMVectorSubtract(dx::XMLoadFloat3(&particles[0]->position), dx::XMLoadFloat3(&particles[1]->position));
+        float distance = dx::XMVectorGetX(dx::XMVector3Length(diff));
+        float restLength = constraint.GetRestLength();
+
+        if (restLength > 0.0f)
+        {
+            float error = std::abs(distance - restLength) / restLength;
+            sum += error;
+            maxError = (std::max)(maxError, error);
+        }
+    }
+
+    if (!m_distanceConstraints.empty())
+    {
+        meanError = (float)(sum / m_distanceConstraints.size());
+    }
+}
+
+bool Cloth::IsBatchUpdateSupported() const
+{
+    return m_particles.size() <= kBatchUpdateMaxParticleCount;
 }
 
 void Cloth::Update(IRALGraphicsCommandList* commandList, float deltaTime)
 {
-    // 使用XPBD求解器更新布料状态
-    m_solver.Step(deltaTime);
-    
-    // 计算布料的法线数据
-    // 清空位置和法线向量
-    m_positions.clear();
-    m_normals.clear();
+    if (IsPlayingFrameCache())
+    {
+        // 按帧时间前进到不晚于回放时间的最后一帧，超过最后一帧时从头循环
+        const uint32_t frameCount = m_frameCacheReader->GetFrameCount();
+        const uint32_t previousFrame = m_frameCacheFrame;
+        m_frameCachePlaybackTime += deltaTime;
+        if (m_frameCachePlaybackTime > m_frameCacheReader->GetFrameTime(frameCount - 1))
+        {
+            m_frameCacheFrame = 0;
+            m_frameCachePlaybackTime = m_frameCacheReader->GetFrameTime(0);
+        }
+
+        while (m_frameCacheFrame + 1 < frameCount && m_frameCacheReader->GetFrameTime(m_frameCacheFrame + 1) <= m_frameCachePlaybackTime)
+        {
+            ++m_frameCacheFrame;
+        }
+
+        if (m_frameCacheFrame != previousFrame)
+        {
+            LoadFrameCacheFrame();
+        }
+        return;
+    }
+
+    // 使用当前求解器更新布料状态
+    m_solver->Step(deltaTime);
     
-    if (m_meshAndContraintMode == ClothMeshAndContraintMode::Full)
+    // 计算布料的法线数据，同时更新位置和顶点数据
+    ComputeNormals();
+
+    if (m_frameCacheWriter)
     {
-        ComputeFullStructuredNormals();
+        m_frameCacheRecordingTime += deltaTime;
+        if (!m_frameCacheWriter->WriteFrame(m_vertexData.data(), m_frameCacheRecordingTime))
+        {
+            StopFrameCacheRecording();
+        }
+    }
+}
+
+bool Cloth::StartFrameCacheRecording(const std::string& path, ClothFrameCacheFormat format)
+{
+    StopFrameCacheRecording();
+
+    if (m_vertexData.empty() || IsPlayingFrameCache())
+    {
+        logDebug("Cloth::StartFrameCacheRecording: cloth is not simulating");
+        return false;
+    }
+
+    m_frameCacheWriter = new ClothFrameCacheWriter();
+    m_frameCacheRecordingTime = 0.0f;
+
+    if (!m_frameCacheWriter->Open(path, format, (uint32_t)m_particles.size(), m_indices)
+        || !m_frameCacheWriter->WriteFrame(m_vertexData.data(), m_frameCacheRecordingTime))
+    {
+        delete m_frameCacheWriter;
+        m_frameCacheWriter = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void Cloth::StopFrameCacheRecording()
+{
+    if (m_frameCacheWriter)
+    {
+        m_frameCacheWriter->Close();
+        delete m_frameCacheWriter;
+        m_frameCacheWriter = nullptr;
+    }
+}
+
+bool Cloth::InitializeFrameCachePlayback()
+{
+    delete m_frameCacheReader;
+    m_frameCacheReader = new ClothFrameCacheReader();
+
+    if (!m_frameCacheReader->Open(m_frameCachePlaybackFile))
+    {
+        delete m_frameCacheReader;
+        m_frameCacheReader = nullptr;
+        return false;
+    }
+
+    // 索引只在创建索引缓冲区时使用一次，复制后GetIndices仍然有效
+    const uint32_t* indices = m_frameCacheReader->GetIndices();
+    m_indices.assign(indices, indices + m_frameCacheReader->GetIndexCount());
+
+    SeekFrameCache(m_frameCacheFrame);
+    return true;
+}
+
+void Cloth::SeekFrameCache(uint32_t frame)
+{
+    if (!IsPlayingFrameCache())
+    {
+        m_frameCacheFrame = frame;
+        return;
+    }
+
+    m_frameCacheFrame = (std::min)(frame, m_frameCacheReader->GetFrameCount() - 1);
+    m_frameCachePlaybackTime = m_frameCacheReader->GetFrameTime(m_frameCacheFrame);
+    LoadFrameCacheFrame();
+}
+
+void Cloth::LoadFrameCacheFrame()
+{
+    m_frameCacheVertexData = m_frameCacheReader->GetFrameVertexData(m_frameCacheFrame);
+    if (!m_frameCacheVertexData)
+    {
+        m_vertexData.resize((size_t)m_frameCacheReader->GetVertexCount() * 6);
+        m_frameCacheReader->DecodeFrame(m_frameCacheFrame, m_vertexData.data());
+        m_frameCacheVertexData = m_vertexData.data();
+    }
+}
+
+void Cloth::SaveCheckpoint(std::vector<char>& data) const
+{
+    ClothCheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kClothCheckpointMagic, sizeof(header.magic));
+    header.version = kClothCheckpointVersion;
+    header.particleSize = sizeof(Particle);
+    header.solverRealSize = sizeof(SolverReal);
+    header.solverType = (uint32_t)m_solverType;
+    header.particleCount = (uint32_t)m_particles.size();
+    header.constraintCounts[0] = (uint32_t)m_distanceConstraints.size();
+    header.constraintCounts[1] = (uint32_t)m_lraConstraints.size();
+    header.constraintCounts[2] = (uint32_t)m_dihedralBendingConstraints.size();
+    header.constraintCounts[3] = (uint32_t)m_isometricBendingConstraints.size();
+    header.constraintCounts[4] = (uint32_t)m_CollisionConstraints.size();
+
+    data.assign(sizeof(header), 0);
+    ClothCheckpoint::Append(data, m_particles.data(), m_particles.size() * sizeof(Particle));
+    AppendRestParameters(m_distanceConstraints, data);
+    AppendRestParameters(m_lraConstraints, data);
+    AppendRestParameters(m_dihedralBendingConstraints, data);
+    AppendRestParameters(m_isometricBendingConstraints, data);
+    AppendRestParameters(m_CollisionConstraints, data);
+
+    const size_t solverStateBegin = data.size();
+    m_solver->SaveState(data);
+
+    header.solverStateSize = data.size() - solverStateBegin;
+    header.payloadSize = data.size() - sizeof(header);
+    header.checksum = ClothCheckpoint::ComputeChecksum(data.data() + sizeof(header), (size_t)header.payloadSize);
+    memcpy(data.data(), &header, sizeof(header));
+}
+
+bool Cloth::LoadCheckpoint(const char* data, size_t size)
+{
+    if (IsPlayingFrameCache())
+    {
+        logDebug("Cloth::LoadCheckpoint: cloth is playing a frame cache");
+        return false;
+    }
+
+    ClothCheckpointHeader header;
+    if (size < sizeof(header))
+    {
+        logDebug("Cloth::LoadCheckpoint: checkpoint is truncated");
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, kClothCheckpointMagic, sizeof(header.magic)) != 0 || header.version != kClothCheckpointVersion)
+    {
+        logDebug("Cloth::LoadCheckpoint: not a checkpoint or unsupported version");
+        return false;
+    }
+
+    if (header.particleSize != sizeof(Particle) || header.solverRealSize != sizeof(SolverReal))
+    {
+        logDebug("Cloth::LoadCheckpoint: checkpoint was saved by a build with a different particle layout or solver precision");
+        return false;
+    }
+
+    if (header.payloadSize != size - sizeof(header)
+        || header.checksum != ClothCheckpoint::ComputeChecksum(data + sizeof(header), size - sizeof(header)))
+    {
+        logDebug("Cloth::LoadCheckpoint: checkpoint is truncated or corrupted");
+        return false;
+    }
+
+    // 检查拓扑：粒子和约束的数量必须与当前布料一致
+    const uint32_t constraintCounts[kClothCheckpointConstraintFamilyCount] =
+    {
+        (uint32_t)m_distanceConstraints.size(),
+        (uint32_t)m_lraConstraints.size(),
+        (uint32_t)m_dihedralBendingConstraints.size(),
+        (uint32_t)m_isometricBendingConstraints.size(),
+        (uint32_t)m_CollisionConstraints.size(),
+    };
+
+    bool topologyMatches = header.particleCount == m_particles.size();
+    for (uint32_t i = 0; i < kClothCheckpointConstraintFamilyCount; ++i)
+    {
+        topologyMatches = topologyMatches && header.constraintCounts[i] == constraintCounts[i];
+    }
+
+    if (!topologyMatches)
+    {
+        logDebug("Cloth::LoadCheckpoint: checkpoint was saved from a cloth with a different topology");
+        return false;
+    }
+
+    const uint64_t particleBytes = (uint64_t)m_particles.size() * sizeof(Particle);
+    const uint64_t restParameterBytes = GetRestParameterBytes(m_distanceConstraints)
+        + GetRestParameterBytes(m_lraConstraints)
+        + GetRestParameterBytes(m_dihedralBendingConstraints)
+        + GetRestParameterBytes(m_isometricBendingConstraints)
+        + GetRestParameterBytes(m_CollisionConstraints);
+
+    if (particleBytes + restParameterBytes + header.solverStateSize != header.payloadSize)
+    {
+        logDebug("Cloth::LoadCheckpoint: checkpoint layout does not match the cloth");
+        return false;
+    }
+
+    // 检查通过后才修改布料
+    size_t position = sizeof(header);
+    ClothCheckpoint::Read(data, size, position, m_particles.data(), (size_t)particleBytes);
+    ReadRestParameters(m_distanceConstraints, data, size, position);
+    ReadRestParameters(m_lraConstraints, data, size, position);
+    ReadRestParameters(m_dihedralBendingConstraints, data, size, position);
+    ReadRestParameters(m_isometricBendingConstraints, data, size, position);
+    ReadRestParameters(m_CollisionConstraints, data, size, position);
+
+    // 求解器不同或求解器状态无法恢复时只恢复粒子和约束，休眠状态和拉格朗日乘子从头开始
+    bool solverStateRestored = false;
+    if (header.solverType != (uint32_t)m_solverType)
+    {
+        logDebug("Cloth::LoadCheckpoint: checkpoint was saved with a different solver, solver state is not restored");
     }
     else
     {
-        ComputeSimplifiedStructuredNormals();
+        solverStateRestored = m_solver->LoadState(data + position, (size_t)header.solverStateSize);
     }
-   
-    for (size_t i = 0; i < m_particles.size(); ++i)
+
+    if (!solverStateRestored)
+    {
+        for (Particle& particle : m_particles)
+        {
+            particle.isSleeping = false;
+        }
+        m_solver->WakeAll();
+        m_solver->InvalidateConstraints();
+    }
+
+    ComputeNormals();
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "Cloth::LoadCheckpoint: restored %u particles, %.1f KB", header.particleCount, size / 1024.0);
+    logDebug(buffer);
+    return true;
+}
+
+void Cloth::ComputeNormals()
+{
+    if (!HasGridTopology())
     {
-        m_positions.push_back(m_particles[i].position);
+        ComputeMeshNormals();
+        return;
+    }
+
+    const size_t particleCount = m_particles.size();
+    const int cellRowCount = m_heightResolution - 1;
+
+    // 缓冲区只在粒子数变化时重新分配
+    m_faceNormals.resize((size_t)cellRowCount * (m_widthResolution - 1) * 2);
+    m_positions.resize(particleCount);
+    m_normals.resize(particleCount);
+    m_vertexData.resize(particleCount * 6);
+
+    // 按行分块：第b块先计算格子行[bB, bB+B)的面法线，再汇聚顶点行[bB, bB+B)的法线
+    // 顶点行bB还需要格子行bB-1，因此汇聚任务依赖本块和上一块的面法线任务
+    const int bandCount = (m_heightResolution + kNormalRowBandSize - 1) / kNormalRowBandSize;
+
+    TaskGraph graph;
+    std::vector<TaskGraph::TaskId> faceTasks(bandCount);
+
+    for (int band = 0; band < bandCount; ++band)
+    {
+        int rowBegin = band * kNormalRowBandSize;
+        int cellRowEnd = (std::min)(rowBegin + kNormalRowBandSize, cellRowCount);
+
+        faceTasks[band] = graph.AddTask([this, rowBegin, cellRowEnd]()
+        {
+            ComputeFaceNormals(rowBegin, cellRowEnd);
+        });
+    }
+
+    for (int band = 0; band < bandCount; ++band)
+    {
+        int rowBegin = band * kNormalRowBandSize;
+        int vertexRowEnd = (std::min)(rowBegin + kNormalRowBandSize, m_heightResolution);
+
+        TaskGraph::TaskId gatherTask = graph.AddTask([this, rowBegin, vertexRowEnd]()
+        {
+            GatherVertexNormals(rowBegin, vertexRowEnd);
+        });
+
+        graph.AddDependency(faceTasks[band], gatherTask);
+        if (band > 0)
+        {
+            graph.AddDependency(faceTasks[band - 1], gatherTask);
+        }
+    }
+
+    graph.Execute(TaskScheduler::Get());
+}
+
+void Cloth::ComputeFaceNormals(int rowBegin, int rowEnd)
+{
+    const int width = m_widthResolution;
+    const bool simplified = (m_meshAndContraintMode == ClothMeshAndContraintMode::Simplified);
+
+    for (int h = rowBegin; h < rowEnd; ++h)
+    {
+        const Particle* row0 = &m_particles[(size_t)h * width];
+        const Particle* row1 = &m_particles[(size_t)(h + 1) * width];
+        dx::XMFLOAT4A* faceNormals = &m_faceNormals[(size_t)h * (width - 1) * 2];
+
+        // 沿行滑动，格子右侧的两个顶点作为下一个格子左侧的顶点复用
+        dx::XMVECTOR p00 = dx::XMLoadFloat3(&row0[0].position);
+        dx::XMVECTOR p01 = dx::XMLoadFloat3(&row1[0].position);
+
+        for (int w = 0; w < width - 1; ++w)
+        {
+            dx::XMVECTOR p10 = dx::XMLoadFloat3(&row0[w + 1].position);
+            dx::XMVECTOR p11 = dx::XMLoadFloat3(&row1[w + 1].position);
+            dx::XMVECTOR n1, n2;
+
+            if (!simplified || ((w + h) & 1) == 0)
+            {
+                // 第一个三角形：(w,h), (w+1,h+1), (w+1,h)
+                n1 = dx::XMVector3Normalize(dx::XMVector3Cross(dx::XMVectorSubtract(p11, p00), dx::XMVectorSubtract(p10, p00)));
+
+                // 第二个三角形：(w,h), (w,h+1), (w+1,h+1)
+                n2 = dx::XMVector3Normalize(dx::XMVector3Cross(dx::XMVectorSubtract(p01, p00), dx::XMVectorSubtract(p11, p00)));
+            }
+            else
+            {
+                // 第一个三角形：(w,h), (w,h+1), (w+1,h)
+                n1 = dx::XMVector3Normalize(dx::XMVector3Cross(dx::XMVectorSubtract(p01, p00), dx::XMVectorSubtract(p10, p00)));
+
+                // 第二个三角形：(w+1,h), (w,h+1), (w+1,h+1)
+                n2 = dx::XMVector3Normalize(dx::XMVector3Cross(dx::XMVectorSubtract(p01, p10), dx::XMVectorSubtract(p11, p10)));
+            }
+
+            dx::XMStoreFloat4A(&faceNormals[w * 2], n1);
+            dx::XMStoreFloat4A(&faceNormals[w * 2 + 1], n2);
+
+            p00 = p10;
+            p01 = p11;
+        }
+    }
+}
+
+void Cloth::GatherVertexNormals(int rowBegin, int rowEnd)
+{
+    const int width = m_widthResolution;
+    const int cellsPerRow = width - 1;
+    const int cellRowCount = m_heightResolution - 1;
+    const bool simplified = (m_meshAndContraintMode == ClothMeshAndContraintMode::Simplified);
+    const dx::XMVECTOR defaultNormal = dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+    for (int h = rowBegin; h < rowEnd; ++h)
+    {
+        for (int w = 0; w < width; ++w)
+        {
+            // 顶点(w,h)依次是右下、左下、右上、左上四个格子的角0、1、2、3
+            dx::XMVECTOR sum = dx::XMVectorZero();
+
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                int cellW = w - (corner & 1);
+                int cellH = h - (corner >> 1);
+
+                if (cellW < 0 || cellW >= cellsPerRow || cellH < 0 || cellH >= cellRowCount)
+                {
+                    continue;
+                }
+
+                uint8_t mask = kCellCornerTriangleMask[simplified ? ((cellW + cellH) & 1) : 0][corner];
+                const dx::XMFLOAT4A* cellNormals = &m_faceNormals[((size_t)cellH * cellsPerRow + cellW) * 2];
+
+                if (mask & 1)
+                {
+                    sum = dx::XMVectorAdd(sum, dx::XMLoadFloat4A(&cellNormals[0]));
+                }
+                if (mask & 2)
+                {
+                    sum = dx::XMVectorAdd(sum, dx::XMLoadFloat4A(&cellNormals[1]));
+                }
+            }
+
+            // 归一化顶点法线，如果顶点法线接近零，使用向上的默认法线
+            float lengthSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(sum));
+            dx::XMVECTOR normal = (lengthSquared > 0.0001f) ? dx::XMVector3Normalize(sum) : defaultNormal;
+
+            // 直接写入输出和交错的顶点数据
+            size_t index = (size_t)h * width + w;
+            const dx::XMFLOAT3& position = m_particles[index].position;
+
+            dx::XMStoreFloat3(&m_normals[index], normal);
+            m_positions[index] = position;
+
+            float* vertex = &m_vertexData[index * 6];
+            vertex[0] = position.x;
+            vertex[1] = position.y;
+            vertex[2] = position.z;
+            dx::XMStoreFloat3(reinterpret_cast<dx::XMFLOAT3*>(vertex + 3), normal);
+        }
     }
 }
 
 void Cloth::ClearSphereCollisionConstraints()
 {
-    // 释放球体碰撞约束的内存
-    for (auto constraint : m_CollisionConstraints)
-    {
-        delete constraint;
-    }
-
     m_CollisionConstraints.clear();
+    m_solver->InvalidateConstraints();
 }
 
 void Cloth::CreateParticles()
@@ -220,7 +855,21 @@ void Cloth::CreateParticles()
     dx::XMVECTOR posVector = dx::XMLoadFloat3(&origin);
 
     int totalParticles = m_widthResolution * m_heightResolution;
-    int totalNonStaticParticles = totalParticles - 2; // 减去两个静态粒子
+
+    // 未指定固定粒子时固定左上角和右上角
+    if (!m_pinnedParticlesSpecified)
+    {
+        m_pinnedParticles = { 0, (uint32_t)(m_widthResolution - 1) };
+    }
+    ValidatePinnedParticles((uint32_t)totalParticles);
+
+    std::vector<bool> pinned(totalParticles, false);
+    for (uint32_t index : m_pinnedParticles)
+    {
+        pinned[index] = true;
+    }
+
+    int totalNonStaticParticles = totalParticles - (int)m_pinnedParticles.size(); // 减去静态粒子
 
     float mass = m_mass;
 
@@ -239,8 +888,8 @@ void Cloth::CreateParticles()
             dx::XMFLOAT3 posFloat3;
             dx::XMStoreFloat3(&posFloat3, pos);
 
-            // 左上角和右上角的粒子设为静态
-            bool isStatic = (w == 0 && h == 0) || (w == m_widthResolution - 1 && h == 0);
+            // 固定粒子设为静态
+            bool isStatic = pinned[h * m_widthResolution + w];
 
             // 创建粒子
             m_particles.emplace_back(posFloat3, mass, isStatic);
@@ -259,7 +908,7 @@ void Cloth::AddDistanceConstraint(const DistanceConstraint& constraint)
 #ifdef DEBUG_SOLVER
     const Particle** particles = constraint.GetParticles();
     char buffer[128];
-    sprintf_s(buffer, "[DEBUG] P1_w:%d, P1_h:%d P2_w:%d, P2_h:%d"
+    snprintf(buffer, sizeof(buffer), "[DEBUG] P1_w:%d, P1_h:%d P2_w:%d, P2_h:%d"
         , particles[0]->coordW
         , particles[0]->coordH
         , particles[1]->coordW
@@ -268,6 +917,7 @@ void Cloth::AddDistanceConstraint(const DistanceConstraint& constraint)
 #endif//DEBUG_SOLVER
 
     m_distanceConstraints.push_back(constraint);
+    m_solver->InvalidateConstraints();
 }
 
 void Cloth::AddLRAConstraint(const LRAConstraint& constraint)
@@ -275,13 +925,14 @@ void Cloth::AddLRAConstraint(const LRAConstraint& constraint)
 #ifdef DEBUG_SOLVER
     const Particle** particles = constraint.GetParticles();
     char buffer[128];
-    sprintf_s(buffer, "[DEBUG] P1_w:%d, P1_h:%d"
+    snprintf(buffer, sizeof(buffer), "[DEBUG] P1_w:%d, P1_h:%d"
         , particles[0]->coordW
         , particles[0]->coordH);
     logDebug(buffer);
 #endif//DEBUG_SOLVER
 
     m_lraConstraints.push_back(constraint);
+    m_solver->InvalidateConstraints();
 }
 
 void Cloth::AddDihedralBendingConstraint(const DihedralBendingConstraint& constraint)
@@ -289,7 +940,7 @@ void Cloth::AddDihedralBendingConstraint(const DihedralBendingConstraint& constr
 #ifdef DEBUG_SOLVER
     const Particle** particles = constraint.GetParticles();
     char buffer[256];
-    sprintf_s(buffer, "[DEBUG] P1_w:%d, P1_h:%d P2_w:%d, P2_h:%d P3_w:%d, P3_h:%d P4_w:%d, P4_h:%d"
+    snprintf(buffer, sizeof(buffer), "[DEBUG] P1_w:%d, P1_h:%d P2_w:%d, P2_h:%d P3_w:%d, P3_h:%d P4_w:%d, P4_h:%d"
         , particles[0]->coordW
         , particles[0]->coordH
         , particles[1]->coordW
@@ -303,6 +954,60 @@ void Cloth::AddDihedralBendingConstraint(const DihedralBendingConstraint& constr
 #endif//DEBUG_SOLVER
 
     m_dihedralBendingConstraints.push_back(constraint);
+    m_solver->InvalidateConstraints();
+}
+
+void Cloth::AddIsometricBendingConstraint(const IsometricBendingConstraint& constraint)
+{
+    m_isometricBendingConstraints.push_back(constraint);
+    m_solver->InvalidateConstraints();
+}
+
+void Cloth::AddBendingConstraints(int p1, int p2, int p3, int p4)
+{
+    if (m_addDihedralBendingConstraints)
+    {
+        AddDihedralBendingConstraint(DihedralBendingConstraint(
+            &m_particles[p1], // 公共顶点1
+            &m_particles[p2], // 公共顶点2
+            &m_particles[p3], // 三角形1的第三个顶点
+            &m_particles[p4], // 三角形2的第三个顶点
+            m_dihedralBendingConstraintCompliance,
+            m_dihedralBendingConstraintDamping));
+    }
+
+    if (m_addIsometricBendingConstraints)
+    {
+        AddIsometricBendingConstraint(IsometricBendingConstraint(
+            &m_particles[p1], // 公共顶点1
+            &m_particles[p2], // 公共顶点2
+            &m_particles[p3], // 三角形1的第三个顶点
+            &m_particles[p4], // 三角形2的第三个顶点
+            m_isometricBendingConstraintCompliance,
+            m_isometricBendingConstraintDamping));
+    }
+}
+
+void Cloth::ValidatePinnedParticles(uint32_t particleCount)
+{
+    std::vector<uint32_t> pinnedParticles;
+    pinnedParticles.reserve(m_pinnedParticles.size());
+
+    for (uint32_t index : m_pinnedParticles)
+    {
+        if (index >= particleCount)
+        {
+            logDebug("Cloth: pinned particle " + std::to_string(index) + " is out of range, ignored");
+            continue;
+        }
+
+        if (std::find(pinnedParticles.begin(), pinnedParticles.end(), index) == pinnedParticles.end())
+        {
+            pinnedParticles.push_back(index);
+        }
+    }
+
+    m_pinnedParticles.swap(pinnedParticles);
 }
 
 void Cloth::CreateFullStructuredParticles()
@@ -336,7 +1041,7 @@ void Cloth::CreateFullStructuredParticles()
         }
     }
 
-    ComputeFullStructuredNormals();
+    ComputeNormals();
 }
 
 void Cloth::CreateFullStructuredConstraints()
@@ -460,45 +1165,30 @@ void Cloth::CreateFullStructuredConstraints()
 #endif//DEBUG_SOLVER
 
         // 为除静止粒子外的所有粒子添加LRA约束
-        // 获取两个静止粒子的位置
-        int leftTopIndex = 0; // 左上角静止粒子索引
-        int rightTopIndex = m_widthResolution - 1; // 右上角静止粒子索引
-
-        // 为每个非静止粒子添加到两个静止粒子的LRA约束
+        // 为每个非静止粒子添加到每个固定粒子（默认为左上角和右上角）的LRA约束
         for (int i = 0; i < m_particles.size(); ++i)
         {
             // 跳过静止粒子
-            if (i == leftTopIndex || i == rightTopIndex || m_particles[i].isStatic)
+            if (m_particles[i].isStatic)
                 continue;
 
-            // 计算到左上角静止粒子的欧几里德距离作为测地线距离
             dx::XMVECTOR pos = dx::XMLoadFloat3(&m_particles[i].position);
-            dx::XMVECTOR leftTopPos = dx::XMLoadFloat3(&m_particles[leftTopIndex].position);
-            dx::XMVECTOR diff = dx::XMVectorSubtract(pos, leftTopPos);
-            float distanceToLeftTop = dx::XMVectorGetX(dx::XMVector3Length(diff));
-
-            // 添加到左上角静止粒子的LRA约束
-            AddLRAConstraint(LRAConstraint(
-                &m_particles[i], 
-                m_particles[leftTopIndex].position, 
-                distanceToLeftTop, 
-                m_LRAConstraintCompliance, 
-                m_LRAConstraintDamping, 
-                m_LRAMaxStrech));
-
-            // 计算到右上角静止粒子的欧几里德距离作为测地线距离
-            dx::XMVECTOR rightTopPos = dx::XMLoadFloat3(&m_particles[rightTopIndex].position);
-            diff = dx::XMVectorSubtract(pos, rightTopPos);
-            float distanceToRightTop = dx::XMVectorGetX(dx::XMVector3Length(diff));
-
-            // 添加到右上角静止粒子的LRA约束
-            AddLRAConstraint(LRAConstraint(
-                &m_particles[i], 
-                m_particles[rightTopIndex].position, 
-                distanceToRightTop, 
-                m_LRAConstraintCompliance, 
-                m_LRAConstraintDamping, 
-                m_LRAMaxStrech));
+            for (uint32_t pinnedIndex : m_pinnedParticles)
+            {
+                // 平面布料上的欧几里德距离即为测地线距离
+                dx::XMVECTOR pinnedPos = dx::XMLoadFloat3(&m_particles[pinnedIndex].position);
+                dx::XMVECTOR diff = dx::XMVectorSubtract(pos, pinnedPos);
+                float distanceToPinned = dx::XMVectorGetX(dx::XMVector3Length(diff));
+
+                // 添加到固定粒子的LRA约束
+                AddLRAConstraint(LRAConstraint(
+                    &m_particles[i], 
+                    m_particles[pinnedIndex].position, 
+                    distanceToPinned, 
+                    m_LRAConstraintCompliance, 
+                    m_LRAConstraintDamping, 
+                    m_LRAMaxStrech));
+            }
         }
 
 #ifdef DEBUG_SOLVER
@@ -506,14 +1196,14 @@ void Cloth::CreateFullStructuredConstraints()
 #endif//DEBUG_SOLVER
     }
 
-    // 如果启用了二面角约束，则添加它们
-    if (m_addDihedralBendingConstraints)
+    // 如果启用了二面角约束或等距弯曲约束，则添加它们
+    if (m_addDihedralBendingConstraints || m_addIsometricBendingConstraints)
     {
 #ifdef DEBUG_SOLVER
-        logDebug("[DEBUG] Begin adding dihedral bending constraints");
+        logDebug("[DEBUG] Begin adding bending constraints");
 #endif//DEBUG_SOLVER
         
-        // 遍历布料，为每对相邻的三角形创建二面角约束
+        // 遍历布料，为每对相邻的三角形创建弯曲约束
         for (int h = 0; h < m_heightResolution - 1; ++h)
         {
             for (int w = 0; w < m_widthResolution - 1; ++w)
@@ -529,13 +1219,7 @@ void Cloth::CreateFullStructuredConstraints()
                 // 第二个三角形的第三个顶点 (w,h+1)
                 p4 = (h + 1) * m_widthResolution + (w);
 
-                AddDihedralBendingConstraint(DihedralBendingConstraint(
-                    &m_particles[p1], // 公共顶点1
-                    &m_particles[p2], // 公共顶点2
-                    &m_particles[p3], // 三角形1的第三个顶点
-                    &m_particles[p4], // 三角形2的第三个顶点
-                    m_dihedralBendingConstraintCompliance,
-                    m_dihedralBendingConstraintDamping));
+                AddBendingConstraints(p1, p2, p3, p4);
 
                 if (w + 2 < m_widthResolution)
                 {
@@ -548,13 +1232,7 @@ void Cloth::CreateFullStructuredConstraints()
                     // 第二个三角形的第三个顶点 (w+2,h+1)
                     p4 = (h + 1) * m_widthResolution + (w + 2);
 
-                    AddDihedralBendingConstraint(DihedralBendingConstraint(
-                        &m_particles[p1], // 公共顶点1
-                        &m_particles[p2], // 公共顶点2
-                        &m_particles[p3], // 三角形1的第三个顶点
-                        &m_particles[p4], // 三角形2的第三个顶点
-                        m_dihedralBendingConstraintCompliance,
-                        m_dihedralBendingConstraintDamping));
+                    AddBendingConstraints(p1, p2, p3, p4);
                 }
                 
                 if (h + 2 < m_heightResolution)
@@ -568,107 +1246,17 @@ void Cloth::CreateFullStructuredConstraints()
                     // 第二个三角形的第三个顶点 (w+1,h+2)
                     p4 = (h + 2) * m_widthResolution + (w + 1);
 
-                    AddDihedralBendingConstraint(DihedralBendingConstraint(
-                        &m_particles[p1], // 公共顶点1
-                        &m_particles[p2], // 公共顶点2
-                        &m_particles[p3], // 三角形1的第三个顶点
-                        &m_particles[p4], // 三角形2的第三个顶点
-                        m_dihedralBendingConstraintCompliance,
-                        m_dihedralBendingConstraintDamping));
+                    AddBendingConstraints(p1, p2, p3, p4);
                 }
             }
         }
 
 #ifdef DEBUG_SOLVER
-        logDebug("[DEBUG] End adding dihedral bending constraints");
+        logDebug("[DEBUG] End adding bending constraints");
 #endif//DEBUG_SOLVER
     }
 }
 
-void Cloth::ComputeFullStructuredNormals()
-{
-    // 计算法线（使用面法线的平均值）
-    std::vector<dx::XMFLOAT3> vertexNormals(m_particles.size(), dx::XMFLOAT3(0.0f, 0.0f, 0.0f));
-
-    // 计算顶点法线-按格子
-    for (int h = 0; h < m_heightResolution - 1; ++h)
-    {
-        for (int w = 0; w < m_widthResolution - 1; ++w)
-        {
-            // 第一个三角形：(w,h), (w+1,h+1), (w+1,h)
-            int i1 = (h) * m_widthResolution + (w);
-            int i2 = (h + 1) * m_widthResolution + (w + 1);
-            int i3 = (h) * m_widthResolution + (w + 1);
-
-            // 计算面法线
-            dx::XMVECTOR v1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i2].position), 
-                dx::XMLoadFloat3(&m_particles[i1].position));
-            dx::XMVECTOR v2 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i3].position), 
-                dx::XMLoadFloat3(&m_particles[i1].position));
-            dx::XMVECTOR crossProduct = dx::XMVector3Cross(v1, v2);
-
-            dx::XMVECTOR normal = dx::XMVector3Normalize(crossProduct);
-
-            // 累加到顶点法线
-            dx::XMVECTOR n1 = dx::XMLoadFloat3(&vertexNormals[i1]);
-            dx::XMVECTOR n2 = dx::XMLoadFloat3(&vertexNormals[i2]);
-            dx::XMVECTOR n3 = dx::XMLoadFloat3(&vertexNormals[i3]);
-
-            dx::XMStoreFloat3(&vertexNormals[i1], dx::XMVectorAdd(n1, normal));
-            dx::XMStoreFloat3(&vertexNormals[i2], dx::XMVectorAdd(n2, normal));
-            dx::XMStoreFloat3(&vertexNormals[i3], dx::XMVectorAdd(n3, normal));
-
-            // 第二个三角形：(w,h), (w,h+1), (w+1,h+1)
-            i1 = (h) * m_widthResolution + (w);
-            i2 = (h + 1) * m_widthResolution + (w);
-            i3 = (h + 1) * m_widthResolution + (w + 1);
-
-            // 计算面法线
-            v1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i2].position), 
-                dx::XMLoadFloat3(&m_particles[i1].position));
-            v2 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i3].position), 
-                dx::XMLoadFloat3(&m_particles[i1].position));
-            crossProduct = dx::XMVector3Cross(v1, v2);
-
-            normal = dx::XMVector3Normalize(crossProduct);
-
-            // 累加到顶点法线
-            n1 = dx::XMLoadFloat3(&vertexNormals[i1]);
-            n2 = dx::XMLoadFloat3(&vertexNormals[i2]);
-            n3 = dx::XMLoadFloat3(&vertexNormals[i3]);
-
-            dx::XMStoreFloat3(&vertexNormals[i1], dx::XMVectorAdd(n1, normal));
-            dx::XMStoreFloat3(&vertexNormals[i2], dx::XMVectorAdd(n2, normal));
-            dx::XMStoreFloat3(&vertexNormals[i3], dx::XMVectorAdd(n3, normal));
-        }
-    }
-
-    m_normals.clear();
-    m_normals.reserve(m_particles.size());
-
-    // 归一化顶点法线并准备位置和法线数据
-    for (size_t i = 0; i < m_particles.size(); ++i)
-    {
-        // 归一化顶点法线，添加检查避免对零向量进行归一化
-        dx::XMVECTOR n = dx::XMLoadFloat3(&vertexNormals[i]);
-        float lengthSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(n));
-        dx::XMFLOAT3 normalizedNormal;
-
-        if (lengthSquared > 0.0001f)
-        {
-            n = dx::XMVector3Normalize(n);
-            dx::XMStoreFloat3(&normalizedNormal, n);
-        }
-        else
-        {
-            // 如果顶点法线接近零，使用默认法线
-            normalizedNormal = dx::XMFLOAT3(0.0f, 1.0f, 0.0f); // 向上的法线
-        }
-
-        m_normals.push_back(normalizedNormal);
-    }
-}
-
 void Cloth::CreateSimplifiedStructuredParticles()
 {
     CreateParticles();
@@ -723,7 +1311,7 @@ void Cloth::CreateSimplifiedStructuredParticles()
         }
     }
 
-    ComputeSimplifiedStructuredNormals();
+    ComputeNormals();
 }
 
 void Cloth::CreateSimplifiedStructuredConstraints()
@@ -851,45 +1439,30 @@ void Cloth::CreateSimplifiedStructuredConstraints()
 #endif//DEBUG_SOLVER
 
         // 为除静止粒子外的所有粒子添加LRA约束
-        // 获取两个静止粒子的位置
-        int leftTopIndex = 0; // 左上角静止粒子索引
-        int rightTopIndex = m_widthResolution - 1; // 右上角静止粒子索引
-
-        // 为每个非静止粒子添加到两个静止粒子的LRA约束
+        // 为每个非静止粒子添加到每个固定粒子（默认为左上角和右上角）的LRA约束
         for (int i = 0; i < m_particles.size(); ++i)
         {
             // 跳过静止粒子
-            if (i == leftTopIndex || i == rightTopIndex || m_particles[i].isStatic)
+            if (m_particles[i].isStatic)
                 continue;
 
-            // 计算到左上角静止粒子的欧几里德距离作为测地线距离
             dx::XMVECTOR pos = dx::XMLoadFloat3(&m_particles[i].position);
-            dx::XMVECTOR leftTopPos = dx::XMLoadFloat3(&m_particles[leftTopIndex].position);
-            dx::XMVECTOR diff = dx::XMVectorSubtract(pos, leftTopPos);
-            float distanceToLeftTop = dx::XMVectorGetX(dx::XMVector3Length(diff));
-
-            // 添加到左上角静止粒子的LRA约束
-            AddLRAConstraint(LRAConstraint(
-                &m_particles[i], 
-                m_particles[leftTopIndex].position, 
-                distanceToLeftTop, 
-                m_LRAConstraintCompliance, 
-                m_LRAConstraintDamping, 
-                m_LRAMaxStrech));
-
-            // 计算到右上角静止粒子的欧几里德距离作为测地线距离
-            dx::XMVECTOR rightTopPos = dx::XMLoadFloat3(&m_particles[rightTopIndex].position);
-            diff = dx::XMVectorSubtract(pos, rightTopPos);
-            float distanceToRightTop = dx::XMVectorGetX(dx::XMVector3Length(diff));
-
-            // 添加到右上角静止粒子的LRA约束
-            AddLRAConstraint(LRAConstraint(
-                &m_particles[i], 
-                m_particles[rightTopIndex].position, 
-                distanceToRightTop, 
-                m_LRAConstraintCompliance, 
-                m_LRAConstraintDamping, 
-                m_LRAMaxStrech));
+            for (uint32_t pinnedIndex : m_pinnedParticles)
+            {
+                // 平面布料上的欧几里德距离即为测地线距离
+                dx::XMVECTOR pinnedPos = dx::XMLoadFloat3(&m_particles[pinnedIndex].position);
+                dx::XMVECTOR diff = dx::XMVectorSubtract(pos, pinnedPos);
+                float distanceToPinned = dx::XMVectorGetX(dx::XMVector3Length(diff));
+
+                // 添加到固定粒子的LRA约束
+                AddLRAConstraint(LRAConstraint(
+                    &m_particles[i], 
+                    m_particles[pinnedIndex].position, 
+                    distanceToPinned, 
+                    m_LRAConstraintCompliance, 
+                    m_LRAConstraintDamping, 
+                    m_LRAMaxStrech));
+            }
         }
 
 #ifdef DEBUG_SOLVER
@@ -897,14 +1470,14 @@ void Cloth::CreateSimplifiedStructuredConstraints()
 #endif//DEBUG_SOLVER
     }
 
-    // 如果启用了二面角约束，则添加它们
-    if (m_addDihedralBendingConstraints)
+    // 如果启用了二面角约束或等距弯曲约束，则添加它们
+    if (m_addDihedralBendingConstraints || m_addIsometricBendingConstraints)
     {
 #ifdef DEBUG_SOLVER
-        logDebug("[DEBUG] Begin adding dihedral bending constraints");
+        logDebug("[DEBUG] Begin adding bending constraints");
 #endif//DEBUG_SOLVER
 
-        // 遍历布料，为每对相邻的三角形创建二面角约束
+        // 遍历布料，为每对相邻的三角形创建弯曲约束
         for (int h = 0; h < m_heightResolution - 1; ++h)
         {
             for (int w = 0; w < m_widthResolution - 1; ++w)
@@ -922,13 +1495,7 @@ void Cloth::CreateSimplifiedStructuredConstraints()
                     // 第二个三角形的第三个顶点 (w,h+1)
                     p4 = (h + 1) * m_widthResolution + (w);
 
-                    AddDihedralBendingConstraint(DihedralBendingConstraint(
-                        &m_particles[p1], // 公共顶点1
-                        &m_particles[p2], // 公共顶点2
-                        &m_particles[p3], // 三角形1的第三个顶点
-                        &m_particles[p4], // 三角形2的第三个顶点
-                        m_dihedralBendingConstraintCompliance,
-                        m_dihedralBendingConstraintDamping));
+                    AddBendingConstraints(p1, p2, p3, p4);
 
                     if (w + 2 < m_widthResolution)
                     {
@@ -941,13 +1508,7 @@ void Cloth::CreateSimplifiedStructuredConstraints()
                         // 第二个三角形的第三个顶点 (w+2,h)
                         p4 = (h) * m_widthResolution + (w + 2);
 
-                        AddDihedralBendingConstraint(DihedralBendingConstraint(
-                            &m_particles[p1], // 公共顶点1
-                            &m_particles[p2], // 公共顶点2
-                            &m_particles[p3], // 三角形1的第三个顶点
-                            &m_particles[p4], // 三角形2的第三个顶点
-                            m_dihedralBendingConstraintCompliance,
-                            m_dihedralBendingConstraintDamping));
+                        AddBendingConstraints(p1, p2, p3, p4);
                     }
 
                     if (h + 2 < m_heightResolution)
@@ -961,13 +1522,7 @@ void Cloth::CreateSimplifiedStructuredConstraints()
                         // 第二个三角形的第三个顶点 (w,h+2)
                         p4 = (h + 2) * m_widthResolution + (w);
 
-                        AddDihedralBendingConstraint(DihedralBendingConstraint(
-                            &m_particles[p1], // 公共顶点1
-                            &m_particles[p2], // 公共顶点2
-                            &m_particles[p3], // 三角形1的第三个顶点
-                            &m_particles[p4], // 三角形2的第三个顶点
-                            m_dihedralBendingConstraintCompliance,
-                            m_dihedralBendingConstraintDamping));
+                        AddBendingConstraints(p1, p2, p3, p4);
                     }
                 }
                 else
@@ -992,13 +1547,7 @@ void Cloth::CreateSimplifiedStructuredConstraints()
                         // 第二个三角形的第三个顶点 (w+2,h+1)
                         p4 = (h + 1) * m_widthResolution + (w + 2);
 
-                        AddDihedralBendingConstraint(DihedralBendingConstraint(
-                            &m_particles[p1], // 公共顶点1
-                            &m_particles[p2], // 公共顶点2
-                            &m_particles[p3], // 三角形1的第三个顶点
-                            &m_particles[p4], // 三角形2的第三个顶点
-                            m_dihedralBendingConstraintCompliance,
-                            m_dihedralBendingConstraintDamping));
+                        AddBendingConstraints(p1, p2, p3, p4);
                     }
 
                     if (h + 2 < m_heightResolution)
@@ -1012,157 +1561,459 @@ void Cloth::CreateSimplifiedStructuredConstraints()
                         // 第二个三角形的第三个顶点 (w+1,h+2)
                         p4 = (h + 2) * m_widthResolution + (w + 1);
 
-                        AddDihedralBendingConstraint(DihedralBendingConstraint(
-                            &m_particles[p1], // 公共顶点1
-                            &m_particles[p2], // 公共顶点2
-                            &m_particles[p3], // 三角形1的第三个顶点
-                            &m_particles[p4], // 三角形2的第三个顶点
-                            m_dihedralBendingConstraintCompliance,
-                            m_dihedralBendingConstraintDamping));
+                        AddBendingConstraints(p1, p2, p3, p4);
                     }
                 }
             }
         }
 
 #ifdef DEBUG_SOLVER
-        logDebug("[DEBUG] End adding dihedral bending constraints");
+        logDebug("[DEBUG] End adding bending constraints");
 #endif//DEBUG_SOLVER
     }
 }
 
-void Cloth::ComputeSimplifiedStructuredNormals()
+void Cloth::GetParticleLayoutCoordinates(std::vector<dx::XMFLOAT2>& coordinates) const
 {
-    // 计算法线（使用面法线的平均值）
-    std::vector<dx::XMFLOAT3> vertexNormals(m_particles.size(), dx::XMFLOAT3(0.0f, 0.0f, 0.0f));
+    const size_t particleCount = m_particles.size();
+    coordinates.resize(particleCount);
 
-    // 计算顶点法线
-    for (int h = 0; h < m_heightResolution - 1; ++h)
+    if (!HasGridTopology() && m_particleLayoutCoordinates.size() == particleCount)
     {
-        for (int w = 0; w < m_widthResolution - 1; ++w)
+        coordinates = m_particleLayoutCoordinates;
+        return;
+    }
+
+    const int width = (std::max)(m_widthResolution, 1);
+    for (size_t i = 0; i < particleCount; ++i)
+    {
+        coordinates[i].x = (float)(i % width);
+        coordinates[i].y = (float)(i / width);
+    }
+}
+
+bool Cloth::CreateMeshParticles()
+{
+    ClothMeshData mesh;
+    if (!ClothMeshLoader::Load(m_meshFile, mesh))
+    {
+        logDebug("Cloth::CreateMeshParticles: failed to load mesh " + m_meshFile);
+        return false;
+    }
+
+    const uint32_t vertexCount = (uint32_t)mesh.positions.size();
+
+    // 1. 按包围盒把网格缩放到m_size大小并把最小角平移到原点，与规则网格布料的摆放方式一致
+    dx::XMVECTOR boundsMin = dx::XMLoadFloat3(&mesh.positions[0]);
+    dx::XMVECTOR boundsMax = boundsMin;
+    for (const dx::XMFLOAT3& position : mesh.positions)
+    {
+        dx::XMVECTOR p = dx::XMLoadFloat3(&position);
+        boundsMin = dx::XMVectorMin(boundsMin, p);
+        boundsMax = dx::XMVectorMax(boundsMax, p);
+    }
+
+    dx::XMFLOAT3 extent;
+    dx::XMStoreFloat3(&extent, dx::XMVectorSubtract(boundsMax, boundsMin));
+    float maxExtent = (std::max)(extent.x, (std::max)(extent.y, extent.z));
+    float scale = maxExtent > 0.0f ? m_size / maxExtent : 1.0f;
+
+    for (dx::XMFLOAT3& position : mesh.positions)
+    {
+        dx::XMStoreFloat3(&position, dx::XMVectorScale(dx::XMVectorSubtract(dx::XMLoadFloat3(&position), boundsMin), scale));
+    }
+    extent = dx::XMFLOAT3(extent.x * scale, extent.y * scale, extent.z * scale);
+
+    // 2. 保持文件中的顶点顺序，需要时由ReorderParticles在约束创建之后统一重排
+    const std::vector<dx::XMFLOAT3>& positions = mesh.positions;
+    m_indices.swap(mesh.indices);
+    m_meshTopology.Build(vertexCount, m_indices);
+
+    // 3. 固定粒子：未指定时为离包围盒顶面前方两个角(0, maxY, 0)和(maxX, maxY, 0)最近的顶点
+    //    平放在XZ平面上的网格即为左上角和右上角，与规则网格布料一致
+    if (!m_pinnedParticlesSpecified)
+    {
+        const dx::XMFLOAT3 pinCorners[2] = { dx::XMFLOAT3(0.0f, extent.y, 0.0f), dx::XMFLOAT3(extent.x, extent.y, 0.0f) };
+        m_pinnedParticles.clear();
+
+        for (const dx::XMFLOAT3& corner : pinCorners)
         {
-            int i1, i2, i3;
+            uint32_t nearest = 0;
+            float nearestDistance = FLT_MAX;
+            dx::XMVECTOR c = dx::XMLoadFloat3(&corner);
 
-            if ((w + h) % 2 == 0)
+            for (uint32_t v = 0; v < vertexCount; ++v)
             {
-                // 第一个三角形：(w,h), (w+1,h+1), (w+1,h)
-                i1 = (h) * m_widthResolution + (w);
-                i2 = (h + 1) * m_widthResolution + (w + 1);
-                i3 = (h) * m_widthResolution + (w + 1);
+                float distance = dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMVectorSubtract(dx::XMLoadFloat3(&positions[v]), c)));
+                if (distance < nearestDistance)
+                {
+                    nearestDistance = distance;
+                    nearest = v;
+                }
+            }
+
+            if (std::find(m_pinnedParticles.begin(), m_pinnedParticles.end(), nearest) == m_pinnedParticles.end())
+            {
+                m_pinnedParticles.push_back(nearest);
+            }
+        }
+    }
+    ValidatePinnedParticles(vertexCount);
+
+    // 4. 质量：固定总质量时按顶点相邻三角形面积的1/3分配，三角形大小不均匀时质量分布仍与面积一致
+    std::vector<float> masses(vertexCount, m_mass);
 
-                // 计算面法线
-                dx::XMVECTOR v1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i2].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                dx::XMVECTOR v2 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i3].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                dx::XMVECTOR crossProduct = dx::XMVector3Cross(v1, v2);
+    if (m_massMode == ClothParticleMassMode::FixedTotalMass)
+    {
+        std::vector<double> areas(vertexCount, 0.0);
+        double totalArea = 0.0;
+
+        for (size_t t = 0; t + 2 < m_indices.size(); t += 3)
+        {
+            dx::XMVECTOR p0 = dx::XMLoadFloat3(&positions[m_indices[t]]);
+            dx::XMVECTOR p1 = dx::XMLoadFloat3(&positions[m_indices[t + 1]]);
+            dx::XMVECTOR p2 = dx::XMLoadFloat3(&positions[m_indices[t + 2]]);
+            double area = 0.5 * dx::XMVectorGetX(dx::XMVector3Length(dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0))));
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                areas[m_indices[t + k]] += area / 3.0;
+            }
+            totalArea += area;
+        }
 
-                dx::XMVECTOR normal = dx::XMVector3Normalize(crossProduct);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            masses[v] = (totalArea > 0.0 && areas[v] > 0.0) ? (float)(m_mass * areas[v] / totalArea) : m_mass / vertexCount;
+        }
+    }
 
-                // 累加到顶点法线
-                dx::XMVECTOR n1 = dx::XMLoadFloat3(&vertexNormals[i1]);
-                dx::XMVECTOR n2 = dx::XMLoadFloat3(&vertexNormals[i2]);
-                dx::XMVECTOR n3 = dx::XMLoadFloat3(&vertexNormals[i3]);
+    // 5. 粒子
+    m_particles.clear();
+    m_particles.reserve(vertexCount);
 
-                dx::XMStoreFloat3(&vertexNormals[i1], dx::XMVectorAdd(n1, normal));
-                dx::XMStoreFloat3(&vertexNormals[i2], dx::XMVectorAdd(n2, normal));
-                dx::XMStoreFloat3(&vertexNormals[i3], dx::XMVectorAdd(n3, normal));
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        bool isStatic = std::find(m_pinnedParticles.begin(), m_pinnedParticles.end(), v) != m_pinnedParticles.end();
+        m_particles.emplace_back(positions[v], masses[v], isStatic);
 
-                // 第二个三角形：(w,h), (w,h+1), (w+1,h+1)
-                i1 = (h) * m_widthResolution + (w);
-                i2 = (h + 1) * m_widthResolution + (w);
-                i3 = (h + 1) * m_widthResolution + (w + 1);
+#ifdef DEBUG_SOLVER
+        Particle& particle = m_particles.back();
+        particle.coordW = (int)v;
+        particle.coordH = 0;
+#endif//DEBUG_SOLVER
+    }
+
+    // 6. 布局坐标：静止位置在包围盒最长的两个方向上的投影
+    const float extents[3] = { extent.x, extent.y, extent.z };
+    int axes[3] = { 0, 1, 2 };
+    std::sort(axes, axes + 3, [&extents](int a, int b) { return extents[a] > extents[b]; });
+
+    m_particleLayoutCoordinates.resize(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        const float* position = &positions[v].x;
+        m_particleLayoutCoordinates[v] = dx::XMFLOAT2(position[axes[0]], position[axes[1]]);
+    }
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Cloth mesh %s: %u vertices, %u triangles, %u edges, %u non-manifold edges, %u pinned"
+        , m_meshFile.c_str()
+        , vertexCount
+        , (uint32_t)(m_indices.size() / 3)
+        , (uint32_t)m_meshTopology.GetEdges().size()
+        , m_meshTopology.GetNonManifoldEdgeCount()
+        , (uint32_t)m_pinnedParticles.size());
+    logDebug(buffer);
+
+    ComputeNormals();
 
-                // 计算面法线
-                v1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i2].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                v2 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i3].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                crossProduct = dx::XMVector3Cross(v1, v2);
+    return true;
+}
 
-                normal = dx::XMVector3Normalize(crossProduct);
+void Cloth::CreateMeshConstraints()
+{
+    const std::vector<ClothMeshEdge>& edges = m_meshTopology.GetEdges();
 
-                // 累加到顶点法线
-                n1 = dx::XMLoadFloat3(&vertexNormals[i1]);
-                n2 = dx::XMLoadFloat3(&vertexNormals[i2]);
-                n3 = dx::XMLoadFloat3(&vertexNormals[i3]);
+    // 每条边一个距离约束（三角网格的边已经包含了规则网格中的对角线约束）
+    for (const ClothMeshEdge& edge : edges)
+    {
+        AddDistanceConstraint(DistanceConstraint(
+            &m_particles[edge.vertices[0]],
+            &m_particles[edge.vertices[1]],
+            m_distanceConstraintCompliance,
+            m_distanceConstraintDamping));
+    }
 
-                dx::XMStoreFloat3(&vertexNormals[i1], dx::XMVectorAdd(n1, normal));
-                dx::XMStoreFloat3(&vertexNormals[i2], dx::XMVectorAdd(n2, normal));
-                dx::XMStoreFloat3(&vertexNormals[i3], dx::XMVectorAdd(n3, normal));
+    // 弯曲约束：内部边两侧三角形的相对顶点之间的距离约束
+    if (m_addBendingConstraints)
+    {
+        for (const ClothMeshEdge& edge : edges)
+        {
+            if (edge.triangleCount != 2)
+            {
+                continue;
             }
-            else
+
+            AddDistanceConstraint(DistanceConstraint(
+                &m_particles[edge.opposites[0]],
+                &m_particles[edge.opposites[1]],
+                m_bendingConstraintCompliance,
+                m_bendingConstraintDamping));
+        }
+    }
+
+    // 二面角约束和等距弯曲约束：每条内部边的两个相邻三角形
+    if (m_addDihedralBendingConstraints || m_addIsometricBendingConstraints)
+    {
+        for (const ClothMeshEdge& edge : edges)
+        {
+            if (edge.triangleCount != 2)
             {
-                // 第一个三角形：(w,h), (w,h+1), (w+1,h)
-                i1 = (h) * m_widthResolution + (w);
-                i2 = (h + 1) * m_widthResolution + (w);
-                i3 = (h) * m_widthResolution + (w + 1);
+                continue;
+            }
 
-                // 计算面法线
-                dx::XMVECTOR v1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i2].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                dx::XMVECTOR v2 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i3].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                dx::XMVECTOR crossProduct = dx::XMVector3Cross(v1, v2);
+            AddBendingConstraints(edge.vertices[0], edge.vertices[1], edge.opposites[0], edge.opposites[1]);
+        }
+    }
 
-                dx::XMVECTOR normal = dx::XMVector3Normalize(crossProduct);
+    // LRA约束：测地线距离取沿网格边的最短路径长度（Dijkstra），弯曲的网格上欧几里德距离会偏短
+    if (m_addLRAConstraints && !m_pinnedParticles.empty())
+    {
+        const std::vector<uint32_t>& neighborOffsets = m_meshTopology.GetVertexNeighborOffsets();
+        const std::vector<uint32_t>& neighbors = m_meshTopology.GetVertexNeighbors();
+        const uint32_t particleCount = (uint32_t)m_particles.size();
 
-                // 累加到顶点法线
-                dx::XMVECTOR n1 = dx::XMLoadFloat3(&vertexNormals[i1]);
-                dx::XMVECTOR n2 = dx::XMLoadFloat3(&vertexNormals[i2]);
-                dx::XMVECTOR n3 = dx::XMLoadFloat3(&vertexNormals[i3]);
+        std::vector<std::vector<float>> geodesicDistances(m_pinnedParticles.size());
 
-                dx::XMStoreFloat3(&vertexNormals[i1], dx::XMVectorAdd(n1, normal));
-                dx::XMStoreFloat3(&vertexNormals[i2], dx::XMVectorAdd(n2, normal));
-                dx::XMStoreFloat3(&vertexNormals[i3], dx::XMVectorAdd(n3, normal));
+        for (size_t p = 0; p < m_pinnedParticles.size(); ++p)
+        {
+            std::vector<float>& distances = geodesicDistances[p];
+            distances.assign(particleCount, FLT_MAX);
 
-                // 第二个三角形：(w+1,h), (w,h+1), (w+1,h+1)
-                i1 = (h) * m_widthResolution + (w + 1);
-                i2 = (h + 1) * m_widthResolution + (w);
-                i3 = (h + 1) * m_widthResolution + (w + 1);
+            typedef std::pair<float, uint32_t> QueueEntry;
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+            distances[m_pinnedParticles[p]] = 0.0f;
+            queue.push(QueueEntry(0.0f, m_pinnedParticles[p]));
+
+            while (!queue.empty())
+            {
+                QueueEntry entry = queue.top();
+                queue.pop();
+
+                uint32_t vertex = entry.second;
+                if (entry.first > distances[vertex])
+                {
+                    continue;
+                }
+
+                dx::XMVECTOR position = dx::XMLoadFloat3(&m_particles[vertex].position);
+
+                for (uint32_t k = neighborOffsets[vertex]; k < neighborOffsets[vertex + 1]; ++k)
+                {
+                    uint32_t neighbor = neighbors[k];
+                    float length = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[neighbor].position), position)));
+                    float distance = entry.first + length;
 
-                // 计算面法线
-                v1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i2].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                v2 = dx::XMVectorSubtract(dx::XMLoadFloat3(&m_particles[i3].position), 
-                    dx::XMLoadFloat3(&m_particles[i1].position));
-                crossProduct = dx::XMVector3Cross(v1, v2);
+                    if (distance < distances[neighbor])
+                    {
+                        distances[neighbor] = distance;
+                        queue.push(QueueEntry(distance, neighbor));
+                    }
+                }
+            }
+        }
 
-                normal = dx::XMVector3Normalize(crossProduct);
+        for (uint32_t i = 0; i < particleCount; ++i)
+        {
+            if (m_particles[i].isStatic)
+            {
+                continue;
+            }
 
-                // 累加到顶点法线
-                n1 = dx::XMLoadFloat3(&vertexNormals[i1]);
-                n2 = dx::XMLoadFloat3(&vertexNormals[i2]);
-                n3 = dx::XMLoadFloat3(&vertexNormals[i3]);
+            for (size_t p = 0; p < m_pinnedParticles.size(); ++p)
+            {
+                // 与固定粒子不连通的粒子不受该固定粒子约束
+                if (geodesicDistances[p][i] == FLT_MAX)
+                {
+                    continue;
+                }
 
-                dx::XMStoreFloat3(&vertexNormals[i1], dx::XMVectorAdd(n1, normal));
-                dx::XMStoreFloat3(&vertexNormals[i2], dx::XMVectorAdd(n2, normal));
-                dx::XMStoreFloat3(&vertexNormals[i3], dx::XMVectorAdd(n3, normal));
+                AddLRAConstraint(LRAConstraint(
+                    &m_particles[i],
+                    m_particles[m_pinnedParticles[p]].position,
+                    geodesicDistances[p][i],
+                    m_LRAConstraintCompliance,
+                    m_LRAConstraintDamping,
+                    m_LRAMaxStrech));
             }
         }
     }
+}
+
+void Cloth::ComputeMeshNormals()
+{
+    const uint32_t particleCount = (uint32_t)m_particles.size();
+    const uint32_t triangleCount = (uint32_t)(m_indices.size() / 3);
 
-    m_normals.clear();
-    m_normals.reserve(m_particles.size());
+    m_faceNormals.resize(triangleCount);
+    m_positions.resize(particleCount);
+    m_normals.resize(particleCount);
+    m_vertexData.resize((size_t)particleCount * 6);
 
-    // 归一化顶点法线并准备位置和法线数据
-    for (size_t i = 0; i < m_particles.size(); ++i)
+    TaskScheduler& scheduler = TaskScheduler::Get();
+
+    // 1. 面法线
+    scheduler.ParallelFor(0, triangleCount, kMeshNormalGrainSize, [this](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            const uint32_t* triangle = &m_indices[(size_t)t * 3];
+            dx::XMVECTOR p0 = dx::XMLoadFloat3(&m_particles[triangle[0]].position);
+            dx::XMVECTOR p1 = dx::XMLoadFloat3(&m_particles[triangle[1]].position);
+            dx::XMVECTOR p2 = dx::XMLoadFloat3(&m_particles[triangle[2]].position);
+
+            dx::XMVECTOR normal = dx::XMVector3Normalize(dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0)));
+            dx::XMStoreFloat4A(&m_faceNormals[t], normal);
+        }
+    });
+
+    // 2. 顶点法线：汇聚相邻三角形的面法线，同时写入位置和交错的顶点数据
+    const std::vector<uint32_t>& triangleOffsets = m_meshTopology.GetVertexTriangleOffsets();
+    const std::vector<uint32_t>& triangles = m_meshTopology.GetVertexTriangles();
+
+    scheduler.ParallelFor(0, particleCount, kMeshNormalGrainSize, [this, &triangleOffsets, &triangles](uint32_t begin, uint32_t end)
     {
-        // 归一化顶点法线，添加检查避免对零向量进行归一化
-        dx::XMVECTOR n = dx::XMLoadFloat3(&vertexNormals[i]);
-        float lengthSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(n));
-        dx::XMFLOAT3 normalizedNormal;
+        const dx::XMVECTOR defaultNormal = dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
 
-        if (lengthSquared > 0.0001f)
+        for (uint32_t v = begin; v < end; ++v)
         {
-            n = dx::XMVector3Normalize(n);
-            dx::XMStoreFloat3(&normalizedNormal, n);
+            dx::XMVECTOR sum = dx::XMVectorZero();
+            for (uint32_t k = triangleOffsets[v]; k < triangleOffsets[v + 1]; ++k)
+            {
+                sum = dx::XMVectorAdd(sum, dx::XMLoadFloat4A(&m_faceNormals[triangles[k]]));
+            }
+
+            // 归一化顶点法线，如果顶点法线接近零，使用向上的默认法线
+            float lengthSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(sum));
+            dx::XMVECTOR normal = (lengthSquared > 0.0001f) ? dx::XMVector3Normalize(sum) : defaultNormal;
+
+            const dx::XMFLOAT3& position = m_particles[v].position;
+
+            dx::XMStoreFloat3(&m_normals[v], normal);
+            m_positions[v] = position;
+
+            float* vertex = &m_vertexData[(size_t)v * 6];
+            vertex[0] = position.x;
+            vertex[1] = position.y;
+            vertex[2] = position.z;
+            dx::XMStoreFloat3(reinterpret_cast<dx::XMFLOAT3*>(vertex + 3), normal);
         }
-        else
+    });
+}
+
+void Cloth::ReorderParticles(ClothParticleOrdering ordering)
+{
+    const uint32_t particleCount = (uint32_t)m_particles.size();
+    if (ordering == ClothParticleOrdering::None || particleCount == 0)
+    {
+        return;
+    }
+
+    const float spanBefore = ComputeMeanConstraintSpan(m_distanceConstraints);
+
+    // 1. 计算新顺序
+    std::vector<uint32_t> order;
+
+    if (ordering == ClothParticleOrdering::Morton)
+    {
+        std::vector<dx::XMFLOAT3> positions(particleCount);
+        for (uint32_t i = 0; i < particleCount; ++i)
         {
-            // 如果顶点法线接近零，使用默认法线
-            normalizedNormal = dx::XMFLOAT3(0.0f, 1.0f, 0.0f); // 向上的法线
+            positions[i] = m_particles[i].position;
         }
 
-        m_normals.push_back(normalizedNormal);
+        ParticleReordering::ComputeMortonOrder(positions, order);
+    }
+    else
+    {
+        // 约束图：距离约束和弯曲约束连接的粒子对，LRA约束和碰撞约束只涉及一个粒子
+        const Particle* particlesBegin = m_particles.data();
+        std::vector<uint32_t> edges;
+        AppendConstraintEdges(m_distanceConstraints, particlesBegin, edges);
+        AppendConstraintEdges(m_dihedralBendingConstraints, particlesBegin, edges);
+        AppendConstraintEdges(m_isometricBendingConstraints, particlesBegin, edges);
+
+        std::vector<uint32_t> adjacencyOffsets;
+        std::vector<uint32_t> adjacency;
+        ParticleReordering::BuildAdjacency(particleCount, edges, adjacencyOffsets, adjacency);
+        ParticleReordering::ComputeReverseCuthillMcKeeOrder(particleCount, adjacencyOffsets, adjacency, order);
+    }
+
+    std::vector<uint32_t> newIndices(particleCount);
+    for (uint32_t k = 0; k < particleCount; ++k)
+    {
+        newIndices[order[k]] = k;
+    }
+
+    // 2. 布局坐标按原顺序取得（规则网格为网格坐标）后随粒子一起重排
+    std::vector<dx::XMFLOAT2> coordinates;
+    GetParticleLayoutCoordinates(coordinates);
+
+    m_particleLayoutCoordinates.resize(particleCount);
+    for (uint32_t k = 0; k < particleCount; ++k)
+    {
+        m_particleLayoutCoordinates[k] = coordinates[order[k]];
+    }
+
+    // 3. 粒子和所有约束的粒子指针
+    std::vector<Particle> particles;
+    particles.reserve(particleCount);
+    for (uint32_t k = 0; k < particleCount; ++k)
+    {
+        particles.push_back(m_particles[order[k]]);
+    }
+
+    const Particle* oldParticles = m_particles.data();
+    RemapConstraintParticles(m_distanceConstraints, oldParticles, particles.data(), newIndices);
+    RemapConstraintParticles(m_lraConstraints, oldParticles, particles.data(), newIndices);
+    RemapConstraintParticles(m_dihedralBendingConstraints, oldParticles, particles.data(), newIndices);
+    RemapConstraintParticles(m_isometricBendingConstraints, oldParticles, particles.data(), newIndices);
+    RemapConstraintParticles(m_CollisionConstraints, oldParticles, particles.data(), newIndices);
+    m_particles.swap(particles);
+
+    const Particle* particlesBegin = m_particles.data();
+    SortConstraintsByMinParticle(m_distanceConstraints, particlesBegin);
+    SortConstraintsByMinParticle(m_lraConstraints, particlesBegin);
+    SortConstraintsByMinParticle(m_dihedralBendingConstraints, particlesBegin);
+    SortConstraintsByMinParticle(m_isometricBendingConstraints, particlesBegin);
+    SortConstraintsByMinParticle(m_CollisionConstraints, particlesBegin);
+
+    // 4. 三角形索引和固定粒子索引
+    for (uint32_t& index : m_indices)
+    {
+        index = newIndices[index];
+    }
+
+    for (uint32_t& pinned : m_pinnedParticles)
+    {
+        pinned = newIndices[pinned];
     }
-}
\ No newline at end of file
+
+    // 重排后不再按规则网格排列，法线改为按三角形拓扑计算
+    m_particlesReordered = true;
+    m_meshTopology.Build(particleCount, m_indices);
+
+    m_solver->WakeAll();
+    m_solver->InvalidateConstraints();
+
+    ComputeNormals();
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Particles reordered by %s: mean distance constraint index span %.1f -> %.1f"
+        , ordering == ClothParticleOrdering::Morton ? "Morton" : "ReverseCuthillMcKee"
+        , spanBefore
+        , ComputeMeanConstraintSpan(m_distanceConstraints));
+    logDebug(buffer);
+}
@@ -1,6 +1,7 @@
 #ifndef CLOTH_H
 #define CLOTH_H
 
+#include <string>
 #include <vector>
 #include <DirectXMath.h>
 #include "Particle.h"
@@ -8,6 +9,11 @@
 #include "DistanceConstraint.h"
 #include "LRAConstraint.h"
 #include "DihedralBendingConstraint.h"
+#include "IsometricBendingConstraint.h"
+#include "SphereCollisionConstraint.h"
+#include "ClothMeshTopology.h"
+#include "ClothFrameCache.h"
+#include "IClothSolver.h"
 #include "XPBDSolver.h"
 #include "Mesh.h"
 #include "RALResource.h"
@@ -30,6 +36,15 @@ enum class ClothMeshAndContraintMode
 {
     Full,          // 完整网格和约束
     Simplified,    // 简化网格和约束
+    Mesh,          // 从三角网格文件（OBJ/PLY）创建，约束由网格拓扑生成
+};
+
+// 布料粒子重排序方式
+enum class ClothParticleOrdering
+{
+    None,               // 保持创建顺序（规则网格按行，Mesh模式按文件中的顶点顺序）
+    Morton,             // 按静止位置的Morton码（Z曲线）排序
+    ReverseCuthillMcKee,// 按约束图的reverse Cuthill-McKee排序
 };
 
 class Cloth : public Mesh 
@@ -51,9 +66,21 @@ public:
     
     // 更新布料状态
     void Update(IRALGraphicsCommandList* commandList, float deltaTime) override;
+
+    // 粒子数不超过kBatchUpdateMaxParticleCount的布料批量更新，更大的布料逐个更新，使用求解器内部的并行
+    bool IsBatchUpdateSupported() const override;
+
+    // 转换为布料
+    Cloth* AsCloth() override
+    {
+        return this;
+    }
     
     // 初始化布料
     bool Initialize(IRALDevice* device);
+
+    // 只创建粒子和约束，不依赖渲染设备（用于无窗口的基准测试）
+    bool InitializeSimulation();
     
     // 初始化Mesh
     virtual void OnSetupMesh(IRALDevice* device, PrimitiveMesh& mesh) override;
@@ -66,6 +93,91 @@ public:
     {
         return m_particles;
     }
+
+    // 获取各类约束
+    const std::vector<DistanceConstraint>& GetDistanceConstraints() const
+    {
+        return m_distanceConstraints;
+    }
+
+    const std::vector<LRAConstraint>& GetLRAConstraints() const
+    {
+        return m_lraConstraints;
+    }
+
+    const std::vector<DihedralBendingConstraint>& GetDihedralBendingConstraints() const
+    {
+        return m_dihedralBendingConstraints;
+    }
+
+    const std::vector<IsometricBendingConstraint>& GetIsometricBendingConstraints() const
+    {
+        return m_isometricBendingConstraints;
+    }
+
+    // 设置Mesh模式下加载的三角网格文件（.obj或.ply），需要在InitializeSimulation之前设置
+    void SetMeshFile(const std::string& path)
+    {
+        m_meshFile = path;
+    }
+
+    // 获取Mesh模式下加载的三角网格文件
+    const std::string& GetMeshFile() const
+    {
+        return m_meshFile;
+    }
+
+    // 指定固定粒子，需要在InitializeSimulation之前设置
+    // 规则网格的粒子索引为h * widthResolution + w，Mesh模式为加载后的顶点索引，超出范围的索引被忽略
+    // 未指定时固定左上角和右上角，指定空数组时没有固定粒子
+    void SetPinnedParticles(const std::vector<uint32_t>& particles)
+    {
+        m_pinnedParticles = particles;
+        m_pinnedParticlesSpecified = true;
+    }
+
+    // 获取固定粒子的索引（InitializeSimulation之后有效）
+    const std::vector<uint32_t>& GetPinnedParticles() const
+    {
+        return m_pinnedParticles;
+    }
+
+    // 粒子是否按宽度×高度的规则网格排列（Mesh模式下或粒子重排序后不是）
+    bool HasGridTopology() const
+    {
+        return m_meshAndContraintMode != ClothMeshAndContraintMode::Mesh && !m_particlesReordered;
+    }
+
+    // 设置InitializeSimulation时的粒子重排序方式
+    void SetParticleOrdering(ClothParticleOrdering ordering)
+    {
+        m_particleOrdering = ordering;
+    }
+
+    // 获取InitializeSimulation时的粒子重排序方式
+    ClothParticleOrdering GetParticleOrdering() const
+    {
+        return m_particleOrdering;
+    }
+
+    // 重排粒子，使约束相连的粒子在内存中也相邻，然后把每类约束按其最小粒子索引排序，
+    // 使求解时按颜色遍历约束也基本顺序访问粒子数组
+    // 约束的粒子指针、LRA约束、碰撞约束、三角形索引和固定粒子索引都按新顺序重映射，
+    // 重排后粒子不再按规则网格排列，法线改为按三角形拓扑计算，多重网格不再生效
+    // 热启动的拉格朗日乘子和休眠计数不随粒子重排，应在模拟开始之前调用
+    // 参数：
+    //   ordering - 重排序方式，None时不做任何修改
+    void ReorderParticles(ClothParticleOrdering ordering);
+
+    // 获取每个粒子的二维布局坐标，用于按几何位置做嵌套剖分重排序
+    // 规则网格为(w, h)，Mesh模式为静止位置在包围盒最长的两个方向上的投影
+    void GetParticleLayoutCoordinates(std::vector<dx::XMFLOAT2>& coordinates) const;
+
+    // 获取网格拓扑表（Mesh模式或粒子重排序后有效，按规则网格排列的布料为空）
+    const ClothMeshTopology& GetMeshTopology() const
+    {
+        return m_meshTopology;
+    }
     
     // 获取布料的宽度（粒子数）
     int GetWidthResolution() const
@@ -103,6 +215,243 @@ public:
         m_subIteratorCount = count;
     }
 
+    // 获取最少迭代次数
+    uint32_t GetMinIteratorCount() const
+    {
+        return m_minIteratorCount;
+    }
+
+    // 设置最少迭代次数（残差达到容差后提前结束时，至少执行的迭代次数）
+    void SetMinIteratorCount(uint32_t count)
+    {
+        m_minIteratorCount = count;
+    }
+
+    // 获取残差容差
+    float GetResidualTolerance() const
+    {
+        return m_residualTolerance;
+    }
+
+    // 设置残差容差
+    // 一次迭代中所有约束的最大|C|不超过该值时提前结束本子步的迭代，0表示始终执行m_iteratorCount次
+    void SetResidualTolerance(float tolerance)
+    {
+        m_residualTolerance = tolerance;
+    }
+
+    // 获取残差停滞比例
+    float GetResidualStagnationRatio() const
+    {
+        return m_residualStagnationRatio;
+    }
+
+    // 设置残差停滞比例
+    // 相邻两次迭代的整体RMS残差相对下降小于该比例时提前结束本子步的迭代，0表示不检测停滞
+    void SetResidualStagnationRatio(float ratio)
+    {
+        m_residualStagnationRatio = ratio;
+    }
+
+    // 获取是否启用Chebyshev加速
+    bool GetChebyshevAcceleration() const
+    {
+        return m_chebyshevAcceleration;
+    }
+
+    // 设置是否启用Chebyshev加速（只对Iterative调度模式有效）
+    void SetChebyshevAcceleration(bool enable)
+    {
+        m_chebyshevAcceleration = enable;
+    }
+
+    // 获取Chebyshev加速使用的谱半径
+    float GetChebyshevSpectralRadius() const
+    {
+        return m_chebyshevSpectralRadius;
+    }
+
+    // 设置Chebyshev加速使用的谱半径，0表示根据残差下降比例自动估计
+    void SetChebyshevSpectralRadius(float spectralRadius)
+    {
+        m_chebyshevSpectralRadius = spectralRadius;
+    }
+
+    // 获取超松弛系数
+    float GetOverRelaxationFactor() const
+    {
+        return m_overRelaxationFactor;
+    }
+
+    // 设置超松弛系数，作用于每次的拉格朗日乘子增量，1表示不松弛
+    void SetOverRelaxationFactor(float factor)
+    {
+        m_overRelaxationFactor = factor;
+    }
+
+    // 获取是否启用休眠
+    bool GetSleepEnabled() const
+    {
+        return m_sleepEnabled;
+    }
+
+    // 设置是否启用休眠
+    void SetSleepEnabled(bool enable)
+    {
+        m_sleepEnabled = enable;
+    }
+
+    // 获取休眠速度阈值
+    float GetSleepVelocityThreshold() const
+    {
+        return m_sleepVelocityThreshold;
+    }
+
+    // 设置休眠速度阈值（米/秒）
+    void SetSleepVelocityThreshold(float threshold)
+    {
+        m_sleepVelocityThreshold = threshold;
+    }
+
+    // 获取休眠位移阈值
+    float GetSleepDisplacementThreshold() const
+    {
+        return m_sleepDisplacementThreshold;
+    }
+
+    // 设置休眠位移阈值（米），粒子在观察窗口内偏离起始位置超过该值时重新计数
+    void SetSleepDisplacementThreshold(float threshold)
+    {
+        m_sleepDisplacementThreshold = threshold;
+    }
+
+    // 获取进入休眠所需的连续静止帧数
+    uint32_t GetSleepFrameCount() const
+    {
+        return m_sleepFrameCount;
+    }
+
+    // 设置进入休眠所需的连续静止帧数
+    void SetSleepFrameCount(uint32_t count)
+    {
+        m_sleepFrameCount = count;
+    }
+
+    // 获取速度阻尼
+    float GetVelocityDamping() const
+    {
+        return m_velocityDamping;
+    }
+
+    // 设置速度阻尼（1/秒），每帧速度乘以(1 - damping * deltaTime)，0表示不衰减
+    void SetVelocityDamping(float damping)
+    {
+        m_velocityDamping = damping;
+    }
+
+    // 获取粗网格层级数
+    uint32_t GetMultigridLevelCount() const
+    {
+        return m_multigridLevelCount;
+    }
+
+    // 设置粗网格层级数，第n层的粒子间隔为2^n，0表示不使用多层级求解，网格太小时自动减少
+    void SetMultigridLevelCount(uint32_t count)
+    {
+        m_multigridLevelCount = count;
+    }
+
+    // 获取每个粗网格层级的迭代次数
+    uint32_t GetMultigridIterationCount() const
+    {
+        return m_multigridIterationCount;
+    }
+
+    // 设置每个粗网格层级的迭代次数
+    void SetMultigridIterationCount(uint32_t count)
+    {
+        m_multigridIterationCount = count;
+    }
+
+    // 获取距离约束的求解方式
+    XPBDDistanceSolveMode GetDistanceSolveMode() const
+    {
+        return m_distanceSolveMode;
+    }
+
+    // 设置距离约束的求解方式
+    // Direct模式下每个子步先用稀疏Cholesky分解整体求解距离约束，迭代只处理其他约束
+    void SetDistanceSolveMode(XPBDDistanceSolveMode mode)
+    {
+        m_distanceSolveMode = mode;
+    }
+
+    // 获取每个子步直接求解距离约束的次数
+    uint32_t GetDirectSolveIterationCount() const
+    {
+        return m_directSolveIterationCount;
+    }
+
+    // 设置每个子步直接求解距离约束的次数（每次求解相当于一次牛顿步）
+    void SetDirectSolveIterationCount(uint32_t count)
+    {
+        m_directSolveIterationCount = count;
+    }
+
+    // 获取求解器类型
+    ClothSolverType GetSolverType() const
+    {
+        return m_solverType;
+    }
+
+    // 设置求解器类型，切换时重新创建求解器
+    void SetSolverType(ClothSolverType type);
+
+    // 获取求解器名称
+    const char* GetSolverName() const
+    {
+        return m_solver->GetName();
+    }
+
+    // 获取最近一帧的求解统计（各类约束的残差和实际迭代次数）
+    const ClothSolverStats& GetSolverStats() const
+    {
+        return m_solver->GetStats();
+    }
+
+    // 获取拉格朗日乘子热启动系数
+    float GetLambdaWarmStartFactor() const
+    {
+        return m_lambdaWarmStartFactor;
+    }
+
+    // 设置拉格朗日乘子热启动系数
+    // 0（默认）表示每个子步开始时清零，大于0时距离约束沿用上一子步的拉伸乘子并乘以该系数，
+    // 乘子对应的位置校正在迭代前作用到预测位置上，系数接近1时与碰撞一起可能不稳定
+    void SetLambdaWarmStartFactor(float factor)
+    {
+        m_lambdaWarmStartFactor = factor;
+    }
+
+    // 获取求解器调度模式
+    XPBDScheduleMode GetScheduleMode() const
+    {
+        return m_scheduleMode;
+    }
+
+    // 设置求解器调度模式
+    // SmallSteps模式下子迭代次数即为子步数，每个子步只迭代一次
+    void SetScheduleMode(XPBDScheduleMode mode)
+    {
+        m_scheduleMode = mode;
+    }
+
+    // 计算距离约束的相对误差（|当前长度-静止长度|/静止长度）
+    // 参数：
+    //   meanError - 输出平均相对误差
+    //   maxError - 输出最大相对误差
+    void ComputeDistanceConstraintError(float& meanError, float& maxError) const;
+
     // 清除所有球体碰撞约束
     void ClearSphereCollisionConstraints();
 
@@ -261,6 +610,42 @@ public:
     {
         m_dihedralBendingConstraintDamping = damping;
     }
+
+    // 获取是否增加等距弯曲约束
+    bool GetAddIsometricBendingConstraints() const
+    {
+        return m_addIsometricBendingConstraints;
+    }
+
+    // 设置是否增加等距弯曲约束（二面角约束的替代，两者使用相同的相邻三角形对）
+    void SetAddIsometricBendingConstraints(bool add)
+    {
+        m_addIsometricBendingConstraints = add;
+    }
+
+    // 获取等距弯曲约束的柔度
+    float GetIsometricBendingConstraintCompliance() const
+    {
+        return m_isometricBendingConstraintCompliance;
+    }
+
+    // 设置等距弯曲约束的柔度
+    void SetIsometricBendingConstraintCompliance(float compliance)
+    {
+        m_isometricBendingConstraintCompliance = compliance;
+    }
+
+    // 获取等距弯曲约束的阻尼
+    float GetIsometricBendingConstraintDamping() const
+    {
+        return m_isometricBendingConstraintDamping;
+    }
+
+    // 设置等距弯曲约束的阻尼
+    void SetIsometricBendingConstraintDamping(float damping)
+    {
+        m_isometricBendingConstraintDamping = damping;
+    }
     
     // 获取每个粒子的质量
     float GetMass() const 
@@ -280,10 +665,69 @@ public:
     // 初始化球体碰撞约束（一次性创建，避免每次重建）
     void InitializeSphereCollisionConstraints(const dx::XMFLOAT3& sphereCenter, float sphereRadius);
 
+    // 开始录制帧缓存：写入当前状态作为第0帧，之后每次Update后追加一帧
+    // 必须在InitializeSimulation之后调用，录制期间不能重排粒子
+    // 参数：
+    //   path - 缓存文件路径
+    //   format - 帧数据格式
+    // 返回：是否成功
+    bool StartFrameCacheRecording(const std::string& path, ClothFrameCacheFormat format);
+
+    // 结束录制，写入帧表后文件才能回放
+    void StopFrameCacheRecording();
+
+    // 是否正在录制帧缓存
+    bool IsRecordingFrameCache() const
+    {
+        return m_frameCacheWriter != nullptr;
+    }
+
+    // 设置回放的帧缓存文件，必须在Initialize之前调用
+    // 设置后Initialize只映射缓存文件，不创建粒子和约束，Update按帧时间回放而不运行求解器
+    void SetFrameCachePlaybackFile(const std::string& path)
+    {
+        m_frameCachePlaybackFile = path;
+    }
+
+    // 是否正在回放帧缓存
+    bool IsPlayingFrameCache() const
+    {
+        return m_frameCacheReader != nullptr;
+    }
+
+    // 跳到回放的任意一帧，超出范围时取最后一帧；在Initialize之前调用时设置回放的起始帧
+    void SeekFrameCache(uint32_t frame);
+
+    // 获取当前回放的帧
+    uint32_t GetFrameCacheFrame() const
+    {
+        return m_frameCacheFrame;
+    }
+
+    // 保存完整的模拟状态：粒子（位置、速度、oldPosition、质量等）、约束的静止参数、碰撞体和求解器状态
+    // 只复制内存，文件写入可以交给ClothCheckpointWriter在后台完成
+    // 参数：
+    //   data - 输出检查点数据
+    void SaveCheckpoint(std::vector<char>& data) const;
+
+    // 恢复SaveCheckpoint保存的模拟状态，之后继续模拟的结果与不中断时逐位一致
+    // 布料必须用相同的分辨率或网格、约束开关和粒子重排序创建，并完成初始化和碰撞约束的创建
+    // 柔度、阻尼、迭代次数等参数保持当前设置，可以从同一个状态分出不同参数的模拟
+    // 参数：
+    //   data - 检查点数据
+    //   size - 检查点数据的字节数
+    // 返回：是否成功，失败时不修改布料
+    bool LoadCheckpoint(const char* data, size_t size);
+
 private:
     // 创建布料粒子
     void CreateParticles();
 
+    // 去掉超出粒子数和重复的固定粒子索引
+    // 参数：
+    //   particleCount - 粒子数
+    void ValidatePinnedParticles(uint32_t particleCount);
+
     // 增加距离约束
     void AddDistanceConstraint(const DistanceConstraint& constraint);
 
@@ -293,14 +737,29 @@ private:
     // 增加二面角约束
     void AddDihedralBendingConstraint(const DihedralBendingConstraint& constraint);
 
+    // 增加等距弯曲约束
+    void AddIsometricBendingConstraint(const IsometricBendingConstraint& constraint);
+
+    // 为一对相邻三角形按开关增加二面角约束和/或等距弯曲约束
+    // 参数：
+    //   p1, p2 - 公共边的顶点索引
+    //   p3, p4 - 两个三角形的第三个顶点索引
+    void AddBendingConstraints(int p1, int p2, int p3, int p4);
+
     // 创建完整结构的布料的粒子
     void CreateFullStructuredParticles();
     
     // 创建完整结构的布料的约束
     void CreateFullStructuredConstraints();
 
-    // 计算完整结构的布料的法线
-    void ComputeFullStructuredNormals();
+    // 计算法线，并更新位置和交错的顶点数据
+    void ComputeNormals();
+
+    // 计算[rowBegin, rowEnd)行格子中两个三角形的面法线
+    void ComputeFaceNormals(int rowBegin, int rowEnd);
+
+    // 从相邻格子的面法线汇聚[rowBegin, rowEnd)行顶点的法线，同时写入位置和顶点数据
+    void GatherVertexNormals(int rowBegin, int rowEnd);
 
     // 创建简化结构的布料的粒子
     void CreateSimplifiedStructuredParticles();
@@ -308,8 +767,23 @@ private:
     // 创建简化结构的布料的约束
     void CreateSimplifiedStructuredConstraints();
 
-    // 计算简化结构的布料的法线
-    void ComputeSimplifiedStructuredNormals();
+    // 加载三角网格，按文件中的顶点顺序创建粒子、索引和拓扑表
+    // 返回：是否成功
+    bool CreateMeshParticles();
+
+    // 按网格拓扑创建约束：每条边一个距离约束，每条内部边一个跨边的弯曲距离约束和二面角/等距弯曲约束，
+    // 固定粒子到其他粒子沿网格边的最短路径长度作为LRA约束的测地线距离
+    void CreateMeshConstraints();
+
+    // Mesh模式的法线计算：按三角形并行计算面法线，再按顶点并行汇聚相邻三角形的面法线
+    void ComputeMeshNormals();
+
+    // 映射回放的帧缓存文件，并复制三角形索引
+    // 返回：是否成功
+    bool InitializeFrameCachePlayback();
+
+    // 准备当前回放帧的顶点数据：Float32格式直接指向映射内存，其他格式解码到m_vertexData
+    void LoadFrameCacheFrame();
 
 private:
     // 布料的尺寸参数
@@ -325,7 +799,8 @@ private:
     std::vector<DistanceConstraint> m_distanceConstraints; // 布料的所有距离约束
     std::vector<LRAConstraint> m_lraConstraints; // LRA约束
     std::vector<DihedralBendingConstraint> m_dihedralBendingConstraints; // 二面角约束
-    std::vector<Constraint*> m_CollisionConstraints; // 碰撞约束
+    std::vector<IsometricBendingConstraint> m_isometricBendingConstraints; // 等距弯曲约束
+    std::vector<SphereCollisionConstraint> m_CollisionConstraints; // 碰撞约束
     float m_distanceConstraintCompliance; // 距离约束的柔度系数
     float m_distanceConstraintDamping;  // 距离约束的阻尼系数
 
@@ -343,11 +818,16 @@ private:
     float m_dihedralBendingConstraintCompliance; // 二面角约束的柔度系数
     float m_dihedralBendingConstraintDamping; // 二面角约束的阻尼系数
 
+    bool m_addIsometricBendingConstraints; // 是否增加等距弯曲约束
+    float m_isometricBendingConstraintCompliance; // 等距弯曲约束的柔度系数
+    float m_isometricBendingConstraintDamping; // 等距弯曲约束的阻尼系数
+
     float m_sphereCollisionConstraintCompliance; // 球面碰撞约束的柔度系数
     float m_sphereCollisionConstraintDamping; // 球面碰撞约束的阻尼系数
 
-    // XPBD求解器
-    XPBDSolver m_solver; // 用于求解布料的物理行为
+    // 求解器
+    ClothSolverType m_solverType; // 求解器类型
+    IClothSolver* m_solver; // 用于求解布料的物理行为
     
     // 重力
     dx::XMFLOAT3 m_gravity; // 作用在布料上的重力
@@ -356,11 +836,52 @@ private:
     std::vector<dx::XMFLOAT3> m_positions; // 布料顶点位置数据
     std::vector<dx::XMFLOAT3> m_normals; // 布料顶点法线数据
     std::vector<uint32_t> m_indices; // 布料索引数据
+    std::vector<dx::XMFLOAT4A> m_faceNormals; // 每个格子两个三角形的面法线（Mesh模式下为每个三角形的面法线，16字节对齐便于SIMD读取）
+    std::vector<float> m_vertexData; // 交错的顶点数据（位置+法线），直接用于上传
+
+    // Mesh模式的网格数据
+    std::string m_meshFile; // 三角网格文件
+    ClothMeshTopology m_meshTopology; // 边表和顶点的相邻三角形
+    std::vector<uint32_t> m_pinnedParticles; // 固定粒子的索引
+    bool m_pinnedParticlesSpecified; // 固定粒子是否由SetPinnedParticles指定
+    std::vector<dx::XMFLOAT2> m_particleLayoutCoordinates; // 不按规则网格排列时每个粒子的二维布局坐标
+
+    // 粒子重排序
+    ClothParticleOrdering m_particleOrdering; // InitializeSimulation时的粒子重排序方式
+    bool m_particlesReordered; // 粒子是否已重排序（不再按规则网格排列）
+
+    // 帧缓存
+    ClothFrameCacheWriter* m_frameCacheWriter; // 录制时的写入器，不录制时为nullptr
+    float m_frameCacheRecordingTime; // 录制的模拟时间
+    std::string m_frameCachePlaybackFile; // 回放的缓存文件，为空时正常模拟
+    ClothFrameCacheReader* m_frameCacheReader; // 回放时的读取器，不回放时为nullptr
+    uint32_t m_frameCacheFrame; // 当前回放的帧
+    float m_frameCachePlaybackTime; // 回放的时间
+    const float* m_frameCacheVertexData; // 当前回放帧的交错顶点数据，指向映射内存或m_vertexData
 
     uint32_t m_iteratorCount;   // 迭代次数
     uint32_t m_subIteratorCount;   // 子迭代次数
+    uint32_t m_minIteratorCount;   // 提前结束时的最少迭代次数
+    float m_residualTolerance;     // 提前结束迭代的残差容差
+    float m_residualStagnationRatio; // 提前结束迭代的残差停滞比例
+    bool m_chebyshevAcceleration;  // 是否启用Chebyshev加速
+    float m_chebyshevSpectralRadius; // Chebyshev加速的谱半径，0表示自动估计
+    float m_overRelaxationFactor;  // 拉格朗日乘子增量的超松弛系数
+    bool m_sleepEnabled;           // 是否启用休眠
+    float m_sleepVelocityThreshold; // 休眠速度阈值
+    float m_sleepDisplacementThreshold; // 休眠位移阈值
+    uint32_t m_sleepFrameCount;    // 进入休眠所需的连续静止帧数
+    float m_velocityDamping;       // 速度阻尼
+    uint32_t m_multigridLevelCount; // 粗网格层级数，0表示不使用
+    uint32_t m_multigridIterationCount; // 每个粗网格层级的迭代次数
+    XPBDDistanceSolveMode m_distanceSolveMode; // 距离约束的求解方式
+    uint32_t m_directSolveIterationCount; // 每个子步直接求解距离约束的次数
+    float m_lambdaWarmStartFactor; // 拉格朗日乘子热启动系数
+    XPBDScheduleMode m_scheduleMode; // 求解器调度模式
 
     friend class XPBDSolver;
+    friend class ProjectiveDynamicsSolver;
+    friend class ClothBatchSolver;
 };
 
 #endif // CLOTH_H
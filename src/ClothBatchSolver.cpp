@@ -0,0 +1,928 @@
+#include "ClothBatchSolver.h"
+#include "Cloth.h"
+#include "XPBDSolver.h"
+#include "TaskScheduler.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+
+extern void logDebug(const std::string& message);
+
+// 粒子阶段（预测、速度更新）每个任务处理的粒子数
+static const uint32_t kParticleGrainSize = 1024;
+
+// 约束求解每个任务处理的约束数：同一种颜色包含所有布料的约束，块可以比单块布料求解时更大
+static const uint32_t kConstraintGrainSize = 1024;
+
+// 贪心着色的最大颜色数，超出的约束放入最后一组串行求解
+static const uint32_t kMaxColorCount = 64;
+
+ClothBatchSolver::ClothBatchSolver()
+    : m_iteratorCount(0)
+    , m_subIteratorCount(0)
+    , m_overRelaxationFactor(1.0f)
+    , m_recordErrors(false)
+{
+    m_distanceColoring.lastColorSerial = false;
+    m_lraColoring.lastColorSerial = false;
+    m_collisionColoring.lastColorSerial = false;
+}
+
+bool ClothBatchSolver::IsSupported(const Cloth* cloth)
+{
+    return cloth->m_solverType == ClothSolverType::XPBD
+        && cloth->m_scheduleMode == XPBDScheduleMode::Iterative
+        && cloth->m_distanceSolveMode == XPBDDistanceSolveMode::Iterative
+        && cloth->m_multigridLevelCount == 0
+        && !cloth->m_chebyshevAcceleration
+        && cloth->m_lambdaWarmStartFactor <= 0.0f
+        && cloth->m_dihedralBendingConstraints.empty()
+        && cloth->m_isometricBendingConstraints.empty()
+        && !cloth->IsPlayingFrameCache()
+        && !cloth->IsRecordingFrameCache()
+        && !cloth->m_particles.empty()
+        && cloth->IsBatchUpdateSupported();
+}
+
+bool ClothBatchSolver::IsCompatible(const Cloth* cloth, const Cloth* other)
+{
+    return cloth->m_iteratorCount == other->m_iteratorCount
+        && cloth->m_subIteratorCount == other->m_subIteratorCount
+        && cloth->m_overRelaxationFactor == other->m_overRelaxationFactor;
+}
+
+void ClothBatchSolver::Clear()
+{
+    m_cloths.clear();
+    m_ranges.clear();
+    m_inverseMass.clear();
+    m_distanceColoring.slots.clear();
+    m_distanceColoring.colorOffsets.clear();
+    m_lraColoring.slots.clear();
+    m_lraColoring.colorOffsets.clear();
+    m_collisionColoring.slots.clear();
+    m_collisionColoring.colorOffsets.clear();
+}
+
+void ClothBatchSolver::Step(const std::vector<Cloth*>& cloths, float deltaTime)
+{
+    if (cloths.empty())
+    {
+        return;
+    }
+
+    // 打包的布料不使用休眠，唤醒之前在逐块更新时进入休眠的粒子（没有休眠粒子时直接返回）
+    for (Cloth* cloth : cloths)
+    {
+        cloth->m_solver->WakeAll();
+    }
+
+    bool packed = !NeedsRebuild(cloths) || Build(cloths);
+
+    // 约束数量不变但引用的粒子变化（例如粒子重排序）时重新打包
+    if (packed && !Gather())
+    {
+        packed = Build(cloths) && Gather();
+    }
+
+    if (!packed)
+    {
+        logDebug("ClothBatchSolver::Step: failed to pack cloths, updating them one by one");
+        Clear();
+
+        for (Cloth* cloth : cloths)
+        {
+            cloth->Update(nullptr, deltaTime);
+        }
+        return;
+    }
+
+    const float subDeltaTime = deltaTime / m_subIteratorCount;
+
+    for (uint32_t i = 0; i < m_subIteratorCount; ++i)
+    {
+        // 1. 预测粒子的位置，考虑外力
+        PredictPositions(subDeltaTime);
+
+        // 拉格朗日乘子只在子步内累积
+        std::fill(m_distanceLambdas.begin(), m_distanceLambdas.end(), (SolverReal)0);
+        std::fill(m_lraLambdas.begin(), m_lraLambdas.end(), (SolverReal)0);
+        std::fill(m_collisionLambdas.begin(), m_collisionLambdas.end(), (SolverReal)0);
+
+        // 2. 按与XPBDSolver相同的约束类型顺序迭代求解
+        for (uint32_t iteration = 0; iteration < m_iteratorCount; ++iteration)
+        {
+            // 求解统计中的残差取最后一个子步的最后一次迭代
+            m_recordErrors = (i == m_subIteratorCount - 1 && iteration == m_iteratorCount - 1);
+
+            SolveColored(m_distanceColoring, [this, subDeltaTime](uint32_t begin, uint32_t end)
+            {
+                SolveDistanceConstraints(begin, end, subDeltaTime);
+            });
+
+            SolveColored(m_lraColoring, [this, subDeltaTime](uint32_t begin, uint32_t end)
+            {
+                SolveLRAConstraints(begin, end, subDeltaTime);
+            });
+
+            SolveColored(m_collisionColoring, [this, subDeltaTime](uint32_t begin, uint32_t end)
+            {
+                SolveCollisionConstraints(begin, end, subDeltaTime);
+            });
+        }
+
+        // 3. 更新速度
+        UpdateVelocities(subDeltaTime);
+    }
+
+    EndStep(deltaTime);
+
+    Scatter();
+}
+
+bool ClothBatchSolver::NeedsRebuild(const std::vector<Cloth*>& cloths) const
+{
+    if (cloths != m_cloths)
+    {
+        return true;
+    }
+
+    for (const ClothRange& range : m_ranges)
+    {
+        const Cloth* cloth = range.cloth;
+        if (cloth->m_particles.size() != range.particleCount
+            || cloth->m_distanceConstraints.size() != range.distanceCount
+            || cloth->m_lraConstraints.size() != range.lraCount
+            || cloth->m_CollisionConstraints.size() != range.collisionCount
+            || cloth->m_iteratorCount != m_iteratorCount
+            || cloth->m_subIteratorCount != m_subIteratorCount
+            || cloth->m_overRelaxationFactor != m_overRelaxationFactor)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ClothBatchSolver::Build(const std::vector<Cloth*>& cloths)
+{
+    Clear();
+
+    m_cloths = cloths;
+    m_iteratorCount = cloths.front()->m_iteratorCount;
+    m_subIteratorCount = (std::max)(1u, cloths.front()->m_subIteratorCount);
+    m_overRelaxationFactor = cloths.front()->m_overRelaxationFactor;
+
+    // 1. 按布料顺序分配粒子和约束的位置
+    uint32_t particleCount = 0;
+    uint32_t distanceCount = 0;
+    uint32_t lraCount = 0;
+    uint32_t collisionCount = 0;
+
+    m_ranges.resize(cloths.size());
+    for (size_t c = 0; c < cloths.size(); ++c)
+    {
+        ClothRange& range = m_ranges[c];
+        range.cloth = cloths[c];
+        range.particleOffset = particleCount;
+        range.particleCount = (uint32_t)range.cloth->m_particles.size();
+        range.distanceOffset = distanceCount;
+        range.distanceCount = (uint32_t)range.cloth->m_distanceConstraints.size();
+        range.lraOffset = lraCount;
+        range.lraCount = (uint32_t)range.cloth->m_lraConstraints.size();
+        range.collisionOffset = collisionCount;
+        range.collisionCount = (uint32_t)range.cloth->m_CollisionConstraints.size();
+
+        particleCount += range.particleCount;
+        distanceCount += range.distanceCount;
+        lraCount += range.lraCount;
+        collisionCount += range.collisionCount;
+    }
+
+    // 2. 收集每个约束引用的粒子（全局索引，按布料顺序排列），着色时需要知道哪些粒子是静态的
+    m_inverseMass.resize(particleCount);
+
+    std::vector<uint32_t> distanceParticles(distanceCount * 2);
+    std::vector<uint32_t> lraParticles(lraCount);
+    std::vector<uint32_t> collisionParticles(collisionCount);
+
+    for (const ClothRange& range : m_ranges)
+    {
+        const std::vector<Particle>& particles = range.cloth->m_particles;
+        const Particle* particlesBegin = particles.data();
+
+        // 返回粒子的全局索引，不属于这块布料的粒子返回UINT32_MAX
+        auto getParticleIndex = [&range, particlesBegin](const Particle* particle)
+        {
+            if (particle < particlesBegin || particle >= particlesBegin + range.particleCount)
+            {
+                return UINT32_MAX;
+            }
+            return range.particleOffset + (uint32_t)(particle - particlesBegin);
+        };
+
+        for (uint32_t i = 0; i < range.particleCount; ++i)
+        {
+            m_inverseMass[range.particleOffset + i] = particles[i].isStatic ? 0.0f : particles[i].inverseMass;
+        }
+
+        for (uint32_t i = 0; i < range.distanceCount; ++i)
+        {
+            const DistanceConstraint& constraint = range.cloth->m_distanceConstraints[i];
+            const Particle** constraintParticles = constraint.DistanceConstraint::GetParticles();
+            distanceParticles[(range.distanceOffset + i) * 2] = getParticleIndex(constraintParticles[0]);
+            distanceParticles[(range.distanceOffset + i) * 2 + 1] = getParticleIndex(constraintParticles[1]);
+        }
+
+        for (uint32_t i = 0; i < range.lraCount; ++i)
+        {
+            const LRAConstraint& constraint = range.cloth->m_lraConstraints[i];
+            lraParticles[range.lraOffset + i] = getParticleIndex(constraint.LRAConstraint::GetParticles()[0]);
+        }
+
+        for (uint32_t i = 0; i < range.collisionCount; ++i)
+        {
+            const SphereCollisionConstraint& constraint = range.cloth->m_CollisionConstraints[i];
+            collisionParticles[range.collisionOffset + i] = getParticleIndex(constraint.SphereCollisionConstraint::GetParticles()[0]);
+        }
+    }
+
+    if (std::find(distanceParticles.begin(), distanceParticles.end(), UINT32_MAX) != distanceParticles.end()
+        || std::find(lraParticles.begin(), lraParticles.end(), UINT32_MAX) != lraParticles.end()
+        || std::find(collisionParticles.begin(), collisionParticles.end(), UINT32_MAX) != collisionParticles.end())
+    {
+        logDebug("ClothBatchSolver::Build: constraint references a particle outside its cloth");
+        return false;
+    }
+
+    // 3. 每块布料内部着色，所有布料的同一种颜色连续存放
+    BuildPackedColoring(distanceParticles, 2, [](const ClothRange& range) { return std::make_pair(range.distanceOffset, range.distanceCount); }, m_distanceColoring);
+    BuildPackedColoring(lraParticles, 1, [](const ClothRange& range) { return std::make_pair(range.lraOffset, range.lraCount); }, m_lraColoring);
+    BuildPackedColoring(collisionParticles, 1, [](const ClothRange& range) { return std::make_pair(range.collisionOffset, range.collisionCount); }, m_collisionColoring);
+
+    // 4. 分配SoA数组，写入打包后的粒子索引，其余参数每帧在Gather中收集
+    m_positionX.resize(particleCount); m_positionY.resize(particleCount); m_positionZ.resize(particleCount);
+    m_predPositionX.resize(particleCount); m_predPositionY.resize(particleCount); m_predPositionZ.resize(particleCount);
+    m_oldPositionX.resize(particleCount); m_oldPositionY.resize(particleCount); m_oldPositionZ.resize(particleCount);
+    m_initialPositionX.resize(particleCount); m_initialPositionY.resize(particleCount); m_initialPositionZ.resize(particleCount);
+    m_velocityX.resize(particleCount); m_velocityY.resize(particleCount); m_velocityZ.resize(particleCount);
+    m_accelerationX.resize(particleCount); m_accelerationY.resize(particleCount); m_accelerationZ.resize(particleCount);
+    m_velocityDamping.resize(particleCount);
+
+    m_distanceParticle1.resize(distanceCount);
+    m_distanceParticle2.resize(distanceCount);
+    m_distanceRestLength.resize(distanceCount);
+    m_distanceCompliance.resize(distanceCount);
+    m_distanceDamping.resize(distanceCount);
+    m_distanceLambdas.resize(distanceCount);
+    m_distanceErrors.resize(distanceCount);
+
+    for (uint32_t i = 0; i < distanceCount; ++i)
+    {
+        const uint32_t slot = m_distanceColoring.slots[i];
+        m_distanceParticle1[slot] = distanceParticles[i * 2];
+        m_distanceParticle2[slot] = distanceParticles[i * 2 + 1];
+    }
+
+    m_lraParticle.resize(lraCount);
+    m_lraAttachmentX.resize(lraCount); m_lraAttachmentY.resize(lraCount); m_lraAttachmentZ.resize(lraCount);
+    m_lraMaxDistance.resize(lraCount);
+    m_lraCompliance.resize(lraCount);
+    m_lraDamping.resize(lraCount);
+    m_lraLambdas.resize(lraCount);
+    m_lraErrors.resize(lraCount);
+
+    for (uint32_t i = 0; i < lraCount; ++i)
+    {
+        m_lraParticle[m_lraColoring.slots[i]] = lraParticles[i];
+    }
+
+    m_collisionParticle.resize(collisionCount);
+    m_collisionCenterX.resize(collisionCount); m_collisionCenterY.resize(collisionCount); m_collisionCenterZ.resize(collisionCount);
+    m_collisionRadius.resize(collisionCount);
+    m_collisionCompliance.resize(collisionCount);
+    m_collisionDamping.resize(collisionCount);
+    m_collisionLambdas.resize(collisionCount);
+    m_collisionErrors.resize(collisionCount);
+
+    for (uint32_t i = 0; i < collisionCount; ++i)
+    {
+        m_collisionParticle[m_collisionColoring.slots[i]] = collisionParticles[i];
+    }
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "[DEBUG] ClothBatchSolver::Build: %u cloths, %u particles, %u distance (%u colors), %u LRA, %u collision constraints"
+        , (uint32_t)m_cloths.size()
+        , particleCount
+        , distanceCount
+        , (uint32_t)m_distanceColoring.colorOffsets.size() - 1
+        , lraCount
+        , collisionCount);
+    logDebug(buffer);
+
+    return true;
+}
+
+template<typename GetRangeFunc>
+void ClothBatchSolver::BuildPackedColoring(const std::vector<uint32_t>& particles, uint32_t arity, GetRangeFunc getRange, PackedColoring& coloring)
+{
+    const uint32_t constraintCount = (uint32_t)(particles.size() / arity);
+
+    // 每个约束的颜色，以及每个粒子已被占用的颜色（位掩码，按布料复用）
+    std::vector<uint8_t> constraintColors(constraintCount);
+    std::vector<uint64_t> usedColors;
+    uint32_t colorCounts[kMaxColorCount + 1] = {};
+
+    for (const ClothRange& range : m_ranges)
+    {
+        const std::pair<uint32_t, uint32_t> constraintRange = getRange(range);
+        usedColors.assign(range.particleCount, 0);
+
+        for (uint32_t c = constraintRange.first; c < constraintRange.first + constraintRange.second; ++c)
+        {
+            // 静态粒子不会被写入，不参与冲突判断
+            uint64_t used = 0;
+            for (uint32_t i = 0; i < arity; ++i)
+            {
+                const uint32_t particle = particles[c * arity + i];
+                if (m_inverseMass[particle] > 0.0f)
+                {
+                    used |= usedColors[particle - range.particleOffset];
+                }
+            }
+
+            uint32_t color = kMaxColorCount;
+            for (uint32_t i = 0; i < kMaxColorCount; ++i)
+            {
+                if ((used & (1ull << i)) == 0)
+                {
+                    color = i;
+                    break;
+                }
+            }
+
+            if (color < kMaxColorCount)
+            {
+                for (uint32_t i = 0; i < arity; ++i)
+                {
+                    const uint32_t particle = particles[c * arity + i];
+                    if (m_inverseMass[particle] > 0.0f)
+                    {
+                        usedColors[particle - range.particleOffset] |= (1ull << color);
+                    }
+                }
+            }
+
+            constraintColors[c] = (uint8_t)color;
+            colorCounts[color]++;
+        }
+    }
+
+    // 计算每种颜色的起始位置，跳过空颜色
+    uint32_t colorStarts[kMaxColorCount + 1] = {};
+    uint32_t offset = 0;
+    coloring.colorOffsets.clear();
+    for (uint32_t color = 0; color <= kMaxColorCount; ++color)
+    {
+        colorStarts[color] = offset;
+        if (colorCounts[color] > 0)
+        {
+            coloring.colorOffsets.push_back(offset);
+            offset += colorCounts[color];
+        }
+    }
+    coloring.colorOffsets.push_back(offset);
+    coloring.lastColorSerial = colorCounts[kMaxColorCount] > 0;
+
+    // 同一种颜色内按布料顺序排列，每块布料的约束在颜色内是连续的一段
+    coloring.slots.resize(constraintCount);
+    for (uint32_t c = 0; c < constraintCount; ++c)
+    {
+        coloring.slots[c] = colorStarts[constraintColors[c]]++;
+    }
+}
+
+bool ClothBatchSolver::Gather()
+{
+    std::atomic<bool> matched(true);
+
+    // 每块布料是一个块，布料之间写入的位置互不重叠
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)m_ranges.size(), 1, [this, &matched](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t c = begin; c < end; ++c)
+        {
+            const ClothRange& range = m_ranges[c];
+            const Cloth* cloth = range.cloth;
+            const Particle* particlesBegin = cloth->m_particles.data();
+            const uint32_t particleOffset = range.particleOffset;
+            const dx::XMFLOAT3 gravity = cloth->m_gravity;
+            const float velocityDamping = cloth->m_velocityDamping;
+
+            for (uint32_t i = 0; i < range.particleCount; ++i)
+            {
+                const Particle& particle = cloth->m_particles[i];
+                const uint32_t p = particleOffset + i;
+                const float inverseMass = particle.isStatic ? 0.0f : particle.inverseMass;
+
+                m_positionX[p] = particle.position.x;
+                m_positionY[p] = particle.position.y;
+                m_positionZ[p] = particle.position.z;
+                m_predPositionX[p] = particle.position.x;
+                m_predPositionY[p] = particle.position.y;
+                m_predPositionZ[p] = particle.position.z;
+                m_oldPositionX[p] = particle.position.x;
+                m_oldPositionY[p] = particle.position.y;
+                m_oldPositionZ[p] = particle.position.z;
+                m_initialPositionX[p] = particle.position.x;
+                m_initialPositionY[p] = particle.position.y;
+                m_initialPositionZ[p] = particle.position.z;
+                m_velocityX[p] = particle.velocity.x;
+                m_velocityY[p] = particle.velocity.y;
+                m_velocityZ[p] = particle.velocity.z;
+
+                // 重力按力作用在粒子上，与XPBDSolver::PredictPositions相同
+                m_accelerationX[p] = gravity.x * inverseMass;
+                m_accelerationY[p] = gravity.y * inverseMass;
+                m_accelerationZ[p] = gravity.z * inverseMass;
+                m_velocityDamping[p] = velocityDamping;
+                m_inverseMass[p] = inverseMass;
+            }
+
+            auto getParticleIndex = [particlesBegin, particleOffset](const Particle* particle)
+            {
+                return particleOffset + (uint32_t)(particle - particlesBegin);
+            };
+
+            bool clothMatched = true;
+
+            for (uint32_t i = 0; i < range.distanceCount; ++i)
+            {
+                const DistanceConstraint& constraint = cloth->m_distanceConstraints[i];
+                const Particle** constraintParticles = constraint.DistanceConstraint::GetParticles();
+                const uint32_t slot = m_distanceColoring.slots[range.distanceOffset + i];
+
+                clothMatched = clothMatched
+                    && m_distanceParticle1[slot] == getParticleIndex(constraintParticles[0])
+                    && m_distanceParticle2[slot] == getParticleIndex(constraintParticles[1]);
+
+                m_distanceRestLength[slot] = constraint.GetRestLength();
+                m_distanceCompliance[slot] = constraint.GetCompliance();
+                m_distanceDamping[slot] = constraint.GetDamping();
+            }
+
+            for (uint32_t i = 0; i < range.lraCount; ++i)
+            {
+                const LRAConstraint& constraint = cloth->m_lraConstraints[i];
+                const uint32_t slot = m_lraColoring.slots[range.lraOffset + i];
+
+                clothMatched = clothMatched && m_lraParticle[slot] == getParticleIndex(constraint.LRAConstraint::GetParticles()[0]);
+
+                const dx::XMFLOAT3& attachmentPoint = constraint.GetAttachmentPoint();
+                m_lraAttachmentX[slot] = attachmentPoint.x;
+                m_lraAttachmentY[slot] = attachmentPoint.y;
+                m_lraAttachmentZ[slot] = attachmentPoint.z;
+                m_lraMaxDistance[slot] = constraint.GetGeodesicDistance() * (1 + constraint.GetMaxStretch());
+                m_lraCompliance[slot] = constraint.GetCompliance();
+                m_lraDamping[slot] = constraint.GetDamping();
+            }
+
+            for (uint32_t i = 0; i < range.collisionCount; ++i)
+            {
+                const SphereCollisionConstraint& constraint = cloth->m_CollisionConstraints[i];
+                const uint32_t slot = m_collisionColoring.slots[range.collisionOffset + i];
+
+                clothMatched = clothMatched && m_collisionParticle[slot] == getParticleIndex(constraint.SphereCollisionConstraint::GetParticles()[0]);
+
+                const dx::XMFLOAT3& center = constraint.GetSphereCenter();
+                m_collisionCenterX[slot] = center.x;
+                m_collisionCenterY[slot] = center.y;
+                m_collisionCenterZ[slot] = center.z;
+                m_collisionRadius[slot] = constraint.GetSphereRadius();
+                m_collisionCompliance[slot] = constraint.GetCompliance();
+                m_collisionDamping[slot] = constraint.GetDamping();
+            }
+
+            if (!clothMatched)
+            {
+                matched = false;
+            }
+        }
+    });
+
+    return matched;
+}
+
+void ClothBatchSolver::Scatter()
+{
+    // 每块布料在一个工作线程上写回粒子并计算法线，法线计算内部的并行在SerialTaskScope中顺序执行
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)m_ranges.size(), 1, [this](uint32_t begin, uint32_t end)
+    {
+        SerialTaskScope serialScope;
+        for (uint32_t c = begin; c < end; ++c)
+        {
+            const ClothRange& range = m_ranges[c];
+            std::vector<Particle>& particles = range.cloth->m_particles;
+
+            for (uint32_t i = 0; i < range.particleCount; ++i)
+            {
+                Particle& particle = particles[i];
+                const uint32_t p = range.particleOffset + i;
+
+                if (!particle.isStatic)
+                {
+                    particle.position = dx::XMFLOAT3(m_positionX[p], m_positionY[p], m_positionZ[p]);
+                    particle.positionInitial = dx::XMFLOAT3(m_initialPositionX[p], m_initialPositionY[p], m_initialPositionZ[p]);
+                    particle.oldPosition = dx::XMFLOAT3(m_oldPositionX[p], m_oldPositionY[p], m_oldPositionZ[p]);
+                    particle.predPosition = dx::XMFLOAT3(m_predPositionX[p], m_predPositionY[p], m_predPositionZ[p]);
+                    particle.velocity = dx::XMFLOAT3(m_velocityX[p], m_velocityY[p], m_velocityZ[p]);
+                    particle.ResetForce();
+                }
+            }
+
+            // 更新位置、法线和交错的顶点数据
+            range.cloth->ComputeNormals();
+
+            UpdateStats(range);
+        }
+    });
+}
+
+void ClothBatchSolver::UpdateStats(const ClothRange& range)
+{
+    ClothSolverStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    // 没有残差提前结束，每个子步都执行全部迭代
+    stats.iterationCount = m_subIteratorCount * m_iteratorCount;
+    stats.iterationBudget = stats.iterationCount;
+    stats.converged = false;
+
+    ReduceResidual(m_distanceErrors, m_distanceColoring, range.distanceOffset, range.distanceCount,
+        [this](uint32_t k) { return m_inverseMass[m_distanceParticle1[k]] > 0.0f || m_inverseMass[m_distanceParticle2[k]] > 0.0f; }, stats.distance);
+    ReduceResidual(m_lraErrors, m_lraColoring, range.lraOffset, range.lraCount,
+        [this](uint32_t k) { return m_inverseMass[m_lraParticle[k]] > 0.0f; }, stats.lra);
+    ReduceResidual(m_collisionErrors, m_collisionColoring, range.collisionOffset, range.collisionCount,
+        [this](uint32_t k) { return m_inverseMass[m_collisionParticle[k]] > 0.0f; }, stats.collision);
+
+    // 汇总所有约束的残差
+    const ClothConstraintResidual* residuals[] = { &stats.distance, &stats.lra, &stats.collision };
+    double sumSquares = 0.0;
+    uint32_t constraintCount = 0;
+
+    for (const ClothConstraintResidual* residual : residuals)
+    {
+        stats.maxError = (std::max)(stats.maxError, residual->maxError);
+        sumSquares += (double)residual->rmsError * residual->rmsError * residual->constraintCount;
+        constraintCount += residual->constraintCount;
+    }
+    stats.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+
+    // IsSupported保证打包的布料使用XPBD求解器
+    static_cast<XPBDSolver*>(range.cloth->m_solver)->SetStats(stats);
+}
+
+template<typename IsActiveFunc>
+void ClothBatchSolver::ReduceResidual(const std::vector<float>& errors, const PackedColoring& coloring, uint32_t offset, uint32_t count,
+    IsActiveFunc isActive, ClothConstraintResidual& residual) const
+{
+    float maxError = 0.0f;
+    double sumSquares = 0.0;
+    uint32_t activeCount = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t k = coloring.slots[offset + i];
+        if (!isActive(k))
+        {
+            continue;
+        }
+
+        maxError = (std::max)(maxError, errors[k]);
+        sumSquares += (double)errors[k] * errors[k];
+        activeCount++;
+    }
+
+    residual.constraintCount = activeCount;
+    residual.maxError = maxError;
+    residual.rmsError = activeCount > 0 ? (float)std::sqrt(sumSquares / activeCount) : 0.0f;
+}
+
+void ClothBatchSolver::PredictPositions(float deltaTime)
+{
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)m_inverseMass.size(), kParticleGrainSize, [this, deltaTime, halfDeltaTimeSquared](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (m_inverseMass[i] > 0.0f)
+            {
+                // 保存当前位置作为旧位置
+                m_oldPositionX[i] = m_positionX[i];
+                m_oldPositionY[i] = m_positionY[i];
+                m_oldPositionZ[i] = m_positionZ[i];
+
+                // 预测新位置（使用显式欧拉积分），同时作为迭代的初始位置
+                m_positionX[i] = m_positionX[i] + m_velocityX[i] * deltaTime + m_accelerationX[i] * halfDeltaTimeSquared;
+                m_positionY[i] = m_positionY[i] + m_velocityY[i] * deltaTime + m_accelerationY[i] * halfDeltaTimeSquared;
+                m_positionZ[i] = m_positionZ[i] + m_velocityZ[i] * deltaTime + m_accelerationZ[i] * halfDeltaTimeSquared;
+
+                m_predPositionX[i] = m_positionX[i];
+                m_predPositionY[i] = m_positionY[i];
+                m_predPositionZ[i] = m_positionZ[i];
+            }
+        }
+    });
+}
+
+template<typename SolveRangeFunc>
+void ClothBatchSolver::SolveColored(const PackedColoring& coloring, SolveRangeFunc solve)
+{
+    const uint32_t colorCount = (uint32_t)coloring.colorOffsets.size() - 1;
+
+    for (uint32_t color = 0; color < colorCount; ++color)
+    {
+        const uint32_t begin = coloring.colorOffsets[color];
+        const uint32_t end = coloring.colorOffsets[color + 1];
+
+        if (coloring.lastColorSerial && color == colorCount - 1)
+        {
+            // 着色失败的约束之间可能共享粒子，串行求解
+            solve(begin, end);
+        }
+        else
+        {
+            TaskScheduler::Get().ParallelFor(begin, end, kConstraintGrainSize, solve);
+        }
+    }
+}
+
+void ClothBatchSolver::SolveDistanceConstraints(uint32_t begin, uint32_t end, float deltaTime)
+{
+    const SolverReal dt = (SolverReal)deltaTime;
+    const SolverReal overRelaxationFactor = (SolverReal)m_overRelaxationFactor;
+
+    for (uint32_t k = begin; k < end; ++k)
+    {
+        const uint32_t i1 = m_distanceParticle1[k];
+        const uint32_t i2 = m_distanceParticle2[k];
+
+        // 计算约束值和梯度，两个粒子重合时使用任意方向
+        const float dx = m_positionX[i1] - m_positionX[i2];
+        const float dy = m_positionY[i1] - m_positionY[i2];
+        const float dz = m_positionZ[i1] - m_positionZ[i2];
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        float nx = 1.0f;
+        float ny = 0.0f;
+        float nz = 0.0f;
+        if (distance > 0.0f)
+        {
+            const float inverseDistance = 1.0f / distance;
+            nx = dx * inverseDistance;
+            ny = dy * inverseDistance;
+            nz = dz * inverseDistance;
+        }
+
+        const float C = distance - m_distanceRestLength[k];
+
+        if (std::abs(C) < SolverPrecision::kNegligibleError)
+        {
+            if (m_recordErrors)
+            {
+                m_distanceErrors[k] = std::abs(C);
+            }
+            continue;
+        }
+
+        // 静态粒子的质量倒数为0且位置等于预测位置，对分母项和阻尼项都没有贡献
+        const float w1 = m_inverseMass[i1];
+        const float w2 = m_inverseMass[i2];
+        const float gradientLengthSquared = nx * nx + ny * ny + nz * nz;
+
+        SolverReal sum = (SolverReal)gradientLengthSquared * (SolverReal)w1 + (SolverReal)gradientLengthSquared * (SolverReal)w2;
+        SolverReal delta_pos_total =
+            (SolverReal)(nx * (m_positionX[i1] - m_predPositionX[i1]) + ny * (m_positionY[i1] - m_predPositionY[i1]) + nz * (m_positionZ[i1] - m_predPositionZ[i1]))
+            - (SolverReal)(nx * (m_positionX[i2] - m_predPositionX[i2]) + ny * (m_positionY[i2] - m_predPositionY[i2]) + nz * (m_positionZ[i2] - m_predPositionZ[i2]));
+
+        // 添加柔度项和阻尼项
+        SolverReal alpha_tilde = (SolverReal)m_distanceCompliance[k] / (dt * dt);
+        if (alpha_tilde > SolverPrecision::kMaxAlphaTilde)
+        {
+            alpha_tilde = SolverPrecision::kMaxAlphaTilde;
+        }
+
+        const SolverReal gamma = (SolverReal)m_distanceDamping[k] * dt;
+        sum = (1 + gamma) * sum + alpha_tilde;
+
+        // 防止除零
+        if (sum < SolverPrecision::kMinDenominator)
+        {
+            sum = SolverPrecision::kMinDenominator;
+        }
+
+        SolverReal& lambda = m_distanceLambdas[k];
+        if (m_recordErrors)
+        {
+            m_distanceErrors[k] = (float)std::abs((SolverReal)C + alpha_tilde * lambda);
+        }
+
+        const SolverReal deltaLambda = ((-(SolverReal)C - alpha_tilde * lambda - gamma * delta_pos_total) / sum) * overRelaxationFactor;
+
+        // 应用位置校正，第二个粒子的梯度方向相反
+        const float correction1 = (float)(deltaLambda * (SolverReal)w1);
+        const float correction2 = (float)(deltaLambda * (SolverReal)w2);
+
+        if (!std::isnan(correction1) && !std::isnan(correction2))
+        {
+            m_positionX[i1] += nx * correction1;
+            m_positionY[i1] += ny * correction1;
+            m_positionZ[i1] += nz * correction1;
+            m_positionX[i2] -= nx * correction2;
+            m_positionY[i2] -= ny * correction2;
+            m_positionZ[i2] -= nz * correction2;
+        }
+
+        lambda += deltaLambda;
+    }
+}
+
+void ClothBatchSolver::SolveLRAConstraints(uint32_t begin, uint32_t end, float deltaTime)
+{
+    for (uint32_t k = begin; k < end; ++k)
+    {
+        const uint32_t i = m_lraParticle[k];
+
+        // 静态粒子不受LRA约束
+        if (m_inverseMass[i] <= 0.0f)
+        {
+            if (m_recordErrors)
+            {
+                m_lraErrors[k] = 0.0f;
+            }
+            continue;
+        }
+
+        // 只限制超过最大距离的拉伸
+        const float dx = m_positionX[i] - m_lraAttachmentX[k];
+        const float dy = m_positionY[i] - m_lraAttachmentY[k];
+        const float dz = m_positionZ[i] - m_lraAttachmentZ[k];
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float C = distance - m_lraMaxDistance[k];
+
+        if (C <= 0.0f)
+        {
+            if (m_recordErrors)
+            {
+                m_lraErrors[k] = 0.0f;
+            }
+            continue;
+        }
+
+        float nx = 0.0f;
+        float ny = 1.0f;
+        float nz = 0.0f;
+        if (distance > 1e-9f)
+        {
+            const float inverseDistance = 1.0f / distance;
+            nx = dx * inverseDistance;
+            ny = dy * inverseDistance;
+            nz = dz * inverseDistance;
+        }
+
+        const float error = ApplySingleParticleCorrection(i, C, nx, ny, nz, m_lraCompliance[k], m_lraDamping[k], m_lraLambdas[k], deltaTime);
+        if (m_recordErrors)
+        {
+            m_lraErrors[k] = error;
+        }
+    }
+}
+
+void ClothBatchSolver::SolveCollisionConstraints(uint32_t begin, uint32_t end, float deltaTime)
+{
+    for (uint32_t k = begin; k < end; ++k)
+    {
+        const uint32_t i = m_collisionParticle[k];
+
+        if (m_inverseMass[i] <= 0.0f)
+        {
+            if (m_recordErrors)
+            {
+                m_collisionErrors[k] = 0.0f;
+            }
+            continue;
+        }
+
+        // 只在粒子进入球体时把粒子推到球面上
+        const float dx = m_positionX[i] - m_collisionCenterX[k];
+        const float dy = m_positionY[i] - m_collisionCenterY[k];
+        const float dz = m_positionZ[i] - m_collisionCenterZ[k];
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        if (distance > m_collisionRadius[k] || distance <= 1e-6f)
+        {
+            if (m_recordErrors)
+            {
+                m_collisionErrors[k] = 0.0f;
+            }
+            continue;
+        }
+
+        const float inverseDistance = 1.0f / distance;
+        const float error = ApplySingleParticleCorrection(i, distance - m_collisionRadius[k], dx * inverseDistance, dy * inverseDistance, dz * inverseDistance,
+            m_collisionCompliance[k], m_collisionDamping[k], m_collisionLambdas[k], deltaTime);
+        if (m_recordErrors)
+        {
+            m_collisionErrors[k] = error;
+        }
+    }
+}
+
+float ClothBatchSolver::ApplySingleParticleCorrection(uint32_t particle, float C, float nx, float ny, float nz,
+    float compliance, float damping, SolverReal& lambda, float deltaTime)
+{
+    if (std::abs(C) < SolverPrecision::kNegligibleError)
+    {
+        return std::abs(C);
+    }
+
+    const SolverReal dt = (SolverReal)deltaTime;
+    const float w = m_inverseMass[particle];
+
+    SolverReal sum = (SolverReal)(nx * nx + ny * ny + nz * nz) * (SolverReal)w;
+    const SolverReal delta_pos_total = (SolverReal)(nx * (m_positionX[particle] - m_predPositionX[particle])
+        + ny * (m_positionY[particle] - m_predPositionY[particle])
+        + nz * (m_positionZ[particle] - m_predPositionZ[particle]));
+
+    SolverReal alpha_tilde = (SolverReal)compliance / (dt * dt);
+    if (alpha_tilde > SolverPrecision::kMaxAlphaTilde)
+    {
+        alpha_tilde = SolverPrecision::kMaxAlphaTilde;
+    }
+
+    const SolverReal gamma = (SolverReal)damping * dt;
+    sum = (1 + gamma) * sum + alpha_tilde;
+
+    if (sum < SolverPrecision::kMinDenominator)
+    {
+        sum = SolverPrecision::kMinDenominator;
+    }
+
+    const float error = (float)std::abs((SolverReal)C + alpha_tilde * lambda);
+    const SolverReal deltaLambda = ((-(SolverReal)C - alpha_tilde * lambda - gamma * delta_pos_total) / sum) * (SolverReal)m_overRelaxationFactor;
+    const float correction = (float)(deltaLambda * (SolverReal)w);
+
+    if (!std::isnan(correction))
+    {
+        m_positionX[particle] += nx * correction;
+        m_positionY[particle] += ny * correction;
+        m_positionZ[particle] += nz * correction;
+    }
+
+    lambda += deltaLambda;
+
+    return error;
+}
+
+void ClothBatchSolver::UpdateVelocities(float deltaTime)
+{
+    const float inverseDeltaTime = 1.0f / deltaTime;
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)m_inverseMass.size(), kParticleGrainSize, [this, inverseDeltaTime](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (m_inverseMass[i] > 0.0f)
+            {
+                m_velocityX[i] = (m_positionX[i] - m_oldPositionX[i]) * inverseDeltaTime;
+                m_velocityY[i] = (m_positionY[i] - m_oldPositionY[i]) * inverseDeltaTime;
+                m_velocityZ[i] = (m_positionZ[i] - m_oldPositionZ[i]) * inverseDeltaTime;
+            }
+        }
+    });
+}
+
+void ClothBatchSolver::EndStep(float deltaTime)
+{
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)m_inverseMass.size(), kParticleGrainSize, [this, deltaTime](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (m_inverseMass[i] > 0.0f)
+            {
+                // 速度阻尼，让没有摩擦的布料最终能够静止下来
+                const float scale = (std::max)(0.0f, 1.0f - m_velocityDamping[i] * deltaTime) / deltaTime;
+
+                m_velocityX[i] = (m_positionX[i] - m_initialPositionX[i]) * scale;
+                m_velocityY[i] = (m_positionY[i] - m_initialPositionY[i]) * scale;
+                m_velocityZ[i] = (m_positionZ[i] - m_initialPositionZ[i]) * scale;
+            }
+        }
+    });
+}
@@ -0,0 +1,201 @@
+#ifndef CLOTH_BATCH_SOLVER_H
+#define CLOTH_BATCH_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "SolverPrecision.h"
+
+class Cloth;
+struct ClothConstraintResidual;
+
+// 多块小布料的打包求解器
+// 把一组布料的粒子和约束打包到共享的SoA数组中：粒子按布料连续存放，
+// 每类约束在每块布料内部贪心着色后，所有布料的同一种颜色连续存放，
+// 因此每种颜色是一段跨越所有布料、互不冲突的约束，用同一个求解内核并行处理。
+// 每帧开始时从布料收集粒子状态和约束参数，结束时把粒子状态写回每块布料并重新计算顶点数据（m_vertexData）。
+//
+// 与XPBDSolver的区别：
+//   只支持距离约束、LRA约束和球面碰撞约束（IsSupported检查）
+//   每个子步固定迭代iteratorCount次，没有残差提前结束；拉格朗日乘子每个子步清零（冷启动）
+//   不使用休眠，打包求解的布料在收集时唤醒
+// 每块布料的求解统计（Cloth::GetSolverStats）由打包求解填写：迭代次数为固定的iteratorCount乘以子步数，
+// 残差取最后一个子步最后一次迭代，各阶段耗时为0（打包求解的耗时不能按布料拆分）
+// 因此结果与逐块更新不逐位一致，但每帧的结果与线程数无关
+class ClothBatchSolver
+{
+public:
+    ClothBatchSolver();
+
+    // 布料是否可以打包求解：XPBD求解器的迭代模式、距离约束迭代求解、不使用多层级、Chebyshev加速和热启动，
+    // 没有二面角和等距弯曲约束，不在录制或回放帧缓存，且粒子数不超过批量更新的上限
+    static bool IsSupported(const Cloth* cloth);
+
+    // 两块布料是否可以打包在一起：迭代次数、子步数和超松弛系数相同
+    static bool IsCompatible(const Cloth* cloth, const Cloth* other);
+
+    // 模拟所有布料一帧
+    // 参数：
+    //   cloths - 要模拟的布料，必须都满足IsSupported，且两两满足IsCompatible
+    //   deltaTime - 时间步长
+    // 布料集合、粒子数或约束变化时重新打包；打包失败时逐块调用Cloth::Update
+    void Step(const std::vector<Cloth*>& cloths, float deltaTime);
+
+    // 释放打包数据，下次Step时重新打包
+    void Clear();
+
+    // 获取当前打包的布料数
+    uint32_t GetClothCount() const
+    {
+        return (uint32_t)m_cloths.size();
+    }
+
+    // 获取当前打包的粒子数
+    uint32_t GetParticleCount() const
+    {
+        return (uint32_t)m_inverseMass.size();
+    }
+
+private:
+    // 一块布料在打包数组中的范围
+    struct ClothRange
+    {
+        Cloth* cloth;
+        uint32_t particleOffset;        // 第一个粒子在粒子数组中的位置
+        uint32_t particleCount;
+        uint32_t distanceOffset;        // 第一个距离约束在m_distanceColoring.slots中的位置
+        uint32_t distanceCount;
+        uint32_t lraOffset;             // 第一个LRA约束在m_lraColoring.slots中的位置
+        uint32_t lraCount;
+        uint32_t collisionOffset;       // 第一个碰撞约束在m_collisionColoring.slots中的位置
+        uint32_t collisionCount;
+    };
+
+    // 一类约束的打包着色
+    struct PackedColoring
+    {
+        std::vector<uint32_t> slots;        // 按布料顺序排列的约束在打包数组中的位置
+        std::vector<uint32_t> colorOffsets; // 每种颜色在打包数组中的起始位置，末尾额外存放约束总数
+        bool lastColorSerial;               // 最后一种颜色是否为着色失败的约束，需要串行求解
+    };
+
+    // 布料集合、粒子数或约束数是否与打包时不同
+    bool NeedsRebuild(const std::vector<Cloth*>& cloths) const;
+
+    // 按布料顺序分配粒子和约束的位置，对约束着色并生成打包数组中的粒子索引
+    // 返回：是否成功（约束引用了布料之外的粒子时失败）
+    bool Build(const std::vector<Cloth*>& cloths);
+
+    // 对按布料顺序排列的约束着色，并按颜色分配打包数组中的位置
+    // 参数：
+    //   particles - 每个约束的arity个粒子索引（全局索引），按布料顺序排列
+    //   arity - 每个约束的粒子数
+    //   getRange - 按布料返回约束在particles中的[起始, 数量]
+    //   coloring - 输出着色结果
+    template<typename GetRangeFunc>
+    void BuildPackedColoring(const std::vector<uint32_t>& particles, uint32_t arity, GetRangeFunc getRange, PackedColoring& coloring);
+
+    // 从布料收集粒子状态和约束参数，同时检查约束引用的粒子是否与打包时相同
+    // 返回：约束引用的粒子是否都与打包时相同
+    bool Gather();
+
+    // 把粒子状态写回布料，并重新计算布料的顶点数据和求解统计
+    void Scatter();
+
+    // 用最后一次迭代记录的残差填写一块布料的求解统计
+    void UpdateStats(const ClothRange& range);
+
+    // 汇总一块布料的一类约束的残差，与XPBDSolver相同，所有粒子都固定的约束不计入
+    // 参数：
+    //   errors - 每个约束的残差（按颜色排列）
+    //   coloring - 约束的打包着色
+    //   offset, count - 布料的约束在coloring.slots中的范围
+    //   isActive - 打包数组中的约束是否有可移动的粒子
+    //   residual - 输出残差
+    template<typename IsActiveFunc>
+    void ReduceResidual(const std::vector<float>& errors, const PackedColoring& coloring, uint32_t offset, uint32_t count,
+        IsActiveFunc isActive, ClothConstraintResidual& residual) const;
+
+    // 预测粒子位置（包含重力）
+    void PredictPositions(float deltaTime);
+
+    // 按颜色求解一类约束，颜色之间串行，颜色内部并行
+    // 参数：
+    //   coloring - 约束的打包着色
+    //   solve - 求解[begin, end)范围内的约束
+    template<typename SolveRangeFunc>
+    void SolveColored(const PackedColoring& coloring, SolveRangeFunc solve);
+
+    // 求解三类约束，公式与XPBDSolver::SolveConstraintN相同
+    void SolveDistanceConstraints(uint32_t begin, uint32_t end, float deltaTime);
+    void SolveLRAConstraints(uint32_t begin, uint32_t end, float deltaTime);
+    void SolveCollisionConstraints(uint32_t begin, uint32_t end, float deltaTime);
+
+    // 对单个粒子应用沿单位梯度方向的乘子增量（LRA和碰撞约束共用）
+    // 参数：
+    //   particle - 粒子索引
+    //   C - 约束值
+    //   nx, ny, nz - 单位梯度
+    //   compliance, damping - 约束的柔度和阻尼系数
+    //   lambda - 约束的拉格朗日乘子
+    //   deltaTime - 子步时间步长
+    // 返回：约束残差（应用增量前的|C + α̃λ|）
+    float ApplySingleParticleCorrection(uint32_t particle, float C, float nx, float ny, float nz,
+        float compliance, float damping, SolverReal& lambda, float deltaTime);
+
+    // 根据子步内的位移更新速度
+    void UpdateVelocities(float deltaTime);
+
+    // 用整帧的位移和速度阻尼计算帧末速度
+    void EndStep(float deltaTime);
+
+private:
+    std::vector<Cloth*> m_cloths;
+    std::vector<ClothRange> m_ranges;
+
+    // 打包时的迭代参数（所有布料相同）
+    uint32_t m_iteratorCount;
+    uint32_t m_subIteratorCount;
+    float m_overRelaxationFactor;
+
+    // 求解内核是否记录残差，只在最后一个子步的最后一次迭代中记录
+    bool m_recordErrors;
+
+    // 粒子（SoA），静态粒子的质量倒数为0
+    std::vector<float> m_positionX, m_positionY, m_positionZ;
+    std::vector<float> m_predPositionX, m_predPositionY, m_predPositionZ;
+    std::vector<float> m_oldPositionX, m_oldPositionY, m_oldPositionZ;
+    std::vector<float> m_initialPositionX, m_initialPositionY, m_initialPositionZ;
+    std::vector<float> m_velocityX, m_velocityY, m_velocityZ;
+    std::vector<float> m_accelerationX, m_accelerationY, m_accelerationZ; // 重力产生的加速度（重力乘以质量倒数）
+    std::vector<float> m_velocityDamping;  // 所属布料的速度阻尼
+    std::vector<float> m_inverseMass;
+
+    // 距离约束（SoA，按颜色排列）
+    PackedColoring m_distanceColoring;
+    std::vector<uint32_t> m_distanceParticle1, m_distanceParticle2;
+    std::vector<float> m_distanceRestLength;
+    std::vector<float> m_distanceCompliance, m_distanceDamping;
+    std::vector<SolverReal> m_distanceLambdas;
+    std::vector<float> m_distanceErrors;
+
+    // LRA约束（SoA，按颜色排列），maxDistance为测地线距离乘以(1 + 最大拉伸量)
+    PackedColoring m_lraColoring;
+    std::vector<uint32_t> m_lraParticle;
+    std::vector<float> m_lraAttachmentX, m_lraAttachmentY, m_lraAttachmentZ;
+    std::vector<float> m_lraMaxDistance;
+    std::vector<float> m_lraCompliance, m_lraDamping;
+    std::vector<SolverReal> m_lraLambdas;
+    std::vector<float> m_lraErrors;
+
+    // 球面碰撞约束（SoA，按颜色排列）
+    PackedColoring m_collisionColoring;
+    std::vector<uint32_t> m_collisionParticle;
+    std::vector<float> m_collisionCenterX, m_collisionCenterY, m_collisionCenterZ;
+    std::vector<float> m_collisionRadius;
+    std::vector<float> m_collisionCompliance, m_collisionDamping;
+    std::vector<SolverReal> m_collisionLambdas;
+    std::vector<float> m_collisionErrors;
+};
+
+#endif // CLOTH_BATCH_SOLVER_H
@@ -0,0 +1,160 @@
+#include "ClothCheckpoint.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+extern void logDebug(const std::string& message);
+
+bool ClothCheckpoint::Read(const char* data, size_t size, size_t& position, void* destination, size_t count)
+{
+    if (count > size - position)
+    {
+        return false;
+    }
+
+    memcpy(destination, data + position, count);
+    position += count;
+    return true;
+}
+
+uint64_t ClothCheckpoint::ComputeChecksum(const char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= (uint8_t)data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ClothCheckpoint::WriteFile(const std::string& path, const std::vector<char>& data, std::string& error)
+{
+    const std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            error = "failed to create " + temporaryPath;
+            return false;
+        }
+
+        file.write(data.data(), data.size());
+        file.flush();
+        if (!file)
+        {
+            error = "failed to write " + temporaryPath;
+            return false;
+        }
+    }
+
+    // 完整写入后才替换目标文件
+#ifdef _WIN32
+    if (!MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+#else
+    // POSIX的rename在同一文件系统内原子地替换已存在的目标文件
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+#endif
+    {
+        error = "failed to replace " + path;
+        return false;
+    }
+
+    return true;
+}
+
+bool ClothCheckpoint::ReadFile(const std::string& path, std::vector<char>& data)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        logDebug("ClothCheckpoint::ReadFile: failed to open " + path);
+        return false;
+    }
+
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    data.resize((size_t)size);
+    file.read(data.data(), size);
+
+    if (!file)
+    {
+        logDebug("ClothCheckpoint::ReadFile: failed to read " + path);
+        return false;
+    }
+
+    return true;
+}
+
+ClothCheckpointWriter::ClothCheckpointWriter()
+    : m_busy(false)
+    , m_succeeded(true)
+    , m_writeMilliseconds(0.0)
+{
+}
+
+ClothCheckpointWriter::~ClothCheckpointWriter()
+{
+    Wait();
+}
+
+bool ClothCheckpointWriter::WriteAsync(const std::string& path, std::vector<char>&& data)
+{
+    if (m_busy.load())
+    {
+        logDebug("ClothCheckpointWriter: previous checkpoint is still being written, skipping " + path);
+        return false;
+    }
+
+    // 上一次写入已经结束，回收线程并输出结果
+    Wait();
+
+    m_path = path;
+    m_data = std::move(data);
+    m_error.clear();
+    m_busy.store(true);
+
+    // 日志文件不是线程安全的，后台线程只记录结果
+    m_thread = std::thread([this]()
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_succeeded = ClothCheckpoint::WriteFile(m_path, m_data, m_error);
+        auto end = std::chrono::steady_clock::now();
+
+        m_writeMilliseconds = std::chrono::duration<double>(end - start).count() * 1000.0;
+        m_busy.store(false);
+    });
+
+    return true;
+}
+
+bool ClothCheckpointWriter::Wait()
+{
+    if (!m_thread.joinable())
+    {
+        return m_succeeded;
+    }
+
+    m_thread.join();
+
+    if (m_succeeded)
+    {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "ClothCheckpointWriter: %.1f KB written to %s in %.2f ms"
+            , m_data.size() / 1024.0
+            , m_path.c_str()
+            , m_writeMilliseconds);
+        logDebug(buffer);
+    }
+    else
+    {
+        logDebug("ClothCheckpointWriter: " + m_error);
+    }
+
+    return m_succeeded;
+}
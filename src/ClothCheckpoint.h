@@ -0,0 +1,113 @@
+#ifndef CLOTH_CHECKPOINT_H
+#define CLOTH_CHECKPOINT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 模拟状态检查点
+// 数据布局：ClothCheckpointHeader，之后是负载：
+//   粒子数组（按Particle的内存布局原样保存）
+//   距离、LRA、二面角、等距弯曲、碰撞约束的静止参数（每个约束GetRestParameterCount()个float）
+//   求解器状态（IClothSolver::SaveState的数据）
+// 恢复时按原样写回，继续模拟的结果与不中断时逐位一致
+
+// 检查点格式版本，格式不兼容时递增
+static const uint32_t kClothCheckpointVersion = 1;
+
+// 检查点文件标识
+static const char kClothCheckpointMagic[8] = "CLCHKPT";
+
+// 检查点中的约束类型数
+static const uint32_t kClothCheckpointConstraintFamilyCount = 5;
+
+// 检查点文件头
+struct ClothCheckpointHeader
+{
+    char magic[8];              // "CLCHKPT"
+    uint32_t version;           // kClothCheckpointVersion
+    uint32_t particleSize;      // sizeof(Particle)，编译选项（例如DEBUG_SOLVER）不同时不能恢复
+    uint32_t solverRealSize;    // sizeof(SolverReal)，求解器精度不同时不能恢复拉格朗日乘子
+    uint32_t solverType;        // 保存时的ClothSolverType
+    uint32_t particleCount;     // 粒子数
+    uint32_t constraintCounts[kClothCheckpointConstraintFamilyCount]; // 每类约束的数量
+    uint64_t solverStateSize;   // 求解器状态的字节数
+    uint64_t payloadSize;       // 文件头之后的字节数
+    uint64_t checksum;          // 负载的FNV-1a校验和，用于发现写入中断的文件
+};
+
+// 检查点读写的辅助函数
+class ClothCheckpoint
+{
+public:
+    // 追加原始字节
+    static void Append(std::vector<char>& data, const void* source, size_t size)
+    {
+        data.insert(data.end(), (const char*)source, (const char*)source + size);
+    }
+
+    // 按顺序读取原始字节，越界时返回false
+    // 参数：
+    //   data - 数据
+    //   size - 数据的字节数
+    //   position - 读取位置，成功后前进
+    //   destination - 输出
+    //   count - 读取的字节数
+    static bool Read(const char* data, size_t size, size_t& position, void* destination, size_t count);
+
+    // 计算FNV-1a校验和
+    static uint64_t ComputeChecksum(const char* data, size_t size);
+
+    // 写入检查点文件：先写临时文件，完整写入后再替换目标文件，写入中断时保留上一个检查点
+    // 不输出日志，可以在后台线程调用
+    // 参数：
+    //   path - 文件路径
+    //   data - 检查点数据
+    //   error - 失败时输出错误信息
+    // 返回：是否成功
+    static bool WriteFile(const std::string& path, const std::vector<char>& data, std::string& error);
+
+    // 读取检查点文件
+    // 返回：是否成功
+    static bool ReadFile(const std::string& path, std::vector<char>& data);
+};
+
+// 检查点后台写入器：模拟线程只复制状态，文件写入在后台线程完成，不阻塞求解器
+// 写入结果在下一次WriteAsync或Wait时由调用线程输出到日志
+class ClothCheckpointWriter
+{
+public:
+    ClothCheckpointWriter();
+    ~ClothCheckpointWriter();
+
+    // 在后台线程写入检查点，上一次写入未完成时跳过本次，不等待
+    // 参数：
+    //   path - 文件路径
+    //   data - 检查点数据，写入器接管
+    // 返回：是否开始写入
+    bool WriteAsync(const std::string& path, std::vector<char>&& data);
+
+    // 等待当前写入完成并输出写入结果
+    // 返回：最近一次写入是否成功
+    bool Wait();
+
+    // 是否正在写入
+    bool IsBusy() const
+    {
+        return m_busy.load();
+    }
+
+private:
+    std::thread m_thread;
+    std::string m_path;
+    std::vector<char> m_data;
+    std::atomic<bool> m_busy;
+    bool m_succeeded;           // 最近一次写入是否成功
+    std::string m_error;        // 最近一次写入的错误信息
+    double m_writeMilliseconds; // 最近一次写入的耗时
+};
+
+#endif // CLOTH_CHECKPOINT_H
@@ -0,0 +1,531 @@
+#include "ClothFrameCache.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+extern void logDebug(const std::string& message);
+
+namespace
+{
+    const char kClothFrameCacheMagic[8] = "CLCACHE";
+
+    // 读取器的解码器没有解码过任何帧
+    const uint32_t kNoDecodedFrame = 0xffffffff;
+
+    // Quantized16格式每个顶点的数据
+    struct QuantizedVertex
+    {
+        uint16_t position[3];
+        int16_t normal[3];
+    };
+
+    // 一帧数据的字节数（不含对齐填充），压缩格式为最大字节数
+    uint64_t GetFrameSize(ClothFrameCacheFormat format, uint32_t vertexCount)
+    {
+        switch (format)
+        {
+        case ClothFrameCacheFormat::Float32:
+            return (uint64_t)vertexCount * 6 * sizeof(float);
+        case ClothFrameCacheFormat::Quantized16:
+            return sizeof(ClothFrameCacheQuantizedFrameHeader) + (uint64_t)vertexCount * sizeof(QuantizedVertex);
+        case ClothFrameCacheFormat::CompressedNormal16:
+        case ClothFrameCacheFormat::CompressedNormal8:
+            // 3个位置分量和2个法线分量，每个分量2字节
+            return sizeof(ClothFrameCodecHeader) + ClothFrameCodec::GetMaxCompressedSize((uint64_t)vertexCount * 10);
+        default:
+            return 0;
+        }
+    }
+
+    bool IsCompressedFormat(ClothFrameCacheFormat format)
+    {
+        return format == ClothFrameCacheFormat::CompressedNormal16 || format == ClothFrameCacheFormat::CompressedNormal8;
+    }
+
+    // 创建压缩格式的编解码器，其他格式返回nullptr
+    ClothFrameCodec* CreateCodec(ClothFrameCacheFormat format, uint32_t vertexCount)
+    {
+        switch (format)
+        {
+        case ClothFrameCacheFormat::CompressedNormal16:
+            return new ClothFrameCodec(vertexCount, 16);
+        case ClothFrameCacheFormat::CompressedNormal8:
+            return new ClothFrameCodec(vertexCount, 8);
+        default:
+            return nullptr;
+        }
+    }
+
+    uint64_t AlignOffset(uint64_t offset)
+    {
+        return (offset + kClothFrameCacheAlignment - 1) / kClothFrameCacheAlignment * kClothFrameCacheAlignment;
+    }
+}
+
+ClothFrameCacheWriter::ClothFrameCacheWriter()
+    : m_position(0)
+    , m_codec(nullptr)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+ClothFrameCacheWriter::~ClothFrameCacheWriter()
+{
+    Close();
+}
+
+bool ClothFrameCacheWriter::Open(const std::string& path, ClothFrameCacheFormat format, uint32_t vertexCount, const std::vector<uint32_t>& indices)
+{
+    Close();
+
+    if (vertexCount == 0 || GetFrameSize(format, vertexCount) == 0)
+    {
+        logDebug("ClothFrameCacheWriter::Open: invalid format or vertex count");
+        return false;
+    }
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        logDebug("ClothFrameCacheWriter::Open: failed to create " + path);
+        return false;
+    }
+
+    m_path = path;
+    m_frames.clear();
+
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, kClothFrameCacheMagic, sizeof(m_header.magic));
+    m_header.version = kClothFrameCacheVersion;
+    m_header.format = (uint32_t)format;
+    m_header.vertexCount = vertexCount;
+    m_header.indexCount = (uint32_t)indices.size();
+    m_header.topologyOffset = AlignOffset(sizeof(ClothFrameCacheHeader));
+
+    // 文件头先占位，Close时回填帧数和帧表位置
+    m_file.write((const char*)&m_header, sizeof(m_header));
+    m_position = sizeof(m_header);
+    WritePadding();
+
+    m_file.write((const char*)indices.data(), indices.size() * sizeof(uint32_t));
+    m_position += indices.size() * sizeof(uint32_t);
+    WritePadding();
+
+    m_codec = CreateCodec(format, vertexCount);
+    if (!m_codec)
+    {
+        m_frameBuffer.resize((size_t)GetFrameSize(format, vertexCount));
+    }
+
+    return (bool)m_file;
+}
+
+bool ClothFrameCacheWriter::WriteFrame(const float* vertexData, float time)
+{
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+
+    const uint32_t vertexCount = m_header.vertexCount;
+    const char* frameData = (const char*)vertexData;
+
+    if (m_codec)
+    {
+        // 每隔kClothFrameCacheKeyFrameInterval帧编码一个关键帧，帧大小取决于压缩率
+        m_codec->EncodeFrame(vertexData, m_frames.size() % kClothFrameCacheKeyFrameInterval == 0, m_frameBuffer);
+        frameData = m_frameBuffer.data();
+    }
+    else if ((ClothFrameCacheFormat)m_header.format == ClothFrameCacheFormat::Quantized16)
+    {
+        // 每帧的包围盒
+        float boundsMin[3] = { vertexData[0], vertexData[1], vertexData[2] };
+        float boundsMax[3] = { vertexData[0], vertexData[1], vertexData[2] };
+        for (uint32_t v = 1; v < vertexCount; ++v)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                boundsMin[axis] = (std::min)(boundsMin[axis], vertexData[v * 6 + axis]);
+                boundsMax[axis] = (std::max)(boundsMax[axis], vertexData[v * 6 + axis]);
+            }
+        }
+
+        ClothFrameCacheQuantizedFrameHeader* frameHeader = (ClothFrameCacheQuantizedFrameHeader*)m_frameBuffer.data();
+        QuantizedVertex* vertices = (QuantizedVertex*)(m_frameBuffer.data() + sizeof(ClothFrameCacheQuantizedFrameHeader));
+
+        float scale[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            frameHeader->boundsMin[axis] = boundsMin[axis];
+            frameHeader->boundsExtent[axis] = boundsMax[axis] - boundsMin[axis];
+            scale[axis] = frameHeader->boundsExtent[axis] > 0.0f ? 65535.0f / frameHeader->boundsExtent[axis] : 0.0f;
+        }
+
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            const float* vertex = &vertexData[v * 6];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float position = (vertex[axis] - boundsMin[axis]) * scale[axis] + 0.5f;
+                float normal = (std::max)(-1.0f, (std::min)(1.0f, vertex[3 + axis]));
+
+                vertices[v].position[axis] = (uint16_t)(std::min)(position, 65535.0f);
+                vertices[v].normal[axis] = (int16_t)std::lround(normal * 32767.0f);
+            }
+        }
+
+        frameData = m_frameBuffer.data();
+    }
+
+    ClothFrameCacheFrameEntry entry;
+    entry.offset = m_position;
+    entry.size = (uint32_t)m_frameBuffer.size();
+    entry.time = time;
+
+    m_file.write(frameData, entry.size);
+    m_position += entry.size;
+    WritePadding();
+
+    if (!m_file)
+    {
+        logDebug("ClothFrameCacheWriter::WriteFrame: failed to write " + m_path);
+        return false;
+    }
+
+    m_frames.push_back(entry);
+    return true;
+}
+
+bool ClothFrameCacheWriter::Close()
+{
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+
+    m_header.frameCount = (uint32_t)m_frames.size();
+    m_header.frameTableOffset = m_position;
+
+    m_file.write((const char*)m_frames.data(), m_frames.size() * sizeof(ClothFrameCacheFrameEntry));
+    m_file.seekp(0);
+    m_file.write((const char*)&m_header, sizeof(m_header));
+
+    bool succeeded = (bool)m_file;
+    m_file.close();
+
+    delete m_codec;
+    m_codec = nullptr;
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "ClothFrameCacheWriter: %u frames, %u vertices, %.1f MB written to %s"
+        , m_header.frameCount
+        , m_header.vertexCount
+        , (m_position + m_frames.size() * sizeof(ClothFrameCacheFrameEntry)) / (1024.0 * 1024.0)
+        , m_path.c_str());
+    logDebug(buffer);
+
+    return succeeded;
+}
+
+void ClothFrameCacheWriter::WritePadding()
+{
+    static const char zeros[kClothFrameCacheAlignment] = {};
+
+    uint64_t aligned = AlignOffset(m_position);
+    m_file.write(zeros, (std::streamsize)(aligned - m_position));
+    m_position = aligned;
+}
+
+ClothFrameCacheReader::ClothFrameCacheReader()
+#ifdef _WIN32
+    : m_fileHandle(INVALID_HANDLE_VALUE)
+#else
+    : m_fileHandle(nullptr)
+#endif
+    , m_mappingHandle(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+    , m_frameTable(nullptr)
+    , m_codec(nullptr)
+    , m_codecFrame(kNoDecodedFrame)
+{
+}
+
+ClothFrameCacheReader::~ClothFrameCacheReader()
+{
+    Close();
+}
+
+bool ClothFrameCacheReader::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    // 回放时按帧随机访问，提示系统不做顺序预读
+    m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        logDebug("ClothFrameCacheReader::Open: failed to open " + path);
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_fileHandle, &fileSize) || (uint64_t)fileSize.QuadPart < sizeof(ClothFrameCacheHeader))
+    {
+        logDebug("ClothFrameCacheReader::Open: file is too small: " + path);
+        Close();
+        return false;
+    }
+    m_size = (uint64_t)fileSize.QuadPart;
+
+    m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle)
+    {
+        m_data = (const uint8_t*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        logDebug("ClothFrameCacheReader::Open: failed to open " + path);
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0 || (uint64_t)fileStat.st_size < sizeof(ClothFrameCacheHeader))
+    {
+        logDebug("ClothFrameCacheReader::Open: file is too small: " + path);
+        close(fileDescriptor);
+        return false;
+    }
+    m_size = (uint64_t)fileStat.st_size;
+
+    // 映射建立之后不再需要文件描述符；回放时按帧随机访问，提示系统不做顺序预读
+    void* mapping = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    if (mapping != MAP_FAILED)
+    {
+        madvise(mapping, (size_t)m_size, MADV_RANDOM);
+        m_data = (const uint8_t*)mapping;
+    }
+#endif
+
+    if (!m_data)
+    {
+        logDebug("ClothFrameCacheReader::Open: failed to map " + path);
+        Close();
+        return false;
+    }
+
+    // 检查文件头
+    m_header = (const ClothFrameCacheHeader*)m_data;
+    if (memcmp(m_header->magic, kClothFrameCacheMagic, sizeof(m_header->magic)) != 0 || m_header->version != kClothFrameCacheVersion)
+    {
+        logDebug("ClothFrameCacheReader::Open: not a version " + std::to_string(kClothFrameCacheVersion) + " frame cache: " + path);
+        Close();
+        return false;
+    }
+
+    const uint64_t frameSize = GetFrameSize((ClothFrameCacheFormat)m_header->format, m_header->vertexCount);
+    if (frameSize == 0 || m_header->topologyOffset + (uint64_t)m_header->indexCount * sizeof(uint32_t) > m_size)
+    {
+        logDebug("ClothFrameCacheReader::Open: invalid header in " + path);
+        Close();
+        return false;
+    }
+
+    if (m_header->frameCount == 0
+        || m_header->frameTableOffset + (uint64_t)m_header->frameCount * sizeof(ClothFrameCacheFrameEntry) > m_size)
+    {
+        logDebug("ClothFrameCacheReader::Open: no frames or recording was not finished: " + path);
+        Close();
+        return false;
+    }
+
+    // 检查三角形索引和帧表，回放时不再检查
+    const uint32_t* indices = GetIndices();
+    for (uint32_t i = 0; i < m_header->indexCount; ++i)
+    {
+        if (indices[i] >= m_header->vertexCount)
+        {
+            logDebug("ClothFrameCacheReader::Open: index out of range in " + path);
+            Close();
+            return false;
+        }
+    }
+
+    m_frameTable = (const ClothFrameCacheFrameEntry*)(m_data + m_header->frameTableOffset);
+    for (uint32_t frame = 0; frame < m_header->frameCount; ++frame)
+    {
+        // 压缩格式的帧大小可变，只检查不超过最大字节数
+        const ClothFrameCacheFrameEntry& entry = m_frameTable[frame];
+        const bool sizeValid = IsCompressedFormat(GetFormat())
+            ? entry.size >= sizeof(ClothFrameCodecHeader) && entry.size <= frameSize
+            : entry.size == frameSize;
+        if (!sizeValid || entry.offset % kClothFrameCacheAlignment != 0 || entry.offset + entry.size > m_size)
+        {
+            logDebug("ClothFrameCacheReader::Open: invalid frame " + std::to_string(frame) + " in " + path);
+            Close();
+            return false;
+        }
+    }
+
+    // 压缩格式从第0帧开始必须能解码
+    if (IsCompressedFormat(GetFormat()) && !ClothFrameCodec::IsKeyFrame(m_data + m_frameTable[0].offset, m_frameTable[0].size))
+    {
+        logDebug("ClothFrameCacheReader::Open: first frame is not a key frame in " + path);
+        Close();
+        return false;
+    }
+
+    m_codec = CreateCodec(GetFormat(), GetVertexCount());
+    m_codecFrame = kNoDecodedFrame;
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "ClothFrameCacheReader: %s, %u frames, %u vertices, %u indices, %.1f MB mapped"
+        , path.c_str()
+        , m_header->frameCount
+        , m_header->vertexCount
+        , m_header->indexCount
+        , m_size / (1024.0 * 1024.0));
+    logDebug(buffer);
+
+    return true;
+}
+
+void ClothFrameCacheReader::Close()
+{
+    delete m_codec;
+    m_codec = nullptr;
+    m_codecFrame = kNoDecodedFrame;
+
+#ifdef _WIN32
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mappingHandle)
+    {
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+    }
+
+    if (m_fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_fileHandle);
+        m_fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_data)
+    {
+        munmap((void*)m_data, (size_t)m_size);
+        m_data = nullptr;
+    }
+#endif
+
+    m_size = 0;
+    m_header = nullptr;
+    m_frameTable = nullptr;
+}
+
+const float* ClothFrameCacheReader::GetFrameVertexData(uint32_t frame) const
+{
+    if (GetFormat() != ClothFrameCacheFormat::Float32)
+    {
+        return nullptr;
+    }
+
+    return (const float*)(m_data + m_frameTable[frame].offset);
+}
+
+bool ClothFrameCacheReader::DecodeFrame(uint32_t frame, float* vertexData) const
+{
+    if (frame >= GetFrameCount())
+    {
+        return false;
+    }
+
+    const uint8_t* frameData = m_data + m_frameTable[frame].offset;
+    const uint32_t vertexCount = GetVertexCount();
+
+    switch (GetFormat())
+    {
+    case ClothFrameCacheFormat::Float32:
+        memcpy(vertexData, frameData, m_frameTable[frame].size);
+        return true;
+
+    case ClothFrameCacheFormat::Quantized16:
+    {
+        const ClothFrameCacheQuantizedFrameHeader* frameHeader = (const ClothFrameCacheQuantizedFrameHeader*)frameData;
+        const QuantizedVertex* vertices = (const QuantizedVertex*)(frameData + sizeof(ClothFrameCacheQuantizedFrameHeader));
+
+        float scale[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            scale[axis] = frameHeader->boundsExtent[axis] / 65535.0f;
+        }
+
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            float* vertex = &vertexData[v * 6];
+            float normal[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                vertex[axis] = frameHeader->boundsMin[axis] + vertices[v].position[axis] * scale[axis];
+                normal[axis] = vertices[v].normal[axis] / 32767.0f;
+            }
+
+            // 量化后长度略有偏差，重新归一化
+            float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+            vertex[3] = normal[0] * inverseLength;
+            vertex[4] = normal[1] * inverseLength;
+            vertex[5] = normal[2] * inverseLength;
+        }
+        return true;
+    }
+
+    case ClothFrameCacheFormat::CompressedNormal16:
+    case ClothFrameCacheFormat::CompressedNormal8:
+    {
+        // 不是紧接着上一次解码的帧时，从前一个关键帧开始解码，中间帧解码到输出缓冲区后被覆盖
+        if (m_codecFrame == kNoDecodedFrame || frame != m_codecFrame + 1)
+        {
+            uint32_t keyFrame = frame;
+            while (keyFrame > 0 && !ClothFrameCodec::IsKeyFrame(m_data + m_frameTable[keyFrame].offset, m_frameTable[keyFrame].size))
+            {
+                --keyFrame;
+            }
+
+            m_codec->Reset();
+            for (uint32_t k = keyFrame; k < frame; ++k)
+            {
+                if (!m_codec->DecodeFrame(m_data + m_frameTable[k].offset, m_frameTable[k].size, vertexData))
+                {
+                    m_codecFrame = kNoDecodedFrame;
+                    return false;
+                }
+            }
+        }
+
+        bool succeeded = m_codec->DecodeFrame(frameData, m_frameTable[frame].size, vertexData);
+        m_codecFrame = succeeded ? frame : kNoDecodedFrame;
+        return succeeded;
+    }
+
+    default:
+        return false;
+    }
+}
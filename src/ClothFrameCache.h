@@ -0,0 +1,195 @@
+#ifndef CLOTH_FRAME_CACHE_H
+#define CLOTH_FRAME_CACHE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ClothFrameCodec.h"
+
+// 布料帧缓存文件
+// 文件布局（小端，所有块按kClothFrameCacheAlignment对齐，映射后的指针可以直接上传）：
+//   ClothFrameCacheHeader
+//   拓扑块：indexCount个uint32三角形索引
+//   帧块：每帧一个，内容取决于格式
+//   帧表：frameCount个ClothFrameCacheFrameEntry，记录每帧的位置、大小和时间，写入结束时追加
+// 帧表和帧数在写入结束时回填到文件头，没有正常结束的文件frameCount为0，不能读取
+
+// 缓存文件格式版本，格式不兼容时递增
+static const uint32_t kClothFrameCacheVersion = 1;
+
+// 文件中每个块的对齐字节数
+static const uint32_t kClothFrameCacheAlignment = 64;
+
+// 压缩格式的关键帧间隔，随机访问时最多从前一个关键帧开始解码这么多帧
+static const uint32_t kClothFrameCacheKeyFrameInterval = 30;
+
+// 帧数据格式
+enum class ClothFrameCacheFormat : uint32_t
+{
+    Float32 = 0,        // 每个顶点6个float（位置+法线），与Cloth::OnUpdateMesh上传的交错顶点数据相同，回放时不需要解码
+    Quantized16 = 1,    // 每帧先存包围盒，位置在包围盒内量化为3个uint16，法线量化为3个snorm16，每个顶点12字节
+    CompressedNormal16 = 2, // ClothFrameCodec压缩：量化位置和八面体法线（2x16位）的帧间残差，字节平面+LZ77，帧大小可变
+    CompressedNormal8 = 3,  // 同CompressedNormal16，八面体法线为2x8位
+};
+
+// 文件头
+struct ClothFrameCacheHeader
+{
+    char magic[8];              // "CLCACHE"
+    uint32_t version;           // kClothFrameCacheVersion
+    uint32_t format;            // ClothFrameCacheFormat
+    uint32_t vertexCount;       // 每帧的顶点数
+    uint32_t indexCount;        // 三角形索引数
+    uint32_t frameCount;        // 帧数，写入结束时回填
+    uint32_t reserved0;
+    uint64_t topologyOffset;    // 拓扑块的位置
+    uint64_t frameTableOffset;  // 帧表的位置，写入结束时回填
+    uint64_t reserved1[2];
+};
+
+// 帧表的一项
+struct ClothFrameCacheFrameEntry
+{
+    uint64_t offset;            // 帧块的位置
+    uint32_t size;              // 帧块的字节数（不含对齐填充）
+    float time;                 // 帧的模拟时间（秒）
+};
+
+// Quantized16格式每帧的帧头，之后是每个顶点的量化位置和法线
+struct ClothFrameCacheQuantizedFrameHeader
+{
+    float boundsMin[3];         // 包围盒最小角
+    float boundsExtent[3];      // 包围盒大小
+};
+
+// 帧缓存写入器：模拟时每步之后追加一帧，只顺序写文件，内存中只保留帧表
+class ClothFrameCacheWriter
+{
+public:
+    ClothFrameCacheWriter();
+    ~ClothFrameCacheWriter();
+
+    // 创建文件并写入文件头和拓扑块
+    // 参数：
+    //   path - 文件路径
+    //   format - 帧数据格式
+    //   vertexCount - 每帧的顶点数
+    //   indices - 三角形索引
+    // 返回：是否成功
+    bool Open(const std::string& path, ClothFrameCacheFormat format, uint32_t vertexCount, const std::vector<uint32_t>& indices);
+
+    // 追加一帧
+    // 参数：
+    //   vertexData - 交错的顶点数据，每个顶点6个float（位置+法线）
+    //   time - 帧的模拟时间（秒）
+    // 返回：是否成功
+    bool WriteFrame(const float* vertexData, float time);
+
+    // 写入帧表并回填文件头，之后文件才能读取
+    // 返回：是否成功
+    bool Close();
+
+    // 是否已打开
+    bool IsOpen() const
+    {
+        return m_file.is_open();
+    }
+
+    // 已写入的帧数
+    uint32_t GetFrameCount() const
+    {
+        return (uint32_t)m_frames.size();
+    }
+
+private:
+    // 写入填充字节，使文件位置对齐到kClothFrameCacheAlignment
+    void WritePadding();
+
+    std::ofstream m_file;
+    std::string m_path;
+    ClothFrameCacheHeader m_header;
+    std::vector<ClothFrameCacheFrameEntry> m_frames;
+    std::vector<char> m_frameBuffer;    // 编码一帧的临时缓冲区
+    uint64_t m_position;                // 当前文件位置
+    ClothFrameCodec* m_codec;           // 压缩格式的编码器，其他格式为nullptr
+};
+
+// 帧缓存读取器：把文件映射到内存，按需由操作系统调入页面，不把整个文件读入内存
+// Float32格式的帧直接返回映射内存中的指针，任意帧都可以随机访问
+class ClothFrameCacheReader
+{
+public:
+    ClothFrameCacheReader();
+    ~ClothFrameCacheReader();
+
+    // 映射文件并检查文件头和帧表
+    // 参数：
+    //   path - 文件路径
+    // 返回：是否成功
+    bool Open(const std::string& path);
+
+    // 取消映射并关闭文件
+    void Close();
+
+    // 是否已打开
+    bool IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    ClothFrameCacheFormat GetFormat() const
+    {
+        return (ClothFrameCacheFormat)m_header->format;
+    }
+
+    uint32_t GetVertexCount() const
+    {
+        return m_header->vertexCount;
+    }
+
+    uint32_t GetIndexCount() const
+    {
+        return m_header->indexCount;
+    }
+
+    uint32_t GetFrameCount() const
+    {
+        return m_header->frameCount;
+    }
+
+    // 映射内存中的三角形索引
+    const uint32_t* GetIndices() const
+    {
+        return (const uint32_t*)(m_data + m_header->topologyOffset);
+    }
+
+    // 帧的模拟时间（秒）
+    float GetFrameTime(uint32_t frame) const
+    {
+        return m_frameTable[frame].time;
+    }
+
+    // 获取帧在映射内存中的交错顶点数据，只适用于Float32格式，其他格式返回nullptr
+    const float* GetFrameVertexData(uint32_t frame) const;
+
+    // 把任意格式的帧解码为交错顶点数据
+    // 压缩格式顺序解码时每帧只解码一次，随机访问时从前一个关键帧开始解码，解码状态保存在读取器中，不能多线程同时调用
+    // 参数：
+    //   frame - 帧序号
+    //   vertexData - 输出，至少GetVertexCount() * 6个float
+    // 返回：是否成功
+    bool DecodeFrame(uint32_t frame, float* vertexData) const;
+
+private:
+    void* m_fileHandle;                 // 文件句柄（Windows）
+    void* m_mappingHandle;              // 文件映射句柄（Windows）
+    const uint8_t* m_data;              // 映射的文件内容
+    uint64_t m_size;                    // 文件大小
+    const ClothFrameCacheHeader* m_header;
+    const ClothFrameCacheFrameEntry* m_frameTable;
+    ClothFrameCodec* m_codec;           // 压缩格式的解码器，其他格式为nullptr
+    mutable uint32_t m_codecFrame;      // 解码器上一次解码的帧，0xffffffff表示没有
+};
+
+#endif // CLOTH_FRAME_CACHE_H
@@ -0,0 +1,417 @@
+#include "ClothFrameCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // 每个顶点的分量数：3个位置分量和2个八面体法线分量，每个分量一个低字节平面和一个高字节平面
+    const uint32_t kComponentCount = 5;
+    const uint32_t kPlaneCount = kComponentCount * 2;
+
+    // LZ77参数
+    const uint32_t kLZHashBits = 14;
+    const uint32_t kLZMinMatch = 4;
+    const uint32_t kLZMaxOffset = 65535;
+    const uint32_t kLZInvalidPosition = 0xffffffff;
+
+    // 位置在包围盒内量化，编码器和解码器必须使用同一个函数计算预测值
+    uint16_t QuantizePosition(float value, float boundsMin, float scale)
+    {
+        float quantized = (value - boundsMin) * scale + 0.5f;
+        quantized = (std::max)(0.0f, (std::min)(quantized, 65535.0f));
+        return (uint16_t)quantized;
+    }
+
+    float DequantizePosition(uint16_t quantized, float boundsMin, float step)
+    {
+        return boundsMin + quantized * step;
+    }
+
+    // 有符号残差映射为无符号数，绝对值小的残差高字节为0
+    uint16_t ZigZagEncode(uint16_t value, uint16_t prediction)
+    {
+        int32_t residual = (int16_t)(uint16_t)(value - prediction);
+        return (uint16_t)(residual >= 0 ? residual * 2 : -residual * 2 - 1);
+    }
+
+    uint16_t ZigZagDecode(uint16_t encoded, uint16_t prediction)
+    {
+        int32_t residual = (encoded & 1) ? -(int32_t)((encoded + 1u) >> 1) : (int32_t)(encoded >> 1);
+        return (uint16_t)(prediction + residual);
+    }
+
+    // 写入超过15的长度：若干个255，最后一个字节小于255
+    void WriteExtendedLength(std::vector<char>& output, uint64_t length)
+    {
+        while (length >= 255)
+        {
+            output.push_back((char)255);
+            length -= 255;
+        }
+        output.push_back((char)length);
+    }
+
+    bool ReadExtendedLength(const uint8_t* input, uint64_t inputSize, uint64_t& position, uint64_t& length)
+    {
+        uint8_t value;
+        do
+        {
+            if (position >= inputSize)
+            {
+                return false;
+            }
+            value = input[position++];
+            length += value;
+        } while (value == 255);
+
+        return true;
+    }
+
+    // 写入一个序列：字面量，以及matchLength不为0时的匹配
+    void WriteSequence(std::vector<char>& output, const uint8_t* literals, uint64_t literalLength, uint32_t offset, uint64_t matchLength)
+    {
+        uint64_t matchCode = matchLength > 0 ? matchLength - kLZMinMatch : 0;
+        output.push_back((char)(((std::min)(literalLength, (uint64_t)15) << 4) | (std::min)(matchCode, (uint64_t)15)));
+
+        if (literalLength >= 15)
+        {
+            WriteExtendedLength(output, literalLength - 15);
+        }
+        output.insert(output.end(), (const char*)literals, (const char*)literals + literalLength);
+
+        if (matchLength == 0)
+        {
+            return;
+        }
+
+        output.push_back((char)(offset & 0xff));
+        output.push_back((char)(offset >> 8));
+
+        if (matchCode >= 15)
+        {
+            WriteExtendedLength(output, matchCode - 15);
+        }
+    }
+}
+
+ClothFrameCodec::ClothFrameCodec(uint32_t vertexCount, uint32_t normalBits)
+    : m_vertexCount(vertexCount)
+    , m_normalBits(normalBits)
+    , m_hasPreviousFrame(false)
+    , m_previousPositions((size_t)vertexCount * 3)
+    , m_previousNormals((size_t)vertexCount * 2)
+    , m_planes((size_t)vertexCount * kPlaneCount)
+{
+}
+
+void ClothFrameCodec::EncodeFrame(const float* vertexData, bool keyFrame, std::vector<char>& frame)
+{
+    const uint32_t N = m_vertexCount;
+    keyFrame = keyFrame || !m_hasPreviousFrame;
+
+    ClothFrameCodecHeader header;
+    header.flags = keyFrame ? kClothFrameCodecKeyFrame : 0;
+
+    // 本帧包围盒
+    float boundsMax[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        header.boundsMin[axis] = N > 0 ? vertexData[axis] : 0.0f;
+        boundsMax[axis] = header.boundsMin[axis];
+    }
+    for (uint32_t v = 1; v < N; ++v)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            header.boundsMin[axis] = (std::min)(header.boundsMin[axis], vertexData[v * 6 + axis]);
+            boundsMax[axis] = (std::max)(boundsMax[axis], vertexData[v * 6 + axis]);
+        }
+    }
+
+    float scale[3];
+    float step[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        header.boundsExtent[axis] = boundsMax[axis] - header.boundsMin[axis];
+        scale[axis] = header.boundsExtent[axis] > 0.0f ? 65535.0f / header.boundsExtent[axis] : 0.0f;
+        step[axis] = header.boundsExtent[axis] / 65535.0f;
+    }
+
+    for (uint32_t v = 0; v < N; ++v)
+    {
+        const float* vertex = &vertexData[v * 6];
+
+        uint16_t values[kComponentCount];
+        uint16_t predictions[kComponentCount] = {};
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            values[axis] = QuantizePosition(vertex[axis], header.boundsMin[axis], scale[axis]);
+            if (!keyFrame)
+            {
+                predictions[axis] = QuantizePosition(m_previousPositions[v * 3 + axis], header.boundsMin[axis], scale[axis]);
+            }
+
+            // 预测使用重建后的位置，与解码器保持一致
+            m_previousPositions[v * 3 + axis] = DequantizePosition(values[axis], header.boundsMin[axis], step[axis]);
+        }
+
+        EncodeOctahedral(&vertex[3], &values[3]);
+        for (int component = 3; component < 5; ++component)
+        {
+            if (!keyFrame)
+            {
+                predictions[component] = m_previousNormals[v * 2 + component - 3];
+            }
+            m_previousNormals[v * 2 + component - 3] = values[component];
+        }
+
+        for (uint32_t component = 0; component < kComponentCount; ++component)
+        {
+            uint16_t residual = ZigZagEncode(values[component], predictions[component]);
+            m_planes[(size_t)(component * 2) * N + v] = (uint8_t)(residual & 0xff);
+            m_planes[(size_t)(component * 2 + 1) * N + v] = (uint8_t)(residual >> 8);
+        }
+    }
+
+    m_hasPreviousFrame = true;
+
+    frame.clear();
+    frame.reserve(sizeof(header) + GetMaxCompressedSize(m_planes.size()));
+    frame.insert(frame.end(), (const char*)&header, (const char*)&header + sizeof(header));
+    CompressLZ(m_planes.data(), m_planes.size(), frame);
+}
+
+bool ClothFrameCodec::DecodeFrame(const uint8_t* frame, uint64_t size, float* vertexData)
+{
+    const uint32_t N = m_vertexCount;
+
+    if (size < sizeof(ClothFrameCodecHeader))
+    {
+        return false;
+    }
+
+    ClothFrameCodecHeader header;
+    memcpy(&header, frame, sizeof(header));
+
+    const bool keyFrame = (header.flags & kClothFrameCodecKeyFrame) != 0;
+    if (!keyFrame && !m_hasPreviousFrame)
+    {
+        return false;
+    }
+
+    if (!DecompressLZ(frame + sizeof(header), size - sizeof(header), m_planes.data(), m_planes.size()))
+    {
+        m_hasPreviousFrame = false;
+        return false;
+    }
+
+    float scale[3];
+    float step[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        scale[axis] = header.boundsExtent[axis] > 0.0f ? 65535.0f / header.boundsExtent[axis] : 0.0f;
+        step[axis] = header.boundsExtent[axis] / 65535.0f;
+    }
+
+    for (uint32_t v = 0; v < N; ++v)
+    {
+        float* vertex = &vertexData[v * 6];
+
+        uint16_t residuals[kComponentCount];
+        for (uint32_t component = 0; component < kComponentCount; ++component)
+        {
+            residuals[component] = (uint16_t)(m_planes[(size_t)(component * 2) * N + v] | (m_planes[(size_t)(component * 2 + 1) * N + v] << 8));
+        }
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            uint16_t prediction = keyFrame ? 0 : QuantizePosition(m_previousPositions[v * 3 + axis], header.boundsMin[axis], scale[axis]);
+            uint16_t value = ZigZagDecode(residuals[axis], prediction);
+
+            vertex[axis] = DequantizePosition(value, header.boundsMin[axis], step[axis]);
+            m_previousPositions[v * 3 + axis] = vertex[axis];
+        }
+
+        uint16_t normal[2];
+        for (int component = 0; component < 2; ++component)
+        {
+            uint16_t prediction = keyFrame ? 0 : m_previousNormals[v * 2 + component];
+            normal[component] = ZigZagDecode(residuals[3 + component], prediction);
+            m_previousNormals[v * 2 + component] = normal[component];
+        }
+
+        DecodeOctahedral(normal, &vertex[3]);
+    }
+
+    m_hasPreviousFrame = true;
+    return true;
+}
+
+bool ClothFrameCodec::IsKeyFrame(const uint8_t* frame, uint64_t size)
+{
+    if (size < sizeof(ClothFrameCodecHeader))
+    {
+        return false;
+    }
+
+    ClothFrameCodecHeader header;
+    memcpy(&header, frame, sizeof(header));
+    return (header.flags & kClothFrameCodecKeyFrame) != 0;
+}
+
+uint64_t ClothFrameCodec::GetMaxCompressedSize(uint64_t size)
+{
+    return size + size / 255 + 16;
+}
+
+void ClothFrameCodec::CompressLZ(const uint8_t* source, uint64_t size, std::vector<char>& compressed)
+{
+    // 哈希表记录每个4字节序列最近出现的位置
+    std::vector<uint32_t> table((size_t)1 << kLZHashBits, kLZInvalidPosition);
+
+    uint64_t anchor = 0;
+    uint64_t position = 0;
+
+    while (position + kLZMinMatch <= size)
+    {
+        uint32_t sequence;
+        memcpy(&sequence, source + position, sizeof(sequence));
+
+        uint32_t hash = (sequence * 2654435761u) >> (32 - kLZHashBits);
+        uint32_t candidate = table[hash];
+        table[hash] = (uint32_t)position;
+
+        if (candidate == kLZInvalidPosition || position - candidate > kLZMaxOffset || memcmp(source + candidate, &sequence, sizeof(sequence)) != 0)
+        {
+            ++position;
+            continue;
+        }
+
+        uint64_t matchLength = kLZMinMatch;
+        while (position + matchLength < size && source[candidate + matchLength] == source[position + matchLength])
+        {
+            ++matchLength;
+        }
+
+        WriteSequence(compressed, source + anchor, position - anchor, (uint32_t)(position - candidate), matchLength);
+
+        position += matchLength;
+        anchor = position;
+    }
+
+    // 最后一个序列只有字面量
+    WriteSequence(compressed, source + anchor, size - anchor, 0, 0);
+}
+
+bool ClothFrameCodec::DecompressLZ(const uint8_t* compressed, uint64_t compressedSize, uint8_t* destination, uint64_t size)
+{
+    uint64_t input = 0;
+    uint64_t output = 0;
+
+    while (input < compressedSize)
+    {
+        uint8_t token = compressed[input++];
+
+        uint64_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadExtendedLength(compressed, compressedSize, input, literalLength))
+        {
+            return false;
+        }
+
+        if (literalLength > compressedSize - input || literalLength > size - output)
+        {
+            return false;
+        }
+
+        memcpy(destination + output, compressed + input, (size_t)literalLength);
+        input += literalLength;
+        output += literalLength;
+
+        // 最后一个序列之后没有匹配
+        if (input == compressedSize)
+        {
+            break;
+        }
+
+        if (compressedSize - input < 2)
+        {
+            return false;
+        }
+
+        uint32_t offset = compressed[input] | (compressed[input + 1] << 8);
+        input += 2;
+
+        uint64_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadExtendedLength(compressed, compressedSize, input, matchLength))
+        {
+            return false;
+        }
+        matchLength += kLZMinMatch;
+
+        if (offset == 0 || offset > output || matchLength > size - output)
+        {
+            return false;
+        }
+
+        // 距离小于长度时源和目标重叠（例如连续的0），只能逐字节复制
+        uint8_t* target = destination + output;
+        const uint8_t* match = target - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(target, match, (size_t)matchLength);
+        }
+        else
+        {
+            for (uint64_t k = 0; k < matchLength; ++k)
+            {
+                target[k] = match[k];
+            }
+        }
+        output += matchLength;
+    }
+
+    return output == size;
+}
+
+void ClothFrameCodec::EncodeOctahedral(const float* normal, uint16_t* encoded) const
+{
+    const float maxValue = (float)((1u << m_normalBits) - 1);
+
+    float sum = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+    float u = sum > 0.0f ? normal[0] / sum : 0.0f;
+    float v = sum > 0.0f ? normal[1] / sum : 0.0f;
+
+    // 下半球折叠到正方形的四个角
+    if (sum > 0.0f && normal[2] < 0.0f)
+    {
+        float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    encoded[0] = (uint16_t)(std::max)(0.0f, (std::min)((u * 0.5f + 0.5f) * maxValue + 0.5f, maxValue));
+    encoded[1] = (uint16_t)(std::max)(0.0f, (std::min)((v * 0.5f + 0.5f) * maxValue + 0.5f, maxValue));
+}
+
+void ClothFrameCodec::DecodeOctahedral(const uint16_t* encoded, float* normal) const
+{
+    const float maxValue = (float)((1u << m_normalBits) - 1);
+
+    float u = encoded[0] / maxValue * 2.0f - 1.0f;
+    float v = encoded[1] / maxValue * 2.0f - 1.0f;
+    float z = 1.0f - std::abs(u) - std::abs(v);
+
+    // 展开下半球
+    float t = (std::max)(-z, 0.0f);
+    float x = u + (u >= 0.0f ? -t : t);
+    float y = v + (v >= 0.0f ? -t : t);
+
+    float length = std::sqrt(x * x + y * y + z * z);
+    float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+    normal[0] = x * inverseLength;
+    normal[1] = y * inverseLength;
+    normal[2] = z * inverseLength;
+}
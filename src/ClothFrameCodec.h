@@ -0,0 +1,92 @@
+#ifndef CLOTH_FRAME_CODEC_H
+#define CLOTH_FRAME_CODEC_H
+
+#include <cstdint>
+#include <vector>
+
+// 压缩帧的帧头，之后是LZ压缩的残差字节平面
+struct ClothFrameCodecHeader
+{
+    float boundsMin[3];         // 包围盒最小角
+    float boundsExtent[3];      // 包围盒大小
+    uint32_t flags;             // kClothFrameCodecKeyFrame等标志
+};
+
+// 关键帧标志：关键帧不使用前一帧预测，可以从这一帧开始独立解码
+static const uint32_t kClothFrameCodecKeyFrame = 1;
+
+// 帧数据压缩编解码器
+// 每帧的编码步骤：
+//   1. 位置在本帧包围盒内量化为uint16，法线做八面体映射后量化为2个normalBits位整数
+//   2. 非关键帧减去前一帧的预测值：位置的预测值为前一帧解码后的位置在本帧包围盒内的量化值，法线为前一帧的量化值
+//   3. 残差zigzag编码为uint16，按分量拆成低字节和高字节平面，使缓慢运动时全为0的高字节平面连续
+//   4. 所有字节平面用LZ77压缩，解码只需要字节复制
+// 编码器和解码器各自保存前一帧的重建结果，两者的状态在相同的帧序列上保持一致
+class ClothFrameCodec
+{
+public:
+    // 参数：
+    //   vertexCount - 每帧的顶点数
+    //   normalBits - 八面体法线每个分量的位数（8或16）
+    ClothFrameCodec(uint32_t vertexCount, uint32_t normalBits);
+
+    // 编码一帧
+    // 参数：
+    //   vertexData - 交错的顶点数据，每个顶点6个float（位置+法线）
+    //   keyFrame - 是否编码为关键帧，第一帧必须是关键帧
+    //   frame - 输出编码后的帧数据（帧头+压缩数据）
+    void EncodeFrame(const float* vertexData, bool keyFrame, std::vector<char>& frame);
+
+    // 解码一帧，非关键帧必须紧接在上一次解码的帧之后
+    // 参数：
+    //   frame - 帧数据
+    //   size - 帧数据的字节数
+    //   vertexData - 输出交错的顶点数据
+    // 返回：是否成功
+    bool DecodeFrame(const uint8_t* frame, uint64_t size, float* vertexData);
+
+    // 丢弃前一帧的状态，之后只能从关键帧开始解码
+    void Reset()
+    {
+        m_hasPreviousFrame = false;
+    }
+
+    // 帧数据是否为关键帧
+    static bool IsKeyFrame(const uint8_t* frame, uint64_t size);
+
+    // 压缩后的最大字节数（不可压缩的数据只增加少量长度字节）
+    static uint64_t GetMaxCompressedSize(uint64_t size);
+
+    // LZ77压缩，格式类似LZ4：每个序列为一个标记字节（高4位字面量长度，低4位匹配长度-4，15表示有扩展长度字节）、
+    // 字面量、2字节匹配距离和扩展匹配长度，最后一个序列只有字面量
+    // 参数：
+    //   source - 原始数据
+    //   size - 原始数据的字节数
+    //   compressed - 输出，压缩数据追加到末尾
+    static void CompressLZ(const uint8_t* source, uint64_t size, std::vector<char>& compressed);
+
+    // LZ77解压缩，检查所有长度和距离，数据损坏时返回false
+    // 参数：
+    //   compressed - 压缩数据
+    //   compressedSize - 压缩数据的字节数
+    //   destination - 输出
+    //   size - 原始数据的字节数，解压后的长度必须与之相同
+    // 返回：是否成功
+    static bool DecompressLZ(const uint8_t* compressed, uint64_t compressedSize, uint8_t* destination, uint64_t size);
+
+private:
+    // 八面体映射：单位向量映射到[-1, 1]^2的正方形，再量化为normalBits位整数
+    void EncodeOctahedral(const float* normal, uint16_t* encoded) const;
+
+    // 八面体映射的逆变换，输出单位向量
+    void DecodeOctahedral(const uint16_t* encoded, float* normal) const;
+
+    uint32_t m_vertexCount;
+    uint32_t m_normalBits;
+    bool m_hasPreviousFrame;                // 是否有可用于预测的前一帧
+    std::vector<float> m_previousPositions; // 前一帧重建后的位置
+    std::vector<uint16_t> m_previousNormals;// 前一帧量化的八面体法线
+    std::vector<uint8_t> m_planes;          // 字节平面（编码和解码共用的临时缓冲区）
+};
+
+#endif // CLOTH_FRAME_CODEC_H
@@ -0,0 +1,420 @@
+#include "ClothMeshLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+extern void logDebug(const std::string& message);
+
+namespace
+{
+    // PLY属性的标量类型
+    enum class PlyScalarType
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64,
+        Invalid,
+    };
+
+    // PLY元素的一个属性，列表属性有单独的长度类型
+    struct PlyProperty
+    {
+        std::string name;
+        PlyScalarType type;
+        bool isList;
+        PlyScalarType countType;
+    };
+
+    // PLY元素（vertex、face或其他元素）
+    struct PlyElement
+    {
+        std::string name;
+        uint32_t count;
+        std::vector<PlyProperty> properties;
+    };
+
+    PlyScalarType ParsePlyScalarType(const std::string& name)
+    {
+        if (name == "char" || name == "int8") return PlyScalarType::Int8;
+        if (name == "uchar" || name == "uint8") return PlyScalarType::UInt8;
+        if (name == "short" || name == "int16") return PlyScalarType::Int16;
+        if (name == "ushort" || name == "uint16") return PlyScalarType::UInt16;
+        if (name == "int" || name == "int32") return PlyScalarType::Int32;
+        if (name == "uint" || name == "uint32") return PlyScalarType::UInt32;
+        if (name == "float" || name == "float32") return PlyScalarType::Float32;
+        if (name == "double" || name == "float64") return PlyScalarType::Float64;
+        return PlyScalarType::Invalid;
+    }
+
+    // 读取一个二进制（小端）标量
+    bool ReadPlyBinaryScalar(std::istream& stream, PlyScalarType type, double& value)
+    {
+        unsigned char bytes[8];
+
+        switch (type)
+        {
+        case PlyScalarType::Int8:    if (!stream.read((char*)bytes, 1)) return false; value = (double)(int8_t)bytes[0]; return true;
+        case PlyScalarType::UInt8:   if (!stream.read((char*)bytes, 1)) return false; value = (double)bytes[0]; return true;
+        case PlyScalarType::Int16:   { int16_t v; if (!stream.read((char*)&v, 2)) return false; value = v; return true; }
+        case PlyScalarType::UInt16:  { uint16_t v; if (!stream.read((char*)&v, 2)) return false; value = v; return true; }
+        case PlyScalarType::Int32:   { int32_t v; if (!stream.read((char*)&v, 4)) return false; value = v; return true; }
+        case PlyScalarType::UInt32:  { uint32_t v; if (!stream.read((char*)&v, 4)) return false; value = v; return true; }
+        case PlyScalarType::Float32: { float v; if (!stream.read((char*)&v, 4)) return false; value = v; return true; }
+        case PlyScalarType::Float64: { double v; if (!stream.read((char*)&v, 8)) return false; value = v; return true; }
+        default: return false;
+        }
+    }
+
+    // 读取一个标量，ascii格式按空白分隔
+    bool ReadPlyScalar(std::istream& stream, bool binary, PlyScalarType type, double& value)
+    {
+        if (binary)
+        {
+            return ReadPlyBinaryScalar(stream, type, value);
+        }
+        return (bool)(stream >> value);
+    }
+
+    // 把多边形按扇形三角化后追加到索引中
+    void AppendPolygon(const std::vector<uint32_t>& polygon, std::vector<uint32_t>& indices)
+    {
+        for (size_t k = 2; k < polygon.size(); ++k)
+        {
+            indices.push_back(polygon[0]);
+            indices.push_back(polygon[k - 1]);
+            indices.push_back(polygon[k]);
+        }
+    }
+}
+
+bool ClothMeshLoader::Load(const std::string& path, ClothMeshData& mesh)
+{
+    std::string extension;
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos)
+    {
+        extension = path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    }
+
+    if (extension == "obj")
+    {
+        return LoadOBJ(path, mesh);
+    }
+
+    if (extension == "ply")
+    {
+        return LoadPLY(path, mesh);
+    }
+
+    logDebug("ClothMeshLoader: unsupported mesh format: " + path);
+    return false;
+}
+
+bool ClothMeshLoader::LoadOBJ(const std::string& path, ClothMeshData& mesh)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        logDebug("ClothMeshLoader: failed to open " + path);
+        return false;
+    }
+
+    mesh.positions.clear();
+    mesh.indices.clear();
+
+    std::string line;
+    std::vector<uint32_t> polygon;
+    uint32_t lineNumber = 0;
+
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::istringstream stream(line);
+        std::string keyword;
+        if (!(stream >> keyword))
+        {
+            continue;
+        }
+
+        if (keyword == "v")
+        {
+            dx::XMFLOAT3 position;
+            if (!(stream >> position.x >> position.y >> position.z))
+            {
+                logDebug("ClothMeshLoader: invalid vertex at " + path + ":" + std::to_string(lineNumber));
+                return false;
+            }
+            mesh.positions.push_back(position);
+        }
+        else if (keyword == "f")
+        {
+            // 顶点格式为v、v/vt、v//vn或v/vt/vn，只取位置索引，负数表示相对于当前已读取的顶点
+            polygon.clear();
+            std::string token;
+
+            while (stream >> token)
+            {
+                long index = std::strtol(token.c_str(), nullptr, 10);
+                long vertex = index > 0 ? index - 1 : (long)mesh.positions.size() + index;
+
+                if (index == 0 || vertex < 0 || vertex >= (long)mesh.positions.size())
+                {
+                    logDebug("ClothMeshLoader: invalid face index at " + path + ":" + std::to_string(lineNumber));
+                    return false;
+                }
+                polygon.push_back((uint32_t)vertex);
+            }
+
+            AppendPolygon(polygon, mesh.indices);
+        }
+    }
+
+    return Compact(mesh);
+}
+
+bool ClothMeshLoader::LoadPLY(const std::string& path, ClothMeshData& mesh)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        logDebug("ClothMeshLoader: failed to open " + path);
+        return false;
+    }
+
+    mesh.positions.clear();
+    mesh.indices.clear();
+
+    // 1. 文件头
+    std::string line;
+    if (!std::getline(file, line) || line.compare(0, 3, "ply") != 0)
+    {
+        logDebug("ClothMeshLoader: missing ply signature in " + path);
+        return false;
+    }
+
+    bool binary = false;
+    std::vector<PlyElement> elements;
+
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if (keyword == "format")
+        {
+            std::string format;
+            stream >> format;
+
+            if (format == "binary_little_endian")
+            {
+                binary = true;
+            }
+            else if (format != "ascii")
+            {
+                logDebug("ClothMeshLoader: unsupported ply format " + format + " in " + path);
+                return false;
+            }
+        }
+        else if (keyword == "element")
+        {
+            PlyElement element;
+            stream >> element.name >> element.count;
+            elements.push_back(element);
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+            {
+                logDebug("ClothMeshLoader: ply property before any element in " + path);
+                return false;
+            }
+
+            PlyProperty property;
+            std::string type;
+            stream >> type;
+
+            property.isList = (type == "list");
+            if (property.isList)
+            {
+                std::string countType;
+                stream >> countType >> type;
+                property.countType = ParsePlyScalarType(countType);
+            }
+            else
+            {
+                property.countType = PlyScalarType::Invalid;
+            }
+
+            property.type = ParsePlyScalarType(type);
+            stream >> property.name;
+
+            if (property.type == PlyScalarType::Invalid || (property.isList && property.countType == PlyScalarType::Invalid))
+            {
+                logDebug("ClothMeshLoader: unsupported ply property type in " + path);
+                return false;
+            }
+
+            elements.back().properties.push_back(property);
+        }
+        else if (keyword == "end_header")
+        {
+            break;
+        }
+    }
+
+    // 2. 按元素顺序读取数据，只保留顶点位置和面的顶点列表
+    std::vector<uint32_t> polygon;
+
+    for (const PlyElement& element : elements)
+    {
+        const bool isVertex = (element.name == "vertex");
+        const bool isFace = (element.name == "face");
+
+        for (uint32_t i = 0; i < element.count; ++i)
+        {
+            dx::XMFLOAT3 position(0.0f, 0.0f, 0.0f);
+            polygon.clear();
+
+            for (const PlyProperty& property : element.properties)
+            {
+                if (property.isList)
+                {
+                    double count = 0.0;
+                    if (!ReadPlyScalar(file, binary, property.countType, count) || count < 0.0)
+                    {
+                        logDebug("ClothMeshLoader: truncated ply data in " + path);
+                        return false;
+                    }
+
+                    const bool isFaceIndices = isFace && (property.name == "vertex_indices" || property.name == "vertex_index");
+
+                    for (uint32_t k = 0; k < (uint32_t)count; ++k)
+                    {
+                        double value = 0.0;
+                        if (!ReadPlyScalar(file, binary, property.type, value))
+                        {
+                            logDebug("ClothMeshLoader: truncated ply data in " + path);
+                            return false;
+                        }
+
+                        if (isFaceIndices)
+                        {
+                            polygon.push_back((uint32_t)value);
+                        }
+                    }
+                }
+                else
+                {
+                    double value = 0.0;
+                    if (!ReadPlyScalar(file, binary, property.type, value))
+                    {
+                        logDebug("ClothMeshLoader: truncated ply data in " + path);
+                        return false;
+                    }
+
+                    if (isVertex)
+                    {
+                        if (property.name == "x") position.x = (float)value;
+                        else if (property.name == "y") position.y = (float)value;
+                        else if (property.name == "z") position.z = (float)value;
+                    }
+                }
+            }
+
+            if (isVertex)
+            {
+                mesh.positions.push_back(position);
+            }
+            else if (isFace)
+            {
+                AppendPolygon(polygon, mesh.indices);
+            }
+        }
+    }
+
+    for (uint32_t index : mesh.indices)
+    {
+        if (index >= mesh.positions.size())
+        {
+            logDebug("ClothMeshLoader: face index out of range in " + path);
+            return false;
+        }
+    }
+
+    return Compact(mesh);
+}
+
+bool ClothMeshLoader::Compact(ClothMeshData& mesh)
+{
+    std::vector<uint32_t> indices;
+    indices.reserve(mesh.indices.size());
+
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+    {
+        uint32_t a = mesh.indices[t];
+        uint32_t b = mesh.indices[t + 1];
+        uint32_t c = mesh.indices[t + 2];
+
+        if (a != b && b != c && a != c)
+        {
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(c);
+        }
+    }
+
+    // 被引用的顶点按原顺序重新编号
+    std::vector<uint32_t> remap(mesh.positions.size(), UINT32_MAX);
+    for (uint32_t vertex : indices)
+    {
+        remap[vertex] = 0;
+    }
+
+    std::vector<dx::XMFLOAT3> positions;
+    for (size_t v = 0; v < mesh.positions.size(); ++v)
+    {
+        if (remap[v] != UINT32_MAX)
+        {
+            remap[v] = (uint32_t)positions.size();
+            positions.push_back(mesh.positions[v]);
+        }
+    }
+
+    for (uint32_t& vertex : indices)
+    {
+        vertex = remap[vertex];
+    }
+
+    if (indices.size() != mesh.indices.size() || positions.size() != mesh.positions.size())
+    {
+        logDebug("ClothMeshLoader: removed " + std::to_string((mesh.indices.size() - indices.size()) / 3) + " degenerate triangles and "
+            + std::to_string(mesh.positions.size() - positions.size()) + " unreferenced vertices");
+    }
+
+    mesh.positions.swap(positions);
+    mesh.indices.swap(indices);
+
+    if (mesh.indices.empty())
+    {
+        logDebug("ClothMeshLoader: mesh has no triangles");
+        return false;
+    }
+
+    return true;
+}
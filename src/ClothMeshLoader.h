@@ -0,0 +1,44 @@
+#ifndef CLOTH_MESH_LOADER_H
+#define CLOTH_MESH_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 从文件读取的三角网格
+struct ClothMeshData
+{
+    std::vector<dx::XMFLOAT3> positions;    // 顶点位置
+    std::vector<uint32_t> indices;          // 三角形顶点索引，每3个为一个三角形
+};
+
+// 布料三角网格加载器
+// 支持OBJ（只读取v和f，多边形按扇形三角化）和PLY（ascii或binary_little_endian，读取vertex的x/y/z和face的顶点列表）
+// 加载后去掉退化三角形和没有被三角形引用的顶点，顶点编号按原文件中的顺序压缩
+class ClothMeshLoader
+{
+public:
+    // 按扩展名（.obj/.ply，不区分大小写）加载
+    // 参数：
+    //   path - 文件路径
+    //   mesh - 输出网格
+    // 返回：是否成功
+    static bool Load(const std::string& path, ClothMeshData& mesh);
+
+    // 加载OBJ文件
+    static bool LoadOBJ(const std::string& path, ClothMeshData& mesh);
+
+    // 加载PLY文件
+    static bool LoadPLY(const std::string& path, ClothMeshData& mesh);
+
+private:
+    // 去掉退化三角形和未引用的顶点
+    // 返回：是否还有有效的三角形
+    static bool Compact(ClothMeshData& mesh);
+};
+
+#endif // CLOTH_MESH_LOADER_H
@@ -0,0 +1,117 @@
+#include "ClothMeshTopology.h"
+#include <algorithm>
+#include <unordered_map>
+
+void ClothMeshTopology::Build(uint32_t vertexCount, const std::vector<uint32_t>& indices)
+{
+    Clear();
+
+    m_vertexCount = vertexCount;
+    const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+
+    // 1. 边表：键为(较小顶点 << 32) | 较大顶点
+    std::unordered_map<uint64_t, uint32_t> edgeIndices;
+    edgeIndices.reserve((size_t)triangleCount * 2);
+    m_edges.reserve((size_t)triangleCount * 2);
+
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        const uint32_t* triangle = &indices[(size_t)t * 3];
+
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t a = triangle[k];
+            uint32_t b = triangle[(k + 1) % 3];
+            uint32_t opposite = triangle[(k + 2) % 3];
+
+            uint32_t low = (std::min)(a, b);
+            uint32_t high = (std::max)(a, b);
+            uint64_t key = ((uint64_t)low << 32) | high;
+
+            auto inserted = edgeIndices.emplace(key, (uint32_t)m_edges.size());
+            if (inserted.second)
+            {
+                ClothMeshEdge edge;
+                edge.vertices[0] = low;
+                edge.vertices[1] = high;
+                edge.opposites[0] = opposite;
+                edge.opposites[1] = UINT32_MAX;
+                edge.triangleCount = 1;
+                m_edges.push_back(edge);
+            }
+            else
+            {
+                ClothMeshEdge& edge = m_edges[inserted.first->second];
+                if (edge.triangleCount == 1)
+                {
+                    edge.opposites[1] = opposite;
+                }
+                edge.triangleCount++;
+            }
+        }
+    }
+
+    for (const ClothMeshEdge& edge : m_edges)
+    {
+        if (edge.triangleCount > 2)
+        {
+            m_nonManifoldEdgeCount++;
+        }
+    }
+
+    // 2. 顶点的相邻三角形
+    m_vertexTriangleOffsets.assign(vertexCount + 1, 0);
+    for (uint32_t index : indices)
+    {
+        m_vertexTriangleOffsets[index + 1]++;
+    }
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        m_vertexTriangleOffsets[v + 1] += m_vertexTriangleOffsets[v];
+    }
+
+    m_vertexTriangles.resize(m_vertexTriangleOffsets[vertexCount]);
+    std::vector<uint32_t> fill(m_vertexTriangleOffsets.begin(), m_vertexTriangleOffsets.end() - 1);
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            m_vertexTriangles[fill[indices[(size_t)t * 3 + k]]++] = t;
+        }
+    }
+
+    // 3. 顶点的相邻顶点
+    m_vertexNeighborOffsets.assign(vertexCount + 1, 0);
+    for (const ClothMeshEdge& edge : m_edges)
+    {
+        m_vertexNeighborOffsets[edge.vertices[0] + 1]++;
+        m_vertexNeighborOffsets[edge.vertices[1] + 1]++;
+    }
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        m_vertexNeighborOffsets[v + 1] += m_vertexNeighborOffsets[v];
+    }
+
+    m_vertexNeighbors.resize(m_vertexNeighborOffsets[vertexCount]);
+    fill.assign(m_vertexNeighborOffsets.begin(), m_vertexNeighborOffsets.end() - 1);
+    for (const ClothMeshEdge& edge : m_edges)
+    {
+        m_vertexNeighbors[fill[edge.vertices[0]]++] = edge.vertices[1];
+        m_vertexNeighbors[fill[edge.vertices[1]]++] = edge.vertices[0];
+    }
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        std::sort(m_vertexNeighbors.begin() + m_vertexNeighborOffsets[v], m_vertexNeighbors.begin() + m_vertexNeighborOffsets[v + 1]);
+    }
+}
+
+void ClothMeshTopology::Clear()
+{
+    m_vertexCount = 0;
+    m_nonManifoldEdgeCount = 0;
+    m_edges.clear();
+    m_vertexTriangleOffsets.clear();
+    m_vertexTriangles.clear();
+    m_vertexNeighborOffsets.clear();
+    m_vertexNeighbors.clear();
+}
@@ -0,0 +1,82 @@
+#ifndef CLOTH_MESH_TOPOLOGY_H
+#define CLOTH_MESH_TOPOLOGY_H
+
+#include <cstdint>
+#include <vector>
+
+// 三角网格的一条边
+struct ClothMeshEdge
+{
+    uint32_t vertices[2];       // 边的两个顶点，vertices[0] < vertices[1]
+    uint32_t opposites[2];      // 相邻两个三角形中与边相对的顶点，边界边的opposites[1]为UINT32_MAX
+    uint32_t triangleCount;     // 相邻三角形数，1为边界边，2为内部边，大于2为非流形边
+};
+
+// 三角网格的拓扑表：边、边的相邻三角形和顶点的相邻三角形
+// 边通过排序后的顶点对组成的64位键在哈希表中去重，只依赖三角形索引，不要求网格是规则网格
+class ClothMeshTopology
+{
+public:
+    ClothMeshTopology()
+        : m_vertexCount(0)
+        , m_nonManifoldEdgeCount(0)
+    {
+    }
+
+    // 建立拓扑表
+    // 参数：
+    //   vertexCount - 顶点数
+    //   indices - 三角形顶点索引，每3个为一个三角形
+    void Build(uint32_t vertexCount, const std::vector<uint32_t>& indices);
+
+    // 清除拓扑表
+    void Clear();
+
+    // 获取所有边，按第一次出现的三角形顺序排列
+    const std::vector<ClothMeshEdge>& GetEdges() const
+    {
+        return m_edges;
+    }
+
+    // 获取顶点的相邻三角形：vertexTriangles[offsets[v], offsets[v + 1])
+    const std::vector<uint32_t>& GetVertexTriangleOffsets() const
+    {
+        return m_vertexTriangleOffsets;
+    }
+
+    const std::vector<uint32_t>& GetVertexTriangles() const
+    {
+        return m_vertexTriangles;
+    }
+
+    // 获取顶点的相邻顶点：vertexNeighbors[offsets[v], offsets[v + 1])
+    const std::vector<uint32_t>& GetVertexNeighborOffsets() const
+    {
+        return m_vertexNeighborOffsets;
+    }
+
+    const std::vector<uint32_t>& GetVertexNeighbors() const
+    {
+        return m_vertexNeighbors;
+    }
+
+    // 获取非流形边（相邻三角形多于2个）的数量，这些边不生成弯曲约束
+    uint32_t GetNonManifoldEdgeCount() const
+    {
+        return m_nonManifoldEdgeCount;
+    }
+
+private:
+    uint32_t m_vertexCount;
+    uint32_t m_nonManifoldEdgeCount;
+
+    std::vector<ClothMeshEdge> m_edges;
+
+    std::vector<uint32_t> m_vertexTriangleOffsets;
+    std::vector<uint32_t> m_vertexTriangles;
+
+    std::vector<uint32_t> m_vertexNeighborOffsets;
+    std::vector<uint32_t> m_vertexNeighbors;
+};
+
+#endif // CLOTH_MESH_TOPOLOGY_H
@@ -0,0 +1,1297 @@
+#include "ClothSceneLoader.h"
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+extern void logDebug(const std::string& message);
+
+namespace
+{
+    // JSON值
+    struct JsonValue
+    {
+        enum class Type
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object,
+        };
+
+        Type type = Type::Null;
+        bool boolValue = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<JsonValue> elements;                            // 数组元素
+        std::vector<std::pair<std::string, JsonValue>> members;     // 对象成员，保持文件中的顺序
+
+        // 查找对象成员，不存在时返回nullptr
+        const JsonValue* Find(const char* key) const
+        {
+            for (const auto& member : members)
+            {
+                if (member.first == key)
+                {
+                    return &member.second;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    // JSON解析器（RFC 8259，字符串中的\u转义按UTF-8输出）
+    class JsonParser
+    {
+    public:
+        explicit JsonParser(const std::string& text)
+            : m_text(text)
+            , m_position(0)
+        {
+        }
+
+        // 解析整个文本
+        // 参数：
+        //   value - 输出
+        //   error - 失败时输出带行号的错误信息
+        // 返回：是否成功
+        bool Parse(JsonValue& value, std::string& error)
+        {
+            SkipWhitespace();
+            if (!ParseValue(value, 0))
+            {
+                error = FormatError();
+                return false;
+            }
+
+            SkipWhitespace();
+            if (m_position != m_text.size())
+            {
+                m_error = "unexpected data after the top-level value";
+                error = FormatError();
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        // 嵌套层数上限，避免损坏的文件导致栈溢出
+        static const int kMaxDepth = 64;
+
+        bool Fail(const char* message)
+        {
+            m_error = message;
+            return false;
+        }
+
+        std::string FormatError() const
+        {
+            int line = 1;
+            for (size_t i = 0; i < m_position && i < m_text.size(); ++i)
+            {
+                if (m_text[i] == '\n')
+                {
+                    ++line;
+                }
+            }
+            return "line " + std::to_string(line) + ": " + m_error;
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\t' || m_text[m_position] == '\r' || m_text[m_position] == '\n'))
+            {
+                ++m_position;
+            }
+        }
+
+        bool Match(const char* literal)
+        {
+            size_t length = strlen(literal);
+            if (m_text.compare(m_position, length, literal) != 0)
+            {
+                return false;
+            }
+            m_position += length;
+            return true;
+        }
+
+        bool ParseValue(JsonValue& value, int depth)
+        {
+            if (depth > kMaxDepth)
+            {
+                return Fail("nesting is too deep");
+            }
+
+            if (m_position >= m_text.size())
+            {
+                return Fail("unexpected end of file");
+            }
+
+            char c = m_text[m_position];
+            if (c == '{')
+            {
+                return ParseObject(value, depth);
+            }
+            if (c == '[')
+            {
+                return ParseArray(value, depth);
+            }
+            if (c == '"')
+            {
+                value.type = JsonValue::Type::String;
+                return ParseString(value.string);
+            }
+            if (c == '-' || (c >= '0' && c <= '9'))
+            {
+                value.type = JsonValue::Type::Number;
+                return ParseNumber(value.number);
+            }
+            if (Match("true"))
+            {
+                value.type = JsonValue::Type::Bool;
+                value.boolValue = true;
+                return true;
+            }
+            if (Match("false"))
+            {
+                value.type = JsonValue::Type::Bool;
+                value.boolValue = false;
+                return true;
+            }
+            if (Match("null"))
+            {
+                value.type = JsonValue::Type::Null;
+                return true;
+            }
+
+            return Fail("unexpected character");
+        }
+
+        bool ParseObject(JsonValue& value, int depth)
+        {
+            value.type = JsonValue::Type::Object;
+            ++m_position; // '{'
+            SkipWhitespace();
+
+            if (m_position < m_text.size() && m_text[m_position] == '}')
+            {
+                ++m_position;
+                return true;
+            }
+
+            for (;;)
+            {
+                SkipWhitespace();
+                if (m_position >= m_text.size() || m_text[m_position] != '"')
+                {
+                    return Fail("expected a member name");
+                }
+
+                std::string key;
+                if (!ParseString(key))
+                {
+                    return false;
+                }
+
+                SkipWhitespace();
+                if (m_position >= m_text.size() || m_text[m_position] != ':')
+                {
+                    return Fail("expected ':' after a member name");
+                }
+                ++m_position;
+                SkipWhitespace();
+
+                value.members.emplace_back(key, JsonValue());
+                if (!ParseValue(value.members.back().second, depth + 1))
+                {
+                    return false;
+                }
+
+                SkipWhitespace();
+                if (m_position < m_text.size() && m_text[m_position] == ',')
+                {
+                    ++m_position;
+                    continue;
+                }
+                if (m_position < m_text.size() && m_text[m_position] == '}')
+                {
+                    ++m_position;
+                    return true;
+                }
+                return Fail("expected ',' or '}' in an object");
+            }
+        }
+
+        bool ParseArray(JsonValue& value, int depth)
+        {
+            value.type = JsonValue::Type::Array;
+            ++m_position; // '['
+            SkipWhitespace();
+
+            if (m_position < m_text.size() && m_text[m_position] == ']')
+            {
+                ++m_position;
+                return true;
+            }
+
+            for (;;)
+            {
+                SkipWhitespace();
+                value.elements.emplace_back();
+                if (!ParseValue(value.elements.back(), depth + 1))
+                {
+                    return false;
+                }
+
+                SkipWhitespace();
+                if (m_position < m_text.size() && m_text[m_position] == ',')
+                {
+                    ++m_position;
+                    continue;
+                }
+                if (m_position < m_text.size() && m_text[m_position] == ']')
+                {
+                    ++m_position;
+                    return true;
+                }
+                return Fail("expected ',' or ']' in an array");
+            }
+        }
+
+        bool ParseHex4(uint32_t& code)
+        {
+            if (m_position + 4 > m_text.size())
+            {
+                return Fail("truncated \\u escape");
+            }
+
+            code = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = m_text[m_position++];
+                code <<= 4;
+                if (c >= '0' && c <= '9') code |= (uint32_t)(c - '0');
+                else if (c >= 'a' && c <= 'f') code |= (uint32_t)(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F') code |= (uint32_t)(c - 'A' + 10);
+                else return Fail("invalid \\u escape");
+            }
+            return true;
+        }
+
+        static void AppendUtf8(uint32_t code, std::string& output)
+        {
+            if (code < 0x80)
+            {
+                output += (char)code;
+            }
+            else if (code < 0x800)
+            {
+                output += (char)(0xC0 | (code >> 6));
+                output += (char)(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                output += (char)(0xE0 | (code >> 12));
+                output += (char)(0x80 | ((code >> 6) & 0x3F));
+                output += (char)(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                output += (char)(0xF0 | (code >> 18));
+                output += (char)(0x80 | ((code >> 12) & 0x3F));
+                output += (char)(0x80 | ((code >> 6) & 0x3F));
+                output += (char)(0x80 | (code & 0x3F));
+            }
+        }
+
+        bool ParseString(std::string& output)
+        {
+            ++m_position; // '"'
+            output.clear();
+
+            while (m_position < m_text.size())
+            {
+                char c = m_text[m_position++];
+                if (c == '"')
+                {
+                    return true;
+                }
+                if ((unsigned char)c < 0x20)
+                {
+                    return Fail("control character in a string");
+                }
+                if (c != '\\')
+                {
+                    output += c;
+                    continue;
+                }
+
+                if (m_position >= m_text.size())
+                {
+                    break;
+                }
+
+                char escape = m_text[m_position++];
+                switch (escape)
+                {
+                case '"': output += '"'; break;
+                case '\\': output += '\\'; break;
+                case '/': output += '/'; break;
+                case 'b': output += '\b'; break;
+                case 'f': output += '\f'; break;
+                case 'n': output += '\n'; break;
+                case 'r': output += '\r'; break;
+                case 't': output += '\t'; break;
+                case 'u':
+                    {
+                        uint32_t code;
+                        if (!ParseHex4(code))
+                        {
+                            return false;
+                        }
+
+                        // 代理对
+                        if (code >= 0xD800 && code <= 0xDBFF)
+                        {
+                            uint32_t low;
+                            if (!Match("\\u") || !ParseHex4(low) || low < 0xDC00 || low > 0xDFFF)
+                            {
+                                return Fail("invalid surrogate pair");
+                            }
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        AppendUtf8(code, output);
+                    }
+                    break;
+                default:
+                    return Fail("invalid escape in a string");
+                }
+            }
+
+            return Fail("unterminated string");
+        }
+
+        bool ParseNumber(double& number)
+        {
+            // 按JSON语法检查，再用strtod转换
+            size_t start = m_position;
+            if (m_text[m_position] == '-')
+            {
+                ++m_position;
+            }
+
+            if (m_position >= m_text.size() || !isdigit((unsigned char)m_text[m_position]))
+            {
+                return Fail("invalid number");
+            }
+            if (m_text[m_position] == '0')
+            {
+                ++m_position;
+            }
+            else
+            {
+                while (m_position < m_text.size() && isdigit((unsigned char)m_text[m_position])) ++m_position;
+            }
+
+            if (m_position < m_text.size() && m_text[m_position] == '.')
+            {
+                ++m_position;
+                if (m_position >= m_text.size() || !isdigit((unsigned char)m_text[m_position]))
+                {
+                    return Fail("invalid number");
+                }
+                while (m_position < m_text.size() && isdigit((unsigned char)m_text[m_position])) ++m_position;
+            }
+
+            if (m_position < m_text.size() && (m_text[m_position] == 'e' || m_text[m_position] == 'E'))
+            {
+                ++m_position;
+                if (m_position < m_text.size() && (m_text[m_position] == '+' || m_text[m_position] == '-'))
+                {
+                    ++m_position;
+                }
+                if (m_position >= m_text.size() || !isdigit((unsigned char)m_text[m_position]))
+                {
+                    return Fail("invalid number");
+                }
+                while (m_position < m_text.size() && isdigit((unsigned char)m_text[m_position])) ++m_position;
+            }
+
+            number = strtod(m_text.substr(start, m_position - start).c_str(), nullptr);
+            return true;
+        }
+
+        const std::string& m_text;
+        size_t m_position;
+        std::string m_error;
+    };
+
+    // 以下读取函数在类型不符时输出日志并返回false
+    // 参数context为日志中的位置描述，例如"cloths[0].iteratorCount"
+
+    bool ReadNumber(const JsonValue& value, const std::string& context, double& number)
+    {
+        if (value.type != JsonValue::Type::Number)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be a number");
+            return false;
+        }
+        number = value.number;
+        return true;
+    }
+
+    bool ReadFloat(const JsonValue& value, const std::string& context, float& output)
+    {
+        double number;
+        if (!ReadNumber(value, context, number))
+        {
+            return false;
+        }
+        output = (float)number;
+        return true;
+    }
+
+    bool ReadInt(const JsonValue& value, const std::string& context, int& output)
+    {
+        double number;
+        if (!ReadNumber(value, context, number))
+        {
+            return false;
+        }
+        if (number < (double)INT_MIN || number > (double)INT_MAX || number != (double)(int)number)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be an integer");
+            return false;
+        }
+        output = (int)number;
+        return true;
+    }
+
+    bool ReadUInt(const JsonValue& value, const std::string& context, uint32_t& output)
+    {
+        double number;
+        if (!ReadNumber(value, context, number))
+        {
+            return false;
+        }
+        if (number < 0.0 || number > 4294967295.0 || number != (double)(uint32_t)number)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be a non-negative integer");
+            return false;
+        }
+        output = (uint32_t)number;
+        return true;
+    }
+
+    bool ReadBool(const JsonValue& value, const std::string& context, bool& output)
+    {
+        if (value.type != JsonValue::Type::Bool)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be true or false");
+            return false;
+        }
+        output = value.boolValue;
+        return true;
+    }
+
+    bool ReadString(const JsonValue& value, const std::string& context, std::string& output)
+    {
+        if (value.type != JsonValue::Type::String)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be a string");
+            return false;
+        }
+        output = value.string;
+        return true;
+    }
+
+    // 读取count个数的数组
+    bool ReadFloats(const JsonValue& value, const std::string& context, float* output, size_t count)
+    {
+        if (value.type != JsonValue::Type::Array || value.elements.size() != count)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be an array of " + std::to_string(count) + " numbers");
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!ReadFloat(value.elements[i], context + "[" + std::to_string(i) + "]", output[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ReadFloat3(const JsonValue& value, const std::string& context, dx::XMFLOAT3& output)
+    {
+        float components[3];
+        if (!ReadFloats(value, context, components, 3))
+        {
+            return false;
+        }
+        output = dx::XMFLOAT3(components[0], components[1], components[2]);
+        return true;
+    }
+
+    bool ReadFloat4(const JsonValue& value, const std::string& context, dx::XMFLOAT4& output)
+    {
+        float components[4];
+        if (!ReadFloats(value, context, components, 4))
+        {
+            return false;
+        }
+        output = dx::XMFLOAT4(components[0], components[1], components[2], components[3]);
+        return true;
+    }
+
+    // 读取枚举值，names和values一一对应
+    template<typename T, size_t N>
+    bool ReadEnum(const JsonValue& value, const std::string& context, const char* const (&names)[N], const T (&values)[N], T& output)
+    {
+        std::string name;
+        if (!ReadString(value, context, name))
+        {
+            return false;
+        }
+
+        std::string expected;
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (name == names[i])
+            {
+                output = values[i];
+                return true;
+            }
+            expected += (i == 0 ? "" : ", ") + std::string(names[i]);
+        }
+
+        logDebug("ClothSceneLoader: unknown " + context + " \"" + name + "\", expected one of " + expected);
+        return false;
+    }
+
+    // 读取一项布料设置，未知的键视为错误，避免基准测试矩阵中的拼写错误被忽略
+    // 参数：
+    //   object - 设置所在的对象，用于检查同一对象中的其他键
+    //   key, value - 设置项
+    //   context - 日志中的位置描述
+    //   cloth - 输出
+    bool ReadClothSetting(const JsonValue& object, const std::string& key, const JsonValue& value, const std::string& context, ClothSceneCloth& cloth)
+    {
+        static const char* const kSolverNames[] = { "XPBD", "ProjectiveDynamics" };
+        static const ClothSolverType kSolverValues[] = { ClothSolverType::XPBD, ClothSolverType::ProjectiveDynamics };
+        static const char* const kScheduleModeNames[] = { "Iterative", "SmallSteps" };
+        static const XPBDScheduleMode kScheduleModeValues[] = { XPBDScheduleMode::Iterative, XPBDScheduleMode::SmallSteps };
+        static const char* const kDistanceSolveModeNames[] = { "Iterative", "Direct" };
+        static const XPBDDistanceSolveMode kDistanceSolveModeValues[] = { XPBDDistanceSolveMode::Iterative, XPBDDistanceSolveMode::Direct };
+        static const char* const kMassModeNames[] = { "FixedParticleMass", "FixedTotalMass" };
+        static const ClothParticleMassMode kMassModeValues[] = { ClothParticleMassMode::FixedParticleMass, ClothParticleMassMode::FixedTotalMass };
+        static const char* const kMeshModeNames[] = { "Full", "Simplified", "Mesh" };
+        static const ClothMeshAndContraintMode kMeshModeValues[] = { ClothMeshAndContraintMode::Full, ClothMeshAndContraintMode::Simplified, ClothMeshAndContraintMode::Mesh };
+        static const char* const kOrderingNames[] = { "None", "Morton", "RCM" };
+        static const ClothParticleOrdering kOrderingValues[] = { ClothParticleOrdering::None, ClothParticleOrdering::Morton, ClothParticleOrdering::ReverseCuthillMcKee };
+
+        const std::string itemContext = context + "." + key;
+
+        // 网格
+        if (key == "widthResolution") return ReadInt(value, itemContext, cloth.widthResolution);
+        if (key == "heightResolution") return ReadInt(value, itemContext, cloth.heightResolution);
+        if (key == "size") return ReadFloat(value, itemContext, cloth.size);
+        if (key == "position") return ReadFloat3(value, itemContext, cloth.position);
+        if (key == "meshAndContraintMode") return ReadEnum(value, itemContext, kMeshModeNames, kMeshModeValues, cloth.meshAndContraintMode);
+        if (key == "particleOrdering") return ReadEnum(value, itemContext, kOrderingNames, kOrderingValues, cloth.particleOrdering);
+        if (key == "clothMesh")
+        {
+            // 与命令行一致：指定网格文件时切换到Mesh模式，未指定重排序方式时按RCM重排
+            if (!ReadString(value, itemContext, cloth.meshFile))
+            {
+                return false;
+            }
+            cloth.meshAndContraintMode = ClothMeshAndContraintMode::Mesh;
+            if (!object.Find("particleOrdering"))
+            {
+                cloth.particleOrdering = ClothParticleOrdering::ReverseCuthillMcKee;
+            }
+            return true;
+        }
+
+        // 材质
+        if (key == "color") return ReadFloat3(value, itemContext, cloth.diffuseColor);
+        if (key == "mass") return ReadFloat(value, itemContext, cloth.mass);
+        if (key == "massMode") return ReadEnum(value, itemContext, kMassModeNames, kMassModeValues, cloth.massMode);
+        if (key == "addLRAConstraints") return ReadBool(value, itemContext, cloth.addLRAConstraints);
+        if (key == "addBendingConstraints") return ReadBool(value, itemContext, cloth.addBendingConstraints);
+        if (key == "addDihedralBendingConstraints") return ReadBool(value, itemContext, cloth.addDihedralBendingConstraints);
+        if (key == "addIsometricBendingConstraints") return ReadBool(value, itemContext, cloth.addIsometricBendingConstraints);
+        if (key == "addDiagonalConstraints") return ReadBool(value, itemContext, cloth.addDiagonalConstraints);
+        if (key == "distanceCompliance") return ReadFloat(value, itemContext, cloth.distanceCompliance);
+        if (key == "distanceDamping") return ReadFloat(value, itemContext, cloth.distanceDamping);
+        if (key == "LRACompliance") return ReadFloat(value, itemContext, cloth.lraCompliance);
+        if (key == "LRADamping") return ReadFloat(value, itemContext, cloth.lraDamping);
+        if (key == "LRAMaxStretch") return ReadFloat(value, itemContext, cloth.lraMaxStretch);
+        if (key == "bendingCompliance") return ReadFloat(value, itemContext, cloth.bendingCompliance);
+        if (key == "bendingDamping") return ReadFloat(value, itemContext, cloth.bendingDamping);
+        if (key == "dihedralBendingCompliance") return ReadFloat(value, itemContext, cloth.dihedralBendingCompliance);
+        if (key == "dihedralBendingDamping") return ReadFloat(value, itemContext, cloth.dihedralBendingDamping);
+        if (key == "isometricBendingCompliance") return ReadFloat(value, itemContext, cloth.isometricBendingCompliance);
+        if (key == "isometricBendingDamping") return ReadFloat(value, itemContext, cloth.isometricBendingDamping);
+
+        // 求解器
+        if (key == "solver") return ReadEnum(value, itemContext, kSolverNames, kSolverValues, cloth.solverType);
+        if (key == "scheduleMode")
+        {
+            if (!ReadEnum(value, itemContext, kScheduleModeNames, kScheduleModeValues, cloth.scheduleMode))
+            {
+                return false;
+            }
+
+            // 与命令行一致：小步长模式依靠子步数收敛，同一对象中未指定子步数时使用默认值
+            if (cloth.scheduleMode == XPBDScheduleMode::SmallSteps && !object.Find("subIteratorCount"))
+            {
+                cloth.subIteratorCount = kSmallStepsDefaultSubIteratorCount;
+            }
+            return true;
+        }
+        if (key == "iteratorCount") return ReadInt(value, itemContext, cloth.iteratorCount);
+        if (key == "subIteratorCount") return ReadUInt(value, itemContext, cloth.subIteratorCount);
+        if (key == "minIteratorCount") return ReadUInt(value, itemContext, cloth.minIteratorCount);
+        if (key == "lambdaWarmStart") return ReadFloat(value, itemContext, cloth.lambdaWarmStartFactor);
+        if (key == "residualTolerance") return ReadFloat(value, itemContext, cloth.residualTolerance);
+        if (key == "residualStagnation") return ReadFloat(value, itemContext, cloth.residualStagnationRatio);
+        if (key == "chebyshev") return ReadBool(value, itemContext, cloth.chebyshevAcceleration);
+        if (key == "chebyshevSpectralRadius") return ReadFloat(value, itemContext, cloth.chebyshevSpectralRadius);
+        if (key == "overRelaxation") return ReadFloat(value, itemContext, cloth.overRelaxationFactor);
+        if (key == "sleep") return ReadBool(value, itemContext, cloth.sleepEnabled);
+        if (key == "sleepVelocity") return ReadFloat(value, itemContext, cloth.sleepVelocityThreshold);
+        if (key == "sleepDisplacement") return ReadFloat(value, itemContext, cloth.sleepDisplacementThreshold);
+        if (key == "sleepFrames") return ReadUInt(value, itemContext, cloth.sleepFrameCount);
+        if (key == "velocityDamping") return ReadFloat(value, itemContext, cloth.velocityDamping);
+        if (key == "multigridLevels") return ReadUInt(value, itemContext, cloth.multigridLevelCount);
+        if (key == "multigridIterations") return ReadUInt(value, itemContext, cloth.multigridIterationCount);
+        if (key == "distanceSolveMode") return ReadEnum(value, itemContext, kDistanceSolveModeNames, kDistanceSolveModeValues, cloth.distanceSolveMode);
+        if (key == "directSolveIterations") return ReadUInt(value, itemContext, cloth.directSolveIterationCount);
+
+        logDebug("ClothSceneLoader: unknown setting " + itemContext);
+        return false;
+    }
+
+    // 读取对象中的所有布料设置
+    // 参数：
+    //   object - 设置对象
+    //   context - 日志中的位置描述
+    //   reservedKeys - 由调用者处理、不作为布料设置的键，以nullptr结尾
+    //   cloth - 输出
+    bool ReadClothSettings(const JsonValue& object, const std::string& context, const char* const* reservedKeys, ClothSceneCloth& cloth)
+    {
+        if (object.type != JsonValue::Type::Object)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be an object");
+            return false;
+        }
+
+        for (const auto& member : object.members)
+        {
+            bool reserved = false;
+            for (const char* const* reservedKey = reservedKeys; reservedKey && *reservedKey; ++reservedKey)
+            {
+                reserved = reserved || member.first == *reservedKey;
+            }
+
+            if (!reserved && !ReadClothSetting(object, member.first, member.second, context, cloth))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 读取固定粒子，元素为粒子索引或规则网格的[w, h]坐标
+    bool ReadPins(const JsonValue& value, const std::string& context, ClothSceneCloth& cloth)
+    {
+        if (value.type != JsonValue::Type::Array)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be an array");
+            return false;
+        }
+
+        cloth.pinsSpecified = true;
+        cloth.pins.clear();
+
+        for (size_t i = 0; i < value.elements.size(); ++i)
+        {
+            const JsonValue& element = value.elements[i];
+            const std::string elementContext = context + "[" + std::to_string(i) + "]";
+
+            if (element.type == JsonValue::Type::Array)
+            {
+                if (cloth.meshAndContraintMode == ClothMeshAndContraintMode::Mesh)
+                {
+                    logDebug("ClothSceneLoader: " + elementContext + " grid coordinates are not supported for Mesh cloths, use a vertex index");
+                    return false;
+                }
+
+                uint32_t coordinates[2];
+                if (element.elements.size() != 2
+                    || !ReadUInt(element.elements[0], elementContext + "[0]", coordinates[0])
+                    || !ReadUInt(element.elements[1], elementContext + "[1]", coordinates[1]))
+                {
+                    logDebug("ClothSceneLoader: " + elementContext + " must be a particle index or [w, h]");
+                    return false;
+                }
+
+                if (coordinates[0] >= (uint32_t)cloth.widthResolution || coordinates[1] >= (uint32_t)cloth.heightResolution)
+                {
+                    logDebug("ClothSceneLoader: " + elementContext + " is outside the cloth grid");
+                    return false;
+                }
+
+                cloth.pins.push_back(coordinates[1] * (uint32_t)cloth.widthResolution + coordinates[0]);
+            }
+            else
+            {
+                uint32_t index;
+                if (!ReadUInt(element, elementContext, index))
+                {
+                    return false;
+                }
+                cloth.pins.push_back(index);
+            }
+        }
+        return true;
+    }
+
+    // 检查布料设置的取值范围
+    bool ValidateCloth(const ClothSceneCloth& cloth, const std::string& context)
+    {
+        if (cloth.meshAndContraintMode != ClothMeshAndContraintMode::Mesh && (cloth.widthResolution < 2 || cloth.heightResolution < 2))
+        {
+            logDebug("ClothSceneLoader: " + context + " resolution must be at least 2x2");
+            return false;
+        }
+
+        if (cloth.meshAndContraintMode == ClothMeshAndContraintMode::Mesh && cloth.meshFile.empty())
+        {
+            logDebug("ClothSceneLoader: " + context + " uses Mesh mode without clothMesh");
+            return false;
+        }
+
+        if (cloth.size <= 0.0f || cloth.mass <= 0.0f || cloth.subIteratorCount < 1)
+        {
+            logDebug("ClothSceneLoader: " + context + " size, mass and subIteratorCount must be positive");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReadCollider(const JsonValue& value, const std::string& context, ClothSceneSphere& sphere)
+    {
+        if (value.type != JsonValue::Type::Object)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be an object");
+            return false;
+        }
+
+        std::string type = "sphere";
+        sphere.center = dx::XMFLOAT3(0.0f, 0.0f, 0.0f);
+        sphere.radius = 1.0f;
+        sphere.diffuseColor = dx::XMFLOAT3(1.0f, 0.1f, 0.1f);
+
+        for (const auto& member : value.members)
+        {
+            const std::string itemContext = context + "." + member.first;
+            bool succeeded;
+            if (member.first == "type") succeeded = ReadString(member.second, itemContext, type);
+            else if (member.first == "center") succeeded = ReadFloat3(member.second, itemContext, sphere.center);
+            else if (member.first == "radius") succeeded = ReadFloat(member.second, itemContext, sphere.radius);
+            else if (member.first == "color") succeeded = ReadFloat3(member.second, itemContext, sphere.diffuseColor);
+            else
+            {
+                logDebug("ClothSceneLoader: unknown setting " + itemContext);
+                succeeded = false;
+            }
+
+            if (!succeeded)
+            {
+                return false;
+            }
+        }
+
+        // 求解器目前只有球体碰撞约束
+        if (type != "sphere")
+        {
+            logDebug("ClothSceneLoader: " + context + " has unsupported collider type \"" + type + "\", only sphere is supported");
+            return false;
+        }
+
+        if (sphere.radius <= 0.0f)
+        {
+            logDebug("ClothSceneLoader: " + context + ".radius must be positive");
+            return false;
+        }
+
+        return true;
+    }
+
+    // 参数扫描最多展开的配置数，避免维度过多时耗尽内存
+    const size_t kMaxSweepConfigCount = 100000;
+
+    // 扫描取值在日志和CSV中的文本
+    std::string FormatSweepValue(const JsonValue& value)
+    {
+        switch (value.type)
+        {
+        case JsonValue::Type::Bool:
+            return value.boolValue ? "true" : "false";
+        case JsonValue::Type::Number:
+        {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.9g", value.number);
+            return buffer;
+        }
+        case JsonValue::Type::String:
+            return value.string;
+        case JsonValue::Type::Object:
+        {
+            if (const JsonValue* name = value.Find("name"))
+            {
+                if (name->type == JsonValue::Type::String)
+                {
+                    return name->string;
+                }
+            }
+
+            std::string text;
+            for (const auto& member : value.members)
+            {
+                text += (text.empty() ? "" : " ") + member.first + "=" + FormatSweepValue(member.second);
+            }
+            return text;
+        }
+        default:
+            return "";
+        }
+    }
+
+    // 读取参数扫描，按维度取值的所有组合展开第一块布料
+    // 参数：
+    //   value - "sweep"对象
+    //   baseCloth - 场景中的第一块布料
+    //   axes - 输出维度名称
+    //   configs - 输出展开后的配置
+    bool ReadSweep(const JsonValue& value, const ClothSceneCloth& baseCloth, std::vector<std::string>& axes, std::vector<ClothSceneSweepConfig>& configs)
+    {
+        if (value.type != JsonValue::Type::Object || value.members.empty())
+        {
+            logDebug("ClothSceneLoader: sweep must be a non-empty object");
+            return false;
+        }
+
+        size_t configCount = 1;
+        for (const auto& member : value.members)
+        {
+            const JsonValue& values = member.second;
+            if (values.type != JsonValue::Type::Array || values.elements.empty())
+            {
+                logDebug("ClothSceneLoader: sweep." + member.first + " must be a non-empty array");
+                return false;
+            }
+
+            if (configCount > kMaxSweepConfigCount / values.elements.size())
+            {
+                logDebug("ClothSceneLoader: sweep expands to more than " + std::to_string(kMaxSweepConfigCount) + " configurations");
+                return false;
+            }
+            configCount *= values.elements.size();
+        }
+
+        axes.clear();
+        configs.clear();
+        for (const auto& member : value.members)
+        {
+            axes.push_back(member.first);
+        }
+
+        static const char* const kReservedValueKeys[] = { "name", nullptr };
+        std::vector<size_t> indices(axes.size(), 0);
+
+        for (size_t configIndex = 0; configIndex < configCount; ++configIndex)
+        {
+            ClothSceneSweepConfig config;
+            config.cloth = baseCloth;
+            config.cloth.name = baseCloth.name;
+
+            for (size_t axis = 0; axis < axes.size(); ++axis)
+            {
+                const JsonValue& element = value.members[axis].second.elements[indices[axis]];
+                const std::string context = "sweep." + axes[axis] + "[" + std::to_string(indices[axis]) + "]";
+
+                // 标量取值作为与维度同名的设置，在整个sweep对象中查找同时扫描的相关设置（例如小步长模式的子步数）
+                bool succeeded = element.type == JsonValue::Type::Object
+                    ? ReadClothSettings(element, context, kReservedValueKeys, config.cloth)
+                    : ReadClothSetting(value, axes[axis], element, "sweep", config.cloth);
+                if (!succeeded)
+                {
+                    return false;
+                }
+
+                config.values.push_back(FormatSweepValue(element));
+                config.cloth.name += " " + axes[axis] + "=" + config.values.back();
+            }
+
+            // 网格坐标形式的固定粒子已按第一块布料的分辨率换算成索引，分辨率不同时不再对应原来的位置
+            if (config.cloth.pinsSpecified
+                && (config.cloth.widthResolution != baseCloth.widthResolution || config.cloth.heightResolution != baseCloth.heightResolution))
+            {
+                logDebug("ClothSceneLoader: sweep changes the resolution of " + baseCloth.name + ", which has explicit pins; remove the pins to use the default corners");
+                return false;
+            }
+
+            if (!ValidateCloth(config.cloth, "sweep configuration" + config.cloth.name.substr(baseCloth.name.size())))
+            {
+                return false;
+            }
+
+            configs.push_back(config);
+
+            // 最后一个维度变化最快
+            for (size_t axis = axes.size(); axis-- > 0; )
+            {
+                if (++indices[axis] < value.members[axis].second.elements.size())
+                {
+                    break;
+                }
+                indices[axis] = 0;
+            }
+        }
+
+        return true;
+    }
+}
+
+bool ClothSceneLoader::Load(const std::string& path, const ClothSceneCloth& clothDefaults, ClothSceneDescription& scene)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        logDebug("ClothSceneLoader: failed to open " + path);
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    JsonValue root;
+    std::string error;
+    JsonParser parser(text);
+    if (!parser.Parse(root, error))
+    {
+        logDebug("ClothSceneLoader: " + path + " " + error);
+        return false;
+    }
+
+    if (root.type != JsonValue::Type::Object)
+    {
+        logDebug("ClothSceneLoader: " + path + " top-level value must be an object");
+        return false;
+    }
+
+    static const char* const kTopLevelKeys[] = { "solver", "materials", "cloths", "colliders", "light", "camera", "sweep" };
+    for (const auto& member : root.members)
+    {
+        bool known = false;
+        for (const char* key : kTopLevelKeys)
+        {
+            known = known || member.first == key;
+        }
+        if (!known)
+        {
+            logDebug("ClothSceneLoader: unknown top-level member " + member.first);
+            return false;
+        }
+    }
+
+    // 所有布料共用的设置
+    ClothSceneCloth sceneDefaults = clothDefaults;
+    if (const JsonValue* solver = root.Find("solver"))
+    {
+        if (!ReadClothSettings(*solver, "solver", nullptr, sceneDefaults))
+        {
+            return false;
+        }
+    }
+
+    const JsonValue* materials = root.Find("materials");
+    if (materials && materials->type != JsonValue::Type::Object)
+    {
+        logDebug("ClothSceneLoader: materials must be an object");
+        return false;
+    }
+
+    const JsonValue* cloths = root.Find("cloths");
+    if (!cloths || cloths->type != JsonValue::Type::Array || cloths->elements.empty())
+    {
+        logDebug("ClothSceneLoader: " + path + " must contain a non-empty cloths array");
+        return false;
+    }
+
+    std::vector<ClothSceneCloth> sceneCloths;
+    for (size_t i = 0; i < cloths->elements.size(); ++i)
+    {
+        const JsonValue& element = cloths->elements[i];
+        const std::string context = "cloths[" + std::to_string(i) + "]";
+        if (element.type != JsonValue::Type::Object)
+        {
+            logDebug("ClothSceneLoader: " + context + " must be an object");
+            return false;
+        }
+
+        ClothSceneCloth cloth = sceneDefaults;
+        cloth.name = "cloth" + std::to_string(i);
+
+        if (const JsonValue* name = element.Find("name"))
+        {
+            if (!ReadString(*name, context + ".name", cloth.name))
+            {
+                return false;
+            }
+        }
+
+        // 材质在布料自己的设置之前应用
+        if (const JsonValue* materialName = element.Find("material"))
+        {
+            std::string material;
+            if (!ReadString(*materialName, context + ".material", material))
+            {
+                return false;
+            }
+
+            const JsonValue* materialSettings = materials ? materials->Find(material.c_str()) : nullptr;
+            if (!materialSettings)
+            {
+                logDebug("ClothSceneLoader: " + context + " references unknown material " + material);
+                return false;
+            }
+
+            if (!ReadClothSettings(*materialSettings, "materials." + material, nullptr, cloth))
+            {
+                return false;
+            }
+        }
+
+        static const char* const kReservedClothKeys[] = { "name", "material", "pins", nullptr };
+        if (!ReadClothSettings(element, context, kReservedClothKeys, cloth))
+        {
+            return false;
+        }
+
+        // 网格坐标形式的固定粒子需要最终的分辨率，最后读取
+        if (const JsonValue* pins = element.Find("pins"))
+        {
+            if (!ReadPins(*pins, context + ".pins", cloth))
+            {
+                return false;
+            }
+        }
+
+        if (!ValidateCloth(cloth, context))
+        {
+            return false;
+        }
+
+        sceneCloths.push_back(cloth);
+    }
+
+    // 参数扫描基于第一块布料，与基准测试使用的布料一致
+    std::vector<std::string> sweepAxes;
+    std::vector<ClothSceneSweepConfig> sweepConfigs;
+    if (const JsonValue* sweep = root.Find("sweep"))
+    {
+        if (!ReadSweep(*sweep, sceneCloths[0], sweepAxes, sweepConfigs))
+        {
+            return false;
+        }
+    }
+
+    std::vector<ClothSceneSphere> spheres;
+    if (const JsonValue* colliders = root.Find("colliders"))
+    {
+        if (colliders->type != JsonValue::Type::Array)
+        {
+            logDebug("ClothSceneLoader: colliders must be an array");
+            return false;
+        }
+
+        for (size_t i = 0; i < colliders->elements.size(); ++i)
+        {
+            ClothSceneSphere sphere;
+            if (!ReadCollider(colliders->elements[i], "colliders[" + std::to_string(i) + "]", sphere))
+            {
+                return false;
+            }
+            spheres.push_back(sphere);
+        }
+    }
+
+    // 光源和相机，未指定的项保留调用者的默认值
+    dx::XMFLOAT3 lightPosition = scene.lightPosition;
+    dx::XMFLOAT4 lightDiffuseColor = scene.lightDiffuseColor;
+    if (const JsonValue* light = root.Find("light"))
+    {
+        const JsonValue* position = light->Find("position");
+        const JsonValue* color = light->Find("color");
+        if (light->type != JsonValue::Type::Object
+            || (position && !ReadFloat3(*position, "light.position", lightPosition))
+            || (color && !ReadFloat4(*color, "light.color", lightDiffuseColor)))
+        {
+            logDebug("ClothSceneLoader: light must be {\"position\": [x, y, z], \"color\": [r, g, b, a]}");
+            return false;
+        }
+    }
+
+    dx::XMFLOAT3 cameraPosition = scene.cameraPosition;
+    dx::XMFLOAT3 cameraTarget = scene.cameraTarget;
+    if (const JsonValue* camera = root.Find("camera"))
+    {
+        const JsonValue* position = camera->Find("position");
+        const JsonValue* target = camera->Find("target");
+        if (camera->type != JsonValue::Type::Object
+            || (position && !ReadFloat3(*position, "camera.position", cameraPosition))
+            || (target && !ReadFloat3(*target, "camera.target", cameraTarget)))
+        {
+            logDebug("ClothSceneLoader: camera must be {\"position\": [x, y, z], \"target\": [x, y, z]}");
+            return false;
+        }
+    }
+
+    // 全部读取成功后才修改输出
+    scene.cloths.swap(sceneCloths);
+    scene.spheres.swap(spheres);
+    scene.lightPosition = lightPosition;
+    scene.lightDiffuseColor = lightDiffuseColor;
+    scene.cameraPosition = cameraPosition;
+    scene.cameraTarget = cameraTarget;
+    scene.sweepAxes.swap(sweepAxes);
+    scene.sweepConfigs.swap(sweepConfigs);
+
+    logDebug("ClothSceneLoader: loaded " + path + " with " + std::to_string(scene.cloths.size()) + " cloths, "
+        + std::to_string(scene.spheres.size()) + " colliders and " + std::to_string(scene.sweepConfigs.size()) + " sweep configurations");
+    return true;
+}
+
+Cloth* ClothSceneLoader::CreateCloth(const ClothSceneCloth& description)
+{
+    Cloth* cloth = new Cloth(description.widthResolution, description.heightResolution, description.size, description.mass,
+        description.massMode, description.meshAndContraintMode);
+    cloth->SetMeshFile(description.meshFile);
+    cloth->SetParticleOrdering(description.particleOrdering);
+    if (description.pinsSpecified)
+    {
+        cloth->SetPinnedParticles(description.pins);
+        logDebug("Cloth " + description.name + " pinned particle count: " + std::to_string(description.pins.size()));
+    }
+
+    // 设置布料的物理参数
+    cloth->SetAddLRAConstraints(description.addLRAConstraints);
+    logDebug("Cloth add LRA constraints: " + std::to_string(description.addLRAConstraints));
+    cloth->SetAddBendingConstraints(description.addBendingConstraints);
+    logDebug("Cloth add bending constraints: " + std::to_string(description.addBendingConstraints));
+    cloth->SetAddDihedralBendingConstraints(description.addDihedralBendingConstraints);
+    logDebug("Cloth add dihedral bending constraints: " + std::to_string(description.addDihedralBendingConstraints));
+    cloth->SetAddIsometricBendingConstraints(description.addIsometricBendingConstraints);
+    logDebug("Cloth add isometric bending constraints: " + std::to_string(description.addIsometricBendingConstraints));
+    cloth->SetAddDiagonalConstraints(description.addDiagonalConstraints);
+    logDebug("Cloth add diagonal constraints: " + std::to_string(description.addDiagonalConstraints));
+    cloth->SetDistanceConstraintCompliance(description.distanceCompliance);
+    logDebug("Cloth distance constraint compliance set to: " + std::to_string(description.distanceCompliance));
+    cloth->SetDistanceConstraintDamping(description.distanceDamping);
+    logDebug("Cloth distance constraint damping set to: " + std::to_string(description.distanceDamping));
+    cloth->SetLRAMaxStretch(description.lraMaxStretch);
+    logDebug("Cloth LRA max stretch set to: " + std::to_string(description.lraMaxStretch));
+    cloth->SetLRAConstraintCompliance(description.lraCompliance);
+    logDebug("Cloth LRA constraint compliance set to: " + std::to_string(description.lraCompliance));
+    cloth->SetLRAConstraintDamping(description.lraDamping);
+    logDebug("Cloth LRA constraint damping set to: " + std::to_string(description.lraDamping));
+    cloth->SetBendingConstraintCompliance(description.bendingCompliance);
+    logDebug("Cloth bending constraint compliance set to: " + std::to_string(description.bendingCompliance));
+    cloth->SetBendingConstraintDamping(description.bendingDamping);
+    logDebug("Cloth bending constraint damping set to: " + std::to_string(description.bendingDamping));
+    cloth->SetDihedralBendingConstraintCompliance(description.dihedralBendingCompliance);
+    logDebug("Cloth dihedral bending constraint compliance set to: " + std::to_string(description.dihedralBendingCompliance));
+    cloth->SetDihedralBendingConstraintDamping(description.dihedralBendingDamping);
+    logDebug("Cloth dihedral bending constraint clamping set to: " + std::to_string(description.dihedralBendingDamping));
+    cloth->SetIsometricBendingConstraintCompliance(description.isometricBendingCompliance);
+    logDebug("Cloth isometric bending constraint compliance set to: " + std::to_string(description.isometricBendingCompliance));
+    cloth->SetIsometricBendingConstraintDamping(description.isometricBendingDamping);
+    logDebug("Cloth isometric bending constraint damping set to: " + std::to_string(description.isometricBendingDamping));
+    cloth->SetIteratorCount(description.iteratorCount);
+    logDebug("Cloth iterator count set to: " + std::to_string(description.iteratorCount));
+    cloth->SetSubIteratorCount(description.subIteratorCount);
+    logDebug("Cloth sub-iterator count set to: " + std::to_string(description.subIteratorCount));
+    cloth->SetLambdaWarmStartFactor(description.lambdaWarmStartFactor);
+    logDebug("Cloth lambda warm start factor set to: " + std::to_string(description.lambdaWarmStartFactor));
+    cloth->SetMinIteratorCount(description.minIteratorCount);
+    logDebug("Cloth min iterator count set to: " + std::to_string(description.minIteratorCount));
+    cloth->SetResidualTolerance(description.residualTolerance);
+    logDebug("Cloth residual tolerance set to: " + std::to_string(description.residualTolerance));
+    cloth->SetResidualStagnationRatio(description.residualStagnationRatio);
+    logDebug("Cloth residual stagnation ratio set to: " + std::to_string(description.residualStagnationRatio));
+    cloth->SetChebyshevAcceleration(description.chebyshevAcceleration);
+    logDebug("Cloth Chebyshev acceleration set to: " + std::to_string(description.chebyshevAcceleration));
+    cloth->SetChebyshevSpectralRadius(description.chebyshevSpectralRadius);
+    logDebug("Cloth Chebyshev spectral radius set to: " + std::to_string(description.chebyshevSpectralRadius));
+    cloth->SetOverRelaxationFactor(description.overRelaxationFactor);
+    logDebug("Cloth over-relaxation factor set to: " + std::to_string(description.overRelaxationFactor));
+    cloth->SetSleepEnabled(description.sleepEnabled);
+    logDebug("Cloth sleep enabled set to: " + std::to_string(description.sleepEnabled));
+    cloth->SetSleepVelocityThreshold(description.sleepVelocityThreshold);
+    logDebug("Cloth sleep velocity threshold set to: " + std::to_string(description.sleepVelocityThreshold));
+    cloth->SetSleepDisplacementThreshold(description.sleepDisplacementThreshold);
+    logDebug("Cloth sleep displacement threshold set to: " + std::to_string(description.sleepDisplacementThreshold));
+    cloth->SetSleepFrameCount(description.sleepFrameCount);
+    logDebug("Cloth sleep frame count set to: " + std::to_string(description.sleepFrameCount));
+    cloth->SetVelocityDamping(description.velocityDamping);
+    logDebug("Cloth velocity damping set to: " + std::to_string(description.velocityDamping));
+    cloth->SetMultigridLevelCount(description.multigridLevelCount);
+    logDebug("Cloth multigrid level count set to: " + std::to_string(description.multigridLevelCount));
+    cloth->SetMultigridIterationCount(description.multigridIterationCount);
+    logDebug("Cloth multigrid iteration count set to: " + std::to_string(description.multigridIterationCount));
+    cloth->SetDistanceSolveMode(description.distanceSolveMode);
+    logDebug("Cloth distance solve mode set to: " + std::string(description.distanceSolveMode == XPBDDistanceSolveMode::Direct ? "Direct" : "Iterative"));
+    cloth->SetDirectSolveIterationCount(description.directSolveIterationCount);
+    logDebug("Cloth direct solve iteration count set to: " + std::to_string(description.directSolveIterationCount));
+    cloth->SetScheduleMode(description.scheduleMode);
+    logDebug("Cloth schedule mode set to: " + std::string(description.scheduleMode == XPBDScheduleMode::SmallSteps ? "SmallSteps" : "Iterative"));
+    cloth->SetSolverType(description.solverType);
+    logDebug("Cloth solver set to: " + std::string(cloth->GetSolverName()));
+
+    // 设置位置和材质颜色
+    cloth->SetPosition(description.position);
+    cloth->SetDiffuseColor(description.diffuseColor);
+
+    return cloth;
+}
+
+bool ClothSceneLoader::InitializeSimulation(Cloth* cloth, const ClothSceneDescription& scene)
+{
+    if (!cloth->InitializeSimulation())
+    {
+        return false;
+    }
+
+    // 每个球体各自创建一组碰撞约束
+    for (const ClothSceneSphere& sphere : scene.spheres)
+    {
+        cloth->InitializeSphereCollisionConstraints(sphere.center, sphere.radius);
+    }
+    return true;
+}
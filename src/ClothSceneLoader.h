@@ -0,0 +1,135 @@
+#ifndef CLOTH_SCENE_LOADER_H
+#define CLOTH_SCENE_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "Cloth.h"
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 场景中的一块布料：网格、材质（质量和约束参数）、固定粒子和求解器设置
+struct ClothSceneCloth
+{
+    std::string name;                               // 布料名称，只用于日志
+
+    // 网格
+    int widthResolution;                            // 宽度分辨率（粒子数）
+    int heightResolution;                           // 高度分辨率（粒子数）
+    float size;                                     // 布料边长（Mesh模式为包围盒最长边）
+    dx::XMFLOAT3 position;                          // 布料最小角的位置
+    ClothMeshAndContraintMode meshAndContraintMode; // 网格和约束模式
+    std::string meshFile;                           // Mesh模式的三角网格文件
+    ClothParticleOrdering particleOrdering;         // 粒子重排序方式
+    bool pinsSpecified;                             // 是否指定了固定粒子，未指定时固定左上角和右上角
+    std::vector<uint32_t> pins;                     // 固定粒子的索引
+
+    // 材质
+    dx::XMFLOAT3 diffuseColor;                      // 漫反射颜色
+    float mass;                                     // 粒子质量（FixedTotalMass时为总质量）
+    ClothParticleMassMode massMode;                 // 质量模式
+    bool addLRAConstraints;
+    bool addBendingConstraints;
+    bool addDihedralBendingConstraints;
+    bool addIsometricBendingConstraints;
+    bool addDiagonalConstraints;
+    float distanceCompliance;
+    float distanceDamping;
+    float lraCompliance;
+    float lraDamping;
+    float lraMaxStretch;
+    float bendingCompliance;
+    float bendingDamping;
+    float dihedralBendingCompliance;
+    float dihedralBendingDamping;
+    float isometricBendingCompliance;
+    float isometricBendingDamping;
+
+    // 求解器
+    ClothSolverType solverType;
+    XPBDScheduleMode scheduleMode;
+    int iteratorCount;
+    uint32_t subIteratorCount;
+    uint32_t minIteratorCount;
+    float lambdaWarmStartFactor;
+    float residualTolerance;
+    float residualStagnationRatio;
+    bool chebyshevAcceleration;
+    float chebyshevSpectralRadius;
+    float overRelaxationFactor;
+    bool sleepEnabled;
+    float sleepVelocityThreshold;
+    float sleepDisplacementThreshold;
+    uint32_t sleepFrameCount;
+    float velocityDamping;
+    uint32_t multigridLevelCount;
+    uint32_t multigridIterationCount;
+    XPBDDistanceSolveMode distanceSolveMode;
+    uint32_t directSolveIterationCount;
+};
+
+// 球体碰撞体
+struct ClothSceneSphere
+{
+    dx::XMFLOAT3 center;
+    float radius;
+    dx::XMFLOAT3 diffuseColor;
+};
+
+// 参数扫描中的一个配置：场景中的第一块布料应用每个扫描维度的一个取值
+struct ClothSceneSweepConfig
+{
+    std::vector<std::string> values;            // 每个扫描维度的取值，与ClothSceneDescription::sweepAxes一一对应
+    ClothSceneCloth cloth;                      // 应用取值后的布料设置
+};
+
+// 场景描述：窗口模式和无窗口基准测试都按场景描述创建布料和碰撞体
+struct ClothSceneDescription
+{
+    std::vector<ClothSceneCloth> cloths;        // 布料，基准测试只使用第一块布料
+    std::vector<ClothSceneSphere> spheres;      // 球体碰撞体，与每块布料都发生碰撞
+    dx::XMFLOAT3 lightPosition;                 // 光源位置
+    dx::XMFLOAT4 lightDiffuseColor;             // 光源颜色
+    dx::XMFLOAT3 cameraPosition;                // 相机位置
+    dx::XMFLOAT3 cameraTarget;                  // 相机目标
+    std::vector<std::string> sweepAxes;         // 参数扫描的维度名称，为空表示没有参数扫描
+    std::vector<ClothSceneSweepConfig> sweepConfigs; // 所有维度取值的组合，最后一个维度变化最快
+};
+
+// 场景描述文件加载器
+// 文件为JSON格式，顶层对象的成员：
+//   "solver"    - 所有布料共用的求解器设置
+//   "materials" - 材质表，名称到布料设置的对象
+//   "cloths"    - 布料数组，每块布料可以用"material"引用材质，"pins"为固定粒子的数组，
+//                 元素为粒子索引或规则网格的[w, h]坐标
+//   "colliders" - 碰撞体数组，目前只支持{"type": "sphere", "center": [x, y, z], "radius": r}
+//   "light"     - {"position": [x, y, z], "color": [r, g, b, a]}
+//   "camera"    - {"position": [x, y, z], "target": [x, y, z]}
+//   "sweep"     - 参数扫描（-benchmark=sweep），每个成员是一个维度，值为取值数组；
+//                 取值为标量时作为与维度同名的布料设置，为对象时其中的设置一起应用（可以用"name"命名该取值），
+//                 例如{"iteratorCount": [4, 8], "grid": [{"name": "32", "widthResolution": 32, "heightResolution": 32}]}
+// 布料设置的键与命令行参数同名（例如"iteratorCount"、"distanceCompliance"、"scheduleMode"），
+// 另有"position"、"size"、"color"和"subIteratorCount"
+// 每块布料依次应用命令行参数（默认值）、"solver"、材质和布料自己的设置，后者覆盖前者
+class ClothSceneLoader
+{
+public:
+    // 加载场景描述文件
+    // 参数：
+    //   path - 文件路径
+    //   clothDefaults - 布料设置的默认值（通常来自命令行参数）
+    //   scene - 输出场景，调用前填好的光源和相机在文件没有指定时保留；布料、碰撞体和参数扫描替换为文件中的内容
+    // 返回：是否成功
+    static bool Load(const std::string& path, const ClothSceneCloth& clothDefaults, ClothSceneDescription& scene);
+
+    // 按布料描述创建布料对象（未初始化）
+    static Cloth* CreateCloth(const ClothSceneCloth& description);
+
+    // 创建布料的粒子和约束，并创建与场景中所有球体的碰撞约束
+    // 返回：是否成功
+    static bool InitializeSimulation(Cloth* cloth, const ClothSceneDescription& scene);
+};
+
+#endif // CLOTH_SCENE_LOADER_H
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <cctype>
+#include <cstring>
 
 // 命令行参数解析类
 class Commandline
@@ -30,13 +32,13 @@ public:
     // 检查是否存在指定参数
     bool Find(const char* param) const
     {
-        return m_cmdLine.find(param) != std::string::npos;
+        return FindParam(param) != std::string::npos;
     }
     
     // 获取整数类型参数值
     bool Get(const char* param, int& value, int defaultValue) const
     {
-        size_t pos = m_cmdLine.find(param);
+        size_t pos = FindParam(param);
         if (pos == std::string::npos)
         {
             value = defaultValue;
@@ -66,7 +68,7 @@ public:
     // 获取浮点数类型参数值
     bool Get(const char* param, float& value, float defaultValue) const
     {
-        size_t pos = m_cmdLine.find(param);
+        size_t pos = FindParam(param);
         if (pos == std::string::npos)
         {
             value = defaultValue;
@@ -96,7 +98,7 @@ public:
     // 获取布尔类型参数值
     bool Get(const char* param, bool& value, bool defaultValue) const
     {
-        size_t pos = m_cmdLine.find(param);
+        size_t pos = FindParam(param);
         if (pos == std::string::npos)
         {
             value = defaultValue;
@@ -132,7 +134,7 @@ public:
     // 获取无符号整数类型参数值
     bool Get(const char* param, uint32_t& value, uint32_t defaultValue) const
     {
-        size_t pos = m_cmdLine.find(param);
+        size_t pos = FindParam(param);
         if (pos == std::string::npos)
         {
             value = defaultValue;
@@ -162,7 +164,7 @@ public:
     // 获取字符串类型参数值
     bool Get(const char* param, std::string& value, const std::string& defaultValue) const
     {
-        size_t pos = m_cmdLine.find(param);
+        size_t pos = FindParam(param);
         if (pos == std::string::npos)
         {
             value = defaultValue;
@@ -187,6 +189,34 @@ public:
     }
     
 private:
+    // 查找参数的位置，参数必须位于一个参数项的开头（行首或空白之后），
+    // 不以'='结尾的开关必须是完整的参数项（其后为空白、'='或行尾），
+    // 避免-mass=匹配到其他参数值中的文字（例如-clothMesh=shirt-mass=2.obj），或-debug匹配到-debugLog
+    // 返回：参数的位置，未找到时返回std::string::npos
+    size_t FindParam(const char* param) const
+    {
+        const size_t length = strlen(param);
+        const bool hasValue = length > 0 && param[length - 1] == '=';
+
+        for (size_t pos = m_cmdLine.find(param); pos != std::string::npos; pos = m_cmdLine.find(param, pos + 1))
+        {
+            if (pos > 0 && !isspace((unsigned char)m_cmdLine[pos - 1]))
+            {
+                continue;
+            }
+
+            size_t end = pos + length;
+            if (!hasValue && end < m_cmdLine.length() && !isspace((unsigned char)m_cmdLine[end]) && m_cmdLine[end] != '=')
+            {
+                continue;
+            }
+
+            return pos;
+        }
+
+        return std::string::npos;
+    }
+
     std::string m_cmdLine; // 存储命令行参数字符串
 };
 
@@ -8,6 +8,7 @@
 namespace dx = DirectX;
 
 // 约束基类，所有类型的约束都应继承自这个类
+// 派生类需要声明编译期常量kArity（受约束影响的粒子数），求解器按kArity展开求解过程，梯度直接放在栈上
 class Constraint
 {
 public:
@@ -16,8 +17,7 @@ public:
     //   compliance - 柔度（与刚度成反比，值越小刚度越大）
     //   damping - 阻尼系数
     Constraint(float compliance, float damping)
-        : m_lambda(0.0f)
-        , m_compliance(compliance)
+        : m_compliance(compliance)
         , m_damping(damping)
     {}
 
@@ -51,6 +51,26 @@ public:
 
     }
 
+    // 获取静止参数的个数（创建时由静止状态或碰撞体决定的参数，不含柔度和阻尼），用于保存检查点
+    virtual uint32_t GetRestParameterCount() const
+    {
+        return 0;
+    }
+
+    // 读取静止参数
+    // 参数：
+    //   parameters - 输出，至少GetRestParameterCount()个
+    virtual void GetRestParameters(float* parameters) const
+    {
+    }
+
+    // 写入静止参数，用于恢复检查点
+    // 参数：
+    //   parameters - GetRestParameterCount()个静止参数
+    virtual void SetRestParameters(const float* parameters)
+    {
+    }
+
     // 设置约束的柔度
     // 参数：
     //   c - 新的柔度值
@@ -81,23 +101,7 @@ public:
         return m_damping;
     }
 
-    // 设置拉格朗日乘子
-    // 参数：
-    //   l - 新的拉格朗日乘子
-    inline void SetLambda(float l)
-    {
-        m_lambda = l;
-    }
-
-    // 获取拉格朗日乘子
-    // 返回：拉格朗日乘子
-    inline float GetLambda() const
-    {
-        return m_lambda;
-    }
-
 protected:
-    float m_lambda;         // 拉格朗日乘子
     float m_compliance;     // 柔度（与刚度成反比）
     float m_damping;        // 阻尼系数，控制约束方向的阻尼强度，0为无阻尼
 };
@@ -1,6 +1,7 @@
 #include "DX12RALCommandList.h"
 #include "DX12RALResource.h"
 #include <vector>
+#include <stdexcept>
 
 // 前向声明
 D3D12_RESOURCE_STATES ConvertToDX12ResourceState(RALResourceState state);
@@ -77,6 +78,22 @@ void DX12RALGraphicsCommandList::Reset()
     m_commandList->Reset(m_commandAllocator.Get(), nullptr);
 }
 
+// 重置命令分配器并重新开始录制
+void DX12RALGraphicsCommandList::ResetWithAllocator()
+{
+    HRESULT hr = m_commandAllocator->Reset();
+    if (FAILED(hr))
+    {
+        throw std::runtime_error("Failed to reset command allocator.");
+    }
+
+    hr = m_commandList->Reset(m_commandAllocator.Get(), nullptr);
+    if (FAILED(hr))
+    {
+        throw std::runtime_error("Failed to reset command list.");
+    }
+}
+
 // 获取原生命令列表指针
 void* DX12RALGraphicsCommandList::GetNativeCommandList()
 {
@@ -272,35 +289,71 @@ void DX12RALGraphicsCommandList::DrawIndexed(uint32_t indexCount, uint32_t insta
 }
 
 // 绘制调用（间接）
-void DX12RALGraphicsCommandList::DrawIndirect(void* bufferLocation, uint32_t drawCount, uint32_t stride)
+void DX12RALGraphicsCommandList::DrawIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride)
 {
-    // DirectX 12中没有直接的DrawIndirect方法，需要使用ExecuteIndirect
-    // 这里简化处理，实际项目中需要创建命令签名
-    // 注意：这个实现是简化版本，实际项目中需要完整实现ExecuteIndirect的逻辑
-    if (bufferLocation)
-    {
-        // 暂时不实现，返回警告或错误
-        // 实际实现需要：
-        // 1. 创建命令签名 (ID3D12CommandSignature)
-        // 2. 设置正确的参数缓冲区
-        // 3. 调用ExecuteIndirect方法
-    }
+    if (!argumentBuffer || drawCount == 0)
+        return;
+
+    // DirectX 12中没有直接的DrawIndirect方法，通过命令签名 + ExecuteIndirect实现
+    ID3D12CommandSignature* signature = GetCommandSignature(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, stride);
+    if (!signature)
+        return;
+
+    ID3D12Resource* resource = static_cast<ID3D12Resource*>(argumentBuffer->GetNativeResource());
+    m_commandList->ExecuteIndirect(signature, drawCount, resource, argumentOffset, nullptr, 0);
 }
 
 // 绘制调用（索引间接）
-void DX12RALGraphicsCommandList::DrawIndexedIndirect(void* bufferLocation, uint32_t drawCount, uint32_t stride)
+void DX12RALGraphicsCommandList::DrawIndexedIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride)
+{
+    if (!argumentBuffer || drawCount == 0)
+        return;
+
+    ID3D12CommandSignature* signature = GetCommandSignature(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, stride);
+    if (!signature)
+        return;
+
+    ID3D12Resource* resource = static_cast<ID3D12Resource*>(argumentBuffer->GetNativeResource());
+    m_commandList->ExecuteIndirect(signature, drawCount, resource, argumentOffset, nullptr, 0);
+}
+
+// 获取（必要时创建）间接绘制使用的命令签名
+ID3D12CommandSignature* DX12RALGraphicsCommandList::GetCommandSignature(D3D12_INDIRECT_ARGUMENT_TYPE argumentType, uint32_t stride)
 {
-    // DirectX 12中没有直接的DrawIndexedIndirect方法，需要使用ExecuteIndirect
-    // 这里简化处理，实际项目中需要创建命令签名
-    // 注意：这个实现是简化版本，实际项目中需要完整实现ExecuteIndirect的逻辑
-    if (bufferLocation)
+    for (const CommandSignatureEntry& entry : m_commandSignatures)
+    {
+        if (entry.argumentType == argumentType && entry.stride == stride)
+        {
+            return entry.signature.Get();
+        }
+    }
+
+    // 命令签名只包含绘制参数，不修改根参数，因此不需要根签名
+    D3D12_INDIRECT_ARGUMENT_DESC argumentDesc = {};
+    argumentDesc.Type = argumentType;
+
+    D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+    signatureDesc.ByteStride = stride;
+    signatureDesc.NumArgumentDescs = 1;
+    signatureDesc.pArgumentDescs = &argumentDesc;
+    signatureDesc.NodeMask = 0;
+
+    ComPtr<ID3D12Device> device;
+    if (FAILED(m_commandList->GetDevice(IID_PPV_ARGS(device.GetAddressOf()))))
     {
-        // 暂时不实现，返回警告或错误
-        // 实际实现需要：
-        // 1. 创建命令签名 (ID3D12CommandSignature)
-        // 2. 设置正确的参数缓冲区
-        // 3. 调用ExecuteIndirect方法
+        return nullptr;
     }
+
+    CommandSignatureEntry entry;
+    entry.argumentType = argumentType;
+    entry.stride = stride;
+    if (FAILED(device->CreateCommandSignature(&signatureDesc, nullptr, IID_PPV_ARGS(entry.signature.GetAddressOf()))))
+    {
+        return nullptr;
+    }
+
+    m_commandSignatures.push_back(entry);
+    return entry.signature.Get();
 }
 
 // 设置渲染目标
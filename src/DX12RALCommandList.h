@@ -3,6 +3,7 @@
 #include "RALCommandList.h"
 #include <d3d12.h>
 #include <wrl.h>
+#include <vector>
 
 using Microsoft::WRL::ComPtr;
 
@@ -21,6 +22,9 @@ public:
     virtual void Reset() override;
     virtual void* GetNativeCommandList() override;
 
+    // 重置命令分配器并重新开始录制，调用前必须确保GPU已经执行完该分配器上的命令
+    void ResetWithAllocator();
+
     // 从IRALGraphicsCommandList继承的方法
     virtual void ClearRenderTarget(IRALRenderTargetView* renderTargetView, const RALClearValue& clearValue) override;
     virtual void ClearDepthStencil(IRALDepthStencilView* depthStencilView, const RALClearValue& clearValue) override;
@@ -39,8 +43,8 @@ public:
     virtual void SetGraphicsRootUnorderedAccess(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer) override;
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) override;
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
-    virtual void DrawIndirect(void* bufferLocation, uint32_t drawCount, uint32_t stride) override;
-    virtual void DrawIndexedIndirect(void* bufferLocation, uint32_t drawCount, uint32_t stride) override;
+    virtual void DrawIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride) override;
+    virtual void DrawIndexedIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride) override;
     virtual void SetRenderTargets(uint32_t renderTargetCount, IRALRenderTargetView** renderTargetViews, IRALDepthStencilView* depthStencilView) override;
     // 执行渲染通道
     virtual void ExecuteRenderPass(const void* renderPass, const void* framebuffer) override;
@@ -48,8 +52,23 @@ public:
     // 设置图元拓扑
     virtual void SetPrimitiveTopology(RALPrimitiveTopologyType topology) override;
 
+private:
+    // 获取（必要时创建）间接绘制使用的命令签名
+    ID3D12CommandSignature* GetCommandSignature(D3D12_INDIRECT_ARGUMENT_TYPE argumentType, uint32_t stride);
+
+    // 命令签名缓存项，按参数类型和跨度区分
+    struct CommandSignatureEntry
+    {
+        D3D12_INDIRECT_ARGUMENT_TYPE argumentType;
+        uint32_t stride;
+        ComPtr<ID3D12CommandSignature> signature;
+    };
+
 private:
     // 成员变量
     ComPtr<ID3D12CommandAllocator> m_commandAllocator;
     ComPtr<ID3D12GraphicsCommandList> m_commandList;
+
+    // 间接绘制命令签名缓存
+    std::vector<CommandSignatureEntry> m_commandSignatures;
 };
\ No newline at end of file
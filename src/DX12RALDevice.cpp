@@ -101,6 +101,11 @@ void DX12RALDevice::BeginFrame()
         throw std::runtime_error("Failed to reset command list.");
     }
 
+    // 每帧从第一个主命令列表开始录制，上一帧使用的并行命令列表全部归还到池中
+    m_currentGraphicsCommandList = m_graphicsCommandList;
+    m_frameCommandLists.clear();
+    m_commandListPoolUsed = 0;
+
     // 资源转换：设置渲染目标为渲染状态
     D3D12_RESOURCE_BARRIER barrier = {};
     barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -162,8 +167,8 @@ void DX12RALDevice::BeginFrame()
 
 void DX12RALDevice::EndFrame()
 {
-    // 关闭命令列表
-    ID3D12GraphicsCommandList* commandList = (ID3D12GraphicsCommandList*)m_graphicsCommandList->GetNativeCommandList();
+    // 资源转换在最后一个主命令列表上录制
+    ID3D12GraphicsCommandList* commandList = (ID3D12GraphicsCommandList*)m_currentGraphicsCommandList->GetNativeCommandList();
 
     // 资源转换：设置渲染目标为呈现状态
     D3D12_RESOURCE_BARRIER barrier = {};
@@ -174,11 +179,18 @@ void DX12RALDevice::EndFrame()
     barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
     commandList->ResourceBarrier(1, &barrier);
 
-    commandList->Close();
+    // 按录制顺序关闭并一次性提交本帧所有命令列表
+    m_frameCommandLists.push_back(m_currentGraphicsCommandList.Get());
 
-    ID3D12CommandList* ppCommandLists[] = { commandList };
+    std::vector<ID3D12CommandList*> commandLists;
+    commandLists.reserve(m_frameCommandLists.size());
+    for (IRALGraphicsCommandList* frameCommandList : m_frameCommandLists)
+    {
+        frameCommandList->Close();
+        commandLists.push_back((ID3D12CommandList*)frameCommandList->GetNativeCommandList());
+    }
 
-    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    m_commandQueue->ExecuteCommandLists((UINT)commandLists.size(), commandLists.data());
 
     // 呈现
     HRESULT presentHr = m_swapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
@@ -191,6 +203,11 @@ void DX12RALDevice::EndFrame()
     WaitForPreviousFrame();
 
     m_uploadingResources.clear();
+
+    // GPU已执行完毕，下一次录制从第一个主命令列表开始
+    m_frameCommandLists.clear();
+    m_commandListPoolUsed = 0;
+    m_currentGraphicsCommandList = m_graphicsCommandList;
 }
 
 // 创建设备和交换链
@@ -395,6 +412,7 @@ void DX12RALDevice::CreateCommandObjects()
     // 创建DX12RALGraphicsCommandList实例
     m_graphicsCommandList = new DX12RALGraphicsCommandList(m_commandAllocators[0].Get(), commandList.Get());
     m_graphicsCommandList->Reset();
+    m_currentGraphicsCommandList = m_graphicsCommandList;
 }
 
 // 创建描述符堆
@@ -2311,7 +2329,8 @@ bool DX12RALDevice::UploadBuffer(IRALBuffer* buffer, const char* data, uint64_t
     memcpy(mappedData, data, size);
     uploadBuffer->Unmap(0, nullptr);
 
-    ID3D12GraphicsCommandList* commandList = (ID3D12GraphicsCommandList*)m_graphicsCommandList->GetNativeCommandList();
+    // 复制命令录制到当前主命令列表，保证在之后录制的绘制命令之前执行
+    ID3D12GraphicsCommandList* commandList = (ID3D12GraphicsCommandList*)m_currentGraphicsCommandList->GetNativeCommandList();
 
     RALResourceState oldState = buffer->GetResourceState();
 
@@ -2345,7 +2364,82 @@ bool DX12RALDevice::UploadBuffer(IRALBuffer* buffer, const char* data, uint64_t
 
 IRALGraphicsCommandList* DX12RALDevice::GetGraphicsCommandList()
 {
-    return m_graphicsCommandList.Get();
+    return m_currentGraphicsCommandList.Get();
+}
+
+bool DX12RALDevice::AcquireParallelGraphicsCommandLists(uint32_t count, IRALGraphicsCommandList** outCommandLists)
+{
+    if (count == 0 || !outCommandLists)
+    {
+        return false;
+    }
+
+    // 当前主命令列表到此结束，排在并行命令列表之前提交
+    m_frameCommandLists.push_back(m_currentGraphicsCommandList.Get());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        IRALGraphicsCommandList* commandList = AcquirePooledCommandList();
+        SetupFrameDefaultState(commandList);
+        m_frameCommandLists.push_back(commandList);
+        outCommandLists[i] = commandList;
+    }
+
+    // 之后录制到主命令列表的命令排在并行命令列表之后
+    IRALGraphicsCommandList* nextCommandList = AcquirePooledCommandList();
+    SetupFrameDefaultState(nextCommandList);
+    m_currentGraphicsCommandList = nextCommandList;
+
+    return true;
+}
+
+IRALGraphicsCommandList* DX12RALDevice::AcquirePooledCommandList()
+{
+    if (m_commandListPoolUsed == m_commandListPool.size())
+    {
+        ComPtr<ID3D12CommandAllocator> commandAllocator;
+        HRESULT hr = m_device->CreateCommandAllocator(
+            D3D12_COMMAND_LIST_TYPE_DIRECT,
+            IID_PPV_ARGS(commandAllocator.ReleaseAndGetAddressOf())
+        );
+        if (FAILED(hr))
+        {
+            throw std::runtime_error("Failed to create command allocator.");
+        }
+
+        ComPtr<ID3D12GraphicsCommandList> commandList;
+        hr = m_device->CreateCommandList(
+            0,
+            D3D12_COMMAND_LIST_TYPE_DIRECT,
+            commandAllocator.Get(),
+            nullptr,
+            IID_PPV_ARGS(commandList.ReleaseAndGetAddressOf())
+        );
+        if (FAILED(hr))
+        {
+            throw std::runtime_error("Failed to create command list.");
+        }
+
+        // 关闭命令列表（初始状态是打开的），统一在下面重置
+        commandList->Close();
+
+        m_commandListPool.push_back(new DX12RALGraphicsCommandList(commandAllocator.Get(), commandList.Get()));
+    }
+
+    // 池中的命令列表只在上一帧GPU执行完毕后才会被复用，可以安全地重置分配器
+    DX12RALGraphicsCommandList* commandList = static_cast<DX12RALGraphicsCommandList*>(m_commandListPool[m_commandListPoolUsed++].Get());
+    commandList->ResetWithAllocator();
+
+    return commandList;
+}
+
+void DX12RALDevice::SetupFrameDefaultState(IRALGraphicsCommandList* commandList)
+{
+    // 新的D3D12命令列表不继承任何状态，需要重新设置BeginFrame中设置的默认状态
+    IRALRenderTargetView* backBufferRTV = m_backBufferRTVs[m_currentBackBufferIndex].Get();
+    commandList->SetRenderTargets(1, &backBufferRTV, m_mainDepthStencilView.Get());
+    commandList->SetViewport(0.0f, 0.0f, static_cast<float>(m_width), static_cast<float>(m_height), 0.0f, 1.0f);
+    commandList->SetScissorRect(0, 0, static_cast<int32_t>(m_width), static_cast<int32_t>(m_height));
 }
 
 // 清理资源
@@ -326,6 +326,9 @@ public:
     // 获得GraphicsCommandList
     virtual IRALGraphicsCommandList* GetGraphicsCommandList() override;
 
+    // 获取用于多线程并行录制的图形命令列表
+    virtual bool AcquireParallelGraphicsCommandLists(uint32_t count, IRALGraphicsCommandList** outCommandLists) override;
+
     // 创建渲染目标
     virtual IRALRenderTarget* CreateRenderTarget(uint32_t width, uint32_t height, RALDataFormat format, const RALClearValue* clearValue = nullptr, const wchar_t* debugName = nullptr) override;
 
@@ -386,6 +389,12 @@ private:
     // 等待前一帧完成
     void WaitForPreviousFrame();
 
+    // 从命令列表池中取出一个已重置的命令列表（拥有独立的命令分配器）
+    IRALGraphicsCommandList* AcquirePooledCommandList();
+
+    // 为新开始录制的命令列表设置帧默认状态（backbuffer渲染目标、视口和裁剪矩形）
+    void SetupFrameDefaultState(IRALGraphicsCommandList* commandList);
+
 	// 检查资源是否正在上传
 	bool IsUploadingResource(ID3D12Resource* resource) const;
 	void AddUploadingResource(ID3D12Resource* resource, const ComPtr<ID3D12Resource>& uploadBuffer);
@@ -408,7 +417,13 @@ private:
     // 命令对象 - 主渲染
     ComPtr<ID3D12CommandAllocator> m_commandAllocators[2];      // 命令分配器数组
     ComPtr<ID3D12CommandQueue> m_commandQueue;                  // 命令队列
-    TRefCountPtr<IRALGraphicsCommandList> m_graphicsCommandList;   // 渲染命令列表
+    TRefCountPtr<IRALGraphicsCommandList> m_graphicsCommandList;   // 渲染命令列表（每帧的第一个主命令列表）
+    TRefCountPtr<IRALGraphicsCommandList> m_currentGraphicsCommandList;   // 当前录制中的主命令列表
+
+    // 命令对象 - 并行录制
+    std::vector<TRefCountPtr<IRALGraphicsCommandList>> m_commandListPool;  // 命令列表池，每个命令列表拥有独立的命令分配器
+    uint32_t m_commandListPoolUsed = 0;                         // 本帧已使用的池中命令列表数量
+    std::vector<IRALGraphicsCommandList*> m_frameCommandLists;  // 本帧已结束录制、等待提交的命令列表（按提交顺序）
 
     // 同步对象 - 主渲染
     ComPtr<ID3D12Fence> m_fence;                                // 围栏
@@ -17,6 +17,9 @@ namespace dx = DirectX;
 class DihedralBendingConstraint : public Constraint
 {
 public:
+    // 受约束影响的粒子数：共享一条边的两个三角形的4个顶点
+    static const uint32_t kArity = 4;
+
     // 构造函数
     // 参数：
     //   p1, p2 - 两个三角形共享边的顶点（公共边为p1-p2）
@@ -201,7 +204,7 @@ public:
     // 获取受此约束影响的粒子数量
     uint32_t GetParticlesCount() const override
     {
-        return 4; // 二面角约束涉及4个顶点
+        return kArity; // 二面角约束涉及4个顶点
     }
 
     // 获取受此约束影响的粒子数组
@@ -242,6 +245,22 @@ public:
         return m_restDihedralAngle;
     }
 
+    // 静止参数：静止二面角（直接写入，不经过SetRestDihedralAngle的范围限制，保证恢复后逐位一致）
+    uint32_t GetRestParameterCount() const override
+    {
+        return 1;
+    }
+
+    void GetRestParameters(float* parameters) const override
+    {
+        parameters[0] = m_restDihedralAngle;
+    }
+
+    void SetRestParameters(const float* parameters) override
+    {
+        m_restDihedralAngle = parameters[0];
+    }
+
     // 获取约束类型
     const char* GetConstraintType() const override
     {
@@ -17,6 +17,9 @@ namespace dx = DirectX;
 class DistanceConstraint : public Constraint 
 {
 public:
+    // 受约束影响的粒子数：两个粒子
+    static const uint32_t kArity = 2;
+
     // 构造函数
     // 参数：
     //   p1 - 第一个粒子的指针
@@ -79,7 +82,7 @@ public:
     // 返回：受约束影响的粒子数量
     virtual uint32_t GetParticlesCount() const override
     {
-        return 2;
+        return kArity;
     }
 
     // 获取受此约束影响的所有粒子
@@ -111,6 +114,22 @@ public:
         return m_restLength;
     }
     
+    // 静止参数：静止长度
+    virtual uint32_t GetRestParameterCount() const override
+    {
+        return 1;
+    }
+
+    virtual void GetRestParameters(float* parameters) const override
+    {
+        parameters[0] = m_restLength;
+    }
+
+    virtual void SetRestParameters(const float* parameters) override
+    {
+        m_restLength = parameters[0];
+    }
+
     // 获取约束类型
     virtual const char* GetConstraintType() const override
     {
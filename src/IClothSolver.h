@@ -0,0 +1,123 @@
+#ifndef ICLOTH_SOLVER_H
+#define ICLOTH_SOLVER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 布料求解器类型
+enum class ClothSolverType
+{
+    XPBD,               // XPBD：按颜色并行的高斯-赛德尔约束投影
+    ProjectiveDynamics, // Projective Dynamics：并行局部投影 + 预分解的全局线性求解
+};
+
+// 一类约束在一次迭代中的残差（求解前的约束违反量|C|）
+struct ClothConstraintResidual
+{
+    float maxError;             // 最大残差
+    float rmsError;             // 均方根残差
+    uint32_t constraintCount;   // 约束数量
+};
+
+// 求解器本帧各阶段的耗时（毫秒，所有子步和迭代之和）
+struct ClothSolverPhaseTimes
+{
+    double setup;               // 重新着色、筛选活动约束、建立和分解矩阵等准备工作
+    double integrate;           // 预测位置、更新速度等逐粒子阶段
+    double globalSolve;         // 粗网格求解和距离约束的直接求解（XPBD），全局线性求解（Projective Dynamics）
+    double constraints;         // 约束投影迭代（XPBD的高斯-赛德尔迭代和Chebyshev外推，Projective Dynamics的局部投影）
+    double sleeping;            // 休眠检测
+};
+
+// 作用域计时，析构时把耗时累加到指定阶段
+class ScopedSolverPhaseTimer
+{
+public:
+    explicit ScopedSolverPhaseTimer(double& milliseconds)
+        : m_milliseconds(milliseconds)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedSolverPhaseTimer()
+    {
+        m_milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    ScopedSolverPhaseTimer(const ScopedSolverPhaseTimer&);
+    ScopedSolverPhaseTimer& operator=(const ScopedSolverPhaseTimer&);
+
+    double& m_milliseconds;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// 求解器单帧统计
+struct ClothSolverStats
+{
+    // 最后一个子步最后一次迭代的各类约束残差
+    ClothConstraintResidual distance;
+    ClothConstraintResidual dihedralBending;
+    ClothConstraintResidual isometricBending;
+    ClothConstraintResidual lra;
+    ClothConstraintResidual collision;
+
+    float maxError;             // 所有约束的最大残差
+    float rmsError;             // 所有约束的均方根残差
+    uint32_t sleepingParticleCount; // 休眠的粒子数
+    uint32_t iterationCount;    // 本帧实际执行的迭代总数（所有子步之和）
+    uint32_t iterationBudget;   // 本帧最多允许的迭代总数
+    bool converged;             // 最后一个子步是否在容差内提前结束
+    ClothSolverPhaseTimes phaseTimes; // 各阶段的耗时
+};
+
+// 布料求解器接口
+// 求解器直接读写所属布料的粒子和约束，布料参数（迭代次数、子步数等）由各实现按需解释
+class IClothSolver
+{
+public:
+    virtual ~IClothSolver()
+    {
+    }
+
+    // 获取求解器名称
+    virtual const char* GetName() const = 0;
+
+    // 模拟一帧
+    virtual void Step(float deltaTime) = 0;
+
+    // 约束增删后调用，下一次Step时重新建立依赖约束拓扑的数据
+    virtual void InvalidateConstraints() = 0;
+
+    // 唤醒所有休眠的粒子（不支持休眠的求解器不需要处理）
+    virtual void WakeAll() = 0;
+
+    // 唤醒与球体相交的休眠粒子
+    // 参数：
+    //   center - 球心
+    //   radius - 半径
+    virtual void WakeInSphere(const dx::XMFLOAT3& center, float radius) = 0;
+
+    // 获取最近一帧的求解统计
+    virtual const ClothSolverStats& GetStats() const = 0;
+
+    // 保存跨帧保留的内部状态（拉格朗日乘子、休眠计数、统计等），用于检查点
+    // 参数：
+    //   state - 输出，状态数据追加到末尾
+    virtual void SaveState(std::vector<char>& state) const = 0;
+
+    // 恢复SaveState保存的状态，调用前布料的粒子和约束必须已经恢复
+    // 参数：
+    //   data - 状态数据
+    //   size - 状态数据的字节数
+    // 返回：是否成功，失败时状态与新建的求解器相同
+    virtual bool LoadState(const char* data, size_t size) = 0;
+};
+
+#endif // ICLOTH_SOLVER_H
@@ -83,9 +83,23 @@ public:
     // 更新Buffer
     virtual bool UploadBuffer(IRALBuffer* buffer, const char* data, uint64_t size) = 0;
 
-    // 获得GraphicsCommandList
+    // 获得GraphicsCommandList（当前录制中的主命令列表）
     virtual IRALGraphicsCommandList* GetGraphicsCommandList() = 0;
 
+    // 获取用于多线程并行录制的图形命令列表
+    // 参数：
+    //   count - 需要的命令列表数量
+    //   outCommandLists - 输出的命令列表数组，长度至少为count
+    // 返回值：
+    //   是否成功
+    // 说明：
+    //   每个命令列表拥有独立的命令分配器，已重置并设置好帧默认状态（backbuffer渲染目标、视口、裁剪矩形），
+    //   可以在不同线程上同时录制，但同一个命令列表只能由一个线程录制。
+    //   提交顺序为：调用前主命令列表已录制的命令 -> outCommandLists[0..count) -> 调用后录制到主命令列表的命令，
+    //   调用之后GetGraphicsCommandList()会返回新的主命令列表。所有命令列表在EndFrame时按该顺序统一关闭并提交，
+    //   调用者不需要也不应该自行Close。
+    virtual bool AcquireParallelGraphicsCommandLists(uint32_t count, IRALGraphicsCommandList** outCommandLists) = 0;
+
     // 创建渲染目标
     virtual IRALRenderTarget* CreateRenderTarget(uint32_t width, uint32_t height, RALDataFormat format, const RALClearValue* clearValue = nullptr, const wchar_t* debugName = nullptr) = 0;
 
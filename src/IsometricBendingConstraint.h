@@ -0,0 +1,183 @@
+#ifndef ISOMETRIC_BENDING_CONSTRAINT_H
+#define ISOMETRIC_BENDING_CONSTRAINT_H
+
+#include "Constraint.h"
+#include <cmath>
+#include <DirectXMath.h>
+
+// 命名空间别名简化使用
+namespace dx = DirectX;
+
+// 等距弯曲约束类，继承自约束基类
+// 基于二次弯曲能量（Bergou等，"A Quadratic Bending Model for Inextensible Surfaces"）：
+//   E = 1/2 * Q * |Σ K_i * x_i|^2，K为公共边两侧三角形的余切权重组成的4点模板，Q = 3 / (A0 + A1)
+// 在近似等距（几乎不可拉伸）的变形下K和Q保持不变，因此在构造时根据静止位置预计算一次，
+// 求解时只需4次乘加得到v = Σ K_i * x_i，约束C = sqrt(2E) = sqrt(Q) * |v|，
+// 梯度为sqrt(Q) * K_i * v / |v|，没有叉积、acos和分支判断，能量的Hessian为常量。
+// 静止状态假定为平面（布料按平面网格生成），平面时v = 0
+class IsometricBendingConstraint : public Constraint
+{
+public:
+    // 受约束影响的粒子数：共享一条边的两个三角形的4个顶点
+    static const uint32_t kArity = 4;
+
+    // 构造函数
+    // 参数：
+    //   p1, p2 - 两个三角形共享边的顶点（公共边为p1-p2）
+    //   p3 - 第一个三角形的第三个顶点（三角形1：p1-p2-p3）
+    //   p4 - 第二个三角形的第三个顶点（三角形2：p1-p2-p4）
+    //   compliance - 约束的柔度
+    //   damping - 约束的阻尼
+    IsometricBendingConstraint(Particle* p1, Particle* p2, Particle* p3, Particle* p4,
+        float compliance, float damping)
+        : Constraint(compliance, damping)
+        , m_particle1(p1)
+        , m_particle2(p2)
+        , m_particle3(p3)
+        , m_particle4(p4)
+    {
+        ComputeStencil();
+    }
+
+    // 计算约束偏差和约束梯度
+    // 返回：约束偏差值C = sqrt(Q) * |Σ K_i * x_i|
+    float ComputeConstraintAndGradient(dx::XMFLOAT3* gradients) const override
+    {
+        dx::XMVECTOR v = dx::XMVectorScale(dx::XMLoadFloat3(&m_particle1->position), m_stencil[0]);
+        v = dx::XMVectorMultiplyAdd(dx::XMLoadFloat3(&m_particle2->position), dx::XMVectorReplicate(m_stencil[1]), v);
+        v = dx::XMVectorMultiplyAdd(dx::XMLoadFloat3(&m_particle3->position), dx::XMVectorReplicate(m_stencil[2]), v);
+        v = dx::XMVectorMultiplyAdd(dx::XMLoadFloat3(&m_particle4->position), dx::XMVectorReplicate(m_stencil[3]), v);
+
+        float length = dx::XMVectorGetX(dx::XMVector3Length(v));
+
+        // 平面状态，能量为零，梯度方向无定义
+        if (length < 1e-9f)
+        {
+            gradients[0] = dx::XMFLOAT3(0.0f, 0.0f, 0.0f);
+            gradients[1] = dx::XMFLOAT3(0.0f, 0.0f, 0.0f);
+            gradients[2] = dx::XMFLOAT3(0.0f, 0.0f, 0.0f);
+            gradients[3] = dx::XMFLOAT3(0.0f, 0.0f, 0.0f);
+            return 0.0f;
+        }
+
+        dx::XMVECTOR direction = dx::XMVectorScale(v, 1.0f / length);
+
+        for (uint32_t i = 0; i < kArity; ++i)
+        {
+            dx::XMStoreFloat3(&gradients[i], dx::XMVectorScale(direction, m_stencil[i]));
+        }
+
+        return length;
+    }
+
+    // 获取受此约束影响的粒子数量
+    uint32_t GetParticlesCount() const override
+    {
+        return kArity;
+    }
+
+    // 获取受此约束影响的粒子数组
+    Particle** GetParticles() override
+    {
+        return &m_particle1;
+    }
+
+    // 获取受此约束影响的所有粒子（const版本）
+    virtual const Particle** GetParticles() const override
+    {
+        return (const Particle**)(&m_particle1);
+    }
+
+    // 获取预计算的模板权重（已乘以sqrt(Q)）
+    const float* GetStencil() const
+    {
+        return m_stencil;
+    }
+
+    // 静止参数：模板权重
+    uint32_t GetRestParameterCount() const override
+    {
+        return 4;
+    }
+
+    void GetRestParameters(float* parameters) const override
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            parameters[i] = m_stencil[i];
+        }
+    }
+
+    void SetRestParameters(const float* parameters) override
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            m_stencil[i] = parameters[i];
+        }
+    }
+
+    // 获取约束类型
+    const char* GetConstraintType() const override
+    {
+        return "IsometricBending";
+    }
+
+private:
+    // 余切：cot(θ) = (a·b) / |a×b|，θ为a、b的夹角
+    static float Cotangent(dx::XMVECTOR a, dx::XMVECTOR b)
+    {
+        float cosine = dx::XMVectorGetX(dx::XMVector3Dot(a, b));
+        float sine = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVector3Cross(a, b)));
+        return sine > 1e-9f ? cosine / sine : 0.0f;
+    }
+
+    // 根据静止位置计算模板权重
+    void ComputeStencil()
+    {
+        dx::XMVECTOR x0 = dx::XMLoadFloat3(&m_particle1->position);
+        dx::XMVECTOR x1 = dx::XMLoadFloat3(&m_particle2->position);
+        dx::XMVECTOR x2 = dx::XMLoadFloat3(&m_particle3->position);
+        dx::XMVECTOR x3 = dx::XMLoadFloat3(&m_particle4->position);
+
+        dx::XMVECTOR e0 = dx::XMVectorSubtract(x1, x0);     // 公共边
+        dx::XMVECTOR e1 = dx::XMVectorSubtract(x2, x0);
+        dx::XMVECTOR e2 = dx::XMVectorSubtract(x3, x0);
+        dx::XMVECTOR e3 = dx::XMVectorSubtract(x2, x1);
+        dx::XMVECTOR e4 = dx::XMVectorSubtract(x3, x1);
+
+        // 公共边两端在两个三角形中的内角余切
+        float c01 = Cotangent(e0, e1);
+        float c02 = Cotangent(e0, e2);
+        float c03 = Cotangent(dx::XMVectorNegate(e0), e3);
+        float c04 = Cotangent(dx::XMVectorNegate(e0), e4);
+
+        float area0 = 0.5f * dx::XMVectorGetX(dx::XMVector3Length(dx::XMVector3Cross(e0, e1)));
+        float area1 = 0.5f * dx::XMVectorGetX(dx::XMVector3Length(dx::XMVector3Cross(e0, e2)));
+
+        // 退化三角形不产生弯曲力
+        if (area0 + area1 < 1e-12f)
+        {
+            m_stencil[0] = m_stencil[1] = m_stencil[2] = m_stencil[3] = 0.0f;
+            return;
+        }
+
+        float scale = sqrtf(3.0f / (area0 + area1));
+
+        m_stencil[0] = scale * (c03 + c04);
+        m_stencil[1] = scale * (c01 + c02);
+        m_stencil[2] = scale * (-c01 - c03);
+        m_stencil[3] = scale * (-c02 - c04);
+    }
+
+private:
+    // 受约束的四个顶点（两个相邻三角形：(p1,p2,p3)和(p1,p2,p4)，共享边p1-p2）
+    Particle* m_particle1;
+    Particle* m_particle2;
+    Particle* m_particle3;
+    Particle* m_particle4;
+
+    // 预计算的模板权重sqrt(Q) * K_i
+    float m_stencil[4];
+};
+
+#endif // ISOMETRIC_BENDING_CONSTRAINT_H
@@ -13,6 +13,9 @@ namespace dx = DirectX;
 class LRAConstraint : public Constraint
 {
 public:
+    // 受约束影响的粒子数：单个粒子（附着点不是粒子）
+    static const uint32_t kArity = 1;
+
     // 构造函数
     LRAConstraint(Particle* particle, const dx::XMFLOAT3& attachmentPoint, float geodesicDistance, float compliance, float damping, float maxStretch)
         : Constraint(compliance, damping)
@@ -69,7 +72,7 @@ public:
     // 返回：受约束影响的粒子数量
     virtual uint32_t GetParticlesCount() const override
     {
-        return 1;
+        return kArity;
     }
 
     // 获取受此约束影响的所有粒子
@@ -104,6 +107,42 @@ public:
         return this->attachmentInitialPos;
     }
 
+    // 获取测地线距离
+    float GetGeodesicDistance() const
+    {
+        return this->geodesicDistance;
+    }
+
+    // 获取最大拉伸量
+    float GetMaxStretch() const
+    {
+        return this->maxStretch;
+    }
+
+    // 静止参数：测地线距离、当前和初始附着点（最大拉伸量是可调参数，不属于静止参数）
+    virtual uint32_t GetRestParameterCount() const override
+    {
+        return 7;
+    }
+
+    virtual void GetRestParameters(float* parameters) const override
+    {
+        parameters[0] = geodesicDistance;
+        parameters[1] = attachmentPoint.x;
+        parameters[2] = attachmentPoint.y;
+        parameters[3] = attachmentPoint.z;
+        parameters[4] = attachmentInitialPos.x;
+        parameters[5] = attachmentInitialPos.y;
+        parameters[6] = attachmentInitialPos.z;
+    }
+
+    virtual void SetRestParameters(const float* parameters) override
+    {
+        geodesicDistance = parameters[0];
+        attachmentPoint = dx::XMFLOAT3(parameters[1], parameters[2], parameters[3]);
+        attachmentInitialPos = dx::XMFLOAT3(parameters[4], parameters[5], parameters[6]);
+    }
+
     // 获取约束类型
     virtual const char* GetConstraintType() const override
     {
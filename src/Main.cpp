@@ -5,6 +5,10 @@
 #include <cstdint>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
 #include "Cloth.h"
 #include "DX12RALDevice.h"
 #include "Camera.h"
@@ -12,14 +16,20 @@
 #include "Scene.h"
 #include <windowsx.h>
 #include "Commandline.h"
+#include "TaskScheduler.h"
+#include "Benchmark.h"
+#include "ClothCheckpoint.h"
+#include "ClothSceneLoader.h"
 
 // 日志文件
 std::ofstream logFile;
+std::mutex logMutex; // 参数扫描等在工作线程上创建和模拟布料时也会输出日志
 
 // 日志函数
 extern void logDebug(const std::string& message)
 {
     //std::cout << message << std::endl;
+    std::lock_guard<std::mutex> lock(logMutex);
     if (logFile.is_open())
     {
         logFile << message << std::endl;
@@ -72,16 +82,37 @@ int frameCount = 0;            // 当前帧数计数器
 int maxFrames = -1;            // 最大帧数限制（-1表示不限制）
 int iteratorCount = 20;        // XPBD求解器迭代次数，默认20
 uint32_t subIteratorCount = 1; // XPBD求解器子迭代次数，默认1
+float lambdaWarmStartFactor = 0.0f; // 拉格朗日乘子热启动系数，默认0（每个子步清零）
+XPBDScheduleMode scheduleMode = XPBDScheduleMode::Iterative; // 求解器调度模式，默认Iterative
+ClothSolverType clothSolverType = ClothSolverType::XPBD; // 布料求解器类型，默认XPBD
+uint32_t minIteratorCount = 2; // 提前结束迭代时的最少迭代次数，默认2
+float residualTolerance = 1e-4f; // 提前结束迭代的残差容差，默认1e-4
+float residualStagnationRatio = 0.01f; // 提前结束迭代的残差停滞比例，默认0.01
+bool chebyshevAcceleration = false; // 是否启用Chebyshev加速，默认false
+float chebyshevSpectralRadius = 0.0f; // Chebyshev加速的谱半径，默认0（自动估计）
+float overRelaxationFactor = 1.0f; // 拉格朗日乘子增量的超松弛系数，默认1
+bool sleepEnabled = true; // 是否启用粒子休眠，默认true
+float sleepVelocityThreshold = 0.05f; // 休眠速度阈值，默认0.05
+float sleepDisplacementThreshold = 0.01f; // 休眠位移阈值，默认0.01
+uint32_t sleepFrameCount = 30; // 进入休眠需要连续静止的帧数，默认30
+float velocityDamping = 0.0f; // 速度阻尼系数，默认0
+uint32_t multigridLevelCount = 0; // 粗网格层级数，默认0（不使用多层级求解）
+uint32_t multigridIterationCount = 4; // 每个粗网格层级的迭代次数，默认4
+XPBDDistanceSolveMode distanceSolveMode = XPBDDistanceSolveMode::Iterative; // 距离约束的求解方式，默认Iterative
+uint32_t directSolveIterationCount = 2; // 每个子步直接求解距离约束的次数，默认2
 int widthResolution = 100;     // 布料宽度分辨率（粒子数），默认100
 int heightResolution = 100;    // 布料高度分辨率（粒子数），默认100
 ClothParticleMassMode massMode = ClothParticleMassMode::FixedParticleMass; // 布料粒子质量模式，默认固定粒子质量
 ClothMeshAndContraintMode meshAndContraintMode = ClothMeshAndContraintMode::Full; // 布料网格和约束模式，默认完整网格和约束
+std::string clothMeshFile;     // 布料三角网格文件（OBJ或PLY），指定时使用Mesh模式
+ClothParticleOrdering particleOrdering = ClothParticleOrdering::None; // 粒子重排序方式，Mesh模式下默认ReverseCuthillMcKee
 
 // 布料物理参数
 float mass = 1.0f;             // 每个粒子的质量，默认1.0
 bool addLRAConstraints = true; // 是否添加LRA约束，默认true
 bool addBendingConstraints = true; // 是否添加弯曲约束，默认true
 bool addDihedralBendingConstraints = false; // 是否添加二面角约束，默认false
+bool addIsometricBendingConstraints = false; // 是否添加等距弯曲约束，默认false
 bool addDiagonalConstraints = true; // 是否添加对角线约束，默认true
 float distanceCompliance = 0.00000001f; // 距离约束的柔度，默认0.00000001
 float distanceDamping = 0.01f; // 距离约束的阻尼，默认0.01
@@ -91,8 +122,43 @@ float bendingCompliance = 0.00001f; // 弯曲约束的柔度，默认0.00001
 float bendingDamping = 0.001f; // 弯曲约束的阻尼，默认0.001
 float dihedralBendingCompliance = 1.0f; // 二面角约束的柔度，默认1.0
 float dihedralBendingDamping = 1.0f; // 二面角约束的阻尼，默认1.0
+float isometricBendingCompliance = 1.0f; // 等距弯曲约束的柔度，默认1.0
+float isometricBendingDamping = 1.0f; // 等距弯曲约束的阻尼，默认1.0
 float lraMaxStretch = 0.01f; // LRA约束最大拉伸量，默认0.01
 
+// 渲染参数
+uint32_t renderThreadCount = (std::max)(1u, std::thread::hardware_concurrency()); // 几何Pass并行录制线程数，默认硬件线程数
+uint32_t workerThreadCount = 0; // 全局任务调度器的工作线程数，0表示使用硬件线程数
+
+// 场景参数
+std::string sceneFile; // 场景描述文件（JSON），为空时使用命令行参数描述的默认场景
+ClothSceneDescription sceneDescription; // 窗口模式和基准测试共用的场景描述
+bool packedClothBatching = false; // 是否用打包求解器更新场景中的小块布料
+
+// 基准测试参数
+std::string benchmarkName; // 基准测试名称，为空表示正常运行
+int benchmarkFrames = 300; // 基准测试模拟的帧数
+std::string trajectoryFile = "trajectory.bin"; // 轨迹录制和对比使用的文件
+float trajectoryTolerance = 1e-3f; // 轨迹对比允许的最大位置偏差
+std::string determinismHash; // 确定性测试的参考哈希（十六进制），为空表示只对比不同线程数的结果
+std::string goldenDirectory = "golden"; // 回归测试的参考文件目录
+float perfThreshold = 0.25f; // 回归测试允许的耗时增加比例
+bool updateGolden = false; // 回归测试是否重新录制参考文件
+std::string sweepOutputFile = "sweep.csv"; // 参数扫描结果的CSV文件
+int batchClothCount = 256; // 批量更新测试的布料数量
+
+// 帧缓存参数
+std::string recordCacheFile; // 录制帧缓存的文件，为空表示不录制
+ClothFrameCacheFormat frameCacheFormat = ClothFrameCacheFormat::Float32; // 录制帧缓存的帧数据格式
+std::string playCacheFile; // 回放的帧缓存文件，指定时不运行模拟
+int playCacheFrame = 0; // 回放的起始帧
+
+// 检查点参数
+std::string checkpointFile = "checkpoint.bin"; // 定期保存检查点的文件
+int checkpointInterval = 0; // 保存检查点的间隔帧数，0表示不保存
+std::string restoreCheckpointFile; // 启动时恢复的检查点文件，为空表示不恢复
+ClothCheckpointWriter checkpointWriter; // 在后台线程写入检查点
+
 // 相机对象
 Camera* camera = nullptr;
 
@@ -121,8 +187,9 @@ void UpdateCamera(const dx::XMVECTOR& position, const dx::XMVECTOR& target, cons
 // 布料、渲染设备和场景对象
 IRALDevice* device = nullptr;
 Scene* scene = nullptr;
-Sphere* sphere = nullptr;
-Cloth* cloth = nullptr;
+std::vector<Sphere*> spheres;
+std::vector<Cloth*> cloths;
+Cloth* cloth = nullptr; // 第一块布料，窗口标题、帧缓存和检查点只针对这块布料
 
 // 窗口过程函数
 LRESULT CALLBACK WndProc(HWND hWnd, uint32_t message, WPARAM wParam, LPARAM lParam)
@@ -442,8 +509,8 @@ BOOL InitializeDevice()
     std::cout << "  - Camera object created successfully" << std::endl;
     
     // 设置相机初始位置和目标
-    dx::XMVECTOR cameraPos = dx::XMVectorSet(0.0f, 10.0f, 15.0f, 1.0f); // 直接在布料正前方
-    dx::XMVECTOR cameraTarget = dx::XMVectorSet(0.0f, 5.0f, 0.0f, 1.0f); // 直接指向布料中心
+    dx::XMVECTOR cameraPos = dx::XMVectorSetW(dx::XMLoadFloat3(&sceneDescription.cameraPosition), 1.0f);
+    dx::XMVECTOR cameraTarget = dx::XMVectorSetW(dx::XMLoadFloat3(&sceneDescription.cameraTarget), 1.0f);
     dx::XMVECTOR cameraUp = dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
     UpdateCamera(cameraPos, cameraTarget, cameraUp);
 
@@ -470,6 +537,9 @@ BOOL InitializeDevice()
         return FALSE;
     }
     std::cout << "  - scene->Initialize() succeeded" << std::endl;
+    scene->SetParallelRecordingThreadCount(renderThreadCount);
+    logDebug("Scene parallel recording thread count: " + std::to_string(scene->GetParallelRecordingThreadCount()));
+    scene->SetPackedClothBatching(packedClothBatching);
 
     return TRUE;
 }
@@ -575,6 +645,9 @@ void UpdateCamera(const dx::XMVECTOR& position, const dx::XMVECTOR& target, cons
 // 清理资源
 void Cleanup()
 {
+    // 等待未完成的检查点写入
+    checkpointWriter.Wait();
+
     // 清理场景对象
     if (scene)
     {
@@ -582,17 +655,18 @@ void Cleanup()
     }
     
     // 清理布料对象
-    if (cloth)
+    for (Cloth* sceneCloth : cloths)
     {
-        delete cloth;
-        cloth = nullptr;
+        delete sceneCloth;
     }
+    cloths.clear();
+    cloth = nullptr;
 
-    if (sphere)
+    for (Sphere* sphere : spheres)
     {
         delete sphere;
-        cloth = nullptr;
     }
+    spheres.clear();
     
     // 清理场景对象
     if (scene)
@@ -615,6 +689,248 @@ void Cleanup()
         delete camera;
         camera = nullptr;
     }
+
+    // 停止任务调度器的工作线程
+    TaskScheduler::Get().Shutdown();
+}
+
+// 按命令行参数生成布料描述，也是场景文件中布料设置的默认值
+ClothSceneCloth CreateCommandLineClothDescription()
+{
+    ClothSceneCloth description;
+    description.name = "cloth";
+    description.widthResolution = widthResolution;
+    description.heightResolution = heightResolution;
+    description.size = 10.0f;
+    description.position = dx::XMFLOAT3(-5.0f, 10.0f, -5.0f);
+    description.meshAndContraintMode = meshAndContraintMode;
+    description.meshFile = clothMeshFile;
+    description.particleOrdering = particleOrdering;
+    description.pinsSpecified = false;
+
+    description.diffuseColor = dx::XMFLOAT3(1.0f, 0.1f, 0.1f);
+    description.mass = mass;
+    description.massMode = massMode;
+    description.addLRAConstraints = addLRAConstraints;
+    description.addBendingConstraints = addBendingConstraints;
+    description.addDihedralBendingConstraints = addDihedralBendingConstraints;
+    description.addIsometricBendingConstraints = addIsometricBendingConstraints;
+    description.addDiagonalConstraints = addDiagonalConstraints;
+    description.distanceCompliance = distanceCompliance;
+    description.distanceDamping = distanceDamping;
+    description.lraCompliance = lraCompliance;
+    description.lraDamping = lraDamping;
+    description.lraMaxStretch = lraMaxStretch;
+    description.bendingCompliance = bendingCompliance;
+    description.bendingDamping = bendingDamping;
+    description.dihedralBendingCompliance = dihedralBendingCompliance;
+    description.dihedralBendingDamping = dihedralBendingDamping;
+    description.isometricBendingCompliance = isometricBendingCompliance;
+    description.isometricBendingDamping = isometricBendingDamping;
+
+    description.solverType = clothSolverType;
+    description.scheduleMode = scheduleMode;
+    description.iteratorCount = iteratorCount;
+    description.subIteratorCount = subIteratorCount;
+    description.minIteratorCount = minIteratorCount;
+    description.lambdaWarmStartFactor = lambdaWarmStartFactor;
+    description.residualTolerance = residualTolerance;
+    description.residualStagnationRatio = residualStagnationRatio;
+    description.chebyshevAcceleration = chebyshevAcceleration;
+    description.chebyshevSpectralRadius = chebyshevSpectralRadius;
+    description.overRelaxationFactor = overRelaxationFactor;
+    description.sleepEnabled = sleepEnabled;
+    description.sleepVelocityThreshold = sleepVelocityThreshold;
+    description.sleepDisplacementThreshold = sleepDisplacementThreshold;
+    description.sleepFrameCount = sleepFrameCount;
+    description.velocityDamping = velocityDamping;
+    description.multigridLevelCount = multigridLevelCount;
+    description.multigridIterationCount = multigridIterationCount;
+    description.distanceSolveMode = distanceSolveMode;
+    description.directSolveIterationCount = directSolveIterationCount;
+
+    return description;
+}
+
+// 默认场景：命令行参数描述的一块布料落到球体上
+ClothSceneDescription CreateDefaultSceneDescription()
+{
+    ClothSceneDescription description;
+    description.cloths.push_back(CreateCommandLineClothDescription());
+
+    ClothSceneSphere sphere;
+    sphere.center = dx::XMFLOAT3(0.0f, 5.0f, 0.0f);
+    sphere.radius = 2.0f;
+    sphere.diffuseColor = dx::XMFLOAT3(1.0f, 0.1f, 0.1f);
+    description.spheres.push_back(sphere);
+
+    description.lightPosition = dx::XMFLOAT3(-10.0f, 30.0f, -10.0f);
+    description.lightDiffuseColor = dx::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+    description.cameraPosition = dx::XMFLOAT3(0.0f, 10.0f, 15.0f);  // 布料正前方
+    description.cameraTarget = dx::XMFLOAT3(0.0f, 5.0f, 0.0f);      // 布料中心
+    return description;
+}
+
+// 创建回归测试和参数扫描的布料回调：按布料描述创建布料，与场景中的所有球体碰撞
+ClothFactory CreateSceneClothFactory(const ClothSceneCloth& description)
+{
+    return [description]() -> Cloth*
+    {
+        Cloth* sceneCloth = ClothSceneLoader::CreateCloth(description);
+        if (!ClothSceneLoader::InitializeSimulation(sceneCloth, sceneDescription))
+        {
+            delete sceneCloth;
+            return nullptr;
+        }
+        return sceneCloth;
+    };
+}
+
+// 运行无窗口基准测试
+// 返回：进程退出码
+int RunBenchmark(const std::string& name)
+{
+    // 指定了检查点时每个测试都从检查点的状态开始，文件只读取一次
+    std::vector<char> restoreCheckpoint;
+    if (!restoreCheckpointFile.empty() && !ClothCheckpoint::ReadFile(restoreCheckpointFile, restoreCheckpoint))
+    {
+        return -1;
+    }
+
+    // 每个测试使用场景中的第一块布料和所有球体碰撞体
+    ClothFactory createCloth = [&restoreCheckpoint]() -> Cloth*
+    {
+        Cloth* benchmarkCloth = ClothSceneLoader::CreateCloth(sceneDescription.cloths[0]);
+        if (!ClothSceneLoader::InitializeSimulation(benchmarkCloth, sceneDescription))
+        {
+            delete benchmarkCloth;
+            return nullptr;
+        }
+
+        if (!restoreCheckpoint.empty() && !benchmarkCloth->LoadCheckpoint(restoreCheckpoint.data(), restoreCheckpoint.size()))
+        {
+            delete benchmarkCloth;
+            return nullptr;
+        }
+        return benchmarkCloth;
+    };
+
+    if (name == "schedule")
+    {
+        // 每个配置只改变求解器调度方式
+        std::vector<SolverScheduleConfig> configs = GetDefaultSolverScheduleConfigs(iteratorCount, subIteratorCount);
+        std::vector<SolverScheduleResult> results = RunSolverScheduleBenchmark(createCloth, configs, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f);
+        LogSolverScheduleResults(results);
+
+        return results.empty() ? -1 : 0;
+    }
+
+    if (name == "recordTrajectory")
+    {
+        return RecordTrajectory(createCloth, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f, trajectoryFile) ? 0 : -1;
+    }
+
+    if (name == "compareTrajectory")
+    {
+        // 例如用XPBD_SOLVER_DOUBLE构建录制参考轨迹，再用默认的float构建对比
+        TrajectoryComparison comparison;
+        if (!CompareTrajectory(createCloth, trajectoryFile, trajectoryTolerance, comparison))
+        {
+            return -1;
+        }
+
+        return LogTrajectoryComparison(comparison, trajectoryTolerance) ? 0 : 1;
+    }
+
+    if (name == "bending")
+    {
+        std::vector<BendingConstraintCost> costs = RunBendingConstraintBenchmark(createCloth, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f);
+        LogBendingConstraintCosts(costs);
+
+        return costs.empty() ? -1 : 0;
+    }
+
+    if (name == "ordering")
+    {
+        std::vector<ParticleOrderingResult> results = RunParticleOrderingBenchmark(createCloth, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f);
+        LogParticleOrderingResults(results);
+
+        return results.empty() ? -1 : 0;
+    }
+
+    if (name == "frameCache")
+    {
+        std::vector<FrameCacheResult> results = RunFrameCacheBenchmark(createCloth, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f,
+            recordCacheFile.empty() ? "cloth.cache" : recordCacheFile);
+        LogFrameCacheResults(results);
+
+        return results.empty() ? -1 : 0;
+    }
+
+    if (name == "determinism")
+    {
+        std::vector<DeterminismResult> results = RunDeterminismBenchmark(createCloth, GetDefaultDeterminismThreadCounts(),
+            (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f);
+
+        return LogDeterminismResults(results, determinismHash) ? 0 : 1;
+    }
+
+    if (name == "regression")
+    {
+        // 场景中的第一块布料，以及简化网格、只有二面角弯曲约束和关闭LRA约束三个变体
+        std::vector<RegressionScene> scenes = GetRegressionScenes(sceneDescription);
+
+        std::vector<RegressionResult> results = RunRegressionBenchmark(scenes, goldenDirectory, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f,
+            trajectoryTolerance, perfThreshold, updateGolden);
+
+        return LogRegressionResults(results, trajectoryTolerance, perfThreshold);
+    }
+
+    if (name == "batch")
+    {
+        // 大量小块布料，例如-widthResolution=16 -heightResolution=16
+        BatchUpdateResult result = RunBatchUpdateBenchmark(createCloth, (uint32_t)(std::max)(1, batchClothCount),
+            (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f);
+        LogBatchUpdateResult(result);
+
+        return result.bitExact && (!result.packedSupported || result.packedFinite) ? 0 : 1;
+    }
+
+    if (name == "sweep")
+    {
+        // 扫描的网格来自场景描述文件的"sweep"，每个配置从初始状态开始，不使用检查点
+        if (sceneDescription.sweepConfigs.empty())
+        {
+            logDebug("Parameter sweep requires a scene file with a sweep section (-scene=xxx)");
+            return -1;
+        }
+
+        std::vector<ParameterSweepConfig> configs;
+        for (const ClothSceneSweepConfig& sweepConfig : sceneDescription.sweepConfigs)
+        {
+            configs.push_back({ sweepConfig.cloth.name, sweepConfig.values, CreateSceneClothFactory(sweepConfig.cloth) });
+        }
+
+        std::vector<ParameterSweepResult> results = RunParameterSweep(configs, (uint32_t)(std::max)(1, benchmarkFrames), 1.0f / 60.0f);
+        bool allSucceeded = LogParameterSweepResults(results);
+
+        if (!WriteParameterSweepCSV(sceneDescription.sweepAxes, results, sweepOutputFile))
+        {
+            return -1;
+        }
+        return allSucceeded ? 0 : 1;
+    }
+
+    if (name == "checkpoint")
+    {
+        CheckpointResult result = RunCheckpointBenchmark(createCloth, (uint32_t)(std::max)(2, benchmarkFrames), 1.0f / 60.0f, checkpointFile);
+        LogCheckpointResult(result);
+
+        return result.bitExact ? 0 : 1;
+    }
+
+    logDebug("Unknown benchmark: " + name);
+    return -1;
 }
 
 // main函数
@@ -648,11 +964,49 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         std::wcout << L"  -maxFrames=xxx        设置最大帧数限制（xxx为数字，-1表示不限制）" << std::endl;
         std::wcout << L"  -iteratorCount=xxx    设置XPBD求解器迭代次数（xxx为数字，默认20）" << std::endl;
         std::wcout << L"  -subItereratorCount=xxx 设置子迭代次数（xxx为数字，默认1）" << std::endl;
+        std::wcout << L"  -lambdaWarmStart=xxx  设置拉格朗日乘子热启动系数（xxx为浮点数，默认0表示每个子步清零）" << std::endl;
+        std::wcout << L"  -minIteratorCount=xxx 设置提前结束时的最少迭代次数（xxx为数字，默认2）" << std::endl;
+        std::wcout << L"  -residualTolerance=xxx 设置提前结束迭代的残差容差（xxx为浮点数，默认0.0001，0表示不按容差提前结束）" << std::endl;
+        std::wcout << L"  -residualStagnation=xxx 设置残差停滞比例，残差相对下降小于该值时提前结束迭代（xxx为浮点数，默认0.01，0表示不检测）" << std::endl;
+        std::wcout << L"  -chebyshev=xxx        设置是否启用Chebyshev加速（xxx为true/false/1/0/yes/no，默认false）" << std::endl;
+        std::wcout << L"  -chebyshevSpectralRadius=xxx 设置Chebyshev加速的谱半径（xxx为浮点数，默认0表示自动估计）" << std::endl;
+        std::wcout << L"  -overRelaxation=xxx   设置拉格朗日乘子增量的超松弛系数（xxx为浮点数，默认1）" << std::endl;
+        std::wcout << L"  -sleep=xxx            设置是否启用粒子休眠（xxx为true/false/1/0/yes/no，默认true）" << std::endl;
+        std::wcout << L"  -sleepVelocity=xxx    设置休眠速度阈值（xxx为浮点数，默认0.05）" << std::endl;
+        std::wcout << L"  -sleepDisplacement=xxx 设置休眠位移阈值（xxx为浮点数，默认0.01）" << std::endl;
+        std::wcout << L"  -sleepFrames=xxx      设置进入休眠需要连续静止的帧数（xxx为数字，默认30）" << std::endl;
+        std::wcout << L"  -velocityDamping=xxx  设置速度阻尼系数（xxx为浮点数，每秒衰减的速度比例，默认0）" << std::endl;
+        std::wcout << L"  -multigridLevels=xxx  设置粗网格层级数（xxx为数字，默认0表示不使用多层级求解）" << std::endl;
+        std::wcout << L"  -multigridIterations=xxx 设置每个粗网格层级的迭代次数（xxx为数字，默认4）" << std::endl;
+        std::wcout << L"  -distanceSolveMode=xxx 设置距离约束的求解方式（xxx为Iterative或Direct，默认Iterative；Direct用稀疏Cholesky分解整体求解）" << std::endl;
+        std::wcout << L"  -directSolveIterations=xxx 设置Direct模式下每个子步整体求解距离约束的次数（xxx为数字，默认2）" << std::endl;
+        std::wcout << L"  -scheduleMode=xxx     设置求解器调度模式（xxx为Iterative或SmallSteps，默认Iterative；SmallSteps未指定子迭代次数时使用10个子步）" << std::endl;
+        std::wcout << L"  -solver=xxx           设置布料求解器（xxx为XPBD或ProjectiveDynamics，默认XPBD；ProjectiveDynamics不支持二面角约束、等距弯曲约束和休眠）" << std::endl;
+        std::wcout << L"  -benchmark=xxx        无窗口运行基准测试后退出（xxx为schedule：对比迭代布局、Chebyshev加速、多层级求解、Projective Dynamics与小步长模式；recordTrajectory：录制粒子轨迹；compareTrajectory：与录制的轨迹逐帧对比，超出容差时退出码为1；bending：对比二面角约束和等距弯曲约束单个约束的计算耗时；ordering：对比粒子重排序方式的模拟缓存缺失数和耗时；frameCache：对比帧缓存格式的文件大小、录制和解码耗时及精度；checkpoint：在中间一帧保存检查点，恢复后继续模拟并与不中断的模拟逐位对比，不一致时退出码为1；determinism：分别用1、2、8和32个线程模拟并对比粒子状态的哈希，不一致时退出码为1；regression：典型场景与参考轨迹对比并检查各阶段耗时，轨迹不一致时退出码为1，性能回退时为2；sweep：按场景描述文件中的参数扫描网格在所有工作线程上并行模拟每个配置，结果写入CSV，有配置失败时退出码为1；batch：对比逐个更新、批量更新和打包求解-batchClothCount块布料的耗时，批量更新结果不一致或打包求解出现无效位置时退出码为1）" << std::endl;
+        std::wcout << L"  -scene=xxx            从JSON场景描述文件创建布料、材质、固定粒子、碰撞体、光源和相机（xxx为文件路径），命令行参数作为布料设置的默认值；基准测试使用文件中的第一块布料" << std::endl;
+        std::wcout << L"  -benchmarkFrames=xxx  设置基准测试模拟的帧数（xxx为数字，默认300）" << std::endl;
+        std::wcout << L"  -trajectoryFile=xxx   设置轨迹录制和对比使用的文件（默认trajectory.bin）" << std::endl;
+        std::wcout << L"  -trajectoryTolerance=xxx 设置轨迹对比允许的最大位置偏差（xxx为浮点数，默认0.001）" << std::endl;
+        std::wcout << L"  -determinismHash=xxx  设置-benchmark=determinism的参考哈希（xxx为十六进制数，默认不对比）" << std::endl;
+        std::wcout << L"  -goldenDir=xxx        设置回归测试的参考文件目录（默认golden）" << std::endl;
+        std::wcout << L"  -perfThreshold=xxx    设置回归测试允许的耗时增加比例（xxx为浮点数，默认0.25）" << std::endl;
+        std::wcout << L"  -updateGolden=true/false 设置回归测试是否重新录制参考文件（默认false，参考文件不存在时测试失败）" << std::endl;
+        std::wcout << L"  -sweepOutput=xxx      设置-benchmark=sweep的结果文件（xxx为CSV文件路径，默认sweep.csv）" << std::endl;
+        std::wcout << L"  -batchClothCount=xxx  设置-benchmark=batch的布料数量（xxx为数字，默认256）" << std::endl;
+        std::wcout << L"  -packedClothBatch=true/false 设置场景是否用打包求解器更新小块布料（默认false；只支持距离、LRA和球面碰撞约束，每个子步固定迭代次数且不休眠）" << std::endl;
+        std::wcout << L"  -recordCache=xxx      运行时把每帧的顶点数据录制到帧缓存文件（xxx为文件路径，默认不录制；也是-benchmark=frameCache的输出文件前缀）" << std::endl;
+        std::wcout << L"  -frameCacheFormat=xxx 设置录制帧缓存的格式（xxx为Float32、Quantized16、CompressedNormal16或CompressedNormal8，默认Float32）" << std::endl;
+        std::wcout << L"  -playCache=xxx        回放帧缓存文件而不运行模拟（xxx为文件路径）" << std::endl;
+        std::wcout << L"  -playCacheFrame=xxx   设置回放的起始帧（xxx为数字，默认0）" << std::endl;
+        std::wcout << L"  -checkpointFile=xxx   设置定期保存检查点的文件（默认checkpoint.bin；也是-benchmark=checkpoint的检查点文件）" << std::endl;
+        std::wcout << L"  -checkpointInterval=xxx 每隔xxx帧在后台保存一次检查点（xxx为数字，默认0表示不保存）" << std::endl;
+        std::wcout << L"  -restoreCheckpoint=xxx 启动时从检查点文件恢复模拟状态（xxx为文件路径，布料参数须与保存时一致；基准测试也从该状态开始）" << std::endl;
         std::wcout << L"  -widthResolution=xxx  设置布料宽度分辨率（粒子数，xxx为数字，默认100，最小为2）" << std::endl;
         std::wcout << L"  -heightResolution=xxx 设置布料高度分辨率（粒子数，xxx为数字，默认100，最小为2）" << std::endl;
         std::wcout << L"  -addLRAConstraints=true/false 设置是否添加LRA约束（默认true）" << std::endl;
         std::wcout << L"  -addBendingConstraints=true/false 设置是否添加弯曲约束（默认true）" << std::endl;
         std::wcout << L"  -addDihedralBendingConstraints=true/false 设置是否添加二面角约束（默认false）" << std::endl;
+        std::wcout << L"  -addIsometricBendingConstraints=true/false 设置是否添加等距弯曲约束（二面角约束的替代，预计算模板权重，默认false）" << std::endl;
         std::wcout << L"  -addDiagonalConstraints=true/false 设置是否添加对角线约束（默认true）" << std::endl;
         std::wcout << L"  -distanceCompliance=xxx 设置距离约束的柔度（xxx为浮点数，默认0.00000001）" << std::endl;
         std::wcout << L"  -distanceDamping=xxx 设置距离约束的阻尼（xxx为浮点数，默认0.01）" << std::endl;
@@ -662,13 +1016,19 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         std::wcout << L"  -bendingDamping=xxx 设置弯曲约束的阻尼（xxx为浮点数，默认0.001）" << std::endl;
         std::wcout << L"  -dihedralBendingCompliance=xxx 设置二面角约束的柔度（xxx为浮点数，默认1.0）" << std::endl;
         std::wcout << L"  -dihedralBendingDamping=xxx 设置二面角约束的阻尼（xxx为浮点数，默认1.0）" << std::endl;
+        std::wcout << L"  -isometricBendingCompliance=xxx 设置等距弯曲约束的柔度（xxx为浮点数，默认1.0）" << std::endl;
+        std::wcout << L"  -isometricBendingDamping=xxx 设置等距弯曲约束的阻尼（xxx为浮点数，默认1.0）" << std::endl;
         std::wcout << L"  -LRAMaxStretch=xxx   设置LRA约束最大拉伸量（xxx为数字，默认0.01）" << std::endl;
         std::wcout << L"  -mass=xxx            设置每个粒子的质量（xxx为数字，默认1.0）" << std::endl;
         std::wcout << L"  -massMode=xxx        设置质量模式（xxx为FixedParticleMass或FixedTotalMass，默认FixedParticleMass）" << std::endl;
-        std::wcout << L"  -meshAndContraintMode=xxx 设置网格和约束模式（xxx为Full或Simplified，默认Full）" << std::endl;
+        std::wcout << L"  -meshAndContraintMode=xxx 设置网格和约束模式（xxx为Full、Simplified或Mesh，默认Full，Mesh需要同时指定-clothMesh）" << std::endl;
+        std::wcout << L"  -clothMesh=xxx       从OBJ或PLY三角网格文件创建布料（xxx为文件路径），按网格拓扑自动生成约束" << std::endl;
+        std::wcout << L"  -particleOrdering=xxx 设置粒子重排序方式（xxx为None、Morton或RCM，规则网格默认None，Mesh模式默认RCM）" << std::endl;
         std::wcout << L"  -fullscreen          以全屏模式启动程序" << std::endl;
         std::wcout << L"  -winWidth=xxx        设置窗口宽度（xxx为数字，默认1280，不能超过系统分辨率）" << std::endl;
         std::wcout << L"  -winHeight=xxx       设置窗口高度（xxx为数字，默认800，不能超过系统分辨率）" << std::endl;
+        std::wcout << L"  -renderThreads=xxx   设置几何Pass并行录制命令列表的线程数（xxx为数字，默认硬件线程数，1表示单线程录制）" << std::endl;
+        std::wcout << L"  -workerThreads=xxx   设置任务调度器的工作线程数（xxx为数字，包含主线程，默认0表示使用硬件线程数）" << std::endl;
         std::wcout << L"===================================================" << std::endl;
         std::wcout << L"程序控制：" << std::endl;
         std::wcout << L"  F9                    切换调试输出开关" << std::endl;
@@ -743,11 +1103,151 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     }
     
     uint32_t tempSubIteratorCount = subIteratorCount;
-    if (cmdLine.Get("-subItereratorCount=", tempSubIteratorCount, subIteratorCount))
+    bool subIteratorCountSet = cmdLine.Get("-subItereratorCount=", tempSubIteratorCount, subIteratorCount);
+    if (subIteratorCountSet)
     {
         subIteratorCount = (tempSubIteratorCount < 1) ? 1 : tempSubIteratorCount;
         logDebug("Sub-iterator count is set by command line parameters to: " + std::to_string(subIteratorCount));
     }
+
+    if (cmdLine.Get("-lambdaWarmStart=", lambdaWarmStartFactor, lambdaWarmStartFactor))
+    {
+        logDebug("Lambda warm start factor is set by command line parameters to: " + std::to_string(lambdaWarmStartFactor));
+    }
+
+    if (cmdLine.Get("-minIteratorCount=", minIteratorCount, minIteratorCount))
+    {
+        logDebug("Min iterator count is set by command line parameters to: " + std::to_string(minIteratorCount));
+    }
+
+    if (cmdLine.Get("-residualTolerance=", residualTolerance, residualTolerance))
+    {
+        logDebug("Residual tolerance is set by command line parameters to: " + std::to_string(residualTolerance));
+    }
+
+    if (cmdLine.Get("-residualStagnation=", residualStagnationRatio, residualStagnationRatio))
+    {
+        logDebug("Residual stagnation ratio is set by command line parameters to: " + std::to_string(residualStagnationRatio));
+    }
+
+    if (cmdLine.Get("-chebyshev=", chebyshevAcceleration, chebyshevAcceleration))
+    {
+        logDebug("Chebyshev acceleration is set by command line parameters to: " + std::to_string(chebyshevAcceleration));
+    }
+
+    if (cmdLine.Get("-chebyshevSpectralRadius=", chebyshevSpectralRadius, chebyshevSpectralRadius))
+    {
+        logDebug("Chebyshev spectral radius is set by command line parameters to: " + std::to_string(chebyshevSpectralRadius));
+    }
+
+    if (cmdLine.Get("-overRelaxation=", overRelaxationFactor, overRelaxationFactor))
+    {
+        logDebug("Over-relaxation factor is set by command line parameters to: " + std::to_string(overRelaxationFactor));
+    }
+
+    if (cmdLine.Get("-sleep=", sleepEnabled, sleepEnabled))
+    {
+        logDebug("Sleep enabled is set by command line parameters to: " + std::to_string(sleepEnabled));
+    }
+
+    if (cmdLine.Get("-sleepVelocity=", sleepVelocityThreshold, sleepVelocityThreshold))
+    {
+        logDebug("Sleep velocity threshold is set by command line parameters to: " + std::to_string(sleepVelocityThreshold));
+    }
+
+    if (cmdLine.Get("-sleepDisplacement=", sleepDisplacementThreshold, sleepDisplacementThreshold))
+    {
+        logDebug("Sleep displacement threshold is set by command line parameters to: " + std::to_string(sleepDisplacementThreshold));
+    }
+
+    if (cmdLine.Get("-sleepFrames=", sleepFrameCount, sleepFrameCount))
+    {
+        logDebug("Sleep frame count is set by command line parameters to: " + std::to_string(sleepFrameCount));
+    }
+
+    if (cmdLine.Get("-velocityDamping=", velocityDamping, velocityDamping))
+    {
+        logDebug("Velocity damping is set by command line parameters to: " + std::to_string(velocityDamping));
+    }
+
+    if (cmdLine.Get("-multigridLevels=", multigridLevelCount, multigridLevelCount))
+    {
+        logDebug("Multigrid level count is set by command line parameters to: " + std::to_string(multigridLevelCount));
+    }
+
+    if (cmdLine.Get("-multigridIterations=", multigridIterationCount, multigridIterationCount))
+    {
+        logDebug("Multigrid iteration count is set by command line parameters to: " + std::to_string(multigridIterationCount));
+    }
+
+    std::string distanceSolveModeStr;
+    if (cmdLine.Get("-distanceSolveMode=", distanceSolveModeStr, "Iterative"))
+    {
+        logDebug("Distance solve mode is set by command line parameters to: " + distanceSolveModeStr);
+        if (distanceSolveModeStr == "Direct")
+        {
+            distanceSolveMode = XPBDDistanceSolveMode::Direct;
+        }
+        else if (distanceSolveModeStr == "Iterative")
+        {
+            distanceSolveMode = XPBDDistanceSolveMode::Iterative;
+        }
+        else
+        {
+            logDebug("Unknown distance solve mode: " + distanceSolveModeStr + ", defaulting to Iterative");
+            distanceSolveMode = XPBDDistanceSolveMode::Iterative;
+        }
+    }
+
+    if (cmdLine.Get("-directSolveIterations=", directSolveIterationCount, directSolveIterationCount))
+    {
+        logDebug("Direct solve iteration count is set by command line parameters to: " + std::to_string(directSolveIterationCount));
+    }
+
+    std::string scheduleModeStr;
+    if (cmdLine.Get("-scheduleMode=", scheduleModeStr, "Iterative"))
+    {
+        logDebug("Schedule mode is set by command line parameters to: " + scheduleModeStr);
+        if (scheduleModeStr == "SmallSteps")
+        {
+            scheduleMode = XPBDScheduleMode::SmallSteps;
+
+            // 小步长模式依靠子步数收敛，未指定时使用调优后的默认值
+            if (!subIteratorCountSet)
+            {
+                subIteratorCount = kSmallStepsDefaultSubIteratorCount;
+                logDebug("Sub-iterator count defaults to " + std::to_string(subIteratorCount) + " in SmallSteps mode");
+            }
+        }
+        else if (scheduleModeStr == "Iterative")
+        {
+            scheduleMode = XPBDScheduleMode::Iterative;
+        }
+        else
+        {
+            logDebug("Unknown schedule mode: " + scheduleModeStr + ", defaulting to Iterative");
+            scheduleMode = XPBDScheduleMode::Iterative;
+        }
+    }
+    
+    std::string solverTypeStr;
+    if (cmdLine.Get("-solver=", solverTypeStr, "XPBD"))
+    {
+        logDebug("Solver is set by command line parameters to: " + solverTypeStr);
+        if (solverTypeStr == "ProjectiveDynamics")
+        {
+            clothSolverType = ClothSolverType::ProjectiveDynamics;
+        }
+        else if (solverTypeStr == "XPBD")
+        {
+            clothSolverType = ClothSolverType::XPBD;
+        }
+        else
+        {
+            logDebug("Unknown solver: " + solverTypeStr + ", defaulting to XPBD");
+            clothSolverType = ClothSolverType::XPBD;
+        }
+    }
     
     // 解析布料物理参数
     if (cmdLine.Get("-mass=", mass, mass))
@@ -789,6 +1289,11 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         logDebug("Dihedral bending constraints is set by command line parameters to: " + std::string(addDihedralBendingConstraints ? "true" : "false"));
     }
     
+    if (cmdLine.Get("-addIsometricBendingConstraints=", addIsometricBendingConstraints, addIsometricBendingConstraints))
+    {
+        logDebug("Isometric bending constraints is set by command line parameters to: " + std::string(addIsometricBendingConstraints ? "true" : "false"));
+    }
+    
     if (cmdLine.Get("-addDiagonalConstraints=", addDiagonalConstraints, addDiagonalConstraints))
     {
         logDebug("Diagonal constraints is set by command line parameters to: " + std::string(addDiagonalConstraints ? "true" : "false"));
@@ -834,6 +1339,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         logDebug("Dihedral bending constraint damping is set by command line parameters to: " + std::to_string(dihedralBendingDamping));
     }
     
+    if (cmdLine.Get("-isometricBendingCompliance=", isometricBendingCompliance, isometricBendingCompliance))
+    {
+        logDebug("Isometric bending constraint compliance is set by command line parameters to: " + std::to_string(isometricBendingCompliance));
+    }
+    
+    if (cmdLine.Get("-isometricBendingDamping=", isometricBendingDamping, isometricBendingDamping))
+    {
+        logDebug("Isometric bending constraint damping is set by command line parameters to: " + std::to_string(isometricBendingDamping));
+    }
+    
     if (cmdLine.Get("-LRAMaxStretch=", lraMaxStretch, lraMaxStretch))
     {
         logDebug("LRA max stretch is set by command line parameters to: " + std::to_string(lraMaxStretch));
@@ -852,12 +1367,202 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         {
             meshAndContraintMode = ClothMeshAndContraintMode::Full;
         }
+        else if (meshAndConstraintModeStr == "Mesh")
+        {
+            meshAndContraintMode = ClothMeshAndContraintMode::Mesh;
+        }
         else
         {
             logDebug("Unknown mesh and constraint mode: " + meshAndConstraintModeStr + ", defaulting to Full");
             meshAndContraintMode = ClothMeshAndContraintMode::Full;
         }
     }
+
+    // 解析布料三角网格文件参数，指定文件时自动切换到Mesh模式
+    if (cmdLine.Get("-clothMesh=", clothMeshFile, ""))
+    {
+        logDebug("Cloth mesh file is set by command line parameters to: " + clothMeshFile);
+        meshAndContraintMode = ClothMeshAndContraintMode::Mesh;
+    }
+    else if (meshAndContraintMode == ClothMeshAndContraintMode::Mesh)
+    {
+        logDebug("Mesh and constraint mode Mesh requires -clothMesh, defaulting to Full");
+        meshAndContraintMode = ClothMeshAndContraintMode::Full;
+    }
+
+    // 解析粒子重排序参数，文件中的顶点顺序通常与网格邻接关系无关，Mesh模式默认按RCM重排
+    std::string particleOrderingStr;
+    if (cmdLine.Get("-particleOrdering=", particleOrderingStr, ""))
+    {
+        logDebug("Particle ordering is set by command line parameters to: " + particleOrderingStr);
+        if (particleOrderingStr == "Morton")
+        {
+            particleOrdering = ClothParticleOrdering::Morton;
+        }
+        else if (particleOrderingStr == "RCM")
+        {
+            particleOrdering = ClothParticleOrdering::ReverseCuthillMcKee;
+        }
+        else if (particleOrderingStr == "None")
+        {
+            particleOrdering = ClothParticleOrdering::None;
+        }
+        else
+        {
+            logDebug("Unknown particle ordering: " + particleOrderingStr + ", defaulting to None");
+            particleOrdering = ClothParticleOrdering::None;
+        }
+    }
+    else if (meshAndContraintMode == ClothMeshAndContraintMode::Mesh)
+    {
+        particleOrdering = ClothParticleOrdering::ReverseCuthillMcKee;
+    }
+    
+    uint32_t tempRenderThreadCount = renderThreadCount;
+    if (cmdLine.Get("-renderThreads=", tempRenderThreadCount, renderThreadCount))
+    {
+        renderThreadCount = (tempRenderThreadCount < 1) ? 1 : tempRenderThreadCount;
+        logDebug("Render thread count is set by command line parameters to: " + std::to_string(renderThreadCount));
+    }
+    
+    if (cmdLine.Get("-workerThreads=", workerThreadCount, workerThreadCount))
+    {
+        logDebug("Worker thread count is set by command line parameters to: " + std::to_string(workerThreadCount));
+    }
+
+    // 初始化全局任务调度器，求解器和渲染的并行任务共享同一个线程池
+    TaskScheduler::Get().Initialize(workerThreadCount);
+
+    if (cmdLine.Get("-benchmarkFrames=", benchmarkFrames, benchmarkFrames))
+    {
+        logDebug("Benchmark frames is set by command line parameters to: " + std::to_string(benchmarkFrames));
+    }
+
+    if (cmdLine.Get("-trajectoryFile=", trajectoryFile, trajectoryFile))
+    {
+        logDebug("Trajectory file is set by command line parameters to: " + trajectoryFile);
+    }
+
+    if (cmdLine.Get("-trajectoryTolerance=", trajectoryTolerance, trajectoryTolerance))
+    {
+        logDebug("Trajectory tolerance is set by command line parameters to: " + std::to_string(trajectoryTolerance));
+    }
+
+    if (cmdLine.Get("-determinismHash=", determinismHash, ""))
+    {
+        logDebug("Determinism hash is set by command line parameters to: " + determinismHash);
+    }
+
+    if (cmdLine.Get("-goldenDir=", goldenDirectory, goldenDirectory))
+    {
+        logDebug("Golden directory is set by command line parameters to: " + goldenDirectory);
+    }
+
+    if (cmdLine.Get("-perfThreshold=", perfThreshold, perfThreshold))
+    {
+        logDebug("Performance threshold is set by command line parameters to: " + std::to_string(perfThreshold));
+    }
+
+    if (cmdLine.Get("-updateGolden=", updateGolden, updateGolden))
+    {
+        logDebug("Update golden is set by command line parameters to: " + std::to_string(updateGolden));
+    }
+
+    if (cmdLine.Get("-sweepOutput=", sweepOutputFile, sweepOutputFile))
+    {
+        logDebug("Sweep output file is set by command line parameters to: " + sweepOutputFile);
+    }
+
+    if (cmdLine.Get("-batchClothCount=", batchClothCount, batchClothCount))
+    {
+        logDebug("Batch cloth count is set by command line parameters to: " + std::to_string(batchClothCount));
+    }
+
+    if (cmdLine.Get("-packedClothBatch=", packedClothBatching, packedClothBatching))
+    {
+        logDebug("Packed cloth batching is set by command line parameters to: " + std::to_string(packedClothBatching));
+    }
+
+    if (cmdLine.Get("-recordCache=", recordCacheFile, ""))
+    {
+        logDebug("Record cache file is set by command line parameters to: " + recordCacheFile);
+    }
+
+    std::string frameCacheFormatStr;
+    if (cmdLine.Get("-frameCacheFormat=", frameCacheFormatStr, ""))
+    {
+        logDebug("Frame cache format is set by command line parameters to: " + frameCacheFormatStr);
+        if (frameCacheFormatStr == "Quantized16")
+        {
+            frameCacheFormat = ClothFrameCacheFormat::Quantized16;
+        }
+        else if (frameCacheFormatStr == "CompressedNormal16")
+        {
+            frameCacheFormat = ClothFrameCacheFormat::CompressedNormal16;
+        }
+        else if (frameCacheFormatStr == "CompressedNormal8")
+        {
+            frameCacheFormat = ClothFrameCacheFormat::CompressedNormal8;
+        }
+        else if (frameCacheFormatStr == "Float32")
+        {
+            frameCacheFormat = ClothFrameCacheFormat::Float32;
+        }
+        else
+        {
+            logDebug("Unknown frame cache format: " + frameCacheFormatStr + ", defaulting to Float32");
+            frameCacheFormat = ClothFrameCacheFormat::Float32;
+        }
+    }
+
+    if (cmdLine.Get("-playCache=", playCacheFile, ""))
+    {
+        logDebug("Play cache file is set by command line parameters to: " + playCacheFile);
+    }
+
+    if (cmdLine.Get("-playCacheFrame=", playCacheFrame, playCacheFrame))
+    {
+        logDebug("Play cache start frame is set by command line parameters to: " + std::to_string(playCacheFrame));
+    }
+
+    if (cmdLine.Get("-checkpointFile=", checkpointFile, checkpointFile))
+    {
+        logDebug("Checkpoint file is set by command line parameters to: " + checkpointFile);
+    }
+
+    if (cmdLine.Get("-checkpointInterval=", checkpointInterval, checkpointInterval))
+    {
+        logDebug("Checkpoint interval is set by command line parameters to: " + std::to_string(checkpointInterval));
+    }
+
+    if (cmdLine.Get("-restoreCheckpoint=", restoreCheckpointFile, ""))
+    {
+        logDebug("Restore checkpoint file is set by command line parameters to: " + restoreCheckpointFile);
+    }
+
+    // 场景描述：命令行参数描述的布料和默认球体，指定场景文件时布料和碰撞体替换为文件中的内容，命令行参数作为布料设置的默认值
+    sceneDescription = CreateDefaultSceneDescription();
+    if (cmdLine.Get("-scene=", sceneFile, ""))
+    {
+        logDebug("Scene file is set by command line parameters to: " + sceneFile);
+        ClothSceneCloth commandLineCloth = CreateCommandLineClothDescription();
+        if (!ClothSceneLoader::Load(sceneFile, commandLineCloth, sceneDescription))
+        {
+            std::cerr << "Failed to load scene file " << sceneFile << std::endl;
+            TaskScheduler::Get().Shutdown();
+            closeLogFile();
+            return -1;
+        }
+    }
+
+    // 无窗口基准测试模式，运行完成后直接退出
+    if (cmdLine.Get("-benchmark=", benchmarkName, ""))
+    {
+        int exitCode = RunBenchmark(benchmarkName);
+        TaskScheduler::Get().Shutdown();
+        closeLogFile();
+        return exitCode;
+    }
     
     // 创建窗口
     std::cout << "Creating window..." << std::endl;
@@ -880,86 +1585,83 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     }
     std::cout << "Device initialized successfully" << std::endl;
     
-    // 创建布料对象，调整位置使布料正中心对准球体(0,0,0)
-    std::cout << "Creating cloth object..." << std::endl;
-    
-    cloth = new Cloth(widthResolution, heightResolution, 10.0f, mass, massMode, meshAndContraintMode);
-    
-    // 设置布料的物理参数
-    cloth->SetAddLRAConstraints(addLRAConstraints);
-    logDebug("Cloth add LRA constraints: " + std::to_string(addLRAConstraints));
-    cloth->SetAddBendingConstraints(addBendingConstraints);
-    logDebug("Cloth add bending constraints: " + std::to_string(addBendingConstraints));
-    cloth->SetAddDihedralBendingConstraints(addDihedralBendingConstraints);
-    logDebug("Cloth add dihedral bending constraints: " + std::to_string(addDihedralBendingConstraints));
-    cloth->SetAddDiagonalConstraints(addDiagonalConstraints);
-    logDebug("Cloth add diagonal constraints: " + std::to_string(addDiagonalConstraints));
-    cloth->SetDistanceConstraintCompliance(distanceCompliance);
-    logDebug("Cloth distance constraint compliance set to: " + std::to_string(distanceCompliance));
-    cloth->SetDistanceConstraintDamping(distanceDamping);
-    logDebug("Cloth distance constraint damping set to: " + std::to_string(distanceDamping));
-    cloth->SetLRAMaxStretch(lraMaxStretch);
-    logDebug("Cloth LRA max stretch set to: " + std::to_string(lraMaxStretch));
-    cloth->SetLRAConstraintCompliance(lraCompliance);
-    logDebug("Cloth LRA constraint compliance set to: " + std::to_string(lraCompliance));
-    cloth->SetLRAConstraintDamping(lraDamping);
-    logDebug("Cloth LRA constraint damping set to: " + std::to_string(lraDamping));
-    cloth->SetBendingConstraintCompliance(bendingCompliance);
-    logDebug("Cloth bending constraint compliance set to: " + std::to_string(bendingCompliance));
-    cloth->SetBendingConstraintDamping(bendingDamping);
-    logDebug("Cloth bending constraint damping set to: " + std::to_string(bendingDamping));
-    cloth->SetDihedralBendingConstraintCompliance(dihedralBendingCompliance);
-    logDebug("Cloth dihedral bending constraint compliance set to: " + std::to_string(dihedralBendingCompliance));
-    cloth->SetDihedralBendingConstraintDamping(dihedralBendingDamping);
-    logDebug("Cloth dihedral bending constraint clamping set to: " + std::to_string(dihedralBendingDamping));
-    cloth->SetIteratorCount(iteratorCount);
-    logDebug("Cloth iterator count set to: " + std::to_string(iteratorCount));
-    cloth->SetSubIteratorCount(subIteratorCount);
-    logDebug("Cloth sub-iterator count set to: " + std::to_string(subIteratorCount));
-
-    // 设置位置
-    cloth->SetPosition(dx::XMFLOAT3(-5.0f, 10.0f, -5.0f));
-
-    // 设置布料的材质颜色（红色）
-    cloth->SetDiffuseColor(dx::XMFLOAT3(1.0f, 0.1f, 0.1f));
-
-    // 初始化布料
-	cloth->Initialize(device);
-
-    // 将布料添加到场景中
-    scene->AddPrimitive(cloth);
-
-    std::cout << "Sphere object added to scene successfully" << std::endl;
-
-    std::cout << "Cloth object created successfully" << std::endl;
+    // 按场景描述创建布料对象
+    std::cout << "Creating cloth objects..." << std::endl;
+
+    for (const ClothSceneCloth& clothDescription : sceneDescription.cloths)
+    {
+        Cloth* sceneCloth = ClothSceneLoader::CreateCloth(clothDescription);
+        cloths.push_back(sceneCloth);
+
+        // 回放帧缓存时不创建粒子和约束，帧缓存只用于第一块布料
+        if (cloths.size() == 1 && !playCacheFile.empty())
+        {
+            sceneCloth->SetFrameCachePlaybackFile(playCacheFile);
+            sceneCloth->SeekFrameCache((uint32_t)(std::max)(0, playCacheFrame));
+        }
+
+        // 初始化布料
+        if (!sceneCloth->Initialize(device))
+        {
+            MessageBox(hWnd, L"Failed to initialize cloth", L"Error", MB_OK | MB_ICONERROR);
+            Cleanup();
+            return -1;
+        }
+
+        // 将布料添加到场景中
+        scene->AddPrimitive(sceneCloth);
+    }
+    cloth = cloths[0];
+
+    std::cout << "Cloth objects created successfully" << std::endl;
     
     // 创建并初始化球体对象
-    dx::XMFLOAT3 sphereCenter(0.0f, 5.0f, 0.0f);
-    float sphereRadius = 2.0f;
-
-    std::cout << "Creating sphere object..." << std::endl;
-    sphere = new Sphere(sphereRadius, 32, 32);
+    std::cout << "Creating sphere objects..." << std::endl;
+    for (const ClothSceneSphere& sphereDescription : sceneDescription.spheres)
+    {
+        Sphere* sphere = new Sphere(sphereDescription.radius, 32, 32);
+        spheres.push_back(sphere);
 
-    // 设置球体的材质颜色（红色）
-    sphere->SetDiffuseColor(dx::XMFLOAT3(1.0f, 0.1f, 0.1f));
+        // 设置球体的材质颜色
+        sphere->SetDiffuseColor(sphereDescription.diffuseColor);
     
-    // 设置球体的世界矩阵
-    sphere->SetPosition(dx::XMFLOAT3(0.0f, 5.0f, 0.0f));
-    sphere->SetScale(dx::XMFLOAT3(1.0f, 1.0f, 1.0f));
-    sphere->SetRotation(dx::XMFLOAT3(0.0f, 0.0f, 0.0f));
+        // 设置球体的世界矩阵
+        sphere->SetPosition(sphereDescription.center);
+        sphere->SetScale(dx::XMFLOAT3(1.0f, 1.0f, 1.0f));
+        sphere->SetRotation(dx::XMFLOAT3(0.0f, 0.0f, 0.0f));
     
-    sphere->Initialize(device);
+        sphere->Initialize(device);
 
-    // 初始化球体碰撞约束（一次性创建，避免每帧重建）
-    cloth->InitializeSphereCollisionConstraints(sphere->GetPosition(), sphereRadius);
+        // 初始化球体碰撞约束（一次性创建，避免每帧重建）
+        for (Cloth* sceneCloth : cloths)
+        {
+            sceneCloth->InitializeSphereCollisionConstraints(sphereDescription.center, sphereDescription.radius);
+        }
+
+        // 将球体添加到场景中
+        scene->AddPrimitive(sphere);
+    }
+    std::cout << "Sphere objects added to scene successfully" << std::endl;
+
+    // 从检查点恢复模拟状态，碰撞约束创建后才能恢复
+    if (!restoreCheckpointFile.empty() && !cloth->IsPlayingFrameCache())
+    {
+        std::vector<char> checkpoint;
+        if (ClothCheckpoint::ReadFile(restoreCheckpointFile, checkpoint))
+        {
+            cloth->LoadCheckpoint(checkpoint.data(), checkpoint.size());
+        }
+    }
 
-    // 将球体添加到场景中
-    scene->AddPrimitive(sphere);
-    std::cout << "Sphere object added to scene successfully" << std::endl;
+    // 录制帧缓存，程序退出删除布料时写入帧表
+    if (!recordCacheFile.empty() && !cloth->IsPlayingFrameCache())
+    {
+        cloth->StartFrameCacheRecording(recordCacheFile, frameCacheFormat);
+    }
 
     // 设置场景光源属性
-    scene->SetLightPosition(dx::XMFLOAT3(-10.0f, 30.0f, -10.0f));
-    scene->SetLightDiffuseColor(dx::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+    scene->SetLightPosition(sceneDescription.lightPosition);
+    scene->SetLightDiffuseColor(sceneDescription.lightDiffuseColor);
     
     // 初始化高精度计时器
     QueryPerformanceFrequency(&frequency);
@@ -1017,16 +1719,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             
             // 构造新的窗口标题
             std::wstring originalTitle = L"ClothSimulator";
-			std::wstring solverType = L"Solver::XPBD";
+            std::string solverName = cloth->GetSolverName();
+			std::wstring solverType = L"Solver::" + std::wstring(solverName.begin(), solverName.end());
             std::wstring lraStatus = cloth->GetAddLRAConstraints() ? L"LRA:ON" : L"LRA:OFF";
             std::wstring bendingStatus = cloth->GetAddBendingConstraints() ? L"Bending:ON" : L"Bending:OFF";
             std::wstring dihedralBendingStatus = cloth->GetAddDihedralBendingConstraints() ? L"DihedralBending:ON" : L"DihedralBending:OFF";
+            std::wstring isometricBendingStatus = cloth->GetAddIsometricBendingConstraints() ? L"IsometricBending:ON" : L"IsometricBending:OFF";
             std::wstring diagonalStatus = cloth->GetAddDiagonalConstraints() ? L"Diagonal:ON" : L"Diagonal:OFF";
+            const ClothSolverStats& solverStats = cloth->GetSolverStats();
             std::wstring newTitle = originalTitle + L" [" + solverType + L", " + L"FPS:" + std::to_wstring(static_cast<int>(fps)) + L", " +
-                L"Iter:" + std::to_wstring(iteratorCount) + L", " + 
-                L"SubIter:" + std::to_wstring(subIteratorCount) + L", " +
-                L"Res:" + std::to_wstring(widthResolution) + L"x" + std::to_wstring(heightResolution) + L", " +
-                lraStatus + L", " + bendingStatus + L", " + dihedralBendingStatus + L", " + diagonalStatus + L", " + L"MaxStretch:" + std::to_wstring(cloth->GetLRAMaxStretch()) + L", " + L"Mass:" + std::to_wstring(cloth->GetMass()) + L"]";
+                L"Iter:" + std::to_wstring(solverStats.iterationCount) + L"/" + std::to_wstring(solverStats.iterationBudget) + L", " +
+                L"Residual:" + std::to_wstring(solverStats.maxError) + L", " + 
+                L"SubIter:" + std::to_wstring(cloth->GetSubIteratorCount()) + L", " +
+                L"Res:" + std::to_wstring(cloth->GetWidthResolution()) + L"x" + std::to_wstring(cloth->GetHeightResolution()) + L", " +
+                lraStatus + L", " + bendingStatus + L", " + dihedralBendingStatus + L", " + isometricBendingStatus + L", " + diagonalStatus + L", " + L"MaxStretch:" + std::to_wstring(cloth->GetLRAMaxStretch()) + L", " + L"Mass:" + std::to_wstring(cloth->GetMass()) + L"]";
             
             // 更新窗口标题
             SetWindowTextW(hWnd, newTitle.c_str());
@@ -1048,6 +1754,21 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         if (debugOutputEnabled && frameCount % 30 == 0)
         {
             std::cout << "Current frame: " << frameCount << ", deltaTime: " << deltaTime << std::endl;
+
+            const ClothSolverStats& solverStats = cloth->GetSolverStats();
+            char buffer[256];
+            snprintf(buffer, sizeof(buffer), "Solver iterations: %u/%u, residual max: %g rms: %g (distance %g, bending %g, isometric bending %g, LRA %g, collision %g), sleeping particles: %u"
+                , solverStats.iterationCount
+                , solverStats.iterationBudget
+                , solverStats.maxError
+                , solverStats.rmsError
+                , solverStats.distance.maxError
+                , solverStats.dihedralBending.maxError
+                , solverStats.isometricBending.maxError
+                , solverStats.lra.maxError
+                , solverStats.collision.maxError
+                , solverStats.sleepingParticleCount);
+            logDebug(buffer);
         }
 
 #ifdef DEBUG_SOLVER
@@ -1063,6 +1784,14 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         {
             // 更新场景
             scene->Update(deltaTime);
+
+            // 定期保存检查点，模拟线程只复制状态，文件在后台写入
+            if (checkpointInterval > 0 && frameCount % checkpointInterval == 0 && !cloth->IsPlayingFrameCache())
+            {
+                std::vector<char> checkpoint;
+                cloth->SaveCheckpoint(checkpoint);
+                checkpointWriter.WriteAsync(checkpointFile, std::move(checkpoint));
+            }
         }
 
         scene->Render(camera->GetViewMatrix(), camera->GetProjectionMatrix());
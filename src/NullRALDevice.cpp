@@ -0,0 +1,471 @@
+#include "NullRALDevice.h"
+#include <sstream>
+
+// NullRALGraphicsCommandList构造函数
+NullRALGraphicsCommandList::NullRALGraphicsCommandList()
+    : IRALGraphicsCommandList()
+    , m_closed(false)
+    , m_invalidCommandCount(0)
+{
+}
+
+void NullRALGraphicsCommandList::Record(NullRALCommandType type, const void* object, uint64_t v0, uint64_t v1, uint64_t v2, uint64_t v3, uint64_t v4)
+{
+    // 关闭之后的命令在真实后端上会导致错误，这里只计数，方便验证录制流程
+    if (m_closed)
+    {
+        m_invalidCommandCount++;
+        return;
+    }
+
+    NullRALCommand command;
+    command.type = type;
+    command.object = object;
+    command.values[0] = v0;
+    command.values[1] = v1;
+    command.values[2] = v2;
+    command.values[3] = v3;
+    command.values[4] = v4;
+    m_commands.push_back(command);
+}
+
+void NullRALGraphicsCommandList::ResourceBarrier(const RALResourceBarrier& barrier)
+{
+    ResourceBarriers(&barrier, 1);
+}
+
+void NullRALGraphicsCommandList::ResourceBarriers(const RALResourceBarrier* barriers, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Record(NullRALCommandType::ResourceBarrier, barriers[i].resource,
+            static_cast<uint64_t>(barriers[i].type), static_cast<uint64_t>(barriers[i].oldState), static_cast<uint64_t>(barriers[i].newState));
+    }
+}
+
+void NullRALGraphicsCommandList::Close()
+{
+    m_closed = true;
+}
+
+void NullRALGraphicsCommandList::Reset()
+{
+    m_commands.clear();
+    m_closed = false;
+    m_invalidCommandCount = 0;
+}
+
+void* NullRALGraphicsCommandList::GetNativeCommandList()
+{
+    return nullptr;
+}
+
+void NullRALGraphicsCommandList::ClearRenderTarget(IRALRenderTargetView* renderTargetView, const RALClearValue& clearValue)
+{
+    Record(NullRALCommandType::ClearRenderTarget, renderTargetView);
+}
+
+void NullRALGraphicsCommandList::ClearDepthStencil(IRALDepthStencilView* depthStencilView, const RALClearValue& clearValue)
+{
+    Record(NullRALCommandType::ClearDepthStencil, depthStencilView);
+}
+
+void NullRALGraphicsCommandList::SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth)
+{
+    Record(NullRALCommandType::SetViewport, nullptr,
+        static_cast<uint64_t>(x), static_cast<uint64_t>(y), static_cast<uint64_t>(width), static_cast<uint64_t>(height));
+}
+
+void NullRALGraphicsCommandList::SetScissorRect(int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    Record(NullRALCommandType::SetScissorRect, nullptr,
+        static_cast<uint64_t>(left), static_cast<uint64_t>(top), static_cast<uint64_t>(right), static_cast<uint64_t>(bottom));
+}
+
+void NullRALGraphicsCommandList::SetPipelineState(IRALResource* pipelineState)
+{
+    Record(NullRALCommandType::SetPipelineState, pipelineState);
+}
+
+void NullRALGraphicsCommandList::SetVertexBuffers(uint32_t startSlot, uint32_t count, IRALVertexBuffer** ppVertexBuffers)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Record(NullRALCommandType::SetVertexBuffers, ppVertexBuffers[i], startSlot + i);
+    }
+}
+
+void NullRALGraphicsCommandList::SetIndexBuffer(IRALIndexBuffer* indexBuffer)
+{
+    Record(NullRALCommandType::SetIndexBuffer, indexBuffer);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootSignature(IRALRootSignature* rootSignature)
+{
+    Record(NullRALCommandType::SetGraphicsRootSignature, rootSignature);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootConstant(uint32_t rootParameterIndex, uint32_t shaderRegister, uint32_t value)
+{
+    Record(NullRALCommandType::SetGraphicsRootConstants, nullptr, rootParameterIndex, shaderRegister, 1, value);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootConstants(uint32_t rootParameterIndex, uint32_t shaderRegister, uint32_t count, const uint32_t* values)
+{
+    Record(NullRALCommandType::SetGraphicsRootConstants, nullptr, rootParameterIndex, shaderRegister, count, count > 0 ? values[0] : 0);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootDescriptorTable(uint32_t rootParameterIndex, void* descriptorTable)
+{
+    Record(NullRALCommandType::SetGraphicsRootDescriptorTable, descriptorTable, rootParameterIndex);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootDescriptorTable(uint32_t rootParameterIndex, IRALShaderResourceView* srv)
+{
+    Record(NullRALCommandType::SetGraphicsRootDescriptorTable, srv, rootParameterIndex);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootConstantBuffer(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer)
+{
+    Record(NullRALCommandType::SetGraphicsRootConstantBuffer, constBuffer, rootParameterIndex);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootShaderResource(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer)
+{
+    Record(NullRALCommandType::SetGraphicsRootShaderResource, constBuffer, rootParameterIndex);
+}
+
+void NullRALGraphicsCommandList::SetGraphicsRootUnorderedAccess(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer)
+{
+    Record(NullRALCommandType::SetGraphicsRootUnorderedAccess, constBuffer, rootParameterIndex);
+}
+
+void NullRALGraphicsCommandList::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation)
+{
+    Record(NullRALCommandType::Draw, nullptr, vertexCount, instanceCount, startVertexLocation, startInstanceLocation);
+}
+
+void NullRALGraphicsCommandList::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation)
+{
+    Record(NullRALCommandType::DrawIndexed, nullptr, indexCount, instanceCount, startIndexLocation, static_cast<uint64_t>(baseVertexLocation), startInstanceLocation);
+}
+
+void NullRALGraphicsCommandList::DrawIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride)
+{
+    Record(NullRALCommandType::DrawIndirect, argumentBuffer, argumentOffset, drawCount, stride);
+}
+
+void NullRALGraphicsCommandList::DrawIndexedIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride)
+{
+    Record(NullRALCommandType::DrawIndexedIndirect, argumentBuffer, argumentOffset, drawCount, stride);
+}
+
+void NullRALGraphicsCommandList::SetRenderTargets(uint32_t renderTargetCount, IRALRenderTargetView** renderTargetViews, IRALDepthStencilView* depthStencilView)
+{
+    Record(NullRALCommandType::SetRenderTargets, depthStencilView, renderTargetCount,
+        renderTargetCount > 0 ? reinterpret_cast<uint64_t>(renderTargetViews[0]) : 0);
+}
+
+void NullRALGraphicsCommandList::ExecuteRenderPass(const void* renderPass, const void* framebuffer)
+{
+    Record(NullRALCommandType::ExecuteRenderPass, renderPass);
+}
+
+void NullRALGraphicsCommandList::SetPrimitiveTopology(RALPrimitiveTopologyType topology)
+{
+    Record(NullRALCommandType::SetPrimitiveTopology, nullptr, static_cast<uint64_t>(topology));
+}
+
+// NullRALDevice构造函数
+NullRALDevice::NullRALDevice(uint32_t width, uint32_t height)
+    : m_width(width)
+    , m_height(height)
+    , m_commandListPoolUsed(0)
+    , m_lastFrameErrorCount(0)
+{
+}
+
+NullRALDevice::~NullRALDevice()
+{
+    Cleanup();
+}
+
+bool NullRALDevice::Initialize()
+{
+    m_graphicsCommandList = new NullRALGraphicsCommandList();
+    m_currentGraphicsCommandList = m_graphicsCommandList;
+
+    m_backBuffer = new TNullRALResource<IRALRenderTarget>(m_width, m_height, RALDataFormat::R8G8B8A8_UNorm);
+    m_backBufferDepth = new TNullRALResource<IRALDepthStencil>(m_width, m_height, RALDataFormat::D32_Float);
+    m_backBufferRTV = new NullRALRenderTargetView(m_backBuffer.Get());
+    m_backBufferDSV = new NullRALDepthStencilView(m_backBufferDepth.Get());
+
+    return true;
+}
+
+void NullRALDevice::BeginFrame()
+{
+    m_graphicsCommandList->Reset();
+    m_currentGraphicsCommandList = m_graphicsCommandList;
+    m_frameCommandLists.clear();
+    m_commandListPoolUsed = 0;
+
+    SetupFrameDefaultState(m_graphicsCommandList.Get());
+}
+
+void NullRALDevice::EndFrame()
+{
+    m_frameCommandLists.push_back(m_currentGraphicsCommandList.Get());
+
+    // 按提交顺序关闭并保存命令，同时检查录制错误
+    m_lastFrameSubmission.clear();
+    m_lastFrameErrorCount = 0;
+    for (NullRALGraphicsCommandList* commandList : m_frameCommandLists)
+    {
+        // 调用者不应该自行关闭交给设备管理的命令列表
+        if (commandList->IsClosed())
+        {
+            m_lastFrameErrorCount++;
+        }
+
+        commandList->Close();
+        m_lastFrameErrorCount += commandList->GetInvalidCommandCount();
+        m_lastFrameSubmission.push_back(commandList->GetCommands());
+    }
+
+    m_frameCommandLists.clear();
+    m_commandListPoolUsed = 0;
+    m_currentGraphicsCommandList = m_graphicsCommandList;
+}
+
+void NullRALDevice::Cleanup()
+{
+    m_frameCommandLists.clear();
+    m_commandListPool.clear();
+}
+
+void NullRALDevice::Resize(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+}
+
+IRALVertexShader* NullRALDevice::CompileVertexShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALVertexShader>();
+}
+
+IRALPixelShader* NullRALDevice::CompilePixelShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALPixelShader>();
+}
+
+IRALGeometryShader* NullRALDevice::CompileGeometryShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALGeometryShader>();
+}
+
+IRALComputeShader* NullRALDevice::CompileComputeShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALComputeShader>();
+}
+
+IRALMeshShader* NullRALDevice::CompileMeshShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALMeshShader>();
+}
+
+IRALAmplificationShader* NullRALDevice::CompileAmplificationShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALAmplificationShader>();
+}
+
+IRALRayGenShader* NullRALDevice::CompileRayGenShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALRayGenShader>();
+}
+
+IRALRayMissShader* NullRALDevice::CompileRayMissShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALRayMissShader>();
+}
+
+IRALRayHitGroupShader* NullRALDevice::CompileRayHitGroupShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALRayHitGroupShader>();
+}
+
+IRALRayCallableShader* NullRALDevice::CompileRayCallableShader(const char* shaderCode, const char* entryPoint)
+{
+    return new TNullRALResource<IRALRayCallableShader>();
+}
+
+IRALGraphicsPipelineState* NullRALDevice::CreateGraphicsPipelineState(const RALGraphicsPipelineStateDesc& desc, const wchar_t* debugName)
+{
+    return new TNullRALResource<IRALGraphicsPipelineState>();
+}
+
+IRALRootSignature* NullRALDevice::CreateRootSignature(const std::vector<RALRootParameter>& rootParameters,
+    const std::vector<RALStaticSampler>& staticSamplers, RALRootSignatureFlags flags, const wchar_t* debugName)
+{
+    return new TNullRALResource<IRALRootSignature>();
+}
+
+IRALVertexBuffer* NullRALDevice::CreateVertexBuffer(uint32_t size, uint32_t stride, bool isStatic, const void* initialData, const wchar_t* debugName)
+{
+    return new TNullRALResource<IRALVertexBuffer>(size);
+}
+
+IRALIndexBuffer* NullRALDevice::CreateIndexBuffer(uint32_t count, bool is32BitIndex, bool isStatic, const void* initialData, const wchar_t* debugName)
+{
+    uint32_t size = count * (is32BitIndex ? 4 : 2);
+    return new TNullRALResource<IRALIndexBuffer>(count, size, is32BitIndex);
+}
+
+IRALConstBuffer* NullRALDevice::CreateConstBuffer(uint32_t size, const wchar_t* debugName)
+{
+    return new NullRALConstBuffer(size);
+}
+
+bool NullRALDevice::UploadBuffer(IRALBuffer* buffer, const char* data, uint64_t size)
+{
+    // 上传在真实后端上是录制到当前主命令列表的复制命令，这里只检查参数
+    return buffer != nullptr && data != nullptr && size <= buffer->GetSize();
+}
+
+IRALGraphicsCommandList* NullRALDevice::GetGraphicsCommandList()
+{
+    return m_currentGraphicsCommandList.Get();
+}
+
+bool NullRALDevice::AcquireParallelGraphicsCommandLists(uint32_t count, IRALGraphicsCommandList** outCommandLists)
+{
+    if (count == 0 || !outCommandLists)
+    {
+        return false;
+    }
+
+    // 提交顺序与DX12后端一致：当前主命令列表 -> 并行命令列表 -> 新的主命令列表
+    m_frameCommandLists.push_back(m_currentGraphicsCommandList.Get());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        NullRALGraphicsCommandList* commandList = AcquirePooledCommandList();
+        SetupFrameDefaultState(commandList);
+        m_frameCommandLists.push_back(commandList);
+        outCommandLists[i] = commandList;
+    }
+
+    NullRALGraphicsCommandList* nextCommandList = AcquirePooledCommandList();
+    SetupFrameDefaultState(nextCommandList);
+    m_currentGraphicsCommandList = nextCommandList;
+
+    return true;
+}
+
+NullRALGraphicsCommandList* NullRALDevice::AcquirePooledCommandList()
+{
+    if (m_commandListPoolUsed == m_commandListPool.size())
+    {
+        m_commandListPool.push_back(TRefCountPtr<NullRALGraphicsCommandList>(new NullRALGraphicsCommandList()));
+    }
+
+    NullRALGraphicsCommandList* commandList = m_commandListPool[m_commandListPoolUsed++].Get();
+    commandList->Reset();
+
+    return commandList;
+}
+
+void NullRALDevice::SetupFrameDefaultState(IRALGraphicsCommandList* commandList)
+{
+    IRALRenderTargetView* backBufferRTV = m_backBufferRTV.Get();
+    commandList->SetRenderTargets(1, &backBufferRTV, m_backBufferDSV.Get());
+    commandList->SetViewport(0.0f, 0.0f, static_cast<float>(m_width), static_cast<float>(m_height), 0.0f, 1.0f);
+    commandList->SetScissorRect(0, 0, static_cast<int32_t>(m_width), static_cast<int32_t>(m_height));
+}
+
+IRALRenderTarget* NullRALDevice::CreateRenderTarget(uint32_t width, uint32_t height, RALDataFormat format, const RALClearValue* clearValue, const wchar_t* debugName)
+{
+    return new TNullRALResource<IRALRenderTarget>(width, height, format);
+}
+
+IRALRenderTargetView* NullRALDevice::CreateRenderTargetView(IRALRenderTarget* renderTarget, const RALRenderTargetViewDesc& desc, const wchar_t* debugName)
+{
+    return new NullRALRenderTargetView(renderTarget);
+}
+
+IRALDepthStencilView* NullRALDevice::CreateDepthStencilView(IRALDepthStencil* depthStencil, const RALDepthStencilViewDesc& desc, const wchar_t* debugName)
+{
+    return new NullRALDepthStencilView(depthStencil);
+}
+
+IRALShaderResourceView* NullRALDevice::CreateShaderResourceView(IRALResource* resource, const RALShaderResourceViewDesc& desc, const wchar_t* debugName)
+{
+    return new NullRALShaderResourceView(resource);
+}
+
+IRALDepthStencil* NullRALDevice::CreateDepthStencil(uint32_t width, uint32_t height, RALDataFormat format, const RALClearValue* clearValue, const wchar_t* debugName)
+{
+    return new TNullRALResource<IRALDepthStencil>(width, height, format);
+}
+
+IRALRenderTargetView* NullRALDevice::GetBackBufferRTV()
+{
+    return m_backBufferRTV.Get();
+}
+
+IRALDepthStencilView* NullRALDevice::GetBackBufferDSV()
+{
+    return m_backBufferDSV.Get();
+}
+
+const char* NullRALDevice::GetCommandName(NullRALCommandType type)
+{
+    switch (type)
+    {
+    case NullRALCommandType::ResourceBarrier:                return "ResourceBarrier";
+    case NullRALCommandType::ClearRenderTarget:              return "ClearRenderTarget";
+    case NullRALCommandType::ClearDepthStencil:              return "ClearDepthStencil";
+    case NullRALCommandType::SetViewport:                    return "SetViewport";
+    case NullRALCommandType::SetScissorRect:                 return "SetScissorRect";
+    case NullRALCommandType::SetPipelineState:               return "SetPipelineState";
+    case NullRALCommandType::SetVertexBuffers:               return "SetVertexBuffers";
+    case NullRALCommandType::SetIndexBuffer:                 return "SetIndexBuffer";
+    case NullRALCommandType::SetGraphicsRootSignature:       return "SetGraphicsRootSignature";
+    case NullRALCommandType::SetGraphicsRootConstants:       return "SetGraphicsRootConstants";
+    case NullRALCommandType::SetGraphicsRootDescriptorTable: return "SetGraphicsRootDescriptorTable";
+    case NullRALCommandType::SetGraphicsRootConstantBuffer:  return "SetGraphicsRootConstantBuffer";
+    case NullRALCommandType::SetGraphicsRootShaderResource:  return "SetGraphicsRootShaderResource";
+    case NullRALCommandType::SetGraphicsRootUnorderedAccess: return "SetGraphicsRootUnorderedAccess";
+    case NullRALCommandType::Draw:                           return "Draw";
+    case NullRALCommandType::DrawIndexed:                    return "DrawIndexed";
+    case NullRALCommandType::DrawIndirect:                   return "DrawIndirect";
+    case NullRALCommandType::DrawIndexedIndirect:            return "DrawIndexedIndirect";
+    case NullRALCommandType::SetRenderTargets:               return "SetRenderTargets";
+    case NullRALCommandType::ExecuteRenderPass:              return "ExecuteRenderPass";
+    case NullRALCommandType::SetPrimitiveTopology:           return "SetPrimitiveTopology";
+    default:                                                 return "Unknown";
+    }
+}
+
+std::string NullRALDevice::DescribeLastFrame() const
+{
+    std::ostringstream stream;
+    for (size_t listIndex = 0; listIndex < m_lastFrameSubmission.size(); ++listIndex)
+    {
+        const std::vector<NullRALCommand>& commands = m_lastFrameSubmission[listIndex];
+        stream << "CommandList " << listIndex << " (" << commands.size() << " commands)\n";
+
+        for (const NullRALCommand& command : commands)
+        {
+            stream << "  " << GetCommandName(command.type) << " " << command.object;
+            for (uint64_t value : command.values)
+            {
+                stream << " " << value;
+            }
+            stream << "\n";
+        }
+    }
+
+    return stream.str();
+}
@@ -0,0 +1,303 @@
+#ifndef NULL_RAL_DEVICE_H
+#define NULL_RAL_DEVICE_H
+
+#include "IRALDevice.h"
+#include "TRefCountPtr.h"
+#include <vector>
+#include <string>
+#include <utility>
+
+// Null/Recording后端
+// 不依赖任何图形API，所有资源都只在内存中存在，命令列表只把收到的命令按顺序记录下来。
+// 用于在没有D3D12的环境（例如Linux）中验证场景的录制顺序和多线程录制的正确性。
+
+// 记录的命令类型
+enum class NullRALCommandType
+{
+    ResourceBarrier,
+    ClearRenderTarget,
+    ClearDepthStencil,
+    SetViewport,
+    SetScissorRect,
+    SetPipelineState,
+    SetVertexBuffers,
+    SetIndexBuffer,
+    SetGraphicsRootSignature,
+    SetGraphicsRootConstants,
+    SetGraphicsRootDescriptorTable,
+    SetGraphicsRootConstantBuffer,
+    SetGraphicsRootShaderResource,
+    SetGraphicsRootUnorderedAccess,
+    Draw,
+    DrawIndexed,
+    DrawIndirect,
+    DrawIndexedIndirect,
+    SetRenderTargets,
+    ExecuteRenderPass,
+    SetPrimitiveTopology
+};
+
+// 一条记录的命令
+struct NullRALCommand
+{
+    NullRALCommandType type;
+    const void* object;     // 命令引用的主要对象（缓冲区、管线状态、根签名等）
+    uint64_t values[5];     // 命令的整数参数，含义取决于命令类型
+};
+
+// 通用的Null资源：只实现GetNativeResource，构造参数原样转发给接口基类
+template<typename BaseType>
+class TNullRALResource : public BaseType
+{
+public:
+    template<typename... ArgTypes>
+    TNullRALResource(ArgTypes&&... args)
+        : BaseType(std::forward<ArgTypes>(args)...)
+    {
+    }
+
+    virtual void* GetNativeResource() const override
+    {
+        return nullptr;
+    }
+};
+
+// Null常量缓冲区：数据保存在内存中，Map直接返回内存地址
+class NullRALConstBuffer : public IRALConstBuffer
+{
+public:
+    NullRALConstBuffer(uint32_t size)
+        : IRALConstBuffer(size)
+        , m_data(size)
+    {
+    }
+
+    virtual void* GetNativeResource() const override
+    {
+        return nullptr;
+    }
+
+    virtual bool Map(void** ppData) override
+    {
+        *ppData = m_data.data();
+        return true;
+    }
+
+    virtual void Unmap() override
+    {
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+// Null渲染目标视图
+class NullRALRenderTargetView : public IRALRenderTargetView
+{
+public:
+    NullRALRenderTargetView(IRALRenderTarget* renderTarget)
+        : m_renderTarget(renderTarget)
+    {
+    }
+
+    virtual void* GetNativeResource() const override { return nullptr; }
+    virtual IRALRenderTarget* GetRenderTarget() const override { return m_renderTarget.Get(); }
+    virtual void* GetNativeRenderTargetView() const override { return nullptr; }
+
+private:
+    TRefCountPtr<IRALRenderTarget> m_renderTarget;
+};
+
+// Null深度模板视图
+class NullRALDepthStencilView : public IRALDepthStencilView
+{
+public:
+    NullRALDepthStencilView(IRALDepthStencil* depthStencil)
+        : m_depthStencil(depthStencil)
+    {
+    }
+
+    virtual void* GetNativeResource() const override { return nullptr; }
+    virtual IRALDepthStencil* GetDepthStencil() const override { return m_depthStencil.Get(); }
+    virtual void* GetNativeDepthStencilView() const override { return nullptr; }
+
+private:
+    TRefCountPtr<IRALDepthStencil> m_depthStencil;
+};
+
+// Null着色器资源视图
+class NullRALShaderResourceView : public IRALShaderResourceView
+{
+public:
+    NullRALShaderResourceView(IRALResource* resource)
+        : m_resource(resource)
+    {
+    }
+
+    virtual void* GetNativeResource() const override { return nullptr; }
+    virtual IRALResource* GetResource() const override { return m_resource.Get(); }
+    virtual void* GetNativeShaderResourceView() const override { return nullptr; }
+
+private:
+    TRefCountPtr<IRALResource> m_resource;
+};
+
+// 录制用的图形命令列表：按调用顺序记录所有命令
+class NullRALGraphicsCommandList : public IRALGraphicsCommandList
+{
+public:
+    NullRALGraphicsCommandList();
+    virtual ~NullRALGraphicsCommandList() = default;
+
+    // 从IRALCommandList继承的方法
+    virtual void ResourceBarrier(const RALResourceBarrier& barrier) override;
+    virtual void ResourceBarriers(const RALResourceBarrier* barriers, uint32_t count) override;
+    virtual void Close() override;
+    virtual void Reset() override;
+    virtual void* GetNativeCommandList() override;
+
+    // 从IRALGraphicsCommandList继承的方法
+    virtual void ClearRenderTarget(IRALRenderTargetView* renderTargetView, const RALClearValue& clearValue) override;
+    virtual void ClearDepthStencil(IRALDepthStencilView* depthStencilView, const RALClearValue& clearValue) override;
+    virtual void SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth) override;
+    virtual void SetScissorRect(int32_t left, int32_t top, int32_t right, int32_t bottom) override;
+    virtual void SetPipelineState(IRALResource* pipelineState) override;
+    virtual void SetVertexBuffers(uint32_t startSlot, uint32_t count, IRALVertexBuffer** ppVertexBuffers) override;
+    virtual void SetIndexBuffer(IRALIndexBuffer* indexBuffer) override;
+    virtual void SetGraphicsRootSignature(IRALRootSignature* rootSignature) override;
+    virtual void SetGraphicsRootConstant(uint32_t rootParameterIndex, uint32_t shaderRegister, uint32_t value) override;
+    virtual void SetGraphicsRootConstants(uint32_t rootParameterIndex, uint32_t shaderRegister, uint32_t count, const uint32_t* values) override;
+    virtual void SetGraphicsRootDescriptorTable(uint32_t rootParameterIndex, void* descriptorTable) override;
+    virtual void SetGraphicsRootDescriptorTable(uint32_t rootParameterIndex, IRALShaderResourceView* srv) override;
+    virtual void SetGraphicsRootConstantBuffer(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer) override;
+    virtual void SetGraphicsRootShaderResource(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer) override;
+    virtual void SetGraphicsRootUnorderedAccess(uint32_t rootParameterIndex, IRALConstBuffer* constBuffer) override;
+    virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) override;
+    virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
+    virtual void DrawIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride) override;
+    virtual void DrawIndexedIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride) override;
+    virtual void SetRenderTargets(uint32_t renderTargetCount, IRALRenderTargetView** renderTargetViews, IRALDepthStencilView* depthStencilView) override;
+    virtual void ExecuteRenderPass(const void* renderPass, const void* framebuffer) override;
+    virtual void SetPrimitiveTopology(RALPrimitiveTopologyType topology) override;
+
+    // 获取已记录的命令
+    const std::vector<NullRALCommand>& GetCommands() const
+    {
+        return m_commands;
+    }
+
+    // 是否已关闭
+    bool IsClosed() const
+    {
+        return m_closed;
+    }
+
+    // 关闭之后仍然收到的命令数量（正确的录制流程中应该为0）
+    uint32_t GetInvalidCommandCount() const
+    {
+        return m_invalidCommandCount;
+    }
+
+private:
+    // 记录一条命令
+    void Record(NullRALCommandType type, const void* object, uint64_t v0 = 0, uint64_t v1 = 0, uint64_t v2 = 0, uint64_t v3 = 0, uint64_t v4 = 0);
+
+private:
+    std::vector<NullRALCommand> m_commands;
+    bool m_closed;
+    uint32_t m_invalidCommandCount;
+};
+
+// Null设备
+class NullRALDevice : public IRALDevice
+{
+public:
+    NullRALDevice(uint32_t width, uint32_t height);
+    virtual ~NullRALDevice();
+
+    virtual bool Initialize() override;
+    virtual void BeginFrame() override;
+    virtual void EndFrame() override;
+    virtual void Cleanup() override;
+    virtual void Resize(uint32_t width, uint32_t height) override;
+    virtual uint32_t GetWidth() const override { return m_width; }
+    virtual uint32_t GetHeight() const override { return m_height; }
+
+    virtual IRALVertexShader* CompileVertexShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALPixelShader* CompilePixelShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALGeometryShader* CompileGeometryShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALComputeShader* CompileComputeShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALMeshShader* CompileMeshShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALAmplificationShader* CompileAmplificationShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALRayGenShader* CompileRayGenShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALRayMissShader* CompileRayMissShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALRayHitGroupShader* CompileRayHitGroupShader(const char* shaderCode, const char* entryPoint = "main") override;
+    virtual IRALRayCallableShader* CompileRayCallableShader(const char* shaderCode, const char* entryPoint = "main") override;
+
+    virtual IRALGraphicsPipelineState* CreateGraphicsPipelineState(const RALGraphicsPipelineStateDesc& desc, const wchar_t* debugName = nullptr) override;
+    virtual IRALRootSignature* CreateRootSignature(const std::vector<RALRootParameter>& rootParameters,
+        const std::vector<RALStaticSampler>& staticSamplers = {},
+        RALRootSignatureFlags flags = RALRootSignatureFlags::AllowInputAssemblerInputLayout, const wchar_t* debugName = nullptr) override;
+
+    virtual IRALVertexBuffer* CreateVertexBuffer(uint32_t size, uint32_t stride, bool isStatic, const void* initialData = nullptr, const wchar_t* debugName = nullptr) override;
+    virtual IRALIndexBuffer* CreateIndexBuffer(uint32_t count, bool is32BitIndex, bool isStatic, const void* initialData = nullptr, const wchar_t* debugName = nullptr) override;
+    virtual IRALConstBuffer* CreateConstBuffer(uint32_t size, const wchar_t* debugName = nullptr) override;
+    virtual bool UploadBuffer(IRALBuffer* buffer, const char* data, uint64_t size) override;
+
+    virtual IRALGraphicsCommandList* GetGraphicsCommandList() override;
+    virtual bool AcquireParallelGraphicsCommandLists(uint32_t count, IRALGraphicsCommandList** outCommandLists) override;
+
+    virtual IRALRenderTarget* CreateRenderTarget(uint32_t width, uint32_t height, RALDataFormat format, const RALClearValue* clearValue = nullptr, const wchar_t* debugName = nullptr) override;
+    virtual IRALRenderTargetView* CreateRenderTargetView(IRALRenderTarget* renderTarget, const RALRenderTargetViewDesc& desc, const wchar_t* debugName = nullptr) override;
+    virtual IRALDepthStencilView* CreateDepthStencilView(IRALDepthStencil* depthStencil, const RALDepthStencilViewDesc& desc, const wchar_t* debugName = nullptr) override;
+    virtual IRALShaderResourceView* CreateShaderResourceView(IRALResource* resource, const RALShaderResourceViewDesc& desc, const wchar_t* debugName = nullptr) override;
+    virtual IRALDepthStencil* CreateDepthStencil(uint32_t width, uint32_t height, RALDataFormat format, const RALClearValue* clearValue = nullptr, const wchar_t* debugName = nullptr) override;
+
+    virtual IRALRenderTargetView* GetBackBufferRTV() override;
+    virtual IRALDepthStencilView* GetBackBufferDSV() override;
+
+    // 上一帧按提交顺序排列的命令列表内容（每个元素对应一个命令列表）
+    const std::vector<std::vector<NullRALCommand>>& GetLastFrameSubmission() const
+    {
+        return m_lastFrameSubmission;
+    }
+
+    // 上一帧录制中出现的错误数量（关闭后继续录制、重复提交等）
+    uint32_t GetLastFrameErrorCount() const
+    {
+        return m_lastFrameErrorCount;
+    }
+
+    // 把上一帧提交的命令按顺序格式化为文本，便于比较串行录制和并行录制的结果
+    std::string DescribeLastFrame() const;
+
+    // 获取命令类型的名称
+    static const char* GetCommandName(NullRALCommandType type);
+
+private:
+    // 从命令列表池中取出一个已重置的命令列表
+    NullRALGraphicsCommandList* AcquirePooledCommandList();
+
+    // 为新开始录制的命令列表设置帧默认状态
+    void SetupFrameDefaultState(IRALGraphicsCommandList* commandList);
+
+private:
+    uint32_t m_width;
+    uint32_t m_height;
+
+    TRefCountPtr<NullRALGraphicsCommandList> m_graphicsCommandList;         // 每帧的第一个主命令列表
+    TRefCountPtr<NullRALGraphicsCommandList> m_currentGraphicsCommandList;  // 当前录制中的主命令列表
+    std::vector<TRefCountPtr<NullRALGraphicsCommandList>> m_commandListPool;
+    uint32_t m_commandListPoolUsed;
+    std::vector<NullRALGraphicsCommandList*> m_frameCommandLists;           // 本帧按提交顺序排列的命令列表
+
+    std::vector<std::vector<NullRALCommand>> m_lastFrameSubmission;
+    uint32_t m_lastFrameErrorCount;
+
+    TRefCountPtr<IRALRenderTarget> m_backBuffer;
+    TRefCountPtr<IRALDepthStencil> m_backBufferDepth;
+    TRefCountPtr<IRALRenderTargetView> m_backBufferRTV;
+    TRefCountPtr<IRALDepthStencilView> m_backBufferDSV;
+};
+
+#endif // NULL_RAL_DEVICE_H
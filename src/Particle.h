@@ -22,6 +22,7 @@ public:
         , mass(m)
         , inverseMass(1.0f / m)
         , isStatic(isStatic)
+        , isSleeping(false)
     {
         if (isStatic)
         {
@@ -64,6 +65,7 @@ public:
     float mass;                         // 质量
     float inverseMass;                  // 质量的倒数（用于加速度计算）
     bool isStatic;                      // 是否为固定粒子
+    bool isSleeping;                    // 是否处于休眠状态（休眠时与固定粒子一样不参与积分和约束修正）
 #ifdef DEBUG_SOLVER
     int coordW;
     int coordH;
@@ -0,0 +1,170 @@
+#include "ParticleReordering.h"
+#include <algorithm>
+
+void ParticleReordering::ComputeMortonOrder(const std::vector<dx::XMFLOAT3>& positions, std::vector<uint32_t>& order)
+{
+    const uint32_t particleCount = (uint32_t)positions.size();
+    order.resize(particleCount);
+
+    if (particleCount == 0)
+    {
+        return;
+    }
+
+    dx::XMVECTOR boundsMin = dx::XMLoadFloat3(&positions[0]);
+    dx::XMVECTOR boundsMax = boundsMin;
+    for (const dx::XMFLOAT3& position : positions)
+    {
+        dx::XMVECTOR p = dx::XMLoadFloat3(&position);
+        boundsMin = dx::XMVectorMin(boundsMin, p);
+        boundsMax = dx::XMVectorMax(boundsMax, p);
+    }
+
+    dx::XMFLOAT3 origin;
+    dx::XMFLOAT3 extent;
+    dx::XMStoreFloat3(&origin, boundsMin);
+    dx::XMStoreFloat3(&extent, dx::XMVectorSubtract(boundsMax, boundsMin));
+
+    // 每个方向分别量化到[0, 1023]，平面布料在法线方向上的范围为0，该方向量化为0
+    const float scaleX = extent.x > 0.0f ? 1023.0f / extent.x : 0.0f;
+    const float scaleY = extent.y > 0.0f ? 1023.0f / extent.y : 0.0f;
+    const float scaleZ = extent.z > 0.0f ? 1023.0f / extent.z : 0.0f;
+
+    std::vector<uint32_t> codes(particleCount);
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        uint32_t x = (uint32_t)((positions[i].x - origin.x) * scaleX + 0.5f);
+        uint32_t y = (uint32_t)((positions[i].y - origin.y) * scaleY + 0.5f);
+        uint32_t z = (uint32_t)((positions[i].z - origin.z) * scaleZ + 0.5f);
+
+        codes[i] = SpreadBits((std::min)(x, 1023u)) | (SpreadBits((std::min)(y, 1023u)) << 1) | (SpreadBits((std::min)(z, 1023u)) << 2);
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&codes](uint32_t a, uint32_t b)
+    {
+        return codes[a] < codes[b];
+    });
+}
+
+void ParticleReordering::ComputeReverseCuthillMcKeeOrder(uint32_t particleCount, const std::vector<uint32_t>& adjacencyOffsets,
+    const std::vector<uint32_t>& adjacency, std::vector<uint32_t>& order)
+{
+    order.clear();
+    order.reserve(particleCount);
+
+    std::vector<uint8_t> visited(particleCount, 0);
+    std::vector<uint32_t> component;
+
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        if (visited[i])
+        {
+            continue;
+        }
+
+        // 先遍历一次找到离i最远的粒子作为近似的外围粒子，再从它开始正式遍历
+        component.clear();
+        uint32_t peripheral = BreadthFirst(i, adjacencyOffsets, adjacency, visited, component);
+        for (uint32_t particle : component)
+        {
+            visited[particle] = 0;
+        }
+
+        BreadthFirst(peripheral, adjacencyOffsets, adjacency, visited, order);
+    }
+
+    std::reverse(order.begin(), order.end());
+}
+
+void ParticleReordering::BuildAdjacency(uint32_t particleCount, const std::vector<uint32_t>& edges,
+    std::vector<uint32_t>& adjacencyOffsets, std::vector<uint32_t>& adjacency)
+{
+    adjacencyOffsets.assign(particleCount + 1, 0);
+    for (size_t e = 0; e + 1 < edges.size(); e += 2)
+    {
+        adjacencyOffsets[edges[e] + 1]++;
+        adjacencyOffsets[edges[e + 1] + 1]++;
+    }
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+
+    std::vector<uint32_t> neighbors(adjacencyOffsets[particleCount]);
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t e = 0; e + 1 < edges.size(); e += 2)
+    {
+        neighbors[fill[edges[e]]++] = edges[e + 1];
+        neighbors[fill[edges[e + 1]]++] = edges[e];
+    }
+
+    // 多个约束可能连接同一对粒子，排序后去重并压缩
+    adjacency.clear();
+    adjacency.reserve(neighbors.size());
+
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        uint32_t end = adjacencyOffsets[i + 1];
+        std::sort(neighbors.begin() + begin, neighbors.begin() + end);
+
+        adjacencyOffsets[i] = (uint32_t)adjacency.size();
+        for (uint32_t k = begin; k < end; ++k)
+        {
+            if (neighbors[k] != i && (k == begin || neighbors[k] != neighbors[k - 1]))
+            {
+                adjacency.push_back(neighbors[k]);
+            }
+        }
+
+        begin = end;
+    }
+    adjacencyOffsets[particleCount] = (uint32_t)adjacency.size();
+}
+
+uint32_t ParticleReordering::BreadthFirst(uint32_t start, const std::vector<uint32_t>& adjacencyOffsets,
+    const std::vector<uint32_t>& adjacency, std::vector<uint8_t>& visited, std::vector<uint32_t>& order)
+{
+    size_t head = order.size();
+    order.push_back(start);
+    visited[start] = 1;
+
+    std::vector<uint32_t> neighbors;
+
+    while (head < order.size())
+    {
+        uint32_t particle = order[head++];
+
+        neighbors.clear();
+        for (uint32_t k = adjacencyOffsets[particle]; k < adjacencyOffsets[particle + 1]; ++k)
+        {
+            uint32_t neighbor = adjacency[k];
+            if (!visited[neighbor])
+            {
+                visited[neighbor] = 1;
+                neighbors.push_back(neighbor);
+            }
+        }
+
+        // 度数小的相邻粒子先访问
+        std::stable_sort(neighbors.begin(), neighbors.end(), [&adjacencyOffsets](uint32_t a, uint32_t b)
+        {
+            return adjacencyOffsets[a + 1] - adjacencyOffsets[a] < adjacencyOffsets[b + 1] - adjacencyOffsets[b];
+        });
+
+        order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+
+    return order.back();
+}
+
+uint32_t ParticleReordering::SpreadBits(uint32_t value)
+{
+    value &= 0x000003ff;
+    value = (value | (value << 16)) & 0x030000ff;
+    value = (value | (value << 8)) & 0x0300f00f;
+    value = (value | (value << 4)) & 0x030c30c3;
+    value = (value | (value << 2)) & 0x09249249;
+    return value;
+}
@@ -0,0 +1,53 @@
+#ifndef PARTICLE_REORDERING_H
+#define PARTICLE_REORDERING_H
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 粒子重排序：计算使相邻粒子在内存中也相邻的粒子顺序
+// 所有函数输出的order[k]为新顺序中第k个粒子的原编号
+class ParticleReordering
+{
+public:
+    // 按Morton码（Z曲线）排序
+    // 位置在包围盒内每个方向量化为10位后交错成30位的Morton码，Morton码相同时保持原顺序，
+    // 空间上相近的粒子在Z曲线上也相近，不依赖约束的拓扑
+    // 参数：
+    //   positions - 粒子位置
+    //   order - 输出新顺序
+    static void ComputeMortonOrder(const std::vector<dx::XMFLOAT3>& positions, std::vector<uint32_t>& order);
+
+    // 按约束图做reverse Cuthill-McKee排序，减小约束图邻接矩阵的带宽
+    // 每个连通分量从近似的外围粒子开始广度优先遍历，相邻粒子按度数从小到大访问，最后整体反转
+    // 参数：
+    //   particleCount - 粒子数
+    //   adjacencyOffsets - 邻接表的起始位置，粒子i的相邻粒子为adjacency[adjacencyOffsets[i], adjacencyOffsets[i + 1])
+    //   adjacency - 邻接表
+    //   order - 输出新顺序
+    static void ComputeReverseCuthillMcKeeOrder(uint32_t particleCount, const std::vector<uint32_t>& adjacencyOffsets,
+        const std::vector<uint32_t>& adjacency, std::vector<uint32_t>& order);
+
+    // 由粒子对（约束图的边）建立去重的邻接表
+    // 参数：
+    //   particleCount - 粒子数
+    //   edges - 粒子对，每2个为一条边
+    //   adjacencyOffsets - 输出邻接表的起始位置
+    //   adjacency - 输出邻接表，每个粒子的相邻粒子按编号排序
+    static void BuildAdjacency(uint32_t particleCount, const std::vector<uint32_t>& edges,
+        std::vector<uint32_t>& adjacencyOffsets, std::vector<uint32_t>& adjacency);
+
+private:
+    // 从start开始广度优先遍历所在的连通分量中未访问的粒子，按访问顺序追加到order并标记为已访问
+    // 返回：最后访问的粒子（离start最远的粒子之一）
+    static uint32_t BreadthFirst(uint32_t start, const std::vector<uint32_t>& adjacencyOffsets,
+        const std::vector<uint32_t>& adjacency, std::vector<uint8_t>& visited, std::vector<uint32_t>& order);
+
+    // 把10位整数的每一位之间插入两个0
+    static uint32_t SpreadBits(uint32_t value);
+};
+
+#endif // PARTICLE_REORDERING_H
@@ -1,9 +1,23 @@
 #include "Primitive.h"
+#include "TaskScheduler.h"
 #include <DirectXMath.h>
 
 // 为了方便使用，定义一个简化的命名空间别名
 namespace dx = DirectX;
 
+void Primitive::UpdateBatch(const std::vector<Primitive*>& primitives, float deltaTime)
+{
+    // 每个对象是一个块，空闲的工作线程动态领取下一个对象
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)primitives.size(), 1, [&primitives, deltaTime](uint32_t begin, uint32_t end)
+    {
+        SerialTaskScope serialScope;
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            primitives[index]->Update(nullptr, deltaTime);
+        }
+    });
+}
+
 void Primitive::SetPosition(const dx::XMFLOAT3& position)
 {
     this->position = position;
@@ -15,6 +15,7 @@ class IRALGraphicsCommandList;
 class IRALVertexBuffer;
 class IRALIndexBuffer;
 class IRALConstBuffer;
+class Cloth;
 
 struct PrimitiveMesh
 {
@@ -31,6 +32,28 @@ public:
     // 纯虚函数，更新对象状态
     virtual void Update(IRALGraphicsCommandList* commandList, float deltaTime) = 0;
 
+    // 是否可以批量更新
+    // 返回true时场景把这类Primitive分配到所有工作线程上同时更新，每个对象在一个线程上单线程更新，
+    // 适合数量多、单个更新开销小的对象（例如大量小块布料）；
+    // 批量更新时Update的commandList为nullptr，且不能访问其他Primitive的状态
+    virtual bool IsBatchUpdateSupported() const
+    {
+        return false;
+    }
+
+    // 批量更新一组Primitive：对象之间并行，对象内部的并行循环在SerialTaskScope中顺序执行
+    // 每个对象的结果与单独更新时逐位一致
+    // 参数：
+    //   primitives - 要更新的对象
+    //   deltaTime - 时间步长
+    static void UpdateBatch(const std::vector<Primitive*>& primitives, float deltaTime);
+
+    // 转换为布料，不是布料时返回nullptr（场景用于把小块布料交给打包求解器）
+    virtual Cloth* AsCloth()
+    {
+        return nullptr;
+    }
+
     // 获取对象的世界变换矩阵
     const dx::XMMATRIX& GetWorldMatrix() const
     {
@@ -88,6 +111,15 @@ public:
 
     }
 
+    // 共享Mesh的键值
+    // 返回0表示该Primitive拥有独立的（可能是动态的）Mesh；
+    // 返回非0值时，键值相同的Primitive共用同一份顶点/索引缓冲区，并可以合批为实例化绘制。
+    // 共享的Mesh必须是静态的，场景不会对其调用OnUpdateMesh。
+    virtual uint64_t GetSharedMeshKey() const
+    {
+        return 0;
+    }
+
     void SetDiffuseColor(const dx::XMFLOAT3& color)
     {
         diffuseColor = color;
@@ -0,0 +1,643 @@
+#include "ProjectiveDynamicsSolver.h"
+#include "Cloth.h"
+#include "TaskScheduler.h"
+#include "ClothCheckpoint.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+extern void logDebug(const std::string& message);
+
+// 粒子阶段每个任务处理的粒子数
+static const uint32_t kParticleGrainSize = 1024;
+
+// 局部步每个任务处理的约束数
+static const uint32_t kConstraintGrainSize = 256;
+
+// 约束权重（1/柔度）的上限，柔度为0或极小时避免矩阵病态
+static const double kMaxConstraintWeight = 1e9;
+
+// 子步时间步长的相对变化超过这个比例时重新分解
+static const float kRefactorDeltaTimeTolerance = 0.05f;
+
+// Chebyshev加速：前几次迭代不外推
+static const uint32_t kChebyshevDelay = 2;
+
+// 未指定谱半径时使用的默认值，以及谱半径上限
+static const float kDefaultSpectralRadius = 0.9f;
+static const float kMaxSpectralRadius = 0.99f;
+
+namespace
+{
+    // 每个任务块的残差累积，块之间按固定顺序合并，结果与线程数无关
+    struct ChunkResidual
+    {
+        float maxError;
+        double sumSquares;
+    };
+}
+
+bool ProjectiveDynamicsSolver::Build()
+{
+    m_valid = false;
+    m_factorDeltaTime = 0.0f;
+    m_constraintsDirty = false;
+
+    const std::vector<Particle>& particles = m_cloth->m_particles;
+    const std::vector<DistanceConstraint>& constraints = m_cloth->m_distanceConstraints;
+    const Particle* particlesBegin = particles.data();
+    const uint32_t particleCount = (uint32_t)particles.size();
+    const uint32_t constraintCount = (uint32_t)constraints.size();
+
+    if ((!m_cloth->m_dihedralBendingConstraints.empty() || !m_cloth->m_isometricBendingConstraints.empty()) && !m_bendingWarningLogged)
+    {
+        logDebug("ProjectiveDynamicsSolver: dihedral and isometric bending constraints are not supported and will be ignored");
+        m_bendingWarningLogged = true;
+    }
+
+    // 1. 固定粒子作为边界条件消去，只有可移动粒子是未知量
+    m_particleUnknowns.assign(particleCount, UINT32_MAX);
+    m_unknownParticles.clear();
+
+    for (uint32_t p = 0; p < particleCount; ++p)
+    {
+        if (!particles[p].isStatic)
+        {
+            m_particleUnknowns[p] = (uint32_t)m_unknownParticles.size();
+            m_unknownParticles.push_back(p);
+        }
+    }
+
+    const uint32_t unknownCount = (uint32_t)m_unknownParticles.size();
+    if (unknownCount == 0)
+    {
+        return false;
+    }
+
+    // 2. 每个未知量关联的距离约束，以及两端都可移动的约束（矩阵的非对角项）
+    std::vector<uint32_t> constraintParticles(constraintCount * 2);
+    m_incidenceOffsets.assign(unknownCount + 1, 0);
+    m_offDiagonalConstraints.clear();
+
+    for (uint32_t c = 0; c < constraintCount; ++c)
+    {
+        const Particle** constraintParticlePointers = constraints[c].GetParticles();
+
+        for (uint32_t k = 0; k < 2; ++k)
+        {
+            uint32_t particle = (uint32_t)(constraintParticlePointers[k] - particlesBegin);
+            if (particle >= particleCount)
+            {
+                logDebug("ProjectiveDynamicsSolver::Build: constraint references a particle outside the cloth");
+                return false;
+            }
+
+            constraintParticles[c * 2 + k] = particle;
+            if (m_particleUnknowns[particle] != UINT32_MAX)
+            {
+                m_incidenceOffsets[m_particleUnknowns[particle] + 1]++;
+            }
+        }
+
+        if (m_particleUnknowns[constraintParticles[c * 2]] != UINT32_MAX && m_particleUnknowns[constraintParticles[c * 2 + 1]] != UINT32_MAX)
+        {
+            m_offDiagonalConstraints.push_back(c);
+        }
+    }
+
+    for (uint32_t u = 0; u < unknownCount; ++u)
+    {
+        m_incidenceOffsets[u + 1] += m_incidenceOffsets[u];
+    }
+
+    m_incidences.resize(m_incidenceOffsets[unknownCount]);
+    std::vector<uint32_t> fill(m_incidenceOffsets.begin(), m_incidenceOffsets.end() - 1);
+
+    for (uint32_t c = 0; c < constraintCount; ++c)
+    {
+        for (uint32_t k = 0; k < 2; ++k)
+        {
+            uint32_t unknown = m_particleUnknowns[constraintParticles[c * 2 + k]];
+            if (unknown == UINT32_MAX)
+            {
+                continue;
+            }
+
+            uint32_t other = constraintParticles[c * 2 + (1 - k)];
+            m_incidences[fill[unknown]++] = { c, other, k == 0 ? 1.0f : -1.0f, m_particleUnknowns[other] == UINT32_MAX };
+        }
+    }
+
+    // 3. 矩阵非零结构和粒子图
+    const size_t entryCount = unknownCount + m_offDiagonalConstraints.size();
+    std::vector<uint32_t> entryRows(entryCount);
+    std::vector<uint32_t> entryColumns(entryCount);
+    std::vector<uint32_t> adjacencyOffsets(unknownCount + 1, 0);
+
+    for (uint32_t u = 0; u < unknownCount; ++u)
+    {
+        entryRows[u] = u;
+        entryColumns[u] = u;
+    }
+
+    for (size_t e = 0; e < m_offDiagonalConstraints.size(); ++e)
+    {
+        uint32_t c = m_offDiagonalConstraints[e];
+        uint32_t unknown1 = m_particleUnknowns[constraintParticles[c * 2]];
+        uint32_t unknown2 = m_particleUnknowns[constraintParticles[c * 2 + 1]];
+
+        entryRows[unknownCount + e] = unknown1;
+        entryColumns[unknownCount + e] = unknown2;
+        adjacencyOffsets[unknown1 + 1]++;
+        adjacencyOffsets[unknown2 + 1]++;
+    }
+
+    for (uint32_t u = 0; u < unknownCount; ++u)
+    {
+        adjacencyOffsets[u + 1] += adjacencyOffsets[u];
+    }
+
+    std::vector<uint32_t> adjacency(adjacencyOffsets[unknownCount]);
+    std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+    for (size_t e = 0; e < m_offDiagonalConstraints.size(); ++e)
+    {
+        uint32_t unknown1 = entryRows[unknownCount + e];
+        uint32_t unknown2 = entryColumns[unknownCount + e];
+
+        adjacency[adjacencyFill[unknown1]++] = unknown2;
+        adjacency[adjacencyFill[unknown2]++] = unknown1;
+    }
+
+    // 4. 按粒子的布局坐标（规则网格为网格坐标）做嵌套剖分重排序，然后符号分析
+    std::vector<dx::XMFLOAT2> particleCoordinates;
+    m_cloth->GetParticleLayoutCoordinates(particleCoordinates);
+
+    std::vector<dx::XMFLOAT2> coordinates(unknownCount);
+    for (uint32_t u = 0; u < unknownCount; ++u)
+    {
+        coordinates[u] = particleCoordinates[m_unknownParticles[u]];
+    }
+
+    std::vector<uint32_t> permutation;
+    SparseCholesky::ComputeNestedDissectionOrder(unknownCount, adjacencyOffsets, adjacency, coordinates, permutation);
+
+    if (!m_cholesky.Analyze(unknownCount, entryRows, entryColumns, permutation))
+    {
+        return false;
+    }
+
+    m_constraintWeights.resize(constraintCount);
+    for (uint32_t c = 0; c < constraintCount; ++c)
+    {
+        double compliance = (double)constraints[c].GetCompliance();
+        m_constraintWeights[c] = (float)(compliance > 1.0 / kMaxConstraintWeight ? 1.0 / compliance : kMaxConstraintWeight);
+    }
+
+    m_projections.resize(constraintCount);
+    m_entryValues.resize(entryCount);
+    for (std::vector<double>& rhs : m_rhs)
+    {
+        rhs.resize(unknownCount);
+    }
+    m_previousPositions.resize(unknownCount);
+
+    m_valid = true;
+
+    logDebug("ProjectiveDynamicsSolver: " + std::to_string(unknownCount) + " unknowns, " + std::to_string(constraintCount)
+        + " constraints, factor non-zeros " + std::to_string(m_cholesky.GetFactorNonZeroCount()));
+
+    return true;
+}
+
+bool ProjectiveDynamicsSolver::Factorize(float deltaTime)
+{
+    const std::vector<Particle>& particles = m_cloth->m_particles;
+    const uint32_t unknownCount = (uint32_t)m_unknownParticles.size();
+    const double inverseDeltaTimeSquared = 1.0 / ((double)deltaTime * (double)deltaTime);
+
+    // 对角项：M/h^2 + 关联约束的权重之和（连接固定粒子的约束也计入对角项）
+    for (uint32_t u = 0; u < unknownCount; ++u)
+    {
+        double diagonal = (double)particles[m_unknownParticles[u]].mass * inverseDeltaTimeSquared;
+
+        for (uint32_t i = m_incidenceOffsets[u]; i < m_incidenceOffsets[u + 1]; ++i)
+        {
+            diagonal += m_constraintWeights[m_incidences[i].constraint];
+        }
+
+        m_entryValues[u] = diagonal;
+    }
+
+    // 非对角项：-w
+    for (size_t e = 0; e < m_offDiagonalConstraints.size(); ++e)
+    {
+        m_entryValues[unknownCount + e] = -(double)m_constraintWeights[m_offDiagonalConstraints[e]];
+    }
+
+    if (!m_cholesky.Factorize(m_entryValues))
+    {
+        m_valid = false;
+        return false;
+    }
+
+    m_factorDeltaTime = deltaTime;
+    return true;
+}
+
+void ProjectiveDynamicsSolver::Step(float deltaTime)
+{
+    Cloth* cloth = m_cloth;
+    ClothSolverPhaseTimes& phaseTimes = m_stats.phaseTimes;
+    memset(&phaseTimes, 0, sizeof(phaseTimes));
+    auto setupStart = std::chrono::steady_clock::now();
+
+    // 约束或粒子数量变化时重新建立全局矩阵
+    if (m_constraintsDirty
+        || m_particleUnknowns.size() != cloth->m_particles.size()
+        || m_projections.size() != cloth->m_distanceConstraints.size())
+    {
+        Build();
+    }
+
+    if (!m_valid)
+    {
+        return;
+    }
+
+    const uint32_t subStepCount = (std::max)(cloth->m_subIteratorCount, 1u);
+    const uint32_t iterationCount = (std::max)(cloth->m_iteratorCount, 1u);
+    const float subDeltaTime = deltaTime / subStepCount;
+
+    // 分解只依赖子步时间步长，帧时间稳定时不需要重新分解
+    if (std::abs(subDeltaTime - m_factorDeltaTime) > kRefactorDeltaTimeTolerance * subDeltaTime)
+    {
+        if (!Factorize(subDeltaTime))
+        {
+            return;
+        }
+    }
+
+    phaseTimes.setup = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+    // 全局步使用分解时的时间步长，保持与矩阵一致
+    const float solveDeltaTime = m_factorDeltaTime;
+
+    std::vector<Particle>& particles = cloth->m_particles;
+    {
+        ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+        TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                particles[i].positionInitial = particles[i].position;
+            }
+        });
+    }
+
+    const float spectralRadius = (std::min)(cloth->m_chebyshevSpectralRadius > 0.0f ? cloth->m_chebyshevSpectralRadius : kDefaultSpectralRadius,
+        kMaxSpectralRadius);
+
+    for (uint32_t subStep = 0; subStep < subStepCount; ++subStep)
+    {
+        {
+            ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+            PredictPositions(subDeltaTime);
+        }
+
+        float omega = 1.0f;
+        for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+        {
+            if (cloth->m_chebyshevAcceleration && iteration >= kChebyshevDelay)
+            {
+                omega = iteration == kChebyshevDelay
+                    ? 2.0f / (2.0f - spectralRadius * spectralRadius)
+                    : 4.0f / (4.0f - spectralRadius * spectralRadius * omega);
+            }
+
+            {
+                ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+                ProjectDistanceConstraints();
+            }
+
+            {
+                ScopedSolverPhaseTimer timer(phaseTimes.globalSolve);
+                SolveGlobal(solveDeltaTime, omega);
+            }
+
+            ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+            ProjectInequalityConstraints();
+        }
+
+        ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+        UpdateVelocities(subDeltaTime);
+    }
+
+    {
+        ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+        EndStep(deltaTime);
+    }
+
+    {
+        ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+        UpdateTotalResidual();
+    }
+    m_stats.iterationCount = subStepCount * iterationCount;
+    m_stats.iterationBudget = subStepCount * iterationCount;
+    m_stats.converged = false;
+    m_stats.sleepingParticleCount = 0;
+}
+
+void ProjectiveDynamicsSolver::PredictPositions(float deltaTime)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const dx::XMFLOAT3 gravity = m_cloth->m_gravity;
+
+    // 与XPBD求解器使用相同的预测公式，两个求解器的结果可以直接比较
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, &gravity, deltaTime](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+
+            if (!particle.isStatic)
+            {
+                particle.oldPosition = particle.position;
+                particle.ApplyForce(gravity);
+
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR vel = dx::XMLoadFloat3(&particle.velocity);
+                dx::XMVECTOR force = dx::XMLoadFloat3(&particle.force);
+
+                pos = dx::XMVectorAdd(pos, dx::XMVectorScale(vel, deltaTime));
+                pos = dx::XMVectorAdd(pos, dx::XMVectorScale(dx::XMVectorScale(force, particle.inverseMass), 0.5f * deltaTime * deltaTime));
+
+                dx::XMStoreFloat3(&particle.predPosition, pos);
+                dx::XMStoreFloat3(&particle.position, pos);
+            }
+        }
+    });
+
+    // Chebyshev加速的迭代历史从预测位置开始
+    const uint32_t unknownCount = (uint32_t)m_unknownParticles.size();
+    for (uint32_t u = 0; u < unknownCount; ++u)
+    {
+        m_previousPositions[u] = particles[m_unknownParticles[u]].position;
+    }
+}
+
+void ProjectiveDynamicsSolver::ProjectDistanceConstraints()
+{
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    ScratchArena& arena = scheduler.GetScratchArena();
+    ScratchArenaScope arenaScope(arena);
+
+    const std::vector<DistanceConstraint>& constraints = m_cloth->m_distanceConstraints;
+    const uint32_t constraintCount = (uint32_t)constraints.size();
+    dx::XMFLOAT3* projections = m_projections.data();
+
+    // 每个块写入自己的残差槽位，避免线程间竞争
+    const size_t chunkCount = ((size_t)constraintCount + kConstraintGrainSize - 1) / kConstraintGrainSize;
+    ChunkResidual* chunkResiduals = arena.AllocateArray<ChunkResidual>(chunkCount);
+
+    scheduler.ParallelFor(0, constraintCount, kConstraintGrainSize, [&constraints, projections, chunkResiduals](uint32_t begin, uint32_t end)
+    {
+        float chunkMaxError = 0.0f;
+        double chunkSumSquares = 0.0;
+
+        for (uint32_t c = begin; c < end; ++c)
+        {
+            const Particle** particles = constraints[c].GetParticles();
+            dx::XMVECTOR diff = dx::XMVectorSubtract(dx::XMLoadFloat3(&particles[0]->position), dx::XMLoadFloat3(&particles[1]->position));
+            float distance = dx::XMVectorGetX(dx::XMVector3Length(diff));
+            float restLength = constraints[c].GetRestLength();
+
+            float error = std::abs(distance - restLength);
+            chunkMaxError = (std::max)(chunkMaxError, error);
+            chunkSumSquares += (double)error * error;
+
+            // 两个粒子重合时方向不确定，保持当前的边
+            if (distance > 1e-9f)
+            {
+                diff = dx::XMVectorScale(diff, restLength / distance);
+            }
+
+            dx::XMStoreFloat3(&projections[c], diff);
+        }
+
+        ChunkResidual& chunkResidual = chunkResiduals[begin / kConstraintGrainSize];
+        chunkResidual.maxError = chunkMaxError;
+        chunkResidual.sumSquares = chunkSumSquares;
+    });
+
+    float maxError = 0.0f;
+    double sumSquares = 0.0;
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        maxError = (std::max)(maxError, chunkResiduals[chunk].maxError);
+        sumSquares += chunkResiduals[chunk].sumSquares;
+    }
+
+    m_stats.distance.constraintCount = constraintCount;
+    m_stats.distance.maxError = maxError;
+    m_stats.distance.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+}
+
+void ProjectiveDynamicsSolver::SolveGlobal(float deltaTime, float omega)
+{
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const uint32_t unknownCount = (uint32_t)m_unknownParticles.size();
+    const double inverseDeltaTimeSquared = 1.0 / ((double)deltaTime * (double)deltaTime);
+
+    // 1. 右端项：M/h^2 * s + Σ w * (±p + 固定端的位置)
+    scheduler.ParallelFor(0, unknownCount, kParticleGrainSize, [this, &particles, inverseDeltaTimeSquared](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t u = begin; u < end; ++u)
+        {
+            const Particle& particle = particles[m_unknownParticles[u]];
+            double inertia = (double)particle.mass * inverseDeltaTimeSquared;
+            double b[3] = { inertia * particle.predPosition.x, inertia * particle.predPosition.y, inertia * particle.predPosition.z };
+
+            for (uint32_t i = m_incidenceOffsets[u]; i < m_incidenceOffsets[u + 1]; ++i)
+            {
+                const Incidence& incidence = m_incidences[i];
+                const dx::XMFLOAT3& projection = m_projections[incidence.constraint];
+                double weight = m_constraintWeights[incidence.constraint];
+
+                double target[3] = { incidence.sign * projection.x, incidence.sign * projection.y, incidence.sign * projection.z };
+                if (incidence.otherStatic)
+                {
+                    const dx::XMFLOAT3& other = particles[incidence.other].position;
+                    target[0] += other.x;
+                    target[1] += other.y;
+                    target[2] += other.z;
+                }
+
+                b[0] += weight * target[0];
+                b[1] += weight * target[1];
+                b[2] += weight * target[2];
+            }
+
+            m_rhs[0][u] = b[0];
+            m_rhs[1][u] = b[1];
+            m_rhs[2][u] = b[2];
+        }
+    });
+
+    // 2. 三个分量共用同一个分解，互相独立
+    scheduler.ParallelFor(0, 3, 1, [this](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t axis = begin; axis < end; ++axis)
+        {
+            m_cholesky.Solve(m_rhs[axis]);
+        }
+    });
+
+    // 3. 写回位置，需要时做Chebyshev外推：x = ω * (x̂ - x_prev) + x_prev
+    scheduler.ParallelFor(0, unknownCount, kParticleGrainSize, [this, &particles, omega](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t u = begin; u < end; ++u)
+        {
+            Particle& particle = particles[m_unknownParticles[u]];
+            dx::XMVECTOR solved = dx::XMVectorSet((float)m_rhs[0][u], (float)m_rhs[1][u], (float)m_rhs[2][u], 0.0f);
+            dx::XMVECTOR current = dx::XMLoadFloat3(&particle.position);
+
+            if (omega != 1.0f)
+            {
+                dx::XMVECTOR previous = dx::XMLoadFloat3(&m_previousPositions[u]);
+                solved = dx::XMVectorAdd(previous, dx::XMVectorScale(dx::XMVectorSubtract(solved, previous), omega));
+            }
+
+            dx::XMStoreFloat3(&m_previousPositions[u], current);
+            dx::XMStoreFloat3(&particle.position, solved);
+        }
+    });
+}
+
+void ProjectiveDynamicsSolver::ProjectInequalityConstraints()
+{
+    Cloth* cloth = m_cloth;
+
+    // 单粒子约束：违反时沿梯度方向移动|C|，相当于柔度为0的XPBD投影
+    auto project = [](Constraint* constraint, float& maxError, double& sumSquares)
+    {
+        dx::XMFLOAT3 gradient;
+        float C = constraint->ComputeConstraintAndGradient(&gradient);
+
+        float error = std::abs(C);
+        maxError = (std::max)(maxError, error);
+        sumSquares += (double)error * error;
+
+        if (C != 0.0f)
+        {
+            Particle* particle = constraint->GetParticles()[0];
+            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle->position);
+            pos = dx::XMVectorSubtract(pos, dx::XMVectorScale(dx::XMLoadFloat3(&gradient), C));
+            dx::XMStoreFloat3(&particle->position, pos);
+        }
+    };
+
+    // 同一个粒子可能有多个LRA约束，串行投影
+    float maxError = 0.0f;
+    double sumSquares = 0.0;
+    for (LRAConstraint& constraint : cloth->m_lraConstraints)
+    {
+        project(&constraint, maxError, sumSquares);
+    }
+
+    uint32_t constraintCount = (uint32_t)cloth->m_lraConstraints.size();
+    m_stats.lra.constraintCount = constraintCount;
+    m_stats.lra.maxError = maxError;
+    m_stats.lra.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+
+    maxError = 0.0f;
+    sumSquares = 0.0;
+    for (SphereCollisionConstraint& constraint : cloth->m_CollisionConstraints)
+    {
+        project(&constraint, maxError, sumSquares);
+    }
+
+    constraintCount = (uint32_t)cloth->m_CollisionConstraints.size();
+    m_stats.collision.constraintCount = constraintCount;
+    m_stats.collision.maxError = maxError;
+    m_stats.collision.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+}
+
+void ProjectiveDynamicsSolver::UpdateVelocities(float deltaTime)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, deltaTime](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+
+            if (!particle.isStatic)
+            {
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR oldPos = dx::XMLoadFloat3(&particle.oldPosition);
+                dx::XMStoreFloat3(&particle.velocity, dx::XMVectorScale(dx::XMVectorSubtract(pos, oldPos), 1.0f / deltaTime));
+
+                particle.ResetForce();
+            }
+        }
+    });
+}
+
+void ProjectiveDynamicsSolver::EndStep(float deltaTime)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+
+    // 与XPBD求解器相同的速度阻尼
+    const float dampingScale = (std::max)(0.0f, 1.0f - m_cloth->m_velocityDamping * deltaTime);
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, deltaTime, dampingScale](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+
+            if (!particle.isStatic)
+            {
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR posInitial = dx::XMLoadFloat3(&particle.positionInitial);
+                dx::XMStoreFloat3(&particle.velocity, dx::XMVectorScale(dx::XMVectorSubtract(pos, posInitial), dampingScale / deltaTime));
+            }
+        }
+    });
+}
+
+void ProjectiveDynamicsSolver::UpdateTotalResidual()
+{
+    const ClothConstraintResidual* residuals[] = { &m_stats.distance, &m_stats.dihedralBending, &m_stats.isometricBending, &m_stats.lra, &m_stats.collision };
+    double sumSquares = 0.0;
+    uint32_t constraintCount = 0;
+
+    m_stats.maxError = 0.0f;
+    for (const ClothConstraintResidual* residual : residuals)
+    {
+        m_stats.maxError = (std::max)(m_stats.maxError, residual->maxError);
+        sumSquares += (double)residual->rmsError * residual->rmsError * residual->constraintCount;
+        constraintCount += residual->constraintCount;
+    }
+    m_stats.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+}
+
+void ProjectiveDynamicsSolver::SaveState(std::vector<char>& state) const
+{
+    ClothCheckpoint::Append(state, &m_stats, sizeof(m_stats));
+}
+
+bool ProjectiveDynamicsSolver::LoadState(const char* data, size_t size)
+{
+    size_t position = 0;
+    if (!ClothCheckpoint::Read(data, size, position, &m_stats, sizeof(m_stats)))
+    {
+        logDebug("ProjectiveDynamicsSolver::LoadState: truncated state");
+        return false;
+    }
+
+    return true;
+}
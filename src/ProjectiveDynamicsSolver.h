@@ -0,0 +1,152 @@
+#ifndef PROJECTIVE_DYNAMICS_SOLVER_H
+#define PROJECTIVE_DYNAMICS_SOLVER_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "Particle.h"
+#include "IClothSolver.h"
+#include "SparseCholesky.h"
+
+class Cloth;
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// Projective Dynamics求解器
+// 每个子步最小化 1/(2h^2)*|x - s|_M^2 + Σ w/2 * |x_i - x_j - p|^2，交替执行：
+//   局部步：每条距离约束独立地把当前边投影到静止长度（p = restLength * dir），所有约束完全并行
+//   全局步：求解(M/h^2 + L) * x = M/h^2 * s + Σ w * A^T * p，L为以w = 1/柔度为权重的边拉普拉斯矩阵
+// 全局矩阵只依赖约束拓扑、刚度、质量和子步时间步长，分解一次后每次迭代只做三次回代（x、y、z分量）。
+// LRA和碰撞约束是不等式约束，不进入全局矩阵，每次全局步之后直接投影。
+// 不支持二面角约束、等距弯曲约束、约束阻尼和休眠
+class ProjectiveDynamicsSolver : public IClothSolver
+{
+public:
+    // 构造函数
+    // 参数
+    //   cloth - 布料
+    ProjectiveDynamicsSolver(Cloth* cloth)
+        : m_cloth(cloth)
+        , m_constraintsDirty(true)
+        , m_valid(false)
+        , m_factorDeltaTime(0.0f)
+        , m_bendingWarningLogged(false)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    ~ProjectiveDynamicsSolver() override
+    {
+    }
+
+    // 获取求解器名称
+    const char* GetName() const override
+    {
+        return "ProjectiveDynamics";
+    }
+
+    // 模拟一帧
+    void Step(float deltaTime) override;
+
+    // 约束增删后调用，下一次Step时重新建立全局矩阵
+    void InvalidateConstraints() override
+    {
+        m_constraintsDirty = true;
+    }
+
+    // 不支持休眠，没有需要唤醒的粒子
+    void WakeAll() override
+    {
+    }
+
+    // 不支持休眠，没有需要唤醒的粒子
+    void WakeInSphere(const dx::XMFLOAT3& center, float radius) override
+    {
+    }
+
+    // 获取最近一帧的求解统计
+    const ClothSolverStats& GetStats() const override
+    {
+        return m_stats;
+    }
+
+    // 跨帧保留的只有统计，预分解的矩阵在下一次Step时按约束重新建立
+    void SaveState(std::vector<char>& state) const override;
+
+    bool LoadState(const char* data, size_t size) override;
+
+private:
+    // 粒子对距离约束的关联
+    struct Incidence
+    {
+        uint32_t constraint;    // 距离约束索引
+        uint32_t other;         // 约束另一端的粒子索引
+        float sign;             // 该粒子为约束的第一个粒子时为1，否则为-1
+        bool otherStatic;       // 另一端的粒子是否固定
+    };
+
+    // 根据约束拓扑建立未知量编号、关联表和矩阵的非零结构，并做符号分析
+    bool Build();
+
+    // 按子步时间步长做数值分解
+    bool Factorize(float deltaTime);
+
+    // 预测位置：s = x + h * v + 外力项，s同时作为迭代初值
+    void PredictPositions(float deltaTime);
+
+    // 局部步：把每条距离约束投影到静止长度，同时统计投影前的残差
+    void ProjectDistanceConstraints();
+
+    // 全局步：组装右端项并回代求解，结果写回粒子位置
+    // 参数：
+    //   omega - Chebyshev外推系数，1表示不外推
+    void SolveGlobal(float deltaTime, float omega);
+
+    // 直接投影不等式约束（LRA和碰撞），统计投影前的残差
+    void ProjectInequalityConstraints();
+
+    // 根据子步位移更新速度
+    void UpdateVelocities(float deltaTime);
+
+    // 帧末根据整帧位移更新速度并施加速度阻尼
+    void EndStep(float deltaTime);
+
+    // 汇总各类约束的残差
+    void UpdateTotalResidual();
+
+    Cloth* m_cloth;
+    ClothSolverStats m_stats;
+
+    bool m_constraintsDirty;
+    bool m_valid;
+    float m_factorDeltaTime;            // 当前分解对应的子步时间步长
+    bool m_bendingWarningLogged;
+
+    // 粒子索引到未知量编号，固定粒子为UINT32_MAX
+    std::vector<uint32_t> m_particleUnknowns;
+    std::vector<uint32_t> m_unknownParticles;
+
+    // 每个未知量关联的距离约束
+    std::vector<uint32_t> m_incidenceOffsets;
+    std::vector<Incidence> m_incidences;
+
+    // 每条距离约束的权重（1/柔度）和局部步的投影结果
+    std::vector<float> m_constraintWeights;
+    std::vector<dx::XMFLOAT3> m_projections;
+
+    // 矩阵的非零项：前面是每个未知量的对角项，后面是两端都可移动的距离约束的非对角项
+    std::vector<uint32_t> m_offDiagonalConstraints;
+    std::vector<double> m_entryValues;
+    SparseCholesky m_cholesky;
+
+    // 全局步的右端项和解（x、y、z分量）
+    std::vector<double> m_rhs[3];
+
+    // Chebyshev加速：上一次迭代的结果
+    std::vector<dx::XMFLOAT3> m_previousPositions;
+};
+
+#endif // PROJECTIVE_DYNAMICS_SOLVER_H
@@ -40,12 +40,32 @@ struct RALResourceBarrier
     RALResourceState newState;
 };
 
+// 间接绘制参数（无索引），内存布局与D3D12_DRAW_ARGUMENTS一致
+struct RALDrawArguments
+{
+    uint32_t vertexCountPerInstance;
+    uint32_t instanceCount;
+    uint32_t startVertexLocation;
+    uint32_t startInstanceLocation;
+};
+
+// 间接绘制参数（有索引），内存布局与D3D12_DRAW_INDEXED_ARGUMENTS一致
+struct RALDrawIndexedArguments
+{
+    uint32_t indexCountPerInstance;
+    uint32_t instanceCount;
+    uint32_t startIndexLocation;
+    int32_t baseVertexLocation;
+    uint32_t startInstanceLocation;
+};
+
 // 命令列表抽象基类
 class IRALCommandList
 {
 public:
     IRALCommandList(RALCommandListType type)
         : m_type(type)
+        , m_refCount(0)
     {
     }
 
@@ -146,10 +166,15 @@ public:
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t startIndexLocation = 0, int32_t baseVertexLocation = 0, uint32_t startInstanceLocation = 0) = 0;
 
     // 绘制调用（间接）
-    virtual void DrawIndirect(void* bufferLocation, uint32_t drawCount, uint32_t stride) = 0;
-
-    // 绘制调用（索引间接）
-    virtual void DrawIndexedIndirect(void* bufferLocation, uint32_t drawCount, uint32_t stride) = 0;
+    // 参数：
+    //   argumentBuffer - 存放RALDrawArguments数组的缓冲区
+    //   argumentOffset - 第一个参数在缓冲区中的字节偏移
+    //   drawCount - 绘制次数
+    //   stride - 相邻两个参数之间的字节跨度
+    virtual void DrawIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride = sizeof(RALDrawArguments)) = 0;
+
+    // 绘制调用（索引间接），参数同DrawIndirect，缓冲区中存放RALDrawIndexedArguments数组
+    virtual void DrawIndexedIndirect(IRALBuffer* argumentBuffer, uint64_t argumentOffset, uint32_t drawCount, uint32_t stride = sizeof(RALDrawIndexedArguments)) = 0;
 
     // 设置渲染目标
     virtual void SetRenderTargets(uint32_t renderTargetCount, IRALRenderTargetView** renderTargetViews, IRALDepthStencilView* depthStencilView = nullptr) = 0;
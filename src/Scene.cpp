@@ -2,10 +2,12 @@
 #include "Primitive.h"
 #include "Cloth.h"
 #include "Sphere.h"
-#include "DX12RALDevice.h"
+#include "IRALDevice.h"
 #include "RALResource.h"
 #include "TRefCountPtr.h"
+#include "TaskScheduler.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <string>
 
@@ -29,7 +31,8 @@ struct SceneConstBuffer
     dx::XMFLOAT4 lightAmbientColor; // 环境光颜色
 };
 
-struct ObjectConstBuffer
+// 每实例数据，与GBuffer顶点着色器中的StructuredBuffer<InstanceData>布局一致
+struct PrimitiveInstanceData
 {
     dx::XMFLOAT4X4 World;           // 世界矩阵
     dx::XMFLOAT3 diffuseColor;      // 漫反射颜色
@@ -40,6 +43,10 @@ struct ObjectConstBuffer
 
 Scene::Scene()
     : m_device(nullptr)
+    , m_packedClothBatching(false)
+    , m_instanceBufferCapacity(0)
+    , m_indirectArgsCapacity(0)
+    , m_parallelRecordingThreadCount(1)
     , m_backgroundColor({0.9f, 0.9f, 0.9f, 1.0f})
     , m_lightPosition({10.0f, 10.0f, 10.0f})
     , m_lightDirection({-1.0f, -1.0f, -1.0f})
@@ -98,14 +105,41 @@ void Scene::Update(float deltaTime)
 
     IRALGraphicsCommandList* commandList = m_device->GetGraphicsCommandList();
 
-    // 更新场景中所有可见对象的状态
+    // 更新场景中所有可见对象的状态，支持批量更新的对象收集起来之后一起更新
+    m_batchUpdatePrimitives.clear();
+    m_packedCloths.clear();
     for (auto& primitiveInfo : m_primitives) 
     {
         if (primitiveInfo.primitive && primitiveInfo.visible)
         {
-            primitiveInfo.primitive->Update(commandList, deltaTime);
+            Cloth* cloth = m_packedClothBatching ? primitiveInfo.primitive->AsCloth() : nullptr;
+
+            // 迭代参数与第一块打包的布料相同的布料打包在一起求解
+            if (cloth && ClothBatchSolver::IsSupported(cloth)
+                && (m_packedCloths.empty() || ClothBatchSolver::IsCompatible(m_packedCloths.front(), cloth)))
+            {
+                m_packedCloths.push_back(cloth);
+            }
+            else if (primitiveInfo.primitive->IsBatchUpdateSupported())
+            {
+                m_batchUpdatePrimitives.push_back(primitiveInfo.primitive);
+            }
+            else
+            {
+                primitiveInfo.primitive->Update(commandList, deltaTime);
+            }
         }
      }
+
+    // 大量小块布料逐个更新时，每块布料的并行循环都很短，调度开销占主要部分；
+    // 批量更新时每块布料在一个工作线程上单线程更新，不同布料分布到所有工作线程上
+    Primitive::UpdateBatch(m_batchUpdatePrimitives, deltaTime);
+
+    // 打包求解时所有布料的同一种颜色的约束一起并行求解，求解后写回每块布料的顶点数据
+    m_clothBatchSolver.Step(m_packedCloths, deltaTime);
+
+    // 在绘制之前统一更新动态Mesh
+    UpdatePrimitiveMeshes();
 }
 
 void Scene::Render(const dx::XMMATRIX& viewMatrix, const dx::XMMATRIX& projectionMatrix)
@@ -177,6 +211,9 @@ void Scene::Clear()
 {
     // 清空所有对象
     m_primitives.clear();
+    m_sharedMeshes.clear();
+    m_drawBatches.clear();
+    m_clothBatchSolver.Clear();
 }
 
 // 设置场景的光源方向（自动归一化）
@@ -197,8 +234,28 @@ void Scene::UpdatePrimitiveRequests()
         primitiveInfo.worldMatrix = primitive->GetWorldMatrix();
         primitiveInfo.visible = primitive->IsVisible();
 
+        primitiveInfo.sharedMeshKey = primitive->GetSharedMeshKey();
+        primitiveInfo.pipelineState = m_gbufferPipelineState.Get();
+
+        // 共享Mesh只创建一次，之后相同键值的Primitive直接复用
         PrimitiveMesh mesh;
-        primitive->OnSetupMesh(m_device, mesh);
+        if (primitiveInfo.sharedMeshKey != 0)
+        {
+            std::unordered_map<uint64_t, PrimitiveMesh>::iterator meshIter = m_sharedMeshes.find(primitiveInfo.sharedMeshKey);
+            if (meshIter != m_sharedMeshes.end())
+            {
+                mesh = meshIter->second;
+            }
+            else
+            {
+                primitive->OnSetupMesh(m_device, mesh);
+                m_sharedMeshes[primitiveInfo.sharedMeshKey] = mesh;
+            }
+        }
+        else
+        {
+            primitive->OnSetupMesh(m_device, mesh);
+        }
         
         primitiveInfo.vertexBuffer = mesh.vertexBuffer;
         primitiveInfo.indexBuffer = mesh.indexBuffer;
@@ -207,7 +264,6 @@ void Scene::UpdatePrimitiveRequests()
         // 尝试获取高光颜色，如果Primitive类没有提供，则设置默认值
         primitiveInfo.specularColor = primitive->GetSpecularColor();
         primitiveInfo.shininess = primitive->GetShininess();
-        primitiveInfo.constBuffer = m_device->CreateConstBuffer(sizeof(ObjectConstBuffer), L"ObjectConstBuffer");
 
         // 添加对象到场景中
         m_primitives.push_back(primitiveInfo);
@@ -246,27 +302,265 @@ void Scene::UpdateSceneConstBuffer(IRALGraphicsCommandList* commandList, const d
 
     // 映射并更新缓冲区
     void* mappedData = nullptr;
-    D3D12_RANGE readRange = { 0, 0 };
     m_sceneConstBuffer.Get()->Map(&mappedData);
     memcpy(mappedData, &data, sizeof(SceneConstBuffer));
     m_sceneConstBuffer.Get()->Unmap();
 }
 
-void Scene::UpdatePrimitiveConstBuffer(IRALGraphicsCommandList* commandList, PrimitiveInfo* primitiveInfo)
+void Scene::UpdatePrimitiveMeshes()
+{
+    for (auto& primitiveInfo : m_primitives)
+    {
+        // 共享Mesh是静态的，不需要更新
+        if (!primitiveInfo.primitive || !primitiveInfo.visible || primitiveInfo.sharedMeshKey != 0)
+        {
+            continue;
+        }
+
+        if (primitiveInfo.vertexBuffer.Get() == nullptr || primitiveInfo.indexBuffer.Get() == nullptr)
+        {
+            continue;
+        }
+
+        PrimitiveMesh mesh;
+        mesh.vertexBuffer = primitiveInfo.vertexBuffer.Get();
+        mesh.indexBuffer = primitiveInfo.indexBuffer.Get();
+
+        primitiveInfo.primitive->OnUpdateMesh(m_device, mesh);
+    }
+}
+
+void Scene::BuildDrawBatches()
 {
-    ObjectConstBuffer data;
-    dx::XMStoreFloat4x4(&data.World, dx::XMMatrixTranspose(primitiveInfo->worldMatrix));
-    data.diffuseColor = primitiveInfo->diffuseColor;
-    // 使用float3直接赋值，不需要转换为float4
-    data.specularColor = primitiveInfo->specularColor;
-    data.shininess = primitiveInfo->shininess;
+    m_drawBatches.clear();
+    m_sortedPrimitiveIndices.clear();
 
-    // 映射并更新缓冲区
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_primitives.size()); ++i)
+    {
+        const PrimitiveInfo& primitiveInfo = m_primitives[i];
+        if (primitiveInfo.primitive && primitiveInfo.visible &&
+            primitiveInfo.vertexBuffer.Get() != nullptr && primitiveInfo.indexBuffer.Get() != nullptr)
+        {
+            m_sortedPrimitiveIndices.push_back(i);
+        }
+    }
+
+    // 按（管线状态、顶点缓冲区、索引缓冲区）排序，相同状态的Primitive相邻；
+    // 键值相同时按下标排序，保证每帧的实例顺序稳定
+    std::sort(m_sortedPrimitiveIndices.begin(), m_sortedPrimitiveIndices.end(),
+        [this](uint32_t a, uint32_t b)
+        {
+            const PrimitiveInfo& infoA = m_primitives[a];
+            const PrimitiveInfo& infoB = m_primitives[b];
+            std::less<const void*> less;
+            if (infoA.pipelineState != infoB.pipelineState)
+                return less(infoA.pipelineState, infoB.pipelineState);
+            if (infoA.vertexBuffer.Get() != infoB.vertexBuffer.Get())
+                return less(infoA.vertexBuffer.Get(), infoB.vertexBuffer.Get());
+            if (infoA.indexBuffer.Get() != infoB.indexBuffer.Get())
+                return less(infoA.indexBuffer.Get(), infoB.indexBuffer.Get());
+            return a < b;
+        });
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_sortedPrimitiveIndices.size()); ++i)
+    {
+        const PrimitiveInfo& primitiveInfo = m_primitives[m_sortedPrimitiveIndices[i]];
+
+        if (!m_drawBatches.empty())
+        {
+            DrawBatch& lastBatch = m_drawBatches.back();
+            if (lastBatch.pipelineState == primitiveInfo.pipelineState &&
+                lastBatch.vertexBuffer == primitiveInfo.vertexBuffer.Get() &&
+                lastBatch.indexBuffer == primitiveInfo.indexBuffer.Get())
+            {
+                lastBatch.instanceCount++;
+                continue;
+            }
+        }
+
+        DrawBatch batch;
+        batch.pipelineState = primitiveInfo.pipelineState;
+        batch.vertexBuffer = primitiveInfo.vertexBuffer.Get();
+        batch.indexBuffer = primitiveInfo.indexBuffer.Get();
+        batch.firstInstance = i;
+        batch.instanceCount = 1;
+        m_drawBatches.push_back(batch);
+    }
+}
+
+bool Scene::UploadDrawBatches()
+{
+    uint32_t instanceCount = static_cast<uint32_t>(m_sortedPrimitiveIndices.size());
+    uint32_t batchCount = static_cast<uint32_t>(m_drawBatches.size());
+
+    // 容量不足时按2的幂扩容，避免每帧重新创建缓冲区
+    if (instanceCount > m_instanceBufferCapacity)
+    {
+        uint32_t capacity = m_instanceBufferCapacity > 0 ? m_instanceBufferCapacity : 64;
+        while (capacity < instanceCount)
+        {
+            capacity *= 2;
+        }
+
+        m_instanceBuffer = m_device->CreateConstBuffer(capacity * sizeof(PrimitiveInstanceData), L"PrimitiveInstanceBuffer");
+        if (!m_instanceBuffer.Get())
+        {
+            logDebug("[DEBUG] Scene::UploadDrawBatches failed: failed to create instance buffer");
+            m_instanceBufferCapacity = 0;
+            return false;
+        }
+        m_instanceBufferCapacity = capacity;
+    }
+
+    if (batchCount > m_indirectArgsCapacity)
+    {
+        uint32_t capacity = m_indirectArgsCapacity > 0 ? m_indirectArgsCapacity : 64;
+        while (capacity < batchCount)
+        {
+            capacity *= 2;
+        }
+
+        m_indirectArgsBuffer = m_device->CreateConstBuffer(capacity * sizeof(RALDrawIndexedArguments), L"IndirectDrawArgsBuffer");
+        if (!m_indirectArgsBuffer.Get())
+        {
+            logDebug("[DEBUG] Scene::UploadDrawBatches failed: failed to create indirect argument buffer");
+            m_indirectArgsCapacity = 0;
+            return false;
+        }
+        m_indirectArgsCapacity = capacity;
+    }
+
+    // 按批次顺序写入实例数据
     void* mappedData = nullptr;
-    D3D12_RANGE readRange = { 0, 0 };
-    primitiveInfo->constBuffer->Map(&mappedData);
-    memcpy(mappedData, &data, sizeof(ObjectConstBuffer));
-    primitiveInfo->constBuffer->Unmap();
+    if (!m_instanceBuffer->Map(&mappedData))
+    {
+        return false;
+    }
+
+    PrimitiveInstanceData* instances = static_cast<PrimitiveInstanceData*>(mappedData);
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        const PrimitiveInfo& primitiveInfo = m_primitives[m_sortedPrimitiveIndices[i]];
+
+        PrimitiveInstanceData data;
+        dx::XMStoreFloat4x4(&data.World, dx::XMMatrixTranspose(primitiveInfo.worldMatrix));
+        data.diffuseColor = primitiveInfo.diffuseColor;
+        data.padding1 = 0.0f;
+        data.specularColor = primitiveInfo.specularColor;
+        data.shininess = primitiveInfo.shininess;
+        memcpy(&instances[i], &data, sizeof(PrimitiveInstanceData));
+    }
+    m_instanceBuffer->Unmap();
+
+    // 每个批次一条间接绘制参数
+    if (!m_indirectArgsBuffer->Map(&mappedData))
+    {
+        return false;
+    }
+
+    RALDrawIndexedArguments* arguments = static_cast<RALDrawIndexedArguments*>(mappedData);
+    for (uint32_t i = 0; i < batchCount; ++i)
+    {
+        const DrawBatch& batch = m_drawBatches[i];
+
+        RALDrawIndexedArguments args;
+        args.indexCountPerInstance = batch.indexBuffer->GetIndexCount();
+        args.instanceCount = batch.instanceCount;
+        args.startIndexLocation = 0;
+        args.baseVertexLocation = 0;
+        // SV_InstanceID不包含StartInstanceLocation，实例基址通过根常量传入着色器
+        args.startInstanceLocation = 0;
+        memcpy(&arguments[i], &args, sizeof(RALDrawIndexedArguments));
+    }
+    m_indirectArgsBuffer->Unmap();
+
+    return true;
+}
+
+// 每个录制线程至少分到的批次数，批次太少时线程和命令列表的开销大于收益
+static const uint32_t kMinBatchesPerRecordingThread = 16;
+
+void Scene::RecordGeometryBatches(IRALGraphicsCommandList* commandList, uint32_t beginBatch, uint32_t endBatch, bool setupPassState)
+{
+    if (setupPassState)
+    {
+        IRALRenderTargetView* renderTargetViews[3] = { m_gbufferARTV.Get(), m_gbufferBRTV.Get(), m_gbufferCRTV.Get() };
+        commandList->SetRenderTargets(3, renderTargetViews, m_gbufferDSV.Get());
+    }
+
+    // 设置GBuffer根签名
+    commandList->SetGraphicsRootSignature(m_gbufferRootSignature.Get());
+
+    // 设置根参数0（场景常量）和根参数2（每实例数据）
+    commandList->SetGraphicsRootConstantBuffer(0, m_sceneConstBuffer.Get());
+    commandList->SetGraphicsRootShaderResource(2, m_instanceBuffer.Get());
+
+    // 设置图元拓扑
+    commandList->SetPrimitiveTopology(RALPrimitiveTopologyType::TriangleList);
+
+    // 每个批次一次间接绘制，只有状态变化时才重新绑定
+    IRALGraphicsPipelineState* currentPipelineState = nullptr;
+    IRALVertexBuffer* currentVertexBuffer = nullptr;
+    IRALIndexBuffer* currentIndexBuffer = nullptr;
+
+    for (uint32_t i = beginBatch; i < endBatch; ++i)
+    {
+        const DrawBatch& batch = m_drawBatches[i];
+
+        if (batch.pipelineState != currentPipelineState)
+        {
+            commandList->SetPipelineState(batch.pipelineState);
+            currentPipelineState = batch.pipelineState;
+        }
+
+        if (batch.vertexBuffer != currentVertexBuffer)
+        {
+            IRALVertexBuffer* vertexBuffer = batch.vertexBuffer;
+            commandList->SetVertexBuffers(0, 1, &vertexBuffer);
+            currentVertexBuffer = batch.vertexBuffer;
+        }
+
+        if (batch.indexBuffer != currentIndexBuffer)
+        {
+            commandList->SetIndexBuffer(batch.indexBuffer);
+            currentIndexBuffer = batch.indexBuffer;
+        }
+
+        // 设置根参数1（实例基址）
+        commandList->SetGraphicsRootConstant(1, 0, batch.firstInstance);
+
+        // 绘制该批次的所有实例
+        commandList->DrawIndexedIndirect(m_indirectArgsBuffer.Get(), i * sizeof(RALDrawIndexedArguments), 1);
+    }
+}
+
+bool Scene::RecordGeometryBatchesParallel(uint32_t threadCount)
+{
+    std::vector<IRALGraphicsCommandList*> commandLists(threadCount, nullptr);
+    if (!m_device->AcquireParallelGraphicsCommandLists(threadCount, commandLists.data()))
+    {
+        return false;
+    }
+
+    // 批次按顺序均分成连续的段，第i段录制到第i个命令列表，提交顺序与串行录制一致
+    uint32_t batchCount = static_cast<uint32_t>(m_drawBatches.size());
+    auto recordRange = [this, &commandLists, batchCount, threadCount](uint32_t index)
+    {
+        uint32_t beginBatch = static_cast<uint32_t>(static_cast<uint64_t>(batchCount) * index / threadCount);
+        uint32_t endBatch = static_cast<uint32_t>(static_cast<uint64_t>(batchCount) * (index + 1) / threadCount);
+        RecordGeometryBatches(commandLists[index], beginBatch, endBatch, true);
+    };
+
+    // 每段作为一个任务交给全局任务调度器，当前线程在等待期间也会录制
+    TaskScheduler::Get().ParallelFor(0, threadCount, 1, [&recordRange](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            recordRange(index);
+        }
+    });
+
+    return true;
 }
 
 // 延迟着色光照阶段常量缓冲区
@@ -519,9 +813,13 @@ bool Scene::InitializeDeferredRendering()
     CreateFullscreenQuad();
 
     // 创建几何阶段根签名
-    std::vector<RALRootParameter> gbufferRootParameters(2);
+    // 参数0：场景常量（b0）
+    // 参数1：当前批次的实例基址（b1，1个32位根常量）
+    // 参数2：每实例数据（t0，StructuredBuffer）
+    std::vector<RALRootParameter> gbufferRootParameters(3);
     InitAsConstantBufferView(gbufferRootParameters[0], 0, 0, RALShaderVisibility::All);
-    InitAsConstantBufferView(gbufferRootParameters[1], 1, 0, RALShaderVisibility::All);
+    InitAsConstants(gbufferRootParameters[1], 1, 0, 1, RALShaderVisibility::Vertex);
+    InitAsShaderResourceView(gbufferRootParameters[2], 0, 0, RALShaderVisibility::Vertex);
 
     // 定义GBuffer几何阶段根签名
     m_gbufferRootSignature = m_device->CreateRootSignature(
@@ -543,12 +841,15 @@ bool Scene::InitializeDeferredRendering()
         "   float3 pos : POSITION;\n"
         "   float3 normal : NORMAL;\n"
         "   float2 uv : TEXCOORD;\n"
+        "   uint instanceID : SV_InstanceID;\n"
         "};\n"
         "struct VS_OUTPUT {\n"
         "   float4 pos : SV_POSITION;\n"
         "   float3 normal : NORMAL;\n"
         "   float3 worldPos : WORLD_POS;\n"
         "   float2 uv : TEXCOORD;\n"
+        "   nointerpolation float3 diffuseColor : DIFFUSE_COLOR;\n"
+        "   nointerpolation float4 specular : SPECULAR; // rgb为高光颜色，a为光泽度\n"
         "};\n"
         "cbuffer SceneConstants : register(b0) {\n"
         "   float4x4 View;\n"
@@ -565,15 +866,21 @@ bool Scene::InitializeDeferredRendering()
         "   float padding3;\n"
         "   float4 lightAmbientColor;\n"
         "};\n"
-        "cbuffer ObjectBuffer : register(b1) {\n"
+        "struct InstanceData {\n"
         "   float4x4 World;\n"
         "   float3 diffuseColor;\n"
 		"   float padding;\n"
         "   float3 specularColor;\n"
         "   float shininess;\n"
         "};\n"
+        "cbuffer DrawConstants : register(b1) {\n"
+        "   uint instanceBase; // 当前批次在实例数据中的起始下标\n"
+        "};\n"
+        "StructuredBuffer<InstanceData> Instances : register(t0);\n"
         "VS_OUTPUT main(VS_INPUT input) {\n"
         "   VS_OUTPUT output;\n"
+        "   InstanceData instance = Instances[instanceBase + input.instanceID];\n"
+        "   float4x4 World = instance.World;\n"
         "   float4x4 worldViewProj = mul(World, ViewProj);\n"
         "   output.pos = mul(float4(input.pos, 1.0f), worldViewProj);\n"
         "   output.worldPos = mul(float4(input.pos, 1.0f), World).xyz;\n"
@@ -581,6 +888,8 @@ bool Scene::InitializeDeferredRendering()
         "   float4 normal = mul(float4(input.normal, 0.0f), World);\n"
         "   output.normal = normalize(normal.xyz);\n"
         "   output.uv = input.uv;\n"
+        "   output.diffuseColor = instance.diffuseColor;\n"
+        "   output.specular = float4(instance.specularColor, instance.shininess);\n"
         "   return output;\n"
         "}";
 
@@ -590,13 +899,8 @@ bool Scene::InitializeDeferredRendering()
         "   float3 normal : NORMAL;\n"
         "   float3 worldPos : WORLD_POS;\n"
         "   float2 uv : TEXCOORD;\n"
-        "};\n"
-        "cbuffer ObjectBuffer : register(b1) {\n"
-        "   float4x4 World;\n"
-        "   float3 diffuseColor;\n"
-        "   float padding;\n"
-        "   float3 specularColor;\n"
-        "   float shininess;\n"
+        "   nointerpolation float3 diffuseColor : DIFFUSE_COLOR;\n"
+        "   nointerpolation float4 specular : SPECULAR;\n"
         "};\n"
         "// 输出到GBuffer\n"
         "struct PS_OUTPUT {\n"
@@ -612,11 +916,11 @@ bool Scene::InitializeDeferredRendering()
         "   output.gbufferA.w = 1.0f;\n"
         "   \n"
         "   // 输出材质属性到GBufferB\n"
-        "   output.gbufferB.rgb = specularColor.rgb; // 高光颜色\n"
-        "   output.gbufferB.a = shininess / 128.0f; // 将shininess映射到[0,1]范围（假设最大值为128）\n"
+        "   output.gbufferB.rgb = input.specular.rgb; // 高光颜色\n"
+        "   output.gbufferB.a = input.specular.a / 128.0f; // 将shininess映射到[0,1]范围（假设最大值为128）\n"
         "   \n"
         "   // 输出基础颜色到GBufferC\n"
-        "   output.gbufferC.rgb = diffuseColor.rgb;\n"
+        "   output.gbufferC.rgb = input.diffuseColor.rgb;\n"
         "   output.gbufferC.a = 1.0f;\n"
         "   \n"
         "   return output;\n"
@@ -1549,50 +1853,22 @@ void Scene::ExecuteGeometryPass(const dx::XMMATRIX& viewMatrix, const dx::XMMATR
     // 更新场景常量缓冲区
     UpdateSceneConstBuffer(commandList, viewMatrix, projectionMatrix);
 
-    // 设置GBuffer根签名和管线状态
-    commandList->SetGraphicsRootSignature(m_gbufferRootSignature.Get());
-    commandList->SetPipelineState(m_gbufferPipelineState.Get());
-
-    // 设置根参数0（场景常量）
-    commandList->SetGraphicsRootConstantBuffer(0, m_sceneConstBuffer.Get());
-
-    // 设置图元拓扑
-    commandList->SetPrimitiveTopology(RALPrimitiveTopologyType::TriangleList);
-
-    // 渲染每个可见的Primitive对象
-    for (size_t i = 0; i < m_primitives.size(); ++i)
+    // 合批并上传实例数据和间接绘制参数
+    BuildDrawBatches();
+    if (m_drawBatches.empty() || !UploadDrawBatches())
     {
-        auto& primitiveInfo = m_primitives[i];
-
-        if (primitiveInfo.primitive && primitiveInfo.visible)
-        {
-            IRALVertexBuffer* vertexBuffer = primitiveInfo.vertexBuffer.Get();
-            IRALIndexBuffer* indexBuffer = primitiveInfo.indexBuffer.Get();
-
-            if (vertexBuffer == nullptr || indexBuffer == nullptr)
-            {
-                continue;
-            }
-
-            PrimitiveMesh mesh;
-            mesh.vertexBuffer = primitiveInfo.vertexBuffer.Get();
-            mesh.indexBuffer = primitiveInfo.indexBuffer.Get();
-
-            // 更新Mesh
-            primitiveInfo.primitive->OnUpdateMesh(m_device, mesh);
-
-            // 更新Primitive常量缓冲区
-            UpdatePrimitiveConstBuffer(commandList, &primitiveInfo);
-
-            commandList->SetVertexBuffers(0, 1, &vertexBuffer);
-            commandList->SetIndexBuffer(indexBuffer);
+        return;
+    }
 
-            // 设置根参数1（对象常量缓冲区）
-            commandList->SetGraphicsRootConstantBuffer(1, primitiveInfo.constBuffer.Get());
-            // 绘制对象
-            commandList->DrawIndexed(indexBuffer->GetIndexCount(), 1, 0, 0, 0);
-        }
+    // 批次足够多时分给多个线程并行录制，否则直接录制到主命令列表
+    uint32_t batchCount = static_cast<uint32_t>(m_drawBatches.size());
+    uint32_t threadCount = std::min(m_parallelRecordingThreadCount, batchCount / kMinBatchesPerRecordingThread);
+    if (threadCount > 1 && RecordGeometryBatchesParallel(threadCount))
+    {
+        return;
     }
+
+    RecordGeometryBatches(commandList, 0, batchCount, false);
 }
 
 // 执行光照阶段
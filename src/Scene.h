@@ -4,8 +4,10 @@
 #include "Primitive.h"
 #include "TRefCountPtr.h"
 #include "RALResource.h"
+#include "ClothBatchSolver.h"
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <DirectXMath.h>
 
 // 前向声明
@@ -123,6 +125,34 @@ public:
     // 调整渲染资源大小
     void Resize(uint32_t width, uint32_t height);
 
+    // 设置几何阶段并行录制使用的线程数（即命令列表数，录制任务由全局任务调度器执行）
+    // 参数：
+    //   count - 线程数，小于等于1时所有绘制都录制到主命令列表
+    void SetParallelRecordingThreadCount(uint32_t count)
+    {
+        m_parallelRecordingThreadCount = count;
+    }
+
+    // 获取几何阶段并行录制使用的线程数
+    uint32_t GetParallelRecordingThreadCount() const
+    {
+        return m_parallelRecordingThreadCount;
+    }
+
+    // 设置是否把可以批量更新的小块布料交给打包求解器
+    // 打包求解器把所有布料的粒子和约束放在共享的SoA数组中按颜色跨布料并行求解，
+    // 结果与逐块更新不逐位一致（见ClothBatchSolver）；不满足打包条件的布料仍然逐块批量更新
+    void SetPackedClothBatching(bool enabled)
+    {
+        m_packedClothBatching = enabled;
+    }
+
+    // 获取是否使用打包求解器更新小块布料
+    bool IsPackedClothBatching() const
+    {
+        return m_packedClothBatching;
+    }
+
 private:
     struct AddPrimitiveRequest
     {
@@ -137,14 +167,45 @@ private:
         dx::XMFLOAT3 diffuseColor;
         dx::XMFLOAT3 specularColor;
         float shininess;
+        uint64_t sharedMeshKey;                         // 共享Mesh键值，0表示独立Mesh
+        IRALGraphicsPipelineState* pipelineState;       // 绘制使用的管线状态
         TRefCountPtr<IRALVertexBuffer> vertexBuffer;
         TRefCountPtr<IRALIndexBuffer> indexBuffer;
-        TRefCountPtr<IRALConstBuffer> constBuffer;
+    };
+
+    // 合批后的一次绘制：管线状态、顶点缓冲区和索引缓冲区都相同的Primitive合并为一次实例化绘制
+    struct DrawBatch
+    {
+        IRALGraphicsPipelineState* pipelineState;
+        IRALVertexBuffer* vertexBuffer;
+        IRALIndexBuffer* indexBuffer;
+        uint32_t firstInstance;     // 在实例数据缓冲区中的起始下标
+        uint32_t instanceCount;     // 实例数量
     };
 
     void UpdatePrimitiveRequests();
     void UpdateSceneConstBuffer(IRALGraphicsCommandList* commandList, const dx::XMMATRIX& viewMatrix, const dx::XMMATRIX& projectionMatrix);
-	void UpdatePrimitiveConstBuffer(IRALGraphicsCommandList* commandList, PrimitiveInfo* primitiveInfo);
+
+    // 更新所有独立Mesh（在绘制循环之外进行，绘制时不再触发上传）
+    void UpdatePrimitiveMeshes();
+
+    // 按（管线状态、顶点缓冲区、索引缓冲区）对可见Primitive排序合批
+    void BuildDrawBatches();
+
+    // 上传实例数据和间接绘制参数，必要时扩容缓冲区
+    bool UploadDrawBatches();
+
+    // 录制[beginBatch, endBatch)范围内的批次
+    // 参数：
+    //   commandList - 录制使用的命令列表
+    //   beginBatch, endBatch - 批次范围
+    //   setupPassState - 是否先设置GBuffer渲染目标（新的并行命令列表不继承主命令列表的状态）
+    void RecordGeometryBatches(IRALGraphicsCommandList* commandList, uint32_t beginBatch, uint32_t endBatch, bool setupPassState);
+
+    // 把批次分成若干段，在多个线程上分别录制到并行命令列表
+    // 返回值：
+    //   是否成功获取并行命令列表，失败时调用者应退回串行录制
+    bool RecordGeometryBatchesParallel(uint32_t threadCount);
 
     // 初始化延迟着色相关资源
     bool InitializeDeferredRendering();
@@ -176,6 +237,32 @@ private:
     // 场景中的所有Mesh对象
     std::vector<PrimitiveInfo> m_primitives;
 
+    // 按键值共享的Mesh
+    std::unordered_map<uint64_t, PrimitiveMesh> m_sharedMeshes;
+
+    // 当前帧的绘制批次，以及排序用的临时下标数组
+    std::vector<DrawBatch> m_drawBatches;
+    std::vector<uint32_t> m_sortedPrimitiveIndices;
+
+    // 当前帧批量更新的Primitive（临时数组，保留容量以便复用）
+    std::vector<Primitive*> m_batchUpdatePrimitives;
+
+    // 打包求解的布料（临时数组）和打包求解器
+    bool m_packedClothBatching;
+    std::vector<Cloth*> m_packedCloths;
+    ClothBatchSolver m_clothBatchSolver;
+
+    // 每实例数据（StructuredBuffer，按批次顺序排列）
+    TRefCountPtr<IRALConstBuffer> m_instanceBuffer;
+    uint32_t m_instanceBufferCapacity;
+
+    // 间接绘制参数缓冲区（每个批次一个RALDrawIndexedArguments）
+    TRefCountPtr<IRALConstBuffer> m_indirectArgsBuffer;
+    uint32_t m_indirectArgsCapacity;
+
+    // 几何阶段并行录制使用的线程数
+    uint32_t m_parallelRecordingThreadCount;
+
     // 场景的背景颜色
     dx::XMFLOAT4 m_backgroundColor; // 默认浅灰色背景
 
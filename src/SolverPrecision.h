@@ -0,0 +1,40 @@
+#ifndef SOLVER_PRECISION_H
+#define SOLVER_PRECISION_H
+
+// 求解器的浮点精度策略
+// 约束求解的中间量（分母累积、柔度项、阻尼项、乘子增量）和拉格朗日乘子统一使用SolverReal：
+//   默认为float，求解内核中没有float/double混合运算，便于编译器向量化，用于实时模拟
+//   定义XPBD_SOLVER_DOUBLE后为double，用于生成参考结果
+// 粒子位置以布料局部坐标存放（布料的世界位置由网格变换给出），始终为float，便于直接上传渲染
+#ifdef XPBD_SOLVER_DOUBLE
+typedef double SolverReal;
+#else
+typedef float SolverReal;
+#endif//XPBD_SOLVER_DOUBLE
+
+// 不同精度下的常量
+template<typename Real>
+struct SolverPrecisionTraits;
+
+template<>
+struct SolverPrecisionTraits<float>
+{
+    static constexpr const char* kName = "float";
+    static constexpr float kNegligibleError = 1e-9f;    // 约束值小于此值时跳过求解
+    static constexpr float kMinDenominator = 1e-9f;     // 乘子增量分母的下限
+    static constexpr float kMaxAlphaTilde = 1e6f;       // α̃ = α/Δt²的上限
+};
+
+template<>
+struct SolverPrecisionTraits<double>
+{
+    static constexpr const char* kName = "double";
+    static constexpr double kNegligibleError = 1e-12;
+    static constexpr double kMinDenominator = 1e-12;
+    static constexpr double kMaxAlphaTilde = 1e6;
+};
+
+// 当前构建使用的精度
+typedef SolverPrecisionTraits<SolverReal> SolverPrecision;
+
+#endif // SOLVER_PRECISION_H
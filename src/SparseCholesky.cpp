@@ -0,0 +1,348 @@
+#include "SparseCholesky.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <string>
+
+extern void logDebug(const std::string& message);
+
+// 消去树中没有父节点
+static const uint32_t kNoParent = UINT32_MAX;
+
+// 嵌套剖分的子集不超过这个大小时不再继续剖分
+static const size_t kNestedDissectionLeafSize = 32;
+
+bool SparseCholesky::Analyze(uint32_t size, const std::vector<uint32_t>& entryRows, const std::vector<uint32_t>& entryColumns,
+    const std::vector<uint32_t>& permutation)
+{
+    m_size = 0;
+    m_factorized = false;
+
+    if (entryRows.size() != entryColumns.size() || permutation.size() != size)
+    {
+        logDebug("SparseCholesky::Analyze: invalid input");
+        return false;
+    }
+
+    // 原编号到新编号
+    std::vector<uint32_t> inversePermutation(size, UINT32_MAX);
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        if (permutation[k] >= size || inversePermutation[permutation[k]] != UINT32_MAX)
+        {
+            logDebug("SparseCholesky::Analyze: invalid permutation");
+            return false;
+        }
+        inversePermutation[permutation[k]] = k;
+    }
+
+    // 1. 重排序后放入上三角，按列压缩存储
+    const size_t entryCount = entryRows.size();
+    std::vector<uint32_t> columnCounts(size + 1, 0);
+
+    for (size_t e = 0; e < entryCount; ++e)
+    {
+        if (entryRows[e] >= size || entryColumns[e] >= size)
+        {
+            logDebug("SparseCholesky::Analyze: entry out of range");
+            return false;
+        }
+
+        uint32_t row = inversePermutation[entryRows[e]];
+        uint32_t column = inversePermutation[entryColumns[e]];
+        columnCounts[(std::max)(row, column)]++;
+    }
+
+    m_columnOffsets.assign(size + 1, 0);
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        m_columnOffsets[k + 1] = m_columnOffsets[k] + columnCounts[k];
+    }
+
+    m_rows.resize(entryCount);
+    m_values.assign(entryCount, 0.0);
+    m_entryPositions.resize(entryCount);
+
+    std::vector<uint32_t> fill(m_columnOffsets.begin(), m_columnOffsets.end() - 1);
+    for (size_t e = 0; e < entryCount; ++e)
+    {
+        uint32_t row = inversePermutation[entryRows[e]];
+        uint32_t column = inversePermutation[entryColumns[e]];
+        uint32_t position = fill[(std::max)(row, column)]++;
+
+        m_rows[position] = (std::min)(row, column);
+        m_entryPositions[e] = position;
+    }
+
+    m_size = size;
+    m_permutation = permutation;
+
+    // 2. 消去树，祖先路径压缩
+    m_parents.assign(size, kNoParent);
+    std::vector<uint32_t> ancestors(size, kNoParent);
+
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        for (uint32_t p = m_columnOffsets[k]; p < m_columnOffsets[k + 1]; ++p)
+        {
+            uint32_t i = m_rows[p];
+            while (i != kNoParent && i < k)
+            {
+                uint32_t next = ancestors[i];
+                ancestors[i] = k;
+                if (next == kNoParent)
+                {
+                    m_parents[i] = k;
+                }
+                i = next;
+            }
+        }
+    }
+
+    // 3. 逐行求L的非零结构，统计每列的非零项数
+    m_stack.resize(size);
+    m_marks.assign(size, 0);
+    m_workspace.assign(size, 0.0);
+
+    std::vector<uint32_t> factorColumnCounts(size, 1);
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        for (uint32_t top = ComputeRowPattern(k); top < size; ++top)
+        {
+            factorColumnCounts[m_stack[top]]++;
+        }
+    }
+
+    m_factorColumnOffsets.assign(size + 1, 0);
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        m_factorColumnOffsets[k + 1] = m_factorColumnOffsets[k] + factorColumnCounts[k];
+    }
+
+    m_factorRows.resize(m_factorColumnOffsets[size]);
+    m_factorValues.resize(m_factorColumnOffsets[size]);
+    m_columnFill.resize(size);
+
+    return true;
+}
+
+uint32_t SparseCholesky::ComputeRowPattern(uint32_t k)
+{
+    // 标记值为k+1表示在第k行中已访问，避免每行清除标记
+    const uint32_t stamp = k + 1;
+    uint32_t top = m_size;
+
+    m_marks[k] = stamp;
+
+    for (uint32_t p = m_columnOffsets[k]; p < m_columnOffsets[k + 1]; ++p)
+    {
+        uint32_t i = m_rows[p];
+        if (i >= k)
+        {
+            continue;
+        }
+
+        // 沿消去树向上走到已访问的节点，路径逆序压入栈顶，保证结果是拓扑顺序
+        uint32_t length = 0;
+        for (; m_marks[i] != stamp; i = m_parents[i])
+        {
+            m_stack[length++] = i;
+            m_marks[i] = stamp;
+        }
+
+        while (length > 0)
+        {
+            m_stack[--top] = m_stack[--length];
+        }
+    }
+
+    return top;
+}
+
+bool SparseCholesky::Factorize(const std::vector<double>& entryValues)
+{
+    m_factorized = false;
+
+    if (entryValues.size() != m_entryPositions.size())
+    {
+        logDebug("SparseCholesky::Factorize: value count does not match the analyzed pattern");
+        return false;
+    }
+
+    std::fill(m_values.begin(), m_values.end(), 0.0);
+    for (size_t e = 0; e < entryValues.size(); ++e)
+    {
+        m_values[m_entryPositions[e]] += entryValues[e];
+    }
+
+    std::fill(m_marks.begin(), m_marks.end(), 0);
+    std::copy(m_factorColumnOffsets.begin(), m_factorColumnOffsets.end() - 1, m_columnFill.begin());
+
+    double* x = m_workspace.data();
+
+    // 上视法：第k行的非零项只依赖前面已经完成的列
+    for (uint32_t k = 0; k < m_size; ++k)
+    {
+        uint32_t top = ComputeRowPattern(k);
+
+        x[k] = 0.0;
+        for (uint32_t p = m_columnOffsets[k]; p < m_columnOffsets[k + 1]; ++p)
+        {
+            x[m_rows[p]] += m_values[p];
+        }
+
+        double diagonal = x[k];
+        x[k] = 0.0;
+
+        for (; top < m_size; ++top)
+        {
+            uint32_t i = m_stack[top];
+            double lki = x[i] / m_factorValues[m_factorColumnOffsets[i]];
+            x[i] = 0.0;
+
+            for (uint32_t p = m_factorColumnOffsets[i] + 1; p < m_columnFill[i]; ++p)
+            {
+                x[m_factorRows[p]] -= m_factorValues[p] * lki;
+            }
+
+            diagonal -= lki * lki;
+
+            uint32_t p = m_columnFill[i]++;
+            m_factorRows[p] = k;
+            m_factorValues[p] = lki;
+        }
+
+        if (!(diagonal > 0.0))
+        {
+            logDebug("SparseCholesky::Factorize: matrix is not positive definite at row " + std::to_string(k));
+            return false;
+        }
+
+        uint32_t p = m_columnFill[k]++;
+        m_factorRows[p] = k;
+        m_factorValues[p] = std::sqrt(diagonal);
+    }
+
+    m_factorized = true;
+    return true;
+}
+
+void SparseCholesky::Solve(std::vector<double>& x) const
+{
+    if (!m_factorized || x.size() != m_size)
+    {
+        return;
+    }
+
+    std::vector<double> y(m_size);
+    for (uint32_t k = 0; k < m_size; ++k)
+    {
+        y[k] = x[m_permutation[k]];
+    }
+
+    // L * z = b
+    for (uint32_t j = 0; j < m_size; ++j)
+    {
+        y[j] /= m_factorValues[m_factorColumnOffsets[j]];
+        for (uint32_t p = m_factorColumnOffsets[j] + 1; p < m_factorColumnOffsets[j + 1]; ++p)
+        {
+            y[m_factorRows[p]] -= m_factorValues[p] * y[j];
+        }
+    }
+
+    // L^T * y = z
+    for (uint32_t j = m_size; j-- > 0; )
+    {
+        for (uint32_t p = m_factorColumnOffsets[j] + 1; p < m_factorColumnOffsets[j + 1]; ++p)
+        {
+            y[j] -= m_factorValues[p] * y[m_factorRows[p]];
+        }
+        y[j] /= m_factorValues[m_factorColumnOffsets[j]];
+    }
+
+    for (uint32_t k = 0; k < m_size; ++k)
+    {
+        x[m_permutation[k]] = y[k];
+    }
+}
+
+void SparseCholesky::ComputeNestedDissectionOrder(uint32_t size, const std::vector<uint32_t>& adjacencyOffsets,
+    const std::vector<uint32_t>& adjacency, const std::vector<dx::XMFLOAT2>& coordinates, std::vector<uint32_t>& permutation)
+{
+    permutation.clear();
+    permutation.reserve(size);
+
+    // 每个未知量最近一次被划入的“右半部分”编号，用于判断左半部分的未知量是否与右半部分相连
+    std::vector<uint32_t> regions(size, 0);
+    uint32_t regionCounter = 0;
+
+    std::function<void(std::vector<uint32_t>&)> dissect = [&](std::vector<uint32_t>& subset)
+    {
+        if (subset.size() <= kNestedDissectionLeafSize)
+        {
+            permutation.insert(permutation.end(), subset.begin(), subset.end());
+            return;
+        }
+
+        // 沿包围盒较长的方向在中位数处分开
+        float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+        for (uint32_t i : subset)
+        {
+            minX = (std::min)(minX, coordinates[i].x);
+            maxX = (std::max)(maxX, coordinates[i].x);
+            minY = (std::min)(minY, coordinates[i].y);
+            maxY = (std::max)(maxY, coordinates[i].y);
+        }
+
+        const bool splitX = (maxX - minX) >= (maxY - minY);
+        const size_t half = subset.size() / 2;
+
+        std::nth_element(subset.begin(), subset.begin() + half, subset.end(), [&coordinates, splitX](uint32_t a, uint32_t b)
+        {
+            return splitX ? coordinates[a].x < coordinates[b].x : coordinates[a].y < coordinates[b].y;
+        });
+
+        std::vector<uint32_t> right(subset.begin() + half, subset.end());
+        const uint32_t rightRegion = ++regionCounter;
+        for (uint32_t i : right)
+        {
+            regions[i] = rightRegion;
+        }
+
+        // 左半部分中与右半部分相连的未知量组成分隔集，去掉分隔集后两半互不相连
+        std::vector<uint32_t> left;
+        std::vector<uint32_t> separator;
+        for (size_t s = 0; s < half; ++s)
+        {
+            uint32_t i = subset[s];
+            bool connected = false;
+
+            for (uint32_t p = adjacencyOffsets[i]; p < adjacencyOffsets[i + 1]; ++p)
+            {
+                if (regions[adjacency[p]] == rightRegion)
+                {
+                    connected = true;
+                    break;
+                }
+            }
+
+            (connected ? separator : left).push_back(i);
+        }
+
+        subset.clear();
+        subset.shrink_to_fit();
+
+        dissect(left);
+        dissect(right);
+        permutation.insert(permutation.end(), separator.begin(), separator.end());
+    };
+
+    std::vector<uint32_t> all(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        all[i] = i;
+    }
+
+    dissect(all);
+}
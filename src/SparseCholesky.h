@@ -0,0 +1,101 @@
+#ifndef SPARSE_CHOLESKY_H
+#define SPARSE_CHOLESKY_H
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 对称正定稀疏矩阵的Cholesky分解（A = L * L^T）
+// 非零结构固定时只需做一次符号分析（重排序、消去树、L的非零结构），之后每次数值变化只需重新做数值分解
+// 矩阵以非零项列表的形式给出，每一项为(row, column, value)，只需给出上三角或下三角中的一个，重复的项会累加
+class SparseCholesky
+{
+public:
+    SparseCholesky()
+        : m_size(0)
+        , m_factorized(false)
+    {
+    }
+
+    // 符号分析
+    // 参数：
+    //   size - 矩阵的阶数
+    //   entryRows - 每个非零项的行号
+    //   entryColumns - 每个非零项的列号
+    //   permutation - 重排序，permutation[k]为新顺序中第k个未知量在原顺序中的编号
+    // 返回：是否成功
+    bool Analyze(uint32_t size, const std::vector<uint32_t>& entryRows, const std::vector<uint32_t>& entryColumns,
+        const std::vector<uint32_t>& permutation);
+
+    // 数值分解
+    // 参数：
+    //   entryValues - 每个非零项的值，顺序与Analyze时的非零项一致
+    // 返回：是否成功（矩阵不正定时失败）
+    bool Factorize(const std::vector<double>& entryValues);
+
+    // 求解A * x = b
+    // 参数：
+    //   x - 输入b，输出x（原顺序）
+    void Solve(std::vector<double>& x) const;
+
+    // 获取矩阵的阶数
+    uint32_t GetSize() const
+    {
+        return m_size;
+    }
+
+    // 获取L的非零项数（包含对角线）
+    size_t GetFactorNonZeroCount() const
+    {
+        return m_factorRows.size();
+    }
+
+    // 按几何位置做嵌套剖分，得到减少填充的重排序
+    // 沿包围盒较长的方向在中位数处把未知量分成两半，与另一半相连的未知量作为分隔集排在最后，两半递归处理
+    // 参数：
+    //   size - 未知量个数
+    //   adjacencyOffsets - 每个未知量的邻接表在adjacency中的起始位置，末尾额外存放adjacency.size()
+    //   adjacency - 邻接表
+    //   coordinates - 每个未知量的二维位置
+    //   permutation - 输出重排序
+    static void ComputeNestedDissectionOrder(uint32_t size, const std::vector<uint32_t>& adjacencyOffsets,
+        const std::vector<uint32_t>& adjacency, const std::vector<dx::XMFLOAT2>& coordinates, std::vector<uint32_t>& permutation);
+
+private:
+    // 计算L第k行的非零结构（按拓扑顺序存放在m_stack[top, size)中）
+    // 返回：top
+    uint32_t ComputeRowPattern(uint32_t k);
+
+    uint32_t m_size;
+    bool m_factorized;
+
+    // 重排序：新编号到原编号
+    std::vector<uint32_t> m_permutation;
+
+    // 重排序后的上三角矩阵，按列压缩存储
+    std::vector<uint32_t> m_columnOffsets;
+    std::vector<uint32_t> m_rows;
+    std::vector<double> m_values;
+
+    // 每个输入的非零项在m_values中的位置
+    std::vector<uint32_t> m_entryPositions;
+
+    // 消去树
+    std::vector<uint32_t> m_parents;
+
+    // L按列压缩存储，每列的第一个元素是对角线
+    std::vector<uint32_t> m_factorColumnOffsets;
+    std::vector<uint32_t> m_factorRows;
+    std::vector<double> m_factorValues;
+
+    // 分解时的工作区
+    std::vector<uint32_t> m_stack;
+    std::vector<uint32_t> m_marks;
+    std::vector<uint32_t> m_columnFill;
+    std::vector<double> m_workspace;
+};
+
+#endif // SPARSE_CHOLESKY_H
@@ -1,6 +1,7 @@
 #include "Sphere.h"
 #include <DirectXMath.h>
 #include <cmath>
+#include <cstring>
 
 // 为了方便使用，定义一个简化的命名空间别名
 namespace dx = DirectX;
@@ -60,6 +61,24 @@ void Sphere::OnSetupMesh(IRALDevice* device, PrimitiveMesh& mesh)
     );
 }
 
+uint64_t Sphere::GetSharedMeshKey() const
+{
+    // 球体Mesh只由半径和分段数决定，使用FNV-1a把它们组合成键值
+    uint32_t radiusBits = 0;
+    memcpy(&radiusBits, &m_radius, sizeof(radiusBits));
+
+    const uint32_t values[3] = { radiusBits, m_sectors, m_stacks };
+    uint64_t key = 14695981039346656037ull;
+    for (uint32_t value : values)
+    {
+        key ^= value;
+        key *= 1099511628211ull;
+    }
+
+    // 0保留给独立Mesh
+    return key != 0 ? key : 1;
+}
+
 void Sphere::SetRadius(float newRadius)
 {
     if (m_radius != newRadius)
@@ -3,7 +3,7 @@
 
 #include "Mesh.h"
 #include "RALResource.h"
-#include "DX12RALDevice.h"
+#include "IRALDevice.h"
 #include <DirectXMath.h>
 #include <vector>
 #include <cstdint>
@@ -35,6 +35,9 @@ public:
     // 初始化Mesh
     virtual void OnSetupMesh(IRALDevice* device, PrimitiveMesh& mesh) override;
 
+    // 半径和分段数相同的球体共用同一份Mesh
+    virtual uint64_t GetSharedMeshKey() const override;
+
     // 获取球体的顶点位置数据
     const std::vector<dx::XMFLOAT3>& GetPositions() const override
     {
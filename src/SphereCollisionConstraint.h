@@ -9,6 +9,9 @@ namespace dx = DirectX;
 class SphereCollisionConstraint : public Constraint
 {
 public:
+    // 受约束影响的粒子数：单个粒子
+    static const uint32_t kArity = 1;
+
     SphereCollisionConstraint(Particle* p, const dx::XMFLOAT3& center, float radius, float compliance, float damping)
         : Constraint(compliance, damping)
         , m_particle(p)
@@ -61,7 +64,7 @@ public:
 
     virtual uint32_t GetParticlesCount() const override
     {
-        return 1;
+        return kArity;
     }
 
     virtual Particle** GetParticles()
@@ -74,6 +77,38 @@ public:
         return (const Particle**)(&m_particle);
     }
 
+    // 获取碰撞球体的球心（布料局部坐标）
+    const dx::XMFLOAT3& GetSphereCenter() const
+    {
+        return m_sphereCenter;
+    }
+
+    // 获取碰撞球体的半径
+    float GetSphereRadius() const
+    {
+        return m_sphereRadius;
+    }
+
+    // 静止参数：碰撞球体的球心（布料局部坐标）和半径
+    virtual uint32_t GetRestParameterCount() const override
+    {
+        return 4;
+    }
+
+    virtual void GetRestParameters(float* parameters) const override
+    {
+        parameters[0] = m_sphereCenter.x;
+        parameters[1] = m_sphereCenter.y;
+        parameters[2] = m_sphereCenter.z;
+        parameters[3] = m_sphereRadius;
+    }
+
+    virtual void SetRestParameters(const float* parameters) override
+    {
+        m_sphereCenter = dx::XMFLOAT3(parameters[0], parameters[1], parameters[2]);
+        m_sphereRadius = parameters[3];
+    }
+
     virtual const char* GetConstraintType() const override
     {
         return "SphereCollision";
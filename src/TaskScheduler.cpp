@@ -0,0 +1,474 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <string>
+
+extern void logDebug(const std::string& message);
+
+namespace
+{
+    // 当前线程的工作线程索引，主线程以及非工作线程为0
+    thread_local uint32_t t_workerIndex = 0;
+
+    // 当前线程嵌套的SerialTaskScope层数
+    thread_local uint32_t t_serialScopeDepth = 0;
+}
+
+SerialTaskScope::SerialTaskScope()
+{
+    ++t_serialScopeDepth;
+}
+
+SerialTaskScope::~SerialTaskScope()
+{
+    --t_serialScopeDepth;
+}
+
+bool SerialTaskScope::IsActive()
+{
+    return t_serialScopeDepth > 0;
+}
+
+void* ScratchArena::Allocate(size_t size, size_t alignment)
+{
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    while (m_currentBlock < m_blocks.size())
+    {
+        Block& block = m_blocks[m_currentBlock];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        uintptr_t aligned = (base + m_currentOffset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t newOffset = (aligned - base) + size;
+
+        if (newOffset <= block.size)
+        {
+            m_currentOffset = newOffset;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // 当前块空间不足，尝试下一个已有的块
+        ++m_currentBlock;
+        m_currentOffset = 0;
+    }
+
+    // 没有可用的块，申请新块
+    Block block;
+    block.size = (std::max)(kMinBlockSize, size + alignment);
+    block.data.reset(new uint8_t[block.size]);
+    m_blocks.push_back(std::move(block));
+    m_currentBlock = m_blocks.size() - 1;
+    m_currentOffset = 0;
+
+    return Allocate(size, alignment);
+}
+
+TaskGraph::TaskId TaskGraph::AddTask(std::function<void()> function)
+{
+    Node node;
+    node.function = std::move(function);
+    node.predecessorCount = 0;
+    m_nodes.push_back(std::move(node));
+
+    return (TaskId)(m_nodes.size() - 1);
+}
+
+void TaskGraph::AddDependency(TaskId predecessor, TaskId successor)
+{
+    m_nodes[predecessor].successors.push_back(successor);
+    m_nodes[successor].predecessorCount++;
+}
+
+void TaskGraph::Schedule(TaskScheduler& scheduler, TaskId id, std::atomic<uint32_t>* pendingCounts, TaskCounter* counter)
+{
+    scheduler.Submit([this, &scheduler, id, pendingCounts, counter]()
+    {
+        Node& node = m_nodes[id];
+        node.function();
+
+        // 在本任务完成计数之前调度后继任务，保证计数器不会提前归零
+        for (TaskId successor : node.successors)
+        {
+            if (pendingCounts[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                Schedule(scheduler, successor, pendingCounts, counter);
+            }
+        }
+    }, counter);
+}
+
+void TaskGraph::Execute(TaskScheduler& scheduler)
+{
+    if (m_nodes.empty())
+    {
+        return;
+    }
+
+    if (SerialTaskScope::IsActive())
+    {
+        ExecuteSerial();
+        return;
+    }
+
+    std::unique_ptr<std::atomic<uint32_t>[]> pendingCounts(new std::atomic<uint32_t>[m_nodes.size()]);
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        pendingCounts[i].store(m_nodes[i].predecessorCount, std::memory_order_relaxed);
+    }
+
+    TaskCounter counter;
+    bool hasRoot = false;
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i].predecessorCount == 0)
+        {
+            hasRoot = true;
+            Schedule(scheduler, (TaskId)i, pendingCounts.get(), &counter);
+        }
+    }
+
+    if (!hasRoot)
+    {
+        logDebug("TaskGraph::Execute: graph has no root task (cyclic dependencies?)");
+        return;
+    }
+
+    scheduler.Wait(counter);
+}
+
+void TaskGraph::ExecuteSerial()
+{
+    std::vector<uint32_t> pendingCounts(m_nodes.size());
+    std::vector<TaskId> readyTasks;
+    readyTasks.reserve(m_nodes.size());
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        pendingCounts[i] = m_nodes[i].predecessorCount;
+        if (pendingCounts[i] == 0)
+        {
+            readyTasks.push_back((TaskId)i);
+        }
+    }
+
+    if (readyTasks.empty())
+    {
+        logDebug("TaskGraph::Execute: graph has no root task (cyclic dependencies?)");
+        return;
+    }
+
+    // 按就绪的先后顺序执行，每个任务完成后把前驱全部完成的后继加入队尾
+    for (size_t next = 0; next < readyTasks.size(); ++next)
+    {
+        Node& node = m_nodes[readyTasks[next]];
+        node.function();
+
+        for (TaskId successor : node.successors)
+        {
+            if (--pendingCounts[successor] == 0)
+            {
+                readyTasks.push_back(successor);
+            }
+        }
+    }
+}
+
+TaskScheduler& TaskScheduler::Get()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+uint32_t TaskScheduler::GetCurrentWorkerIndex()
+{
+    return t_workerIndex;
+}
+
+TaskScheduler::TaskScheduler()
+    : m_queuedTaskCount(0)
+    , m_shutdown(false)
+{
+    // 未初始化时只有主线程一个工作线程，所有任务在调用线程上执行
+    m_workerQueues.emplace_back(new WorkerQueue());
+    m_scratchArenas.resize(1);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    Shutdown();
+}
+
+void TaskScheduler::Initialize(uint32_t workerCount)
+{
+    Shutdown();
+
+    if (workerCount == 0)
+    {
+        workerCount = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workerQueues.clear();
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        m_workerQueues.emplace_back(new WorkerQueue());
+    }
+
+    m_scratchArenas.clear();
+    m_scratchArenas.resize(workerCount);
+
+    m_shutdown.store(false);
+    m_queuedTaskCount.store(0);
+
+    // 0号工作线程是主线程，只需创建其余的线程
+    for (uint32_t i = 1; i < workerCount; ++i)
+    {
+        m_threads.emplace_back(&TaskScheduler::WorkerMain, this, i);
+    }
+
+    logDebug("TaskScheduler initialized with " + std::to_string(workerCount) + " workers");
+}
+
+void TaskScheduler::Shutdown()
+{
+    if (m_threads.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_shutdown.store(true);
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+
+    // 退出前执行完残留的任务，保证计数器都能归零
+    while (TryRunTask(0))
+    {
+    }
+
+    m_workerQueues.resize(1);
+    m_scratchArenas.resize(1);
+}
+
+void TaskScheduler::Submit(std::function<void()> function, TaskCounter* counter)
+{
+    if (counter)
+    {
+        counter->m_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 单线程时直接执行
+    if (m_threads.empty())
+    {
+        function();
+
+        if (counter)
+        {
+            counter->m_value.fetch_sub(1, std::memory_order_release);
+        }
+        return;
+    }
+
+    Task* task = new Task{ std::move(function), counter };
+
+    uint32_t workerIndex = GetCurrentWorkerIndex();
+    WorkerQueue& queue = *m_workerQueues[workerIndex < m_workerQueues.size() ? workerIndex : 0];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    m_queuedTaskCount.fetch_add(1, std::memory_order_release);
+
+    // 加锁后再通知，避免工作线程在检查条件和进入等待之间错过唤醒
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
+
+void TaskScheduler::Wait(TaskCounter& counter)
+{
+    uint32_t workerIndex = GetCurrentWorkerIndex();
+
+    while (!counter.IsDone())
+    {
+        if (!TryRunTask(workerIndex))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    grainSize = (std::max)(1u, grainSize);
+
+    uint32_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+    if (chunkCount == 1 || m_threads.empty() || SerialTaskScope::IsActive())
+    {
+        for (uint32_t chunkBegin = begin; chunkBegin < end; )
+        {
+            uint32_t chunkEnd = (end - chunkBegin > grainSize) ? chunkBegin + grainSize : end;
+            function(chunkBegin, chunkEnd);
+            chunkBegin = chunkEnd;
+        }
+        return;
+    }
+
+    // 各线程通过原子计数动态领取块，块的边界固定
+    std::atomic<uint32_t> nextChunk(0);
+
+    auto runChunks = [&]()
+    {
+        for (;;)
+        {
+            uint32_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount)
+            {
+                break;
+            }
+
+            uint32_t chunkBegin = begin + chunk * grainSize;
+            uint32_t chunkEnd = (end - chunkBegin > grainSize) ? chunkBegin + grainSize : end;
+            function(chunkBegin, chunkEnd);
+        }
+    };
+
+    TaskCounter counter;
+    uint32_t helperCount = (std::min)(chunkCount - 1, GetWorkerCount() - 1);
+
+    for (uint32_t i = 0; i < helperCount; ++i)
+    {
+        Submit(runChunks, &counter);
+    }
+
+    runChunks();
+
+    Wait(counter);
+}
+
+void TaskScheduler::WorkerMain(uint32_t workerIndex)
+{
+    t_workerIndex = workerIndex;
+
+    while (!m_shutdown.load(std::memory_order_acquire))
+    {
+        if (TryRunTask(workerIndex))
+        {
+            continue;
+        }
+
+        // 短暂自旋，避免求解器每个颜色批次之间频繁休眠/唤醒
+        bool foundTask = false;
+        for (uint32_t spin = 0; spin < kSpinCount; ++spin)
+        {
+            if (m_queuedTaskCount.load(std::memory_order_acquire) > 0)
+            {
+                foundTask = true;
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        if (foundTask)
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this]()
+        {
+            return m_shutdown.load(std::memory_order_acquire) || m_queuedTaskCount.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+bool TaskScheduler::TryRunTask(uint32_t workerIndex)
+{
+    Task* task = PopLocal(workerIndex);
+
+    if (!task)
+    {
+        task = Steal(workerIndex);
+    }
+
+    if (!task)
+    {
+        return false;
+    }
+
+    RunTask(task);
+    return true;
+}
+
+TaskScheduler::Task* TaskScheduler::PopLocal(uint32_t workerIndex)
+{
+    if (workerIndex >= m_workerQueues.size())
+    {
+        return nullptr;
+    }
+
+    WorkerQueue& queue = *m_workerQueues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+    {
+        return nullptr;
+    }
+
+    Task* task = queue.tasks.back();
+    queue.tasks.pop_back();
+    m_queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+
+    return task;
+}
+
+TaskScheduler::Task* TaskScheduler::Steal(uint32_t workerIndex)
+{
+    uint32_t queueCount = (uint32_t)m_workerQueues.size();
+
+    for (uint32_t i = 1; i < queueCount; ++i)
+    {
+        WorkerQueue& queue = *m_workerQueues[(workerIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            Task* task = queue.tasks.front();
+            queue.tasks.pop_front();
+            m_queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+void TaskScheduler::RunTask(Task* task)
+{
+    task->function();
+
+    if (task->counter)
+    {
+        task->counter->m_value.fetch_sub(1, std::memory_order_release);
+    }
+
+    delete task;
+}
@@ -0,0 +1,283 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 线程局部的线性分配器，用于任务内部的临时内存
+// 分配的内存不会调用构造/析构函数，只适合存放POD数据
+class ScratchArena
+{
+public:
+    // 分配位置标记，用于回滚到之前的分配状态
+    struct Marker
+    {
+        size_t blockIndex;
+        size_t offset;
+    };
+
+    ScratchArena()
+        : m_currentBlock(0)
+        , m_currentOffset(0)
+    {
+    }
+
+    // 分配一段对齐的内存
+    // 参数：
+    //   size - 字节数
+    //   alignment - 对齐字节数（2的幂）
+    void* Allocate(size_t size, size_t alignment = 16);
+
+    // 分配一段类型化的数组
+    template<typename T>
+    T* AllocateArray(size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T) < 16 ? 16 : alignof(T)));
+    }
+
+    // 获取当前分配位置
+    Marker GetMarker() const
+    {
+        return Marker{ m_currentBlock, m_currentOffset };
+    }
+
+    // 回滚到指定的分配位置，之后的分配全部失效
+    void ResetToMarker(const Marker& marker)
+    {
+        m_currentBlock = marker.blockIndex;
+        m_currentOffset = marker.offset;
+    }
+
+    // 释放全部分配（保留已申请的内存块以便复用）
+    void Reset()
+    {
+        m_currentBlock = 0;
+        m_currentOffset = 0;
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t kMinBlockSize = 64 * 1024;
+
+    std::vector<Block> m_blocks;
+    size_t m_currentBlock;
+    size_t m_currentOffset;
+};
+
+// 作用域内的临时分配，析构时自动回滚
+class ScratchArenaScope
+{
+public:
+    explicit ScratchArenaScope(ScratchArena& arena)
+        : m_arena(arena)
+        , m_marker(arena.GetMarker())
+    {
+    }
+
+    ~ScratchArenaScope()
+    {
+        m_arena.ResetToMarker(m_marker);
+    }
+
+private:
+    ScratchArenaScope(const ScratchArenaScope&);
+    ScratchArenaScope& operator=(const ScratchArenaScope&);
+
+    ScratchArena& m_arena;
+    ScratchArena::Marker m_marker;
+};
+
+// 任务计数器，提交任务时加一，任务完成时减一，为零表示全部完成
+class TaskCounter
+{
+public:
+    TaskCounter()
+        : m_value(0)
+    {
+    }
+
+    bool IsDone() const
+    {
+        return m_value.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    TaskCounter(const TaskCounter&);
+    TaskCounter& operator=(const TaskCounter&);
+
+    std::atomic<uint32_t> m_value;
+
+    friend class TaskScheduler;
+};
+
+class TaskScheduler;
+
+// 作用域内当前线程发起的ParallelFor和TaskGraph直接在当前线程上顺序执行，不提交任务
+// 块的划分与并行执行时相同，结果逐位一致；用于每个工作线程各自运行一个独立的模拟
+// 只影响构造它的线程，可以嵌套
+class SerialTaskScope
+{
+public:
+    SerialTaskScope();
+    ~SerialTaskScope();
+
+    // 当前线程是否处于顺序执行的作用域内
+    static bool IsActive();
+
+private:
+    SerialTaskScope(const SerialTaskScope&);
+    SerialTaskScope& operator=(const SerialTaskScope&);
+};
+
+// 带依赖关系的任务图
+// 所有任务添加完成后调用Execute执行，前驱任务全部完成后才会调度后继任务
+// 任务图必须是无环的
+class TaskGraph
+{
+public:
+    typedef uint32_t TaskId;
+
+    // 添加一个任务
+    // 返回：任务ID，用于建立依赖关系
+    TaskId AddTask(std::function<void()> function);
+
+    // 添加依赖：successor在predecessor完成之后执行
+    void AddDependency(TaskId predecessor, TaskId successor);
+
+    // 执行任务图，阻塞直到全部任务完成（等待期间当前线程也参与执行任务）
+    // 在SerialTaskScope内按依赖顺序在当前线程上执行
+    void Execute(TaskScheduler& scheduler);
+
+    // 清除所有任务
+    void Clear()
+    {
+        m_nodes.clear();
+    }
+
+    size_t GetTaskCount() const
+    {
+        return m_nodes.size();
+    }
+
+private:
+    struct Node
+    {
+        std::function<void()> function;
+        std::vector<TaskId> successors;
+        uint32_t predecessorCount;
+    };
+
+    void Schedule(TaskScheduler& scheduler, TaskId id, std::atomic<uint32_t>* pendingCounts, TaskCounter* counter);
+
+    // 在当前线程上按依赖顺序执行所有任务
+    void ExecuteSerial();
+
+    std::vector<Node> m_nodes;
+};
+
+// 工作窃取式任务调度器
+// 每个工作线程拥有自己的任务队列，本地从队尾取任务，空闲时从其他线程队首窃取
+// 主线程是0号工作线程，在等待任务完成期间也会执行任务
+// 全局共享一个实例（TaskScheduler::Get()），所有并行路径都应使用它而不是自行创建线程
+class TaskScheduler
+{
+public:
+    typedef std::function<void(uint32_t begin, uint32_t end)> RangeFunction;
+
+    // 获取全局调度器
+    static TaskScheduler& Get();
+
+    // 获取当前线程的工作线程索引（非工作线程返回0）
+    static uint32_t GetCurrentWorkerIndex();
+
+    TaskScheduler();
+    ~TaskScheduler();
+
+    // 初始化工作线程
+    // 参数：
+    //   workerCount - 工作线程总数（包含主线程），0表示使用硬件线程数
+    void Initialize(uint32_t workerCount);
+
+    // 停止并销毁所有工作线程
+    void Shutdown();
+
+    // 获取工作线程总数（包含主线程）
+    uint32_t GetWorkerCount() const
+    {
+        return (uint32_t)m_workerQueues.size();
+    }
+
+    // 提交一个任务
+    // 参数：
+    //   function - 任务函数
+    //   counter - 可选的计数器，任务完成时递减
+    void Submit(std::function<void()> function, TaskCounter* counter = nullptr);
+
+    // 等待计数器归零，等待期间当前线程执行其他任务
+    void Wait(TaskCounter& counter);
+
+    // 并行执行[begin, end)区间，按grainSize切分成固定大小的块
+    // 块的划分只取决于区间和grainSize，与线程数无关
+    // 在SerialTaskScope内按顺序在当前线程上执行所有块
+    void ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function);
+
+    // 获取当前工作线程的临时分配器
+    ScratchArena& GetScratchArena()
+    {
+        return m_scratchArenas[GetCurrentWorkerIndex() < m_scratchArenas.size() ? GetCurrentWorkerIndex() : 0];
+    }
+
+private:
+    struct Task
+    {
+        std::function<void()> function;
+        TaskCounter* counter;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task*> tasks;
+    };
+
+    // 工作线程主循环
+    void WorkerMain(uint32_t workerIndex);
+
+    // 尝试执行一个任务（优先本地队列，其次窃取）
+    // 返回：是否执行了任务
+    bool TryRunTask(uint32_t workerIndex);
+
+    // 从本地队列尾部取任务
+    Task* PopLocal(uint32_t workerIndex);
+
+    // 从其他队列头部窃取任务
+    Task* Steal(uint32_t workerIndex);
+
+    void RunTask(Task* task);
+
+    // 空闲工作线程在休眠前自旋尝试取任务的次数
+    static const uint32_t kSpinCount = 2048;
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_workerQueues;
+    std::vector<ScratchArena> m_scratchArenas;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<uint32_t> m_queuedTaskCount;
+    std::atomic<bool> m_shutdown;
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,262 @@
+#include "XPBDDirectSolver.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+extern void logDebug(const std::string& message);
+
+bool XPBDDirectSolver::Build(const std::vector<Particle>& particles, const std::vector<DistanceConstraint>& constraints, const std::vector<dx::XMFLOAT2>& particleCoordinates)
+{
+    Clear();
+
+    const Particle* particlesBegin = particles.data();
+    const uint32_t particleCount = (uint32_t)particles.size();
+    const uint32_t constraintCount = (uint32_t)constraints.size();
+
+    if (constraintCount == 0 || particleCoordinates.size() != particleCount)
+    {
+        return false;
+    }
+
+    // 1. 每个可移动粒子关联的约束
+    m_constraintParticles.resize(constraintCount * 2);
+    std::vector<uint32_t> particleOffsets(particleCount + 1, 0);
+
+    for (uint32_t i = 0; i < constraintCount; ++i)
+    {
+        const Particle** constraintParticles = constraints[i].GetParticles();
+
+        for (uint32_t k = 0; k < 2; ++k)
+        {
+            uint32_t particle = (uint32_t)(constraintParticles[k] - particlesBegin);
+            if (particle >= particleCount)
+            {
+                logDebug("XPBDDirectSolver::Build: constraint references a particle outside the cloth");
+                Clear();
+                return false;
+            }
+
+            m_constraintParticles[i * 2 + k] = particle;
+            if (!particles[particle].isStatic)
+            {
+                particleOffsets[particle + 1]++;
+            }
+        }
+    }
+
+    for (uint32_t p = 0; p < particleCount; ++p)
+    {
+        particleOffsets[p + 1] += particleOffsets[p];
+    }
+
+    // 按约束编号顺序填入，保证同一粒子的约束列表有序
+    std::vector<uint32_t> particleConstraints(particleOffsets[particleCount]);
+    std::vector<uint32_t> fill(particleOffsets.begin(), particleOffsets.end() - 1);
+
+    for (uint32_t i = 0; i < constraintCount * 2; ++i)
+    {
+        uint32_t particle = m_constraintParticles[i];
+        if (!particles[particle].isStatic)
+        {
+            particleConstraints[fill[particle]++] = i;
+        }
+    }
+
+    // 2. 共享同一个可移动粒子的两个约束之间有耦合项
+    //    约束i对粒子1的梯度为n_i，对粒子2的梯度为-n_i，耦合项为w_p * s_i * s_j * (n_i · n_j)
+    for (uint32_t p = 0; p < particleCount; ++p)
+    {
+        for (uint32_t a = particleOffsets[p]; a < particleOffsets[p + 1]; ++a)
+        {
+            for (uint32_t b = a + 1; b < particleOffsets[p + 1]; ++b)
+            {
+                uint32_t slot1 = particleConstraints[a];
+                uint32_t slot2 = particleConstraints[b];
+                float sign1 = (slot1 & 1) ? -1.0f : 1.0f;
+                float sign2 = (slot2 & 1) ? -1.0f : 1.0f;
+
+                m_couplings.push_back({ slot1 >> 1, slot2 >> 1, p, sign1 * sign2 });
+            }
+        }
+    }
+
+    // 3. 矩阵非零项和约束图
+    const size_t entryCount = constraintCount + m_couplings.size();
+    std::vector<uint32_t> entryRows(entryCount);
+    std::vector<uint32_t> entryColumns(entryCount);
+    std::vector<uint32_t> adjacencyOffsets(constraintCount + 1, 0);
+
+    for (uint32_t i = 0; i < constraintCount; ++i)
+    {
+        entryRows[i] = i;
+        entryColumns[i] = i;
+    }
+
+    for (size_t c = 0; c < m_couplings.size(); ++c)
+    {
+        entryRows[constraintCount + c] = m_couplings[c].constraint1;
+        entryColumns[constraintCount + c] = m_couplings[c].constraint2;
+        adjacencyOffsets[m_couplings[c].constraint1 + 1]++;
+        adjacencyOffsets[m_couplings[c].constraint2 + 1]++;
+    }
+
+    for (uint32_t i = 0; i < constraintCount; ++i)
+    {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+
+    std::vector<uint32_t> adjacency(adjacencyOffsets[constraintCount]);
+    std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+    for (const Coupling& coupling : m_couplings)
+    {
+        adjacency[adjacencyFill[coupling.constraint1]++] = coupling.constraint2;
+        adjacency[adjacencyFill[coupling.constraint2]++] = coupling.constraint1;
+    }
+
+    // 4. 以约束两端粒子布局坐标的中点作为约束的位置，按嵌套剖分重排序后做符号分析
+    std::vector<dx::XMFLOAT2> coordinates(constraintCount);
+    for (uint32_t i = 0; i < constraintCount; ++i)
+    {
+        uint32_t particle1 = m_constraintParticles[i * 2];
+        uint32_t particle2 = m_constraintParticles[i * 2 + 1];
+
+        coordinates[i].x = 0.5f * (particleCoordinates[particle1].x + particleCoordinates[particle2].x);
+        coordinates[i].y = 0.5f * (particleCoordinates[particle1].y + particleCoordinates[particle2].y);
+    }
+
+    std::vector<uint32_t> permutation;
+    SparseCholesky::ComputeNestedDissectionOrder(constraintCount, adjacencyOffsets, adjacency, coordinates, permutation);
+
+    if (!m_cholesky.Analyze(constraintCount, entryRows, entryColumns, permutation))
+    {
+        Clear();
+        return false;
+    }
+
+    m_entryValues.resize(entryCount);
+    m_gradients.resize(constraintCount);
+    m_rhs.resize(constraintCount);
+    m_valid = true;
+
+    logDebug("XPBDDirectSolver: " + std::to_string(constraintCount) + " constraints, " + std::to_string(m_couplings.size())
+        + " couplings, factor non-zeros " + std::to_string(m_cholesky.GetFactorNonZeroCount()));
+
+    return true;
+}
+
+void XPBDDirectSolver::Clear()
+{
+    m_valid = false;
+    m_constraintParticles.clear();
+    m_couplings.clear();
+    m_entryValues.clear();
+    m_gradients.clear();
+    m_rhs.clear();
+}
+
+bool XPBDDirectSolver::Solve(std::vector<Particle>& particles, const std::vector<DistanceConstraint>& constraints, SolverReal* lambdas,
+    float deltaTime, ClothConstraintResidual& residual)
+{
+    const uint32_t constraintCount = (uint32_t)m_gradients.size();
+
+    if (!m_valid || constraints.size() != constraintCount)
+    {
+        return false;
+    }
+
+    // 固定或休眠的粒子不移动，质量倒数视为0
+    auto inverseMass = [&particles](uint32_t index)
+    {
+        const Particle& particle = particles[index];
+        return (particle.isStatic || particle.isSleeping) ? 0.0f : particle.inverseMass;
+    };
+
+    const SolverReal dt = (SolverReal)deltaTime;
+    float maxError = 0.0f;
+    double sumSquares = 0.0;
+
+    // 1. 约束值、梯度、右端项和对角项
+    for (uint32_t i = 0; i < constraintCount; ++i)
+    {
+        dx::XMFLOAT3 gradients[2];
+        const SolverReal C = (SolverReal)constraints[i].ComputeConstraintAndGradient(gradients);
+        m_gradients[i] = gradients[0];
+
+        // 与迭代求解相同，柔度项有上限
+        SolverReal alphaTilde = (SolverReal)constraints[i].GetCompliance() / (dt * dt);
+        if (alphaTilde > SolverPrecision::kMaxAlphaTilde)
+        {
+            alphaTilde = SolverPrecision::kMaxAlphaTilde;
+        }
+
+        SolverReal diagonal = (SolverReal)inverseMass(m_constraintParticles[i * 2]) + (SolverReal)inverseMass(m_constraintParticles[i * 2 + 1]);
+        SolverReal rhs = -C - alphaTilde * lambdas[i];
+
+        float error = (float)std::abs(rhs);
+        maxError = (std::max)(maxError, error);
+        sumSquares += (double)error * error;
+
+        // 两端都不能移动的约束与其他约束没有耦合，Δλ保持为0
+        if (diagonal <= 0)
+        {
+            diagonal = 1;
+            rhs = 0;
+        }
+
+        m_entryValues[i] = (double)(diagonal + alphaTilde);
+        m_rhs[i] = (double)rhs;
+    }
+
+    residual.constraintCount = constraintCount;
+    residual.maxError = maxError;
+    residual.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+
+    // 2. 耦合项
+    for (size_t c = 0; c < m_couplings.size(); ++c)
+    {
+        const Coupling& coupling = m_couplings[c];
+        dx::XMVECTOR gradient1 = dx::XMLoadFloat3(&m_gradients[coupling.constraint1]);
+        dx::XMVECTOR gradient2 = dx::XMLoadFloat3(&m_gradients[coupling.constraint2]);
+        float dot = dx::XMVectorGetX(dx::XMVector3Dot(gradient1, gradient2));
+
+        m_entryValues[constraintCount + c] = (double)((SolverReal)inverseMass(coupling.particle) * (SolverReal)coupling.sign * (SolverReal)dot);
+    }
+
+    // 3. 数值分解并求解Δλ
+    if (!m_cholesky.Factorize(m_entryValues))
+    {
+        return false;
+    }
+
+    m_cholesky.Solve(m_rhs);
+
+    // 4. 更新乘子和位置：Δx = M^-1 * J^T * Δλ
+    for (uint32_t i = 0; i < constraintCount; ++i)
+    {
+        const SolverReal deltaLambda = (SolverReal)m_rhs[i];
+        if (deltaLambda == 0)
+        {
+            continue;
+        }
+
+        lambdas[i] += deltaLambda;
+
+        dx::XMVECTOR gradient = dx::XMLoadFloat3(&m_gradients[i]);
+
+        for (uint32_t k = 0; k < 2; ++k)
+        {
+            uint32_t index = m_constraintParticles[i * 2 + k];
+            float weight = inverseMass(index);
+
+            if (weight > 0.0f)
+            {
+                float scale = (float)deltaLambda * weight * (k == 0 ? 1.0f : -1.0f);
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particles[index].position);
+                dx::XMStoreFloat3(&particles[index].position, dx::XMVectorAdd(pos, dx::XMVectorScale(gradient, scale)));
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef XPBD_DIRECT_SOLVER_H
+#define XPBD_DIRECT_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "Particle.h"
+#include "DistanceConstraint.h"
+#include "SparseCholesky.h"
+#include "IClothSolver.h"
+#include "SolverPrecision.h"
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 距离约束的直接求解器
+// 把所有距离约束作为一个整体，每次求解组装(J * M^-1 * J^T + α̃) * Δλ = -(C + α̃ * λ)并用稀疏Cholesky分解直接求解，
+// 相当于对约束做一次牛顿步，然后按Δx = M^-1 * J^T * Δλ更新位置。
+// 约束拓扑不变时矩阵的非零结构不变，重排序和符号分析只在约束变化后做一次，每次求解只重新做数值分解。
+// 约束的阻尼项不参与直接求解。
+// 矩阵元素和乘子增量与迭代求解一样使用SolverReal计算，只有稀疏Cholesky分解和回代始终使用double。
+// 几乎不可拉伸的布料（柔度1e-8）通常1~2次求解即可收敛，而高斯-赛德尔迭代很难完全收敛
+class XPBDDirectSolver
+{
+public:
+    XPBDDirectSolver()
+        : m_valid(false)
+    {
+    }
+
+    // 根据约束拓扑建立矩阵的非零结构并做符号分析
+    // 参数：
+    //   particles - 粒子（固定粒子不产生耦合项）
+    //   constraints - 距离约束
+    //   particleCoordinates - 粒子的二维布局坐标（规则网格为网格坐标），用于按位置计算重排序
+    // 返回：是否成功
+    bool Build(const std::vector<Particle>& particles, const std::vector<DistanceConstraint>& constraints, const std::vector<dx::XMFLOAT2>& particleCoordinates);
+
+    // 清除矩阵结构
+    void Clear();
+
+    // 是否已建立矩阵结构
+    bool IsValid() const
+    {
+        return m_valid;
+    }
+
+    // 做一次全局求解
+    // 参数：
+    //   particles - 粒子，固定或休眠的粒子不移动
+    //   constraints - 距离约束，必须与Build时一致
+    //   lambdas - 距离约束的拉格朗日乘子
+    //   deltaTime - 子步时间步长
+    //   residual - 输出求解前的残差|C + α̃λ|
+    // 返回：是否成功（分解失败时不修改粒子）
+    bool Solve(std::vector<Particle>& particles, const std::vector<DistanceConstraint>& constraints, SolverReal* lambdas,
+        float deltaTime, ClothConstraintResidual& residual);
+
+    // 获取分解因子的非零项数
+    size_t GetFactorNonZeroCount() const
+    {
+        return m_cholesky.GetFactorNonZeroCount();
+    }
+
+private:
+    // 非对角项：两个约束共享一个可移动粒子
+    struct Coupling
+    {
+        uint32_t constraint1;
+        uint32_t constraint2;
+        uint32_t particle;  // 共享的粒子
+        float sign;         // 两个约束对该粒子梯度方向的符号乘积
+    };
+
+    bool m_valid;
+
+    // 每个约束的两个粒子索引
+    std::vector<uint32_t> m_constraintParticles;
+
+    std::vector<Coupling> m_couplings;
+
+    // 矩阵的非零项：前面是每个约束的对角项，后面是每个耦合项
+    std::vector<double> m_entryValues;
+
+    // 每个约束的梯度方向（粒子1的梯度，粒子2的梯度为其相反方向）
+    std::vector<dx::XMFLOAT3> m_gradients;
+
+    // 右端项，求解后为Δλ
+    std::vector<double> m_rhs;
+
+    SparseCholesky m_cholesky;
+};
+
+#endif // XPBD_DIRECT_SOLVER_H
@@ -0,0 +1,276 @@
+#include "XPBDMultigrid.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+extern void logDebug(const std::string& message);
+
+// 并行求解粗网格边时每个任务块的边数
+static const uint32_t kEdgeGrainSize = 256;
+
+// 插值修正时每个任务块的行数
+static const uint32_t kProlongationRowGrainSize = 8;
+
+// 粗网格的边按方向和节点奇偶分成8种颜色
+static const uint32_t kEdgeColorCount = 8;
+
+void XPBDMultigrid::BuildAxisMapping(int resolution, uint32_t stride, AxisMapping& mapping)
+{
+    const uint32_t last = (uint32_t)resolution - 1;
+
+    mapping.nodes.clear();
+    for (uint32_t i = 0; i < last; i += stride)
+    {
+        mapping.nodes.push_back(i);
+    }
+    mapping.nodes.push_back(last);
+
+    mapping.cells.resize(resolution);
+    mapping.weights.resize(resolution);
+    mapping.isNode.assign(resolution, 0);
+
+    const uint32_t lastCell = (uint32_t)mapping.nodes.size() - 2;
+
+    for (uint32_t i = 0; i < (uint32_t)resolution; ++i)
+    {
+        // 除了最后一个单元（可能比抽样间隔短），每个单元都覆盖stride个细网格行/列
+        uint32_t cell = (std::min)(i / stride, lastCell);
+        uint32_t left = mapping.nodes[cell];
+        uint32_t right = mapping.nodes[cell + 1];
+
+        mapping.cells[i] = cell;
+        mapping.weights[i] = (float)(i - left) / (float)(right - left);
+    }
+
+    for (uint32_t node : mapping.nodes)
+    {
+        mapping.isNode[node] = 1;
+    }
+}
+
+void XPBDMultigrid::Build(int widthResolution, int heightResolution, float stepW, float stepH, uint32_t levelCount)
+{
+    Clear();
+
+    m_widthResolution = widthResolution;
+    m_heightResolution = heightResolution;
+    m_requestedLevelCount = levelCount;
+
+    if (widthResolution < 2 || heightResolution < 2)
+    {
+        return;
+    }
+
+    size_t maxNodeCount = 0;
+
+    for (uint32_t levelIndex = 1; levelIndex <= levelCount && levelIndex < 31; ++levelIndex)
+    {
+        Level level;
+        level.stride = 1u << levelIndex;
+
+        BuildAxisMapping(widthResolution, level.stride, level.columns);
+        BuildAxisMapping(heightResolution, level.stride, level.rows);
+
+        // 每个方向至少要有两个单元，否则这一层已经不能比上一层更粗
+        const uint32_t columnCount = (uint32_t)level.columns.nodes.size();
+        const uint32_t rowCount = (uint32_t)level.rows.nodes.size();
+
+        if (columnCount < 3 || rowCount < 3)
+        {
+            break;
+        }
+
+        // 节点(c,r)对应的细网格粒子
+        auto particleIndex = [&level, widthResolution](uint32_t c, uint32_t r)
+        {
+            return level.rows.nodes[r] * (uint32_t)widthResolution + level.columns.nodes[c];
+        };
+
+        auto restLength = [&level, stepW, stepH](uint32_t c1, uint32_t r1, uint32_t c2, uint32_t r2)
+        {
+            float dw = ((float)level.columns.nodes[c2] - (float)level.columns.nodes[c1]) * stepW;
+            float dh = ((float)level.rows.nodes[r2] - (float)level.rows.nodes[r1]) * stepH;
+            return std::sqrt(dw * dw + dh * dh);
+        };
+
+        // 横边、竖边、两个方向的对角边；同方向的两条边只有在沿该方向相邻时才共享节点，按奇偶分色即可
+        std::vector<Edge> colorEdges[kEdgeColorCount];
+
+        for (uint32_t r = 0; r < rowCount; ++r)
+        {
+            for (uint32_t c = 0; c < columnCount; ++c)
+            {
+                if (c + 1 < columnCount)
+                {
+                    colorEdges[0 + (c & 1)].push_back({ particleIndex(c, r), particleIndex(c + 1, r), restLength(c, r, c + 1, r) });
+                }
+
+                if (r + 1 < rowCount)
+                {
+                    colorEdges[2 + (r & 1)].push_back({ particleIndex(c, r), particleIndex(c, r + 1), restLength(c, r, c, r + 1) });
+                }
+
+                if (c + 1 < columnCount && r + 1 < rowCount)
+                {
+                    colorEdges[4 + (c & 1)].push_back({ particleIndex(c, r), particleIndex(c + 1, r + 1), restLength(c, r, c + 1, r + 1) });
+                    colorEdges[6 + (c & 1)].push_back({ particleIndex(c + 1, r), particleIndex(c, r + 1), restLength(c + 1, r, c, r + 1) });
+                }
+            }
+        }
+
+        for (uint32_t color = 0; color < kEdgeColorCount; ++color)
+        {
+            level.colorOffsets.push_back((uint32_t)level.edges.size());
+            level.edges.insert(level.edges.end(), colorEdges[color].begin(), colorEdges[color].end());
+        }
+        level.colorOffsets.push_back((uint32_t)level.edges.size());
+
+        maxNodeCount = (std::max)(maxNodeCount, (size_t)columnCount * rowCount);
+
+        logDebug("XPBDMultigrid: level " + std::to_string(levelIndex) + " " + std::to_string(columnCount) + "x" + std::to_string(rowCount)
+            + " nodes, " + std::to_string(level.edges.size()) + " edges");
+
+        m_levels.push_back(std::move(level));
+    }
+
+    m_nodeDisplacements.resize(maxNodeCount);
+}
+
+void XPBDMultigrid::Clear()
+{
+    m_levels.clear();
+    m_nodeDisplacements.clear();
+    m_widthResolution = 0;
+    m_heightResolution = 0;
+    m_requestedLevelCount = 0;
+}
+
+void XPBDMultigrid::Solve(std::vector<Particle>& particles, uint32_t iterationCount)
+{
+    if (m_levels.empty() || iterationCount == 0 || particles.size() != (size_t)m_widthResolution * m_heightResolution)
+    {
+        return;
+    }
+
+    // 从最粗的层级开始，每一层都在更粗层级插值后的位置上继续求解
+    for (size_t i = m_levels.size(); i-- > 0; )
+    {
+        const Level& level = m_levels[i];
+        const uint32_t columnCount = (uint32_t)level.columns.nodes.size();
+        const uint32_t rowCount = (uint32_t)level.rows.nodes.size();
+
+        for (uint32_t r = 0; r < rowCount; ++r)
+        {
+            for (uint32_t c = 0; c < columnCount; ++c)
+            {
+                m_nodeDisplacements[r * columnCount + c] = particles[level.rows.nodes[r] * (size_t)m_widthResolution + level.columns.nodes[c]].position;
+            }
+        }
+
+        SolveLevel(level, particles, iterationCount);
+
+        for (uint32_t r = 0; r < rowCount; ++r)
+        {
+            for (uint32_t c = 0; c < columnCount; ++c)
+            {
+                dx::XMFLOAT3& displacement = m_nodeDisplacements[r * columnCount + c];
+                const dx::XMFLOAT3& position = particles[level.rows.nodes[r] * (size_t)m_widthResolution + level.columns.nodes[c]].position;
+
+                dx::XMStoreFloat3(&displacement, dx::XMVectorSubtract(dx::XMLoadFloat3(&position), dx::XMLoadFloat3(&displacement)));
+            }
+        }
+
+        ProlongateLevel(level, particles);
+    }
+}
+
+void XPBDMultigrid::SolveLevel(const Level& level, std::vector<Particle>& particles, uint32_t iterationCount)
+{
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    const Edge* edges = level.edges.data();
+    Particle* particlesData = particles.data();
+
+    for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+    {
+        for (size_t color = 0; color + 1 < level.colorOffsets.size(); ++color)
+        {
+            scheduler.ParallelFor(level.colorOffsets[color], level.colorOffsets[color + 1], kEdgeGrainSize, [edges, particlesData](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    const Edge& edge = edges[i];
+                    Particle& particle1 = particlesData[edge.particle1];
+                    Particle& particle2 = particlesData[edge.particle2];
+
+                    float w1 = (particle1.isStatic || particle1.isSleeping) ? 0.0f : particle1.inverseMass;
+                    float w2 = (particle2.isStatic || particle2.isSleeping) ? 0.0f : particle2.inverseMass;
+
+                    if (w1 + w2 <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    dx::XMVECTOR pos1 = dx::XMLoadFloat3(&particle1.position);
+                    dx::XMVECTOR pos2 = dx::XMLoadFloat3(&particle2.position);
+                    dx::XMVECTOR diff = dx::XMVectorSubtract(pos1, pos2);
+                    float distance = dx::XMVectorGetX(dx::XMVector3Length(diff));
+
+                    // 粗网格的边只限制拉伸：两个节点之间的细网格可以弯曲或褶皱，节点间距小于静止长度是正常的
+                    float C = distance - edge.restLength;
+                    if (C <= 0.0f || distance < 1e-9f)
+                    {
+                        continue;
+                    }
+
+                    dx::XMVECTOR correction = dx::XMVectorScale(diff, C / (distance * (w1 + w2)));
+
+                    dx::XMStoreFloat3(&particle1.position, dx::XMVectorSubtract(pos1, dx::XMVectorScale(correction, w1)));
+                    dx::XMStoreFloat3(&particle2.position, dx::XMVectorAdd(pos2, dx::XMVectorScale(correction, w2)));
+                }
+            });
+        }
+    }
+}
+
+void XPBDMultigrid::ProlongateLevel(const Level& level, std::vector<Particle>& particles)
+{
+    const int width = m_widthResolution;
+    const uint32_t columnCount = (uint32_t)level.columns.nodes.size();
+    const dx::XMFLOAT3* displacements = m_nodeDisplacements.data();
+    Particle* particlesData = particles.data();
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)m_heightResolution, kProlongationRowGrainSize,
+        [&level, width, columnCount, displacements, particlesData](uint32_t rowBegin, uint32_t rowEnd)
+    {
+        for (uint32_t h = rowBegin; h < rowEnd; ++h)
+        {
+            const uint32_t row = level.rows.cells[h];
+            const dx::XMVECTOR rowWeight = dx::XMVectorReplicate(level.rows.weights[h]);
+            const dx::XMFLOAT3* rowDisplacements0 = displacements + row * columnCount;
+            const dx::XMFLOAT3* rowDisplacements1 = rowDisplacements0 + columnCount;
+            const bool nodeRow = level.rows.isNode[h] != 0;
+
+            for (uint32_t w = 0; w < (uint32_t)width; ++w)
+            {
+                Particle& particle = particlesData[(size_t)h * width + w];
+
+                // 节点已经在本层求解中移动过
+                if ((nodeRow && level.columns.isNode[w]) || particle.isStatic || particle.isSleeping)
+                {
+                    continue;
+                }
+
+                const uint32_t column = level.columns.cells[w];
+                const dx::XMVECTOR columnWeight = dx::XMVectorReplicate(level.columns.weights[w]);
+
+                // 双线性插值单元四个角节点的位移
+                dx::XMVECTOR top = dx::XMVectorLerpV(dx::XMLoadFloat3(&rowDisplacements0[column]), dx::XMLoadFloat3(&rowDisplacements0[column + 1]), columnWeight);
+                dx::XMVECTOR bottom = dx::XMVectorLerpV(dx::XMLoadFloat3(&rowDisplacements1[column]), dx::XMLoadFloat3(&rowDisplacements1[column + 1]), columnWeight);
+                dx::XMVECTOR displacement = dx::XMVectorLerpV(top, bottom, rowWeight);
+
+                dx::XMStoreFloat3(&particle.position, dx::XMVectorAdd(dx::XMLoadFloat3(&particle.position), displacement));
+            }
+        }
+    });
+}
@@ -0,0 +1,106 @@
+#ifndef XPBD_MULTIGRID_H
+#define XPBD_MULTIGRID_H
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "Particle.h"
+
+// 为了方便使用，创建一个命名空间别名
+namespace dx = DirectX;
+
+// 布料网格的多层级求解器
+// 在细网格之上按2倍抽样建立若干粗网格层级，粗网格的节点就是细网格中对应行列的粒子，
+// 粗网格的边是连接相邻节点的单向距离约束（只限制拉伸），静止长度按网格间距计算。
+// 每个子步在细网格迭代之前从最粗的层级开始求解，求解后把节点的位移双线性插值到其余的粒子，
+// 使整体的拉伸在几次迭代内传播到整块布料，细网格的高斯-赛德尔迭代只需处理局部误差
+class XPBDMultigrid
+{
+public:
+    XPBDMultigrid()
+        : m_widthResolution(0)
+        , m_heightResolution(0)
+        , m_requestedLevelCount(0)
+    {
+    }
+
+    // 建立粗网格层级
+    // 参数：
+    //   widthResolution - 细网格宽度方向的粒子数
+    //   heightResolution - 细网格高度方向的粒子数
+    //   stepW - 细网格宽度方向的粒子间距
+    //   stepH - 细网格高度方向的粒子间距
+    //   levelCount - 粗网格层级数，网格太小时自动减少
+    void Build(int widthResolution, int heightResolution, float stepW, float stepH, uint32_t levelCount);
+
+    // 清除所有层级
+    void Clear();
+
+    // 是否需要按新的参数重新建立层级
+    bool NeedsRebuild(int widthResolution, int heightResolution, uint32_t levelCount) const
+    {
+        return widthResolution != m_widthResolution || heightResolution != m_heightResolution || levelCount != m_requestedLevelCount;
+    }
+
+    // 获取实际建立的层级数
+    uint32_t GetLevelCount() const
+    {
+        return (uint32_t)m_levels.size();
+    }
+
+    // 从最粗的层级开始依次求解，并把每一层的修正插值到细网格
+    // 参数：
+    //   particles - 细网格的粒子，固定或休眠的粒子不移动
+    //   iterationCount - 每一层的迭代次数
+    void Solve(std::vector<Particle>& particles, uint32_t iterationCount);
+
+private:
+    // 粗网格的边（单向距离约束）
+    struct Edge
+    {
+        uint32_t particle1;     // 细网格粒子索引
+        uint32_t particle2;
+        float restLength;       // 静止长度
+    };
+
+    // 细网格的一行或一列到粗网格单元的映射
+    struct AxisMapping
+    {
+        std::vector<uint32_t> nodes;    // 粗网格节点所在的细网格行/列
+        std::vector<uint32_t> cells;    // 每个细网格行/列所在的粗网格单元（左侧节点的编号）
+        std::vector<float> weights;     // 每个细网格行/列在单元内的插值权重（右侧节点的权重）
+        std::vector<uint8_t> isNode;    // 每个细网格行/列是否为粗网格节点
+    };
+
+    // 一个粗网格层级
+    struct Level
+    {
+        uint32_t stride;                    // 相对细网格的抽样间隔
+        AxisMapping columns;
+        AxisMapping rows;
+        std::vector<Edge> edges;            // 按颜色排序的边，同一颜色的边不共享节点
+        std::vector<uint32_t> colorOffsets; // 每种颜色在edges中的起始位置，末尾额外存放edges.size()
+    };
+
+    // 按抽样间隔建立一个方向的映射，首尾的行/列总是节点
+    static void BuildAxisMapping(int resolution, uint32_t stride, AxisMapping& mapping);
+
+    // 求解一个层级的边约束
+    void SolveLevel(const Level& level, std::vector<Particle>& particles, uint32_t iterationCount);
+
+    // 把层级节点本次的位移插值到非节点的粒子
+    void ProlongateLevel(const Level& level, std::vector<Particle>& particles);
+
+    int m_widthResolution;
+    int m_heightResolution;
+    uint32_t m_requestedLevelCount;
+
+    // 从细到粗排列的层级
+    std::vector<Level> m_levels;
+
+    // 求解当前层级之前节点的位置，求解后转换为节点的位移
+    std::vector<dx::XMFLOAT3> m_nodeDisplacements;
+};
+
+#endif // XPBD_MULTIGRID_H
@@ -1,187 +1,1300 @@
 #include "XPBDSolver.h"
 #include "Cloth.h"
-#include "AutoMem.h"
+#include "TaskScheduler.h"
+#include "ClothCheckpoint.h"
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <cfloat>
+#include <atomic>
+#include <type_traits>
 
-#ifdef DEBUG_SOLVER
 extern void logDebug(const std::string& message);
+
+// 粒子阶段（预测、速度更新）每个任务处理的粒子数
+static const uint32_t kParticleGrainSize = 1024;
+
+#ifdef DEBUG_SOLVER
+// 调试模式下日志需要按顺序输出，约束串行求解
+static const uint32_t kConstraintGrainSize = UINT32_MAX;
+#else
+// 约束求解每个任务处理的约束数
+static const uint32_t kConstraintGrainSize = 256;
 #endif//DEBUG_SOLVER
 
-void XPBDSolver::BeginStep()
+// 贪心着色的最大颜色数，超出的约束放入最后一组串行求解
+static const uint32_t kMaxColorCount = 64;
+
+// Chebyshev加速：前几次迭代不外推，用于估计谱半径
+static const uint32_t kChebyshevDelay = 2;
+
+// Chebyshev加速的谱半径和外推系数上限，防止估计偏大时发散
+static const float kChebyshevMaxSpectralRadius = 0.95f;
+static const float kChebyshevMaxOmega = 1.7f;
+
+// 谱半径估计的指数平滑系数
+static const float kSpectralRadiusSmoothing = 0.2f;
+
+namespace
+{
+    // 每个求解任务块的残差累积，块之间按固定顺序合并，结果与线程数无关
+    struct ChunkResidual
+    {
+        float maxError;
+        double sumSquares;
+    };
+}
+
+void XPBDSolver::BeginStep()
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            particles[i].positionInitial = particles[i].position;
+        }
+    });
+}
+
+void XPBDSolver::PredictPositions(float deltaTime)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const dx::XMFLOAT3 gravity = m_cloth->m_gravity;
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, &gravity, deltaTime](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+
+            if (!particle.isStatic && !particle.isSleeping)
+            {
+                // 保存当前位置作为旧位置
+                particle.oldPosition = particle.position;
+
+                // 应用重力
+                particle.ApplyForce(gravity);
+
+                // 将粒子的位置和速度转换为XMVECTOR进行计算
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR vel = dx::XMLoadFloat3(&particle.velocity);
+                dx::XMVECTOR force = dx::XMLoadFloat3(&particle.force);
+
+                // 预测新位置（使用显式欧拉积分）
+                pos = dx::XMVectorAdd(pos, dx::XMVectorScale(vel, deltaTime));
+                pos = dx::XMVectorAdd(pos, dx::XMVectorScale(dx::XMVectorScale(force, particle.inverseMass), 0.5f * deltaTime * deltaTime));
+
+                // 保存预测位置
+                dx::XMStoreFloat3(&particle.predPosition, pos);
+
+                // 初始位置设置为预测位置
+                dx::XMStoreFloat3(&particle.position, pos);
+            }
+        }
+    });
+}
+
+void XPBDSolver::Step(float deltaTime)
+{
+    memset(&m_stats.phaseTimes, 0, sizeof(m_stats.phaseTimes));
+    auto setupStart = std::chrono::steady_clock::now();
+
+    // 约束数量变化时（例如重新创建碰撞约束）重新着色
+    if (m_coloringDirty
+        || m_distanceColoring.order.size() != m_cloth->m_distanceConstraints.size()
+        || m_dihedralBendingColoring.order.size() != m_cloth->m_dihedralBendingConstraints.size()
+        || m_isometricBendingColoring.order.size() != m_cloth->m_isometricBendingConstraints.size()
+        || m_lraColoring.order.size() != m_cloth->m_lraConstraints.size()
+        || m_collisionColoring.order.size() != m_cloth->m_CollisionConstraints.size())
+    {
+        UpdateConstraintColoring();
+    }
+
+    // 粒子数量变化时重置休眠状态
+    if (m_restFrameCounts.size() != m_cloth->m_particles.size())
+    {
+        ResetSleeping();
+    }
+
+    // 关闭休眠后唤醒所有粒子
+    if (!m_cloth->m_sleepEnabled && m_sleepingParticleCount > 0)
+    {
+        WakeAll();
+    }
+
+    // 休眠状态变化后重新筛选需要求解的约束
+    if (m_activeConstraintsDirty)
+    {
+        UpdateActiveConstraints();
+    }
+
+    // 分辨率或层级数变化时重新建立粗网格，粗网格按行列抽取粒子，只适用于规则网格布料
+    const int multigridLevelCount = m_cloth->HasGridTopology() ? m_cloth->m_multigridLevelCount : 0;
+    if (m_multigrid.NeedsRebuild(m_cloth->m_widthResolution, m_cloth->m_heightResolution, multigridLevelCount))
+    {
+        m_multigrid.Build(m_cloth->m_widthResolution, m_cloth->m_heightResolution,
+            m_cloth->m_size / (m_cloth->m_widthResolution - 1), m_cloth->m_size / (m_cloth->m_heightResolution - 1),
+            multigridLevelCount);
+    }
+
+    m_stats.phaseTimes.setup = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+    m_stats.sleepingParticleCount = m_sleepingParticleCount;
+
+    // 所有可移动的粒子都在休眠，本帧不需要模拟
+    if (m_sleepingParticleCount > 0 && m_sleepingParticleCount == m_dynamicParticleCount)
+    {
+        m_stats.iterationCount = 0;
+        m_stats.iterationBudget = 0;
+        m_stats.converged = true;
+        return;
+    }
+
+    if (m_cloth->m_scheduleMode == XPBDScheduleMode::SmallSteps)
+    {
+        StepSmallSteps(deltaTime);
+    }
+    else
+    {
+        StepIterative(deltaTime);
+    }
+
+    if (m_cloth->m_sleepEnabled)
+    {
+        ScopedSolverPhaseTimer timer(m_stats.phaseTimes.sleeping);
+        UpdateSleeping();
+    }
+
+    m_stats.sleepingParticleCount = m_sleepingParticleCount;
+}
+
+void XPBDSolver::StepIterative(float deltaTime)
+{
+    ClothSolverPhaseTimes& phaseTimes = m_stats.phaseTimes;
+
+    {
+        ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+        BeginStep();
+    }
+
+    float subDeltaTime = deltaTime / m_cloth->m_subIteratorCount;
+
+    // 迭代次数在[minIterations, maxIterations]之间，残差达到容差或不再下降时提前结束
+    const uint32_t maxIterations = m_cloth->m_iteratorCount;
+    const uint32_t minIterations = (std::min)((std::max)(1u, m_cloth->m_minIteratorCount), maxIterations);
+    const float tolerance = m_cloth->m_residualTolerance;
+    const float stagnationRatio = m_cloth->m_residualStagnationRatio;
+
+    m_stats.iterationCount = 0;
+    m_stats.iterationBudget = m_cloth->m_subIteratorCount * maxIterations;
+    m_stats.converged = false;
+
+    for (int i = 0; i < m_cloth->m_subIteratorCount; ++i)
+    {
+        // 1. 预测粒子的位置，考虑外力
+        {
+            ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+            PredictPositions(subDeltaTime);
+        }
+
+        // 拉格朗日乘子只在子步内累积
+        {
+            ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+            ResetLambdas();
+        }
+
+        // 先在粗网格上消除整体的拉伸，细网格迭代只需处理局部误差
+        {
+            ScopedSolverPhaseTimer timer(phaseTimes.globalSolve);
+            m_multigrid.Solve(m_cloth->m_particles, m_cloth->m_multigridIterationCount);
+            SolveDistanceConstraintsDirect(subDeltaTime);
+        }
+
+        // 2. 求解约束多次以获得更准确的结果
+        m_stats.converged = false;
+        float previousRMSError = FLT_MAX;
+
+        // Chebyshev加速需要在延迟迭代之后至少还有一次可以外推的迭代
+        bool accelerate = m_cloth->m_chebyshevAcceleration && maxIterations > kChebyshevDelay + 1;
+        float spectralRadius = 0.0f;
+        float omega = 1.0f;
+
+        if (accelerate)
+        {
+            ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+            BeginChebyshev();
+        }
+
+        for (uint32_t iteration = 0; iteration < maxIterations; ++iteration)
+        {
+            {
+                ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+                SolveConstraints(subDeltaTime);
+            }
+            m_stats.iterationCount++;
+
+            const float rmsError = m_stats.rmsError;
+
+            if (iteration + 1 >= minIterations)
+            {
+                // 残差是本次迭代求解前的约束违反量，已满足容差时后续迭代只会带来很小的改善
+                if (tolerance > 0.0f && m_stats.maxError <= tolerance)
+                {
+                    m_stats.converged = true;
+                    break;
+                }
+
+                // 静止或缓慢运动时高斯-赛德尔迭代很快停滞，残差几乎不再下降，继续迭代没有意义
+                // 残差上升（例如新的碰撞约束被激活）不算停滞，继续迭代
+                if (stagnationRatio > 0.0f && previousRMSError > 0.0f && previousRMSError < FLT_MAX)
+                {
+                    const float decrease = (previousRMSError - rmsError) / previousRMSError;
+                    if (decrease >= 0.0f && decrease < stagnationRatio)
+                    {
+                        m_stats.converged = true;
+                        break;
+                    }
+                }
+            }
+
+            // 最后一次迭代不外推，保证输出的位置是一次完整的约束投影（碰撞约束已满足）
+            if (accelerate && iteration + 1 < maxIterations)
+            {
+                if (iteration + 1 == kChebyshevDelay)
+                {
+                    spectralRadius = EstimateSpectralRadius(previousRMSError, rmsError);
+                }
+
+                if (iteration < kChebyshevDelay)
+                {
+                    omega = 1.0f;
+                }
+                else if (iteration > kChebyshevDelay && rmsError > previousRMSError)
+                {
+                    // 外推后残差反而增大，说明谱半径估计偏大，本子步剩余的迭代退回普通迭代
+                    accelerate = false;
+                    omega = 1.0f;
+                }
+                else if (iteration == kChebyshevDelay)
+                {
+                    omega = 2.0f / (2.0f - spectralRadius * spectralRadius);
+                }
+                else
+                {
+                    omega = 4.0f / (4.0f - spectralRadius * spectralRadius * omega);
+                }
+
+                omega = (std::min)(omega, kChebyshevMaxOmega);
+
+                if (accelerate)
+                {
+                    ScopedSolverPhaseTimer timer(phaseTimes.constraints);
+                    ApplyChebyshev(omega);
+                }
+            }
+
+            previousRMSError = rmsError;
+        }
+
+        // 3. 更新速度和位置
+        ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+        UpdateVelocities(subDeltaTime);
+    }
+
+    ScopedSolverPhaseTimer timer(phaseTimes.integrate);
+    EndStep(deltaTime);
+}
+
+void XPBDSolver::StepSmallSteps(float deltaTime)
+{
+    const uint32_t substepCount = (m_cloth->m_subIteratorCount > 0) ? m_cloth->m_subIteratorCount : 1;
+    const float subDeltaTime = deltaTime / substepCount;
+
+    // 小步长模式每个子步固定迭代一次，不提前结束，只记录残差
+    m_stats.iterationCount = substepCount;
+    m_stats.iterationBudget = substepCount;
+    m_stats.converged = false;
+
+    // 保存帧初始位置，同时预测第一个子步
+    FusedParticlePass(SaveInitialPosition | PredictPosition, subDeltaTime, deltaTime);
+
+    for (uint32_t i = 0; i < substepCount; ++i)
+    {
+        // 每个子步只迭代一次，乘子不在子步之间累积
+        {
+            ScopedSolverPhaseTimer timer(m_stats.phaseTimes.constraints);
+            ClearLambdas();
+        }
+
+        {
+            ScopedSolverPhaseTimer timer(m_stats.phaseTimes.globalSolve);
+            m_multigrid.Solve(m_cloth->m_particles, m_cloth->m_multigridIterationCount);
+            SolveDistanceConstraintsDirect(subDeltaTime);
+        }
+
+        {
+            ScopedSolverPhaseTimer timer(m_stats.phaseTimes.constraints);
+            SolveConstraints(subDeltaTime);
+        }
+        m_stats.converged = (m_cloth->m_residualTolerance > 0.0f && m_stats.maxError <= m_cloth->m_residualTolerance);
+
+        // 更新本子步的速度并直接预测下一个子步；最后一个子步计算整帧速度
+        if (i + 1 < substepCount)
+        {
+            FusedParticlePass(UpdateSubstepVelocity | PredictPosition, subDeltaTime, deltaTime);
+        }
+        else
+        {
+            FusedParticlePass(UpdateFrameVelocity, subDeltaTime, deltaTime);
+        }
+    }
+}
+
+void XPBDSolver::FusedParticlePass(uint32_t flags, float subDeltaTime, float deltaTime)
+{
+    ScopedSolverPhaseTimer timer(m_stats.phaseTimes.integrate);
+
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const dx::XMFLOAT3 gravity = m_cloth->m_gravity;
+    const float dampingScale = (std::max)(0.0f, 1.0f - m_cloth->m_velocityDamping * deltaTime);
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, &gravity, flags, subDeltaTime, deltaTime, dampingScale](uint32_t begin, uint32_t end)
+    {
+        const float inverseSubDeltaTime = 1.0f / subDeltaTime;
+        const float inverseDeltaTime = 1.0f / deltaTime;
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+
+            if (flags & SaveInitialPosition)
+            {
+                particle.positionInitial = particle.position;
+            }
+
+            if (particle.isStatic || particle.isSleeping)
+            {
+                continue;
+            }
+
+            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+
+            if (flags & (UpdateSubstepVelocity | UpdateFrameVelocity))
+            {
+                dx::XMVECTOR vel;
+                if (flags & UpdateFrameVelocity)
+                {
+                    vel = dx::XMVectorScale(dx::XMVectorSubtract(pos, dx::XMLoadFloat3(&particle.positionInitial)), inverseDeltaTime * dampingScale);
+                }
+                else
+                {
+                    vel = dx::XMVectorScale(dx::XMVectorSubtract(pos, dx::XMLoadFloat3(&particle.oldPosition)), inverseSubDeltaTime);
+                }
+
+                dx::XMStoreFloat3(&particle.velocity, vel);
+                particle.ResetForce();
+            }
+
+            if (flags & PredictPosition)
+            {
+                particle.oldPosition = particle.position;
+                particle.ApplyForce(gravity);
+
+                dx::XMVECTOR vel = dx::XMLoadFloat3(&particle.velocity);
+                dx::XMVECTOR force = dx::XMLoadFloat3(&particle.force);
+
+                pos = dx::XMVectorAdd(pos, dx::XMVectorScale(vel, subDeltaTime));
+                pos = dx::XMVectorAdd(pos, dx::XMVectorScale(dx::XMVectorScale(force, particle.inverseMass), 0.5f * subDeltaTime * subDeltaTime));
+
+                dx::XMStoreFloat3(&particle.predPosition, pos);
+                dx::XMStoreFloat3(&particle.position, pos);
+            }
+        }
+    });
+}
+
+void XPBDSolver::UpdateConstraintColoring()
+{
+    Cloth* cloth = m_cloth;
+
+    BuildConstraintColoring((uint32_t)cloth->m_distanceConstraints.size(),
+        [cloth](uint32_t index) -> Constraint* { return &cloth->m_distanceConstraints[index]; },
+        m_distanceColoring);
+
+    BuildConstraintColoring((uint32_t)cloth->m_dihedralBendingConstraints.size(),
+        [cloth](uint32_t index) -> Constraint* { return &cloth->m_dihedralBendingConstraints[index]; },
+        m_dihedralBendingColoring);
+
+    BuildConstraintColoring((uint32_t)cloth->m_isometricBendingConstraints.size(),
+        [cloth](uint32_t index) -> Constraint* { return &cloth->m_isometricBendingConstraints[index]; },
+        m_isometricBendingColoring);
+
+    BuildConstraintColoring((uint32_t)cloth->m_lraConstraints.size(),
+        [cloth](uint32_t index) -> Constraint* { return &cloth->m_lraConstraints[index]; },
+        m_lraColoring);
+
+    BuildConstraintColoring((uint32_t)cloth->m_CollisionConstraints.size(),
+        [cloth](uint32_t index) -> Constraint* { return &cloth->m_CollisionConstraints[index]; },
+        m_collisionColoring);
+
+    // 拉格朗日乘子缓冲区按约束类型连续排列
+    m_distanceColoring.lambdaOffset = 0;
+    m_dihedralBendingColoring.lambdaOffset = m_distanceColoring.lambdaOffset + (uint32_t)m_distanceColoring.order.size();
+    m_isometricBendingColoring.lambdaOffset = m_dihedralBendingColoring.lambdaOffset + (uint32_t)m_dihedralBendingColoring.order.size();
+    m_lraColoring.lambdaOffset = m_isometricBendingColoring.lambdaOffset + (uint32_t)m_isometricBendingColoring.order.size();
+    m_collisionColoring.lambdaOffset = m_lraColoring.lambdaOffset + (uint32_t)m_lraColoring.order.size();
+
+    m_lambdas.assign(m_collisionColoring.lambdaOffset + m_collisionColoring.order.size(), 0.0f);
+
+    BuildParticleIslands();
+
+    m_coloringDirty = false;
+    m_activeConstraintsDirty = true;
+    m_directSolverDirty = true;
+}
+
+void XPBDSolver::BeginChebyshev()
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const uint32_t particleCount = (uint32_t)particles.size();
+
+    m_iterateCurrent.resize(particleCount);
+    m_iteratePrevious.resize(particleCount);
+    m_activeContacts.resize(particleCount);
+
+    // 迭代开始时前两次迭代值都取预测位置
+    dx::XMFLOAT3* iterateCurrent = m_iterateCurrent.data();
+    dx::XMFLOAT3* iteratePrevious = m_iteratePrevious.data();
+
+    TaskScheduler::Get().ParallelFor(0, particleCount, kParticleGrainSize, [&particles, iterateCurrent, iteratePrevious](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            iterateCurrent[i] = particles[i].position;
+            iteratePrevious[i] = particles[i].position;
+        }
+    });
+}
+
+float XPBDSolver::EstimateSpectralRadius(float previousRMSError, float rmsError)
+{
+    // 用户指定了谱半径时直接使用
+    if (m_cloth->m_chebyshevSpectralRadius > 0.0f)
+    {
+        return (std::min)(m_cloth->m_chebyshevSpectralRadius, kChebyshevMaxSpectralRadius);
+    }
+
+    // 延迟迭代中相邻两次残差之比近似迭代矩阵的谱半径，跨子步做指数平滑以减少抖动
+    if (previousRMSError > 0.0f && previousRMSError != FLT_MAX)
+    {
+        float ratio = (std::min)(rmsError / previousRMSError, 1.0f);
+        m_spectralRadiusEstimate += (ratio - m_spectralRadiusEstimate) * kSpectralRadiusSmoothing;
+    }
+
+    return (std::min)(m_spectralRadiusEstimate, kChebyshevMaxSpectralRadius);
+}
+
+void XPBDSolver::ApplyChebyshev(float omega)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const Particle* particlesBegin = particles.data();
+    const uint32_t particleCount = (uint32_t)particles.size();
+
+    // 标记本子步中产生过碰撞修正的粒子，这些粒子不做外推，避免被推入碰撞体
+    uint8_t* activeContacts = m_activeContacts.data();
+    memset(activeContacts, 0, particleCount);
+
+    const SolverReal* collisionLambdas = m_lambdas.data() + m_collisionColoring.lambdaOffset;
+    for (size_t c = 0; c < m_cloth->m_CollisionConstraints.size(); ++c)
+    {
+        if (collisionLambdas[c] == 0)
+        {
+            continue;
+        }
+
+        Constraint* constraint = &m_cloth->m_CollisionConstraints[c];
+        Particle** constraintParticles = constraint->GetParticles();
+        for (uint32_t i = 0; i < constraint->GetParticlesCount(); ++i)
+        {
+            size_t particleIndex = constraintParticles[i] - particlesBegin;
+            if (particleIndex < particleCount)
+            {
+                activeContacts[particleIndex] = 1;
+            }
+        }
+    }
+
+    dx::XMFLOAT3* iterateCurrent = m_iterateCurrent.data();
+    dx::XMFLOAT3* iteratePrevious = m_iteratePrevious.data();
+
+    TaskScheduler::Get().ParallelFor(0, particleCount, kParticleGrainSize, [&particles, iterateCurrent, iteratePrevious, activeContacts, omega](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle& particle = particles[i];
+
+            // q(k+1) = omega * (投影结果 - q(k-1)) + q(k-1)
+            if (!particle.isStatic && !activeContacts[i] && omega != 1.0f)
+            {
+                dx::XMVECTOR previous = dx::XMLoadFloat3(&iteratePrevious[i]);
+                dx::XMVECTOR projected = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR extrapolated = dx::XMVectorAdd(previous, dx::XMVectorScale(dx::XMVectorSubtract(projected, previous), omega));
+
+                dx::XMStoreFloat3(&particle.position, extrapolated);
+            }
+
+            iteratePrevious[i] = iterateCurrent[i];
+            iterateCurrent[i] = particle.position;
+        }
+    });
+}
+
+void XPBDSolver::SolveDistanceConstraintsDirect(float deltaTime)
+{
+    if (m_cloth->m_distanceSolveMode != XPBDDistanceSolveMode::Direct)
+    {
+        return;
+    }
+
+    // 约束拓扑变化后重新做符号分析
+    if (m_directSolverDirty)
+    {
+        std::vector<dx::XMFLOAT2> particleCoordinates;
+        m_cloth->GetParticleLayoutCoordinates(particleCoordinates);
+
+        m_directSolver.Build(m_cloth->m_particles, m_cloth->m_distanceConstraints, particleCoordinates);
+        m_directSolverDirty = false;
+    }
+
+    if (!m_directSolver.IsValid())
+    {
+        return;
+    }
+
+    SolverReal* lambdas = m_lambdas.data() + m_distanceColoring.lambdaOffset;
+
+    for (uint32_t i = 0; i < m_cloth->m_directSolveIterationCount; ++i)
+    {
+        if (!m_directSolver.Solve(m_cloth->m_particles, m_cloth->m_distanceConstraints, lambdas, deltaTime, m_stats.distance))
+        {
+            logDebug("XPBDSolver: direct distance solve failed");
+            break;
+        }
+    }
+}
+
+void XPBDSolver::BuildParticleIslands()
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const Particle* particlesBegin = particles.data();
+    const uint32_t particleCount = (uint32_t)particles.size();
+
+    // 用并查集把距离约束连接的可移动粒子合并成岛屿，以岛屿中最小的粒子索引作为编号
+    m_particleIslands.resize(particleCount);
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        m_particleIslands[i] = i;
+    }
+
+    uint32_t* parents = m_particleIslands.data();
+    auto findRoot = [parents](uint32_t index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    };
+
+    for (const DistanceConstraint& constraint : m_cloth->m_distanceConstraints)
+    {
+        const Particle** constraintParticles = constraint.GetParticles();
+        uint32_t a = (uint32_t)(constraintParticles[0] - particlesBegin);
+        uint32_t b = (uint32_t)(constraintParticles[1] - particlesBegin);
+
+        if (a >= particleCount || b >= particleCount || particles[a].isStatic || particles[b].isStatic)
+        {
+            continue;
+        }
+
+        uint32_t rootA = findRoot(a);
+        uint32_t rootB = findRoot(b);
+        if (rootA != rootB)
+        {
+            parents[(std::max)(rootA, rootB)] = (std::min)(rootA, rootB);
+        }
+    }
+
+    m_islandSizes.assign(particleCount, 0);
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        m_particleIslands[i] = findRoot(i);
+        if (!particles[i].isStatic)
+        {
+            m_islandSizes[m_particleIslands[i]]++;
+        }
+    }
+}
+
+void XPBDSolver::ClearLambdas()
+{
+    if (!m_lambdas.empty())
+    {
+        memset(m_lambdas.data(), 0, sizeof(SolverReal) * m_lambdas.size());
+    }
+}
+
+void XPBDSolver::ResetLambdas()
+{
+    if (m_lambdas.empty())
+    {
+        return;
+    }
+
+    float warmStartFactor = m_cloth->m_lambdaWarmStartFactor;
+
+    if (warmStartFactor <= 0.0f)
+    {
+        ClearLambdas();
+        return;
+    }
+
+    // 热启动只用于距离约束：沿用上一子步的拉伸乘子并按系数衰减
+    // 布料受压时会屈曲，压缩乘子（大于0）和弯曲、LRA、碰撞约束的乘子在下一子步中没有可靠的方向，仍然清零
+    const uint32_t warmStartCount = m_dihedralBendingColoring.lambdaOffset;
+
+    for (uint32_t i = 0; i < warmStartCount; ++i)
+    {
+        m_lambdas[i] = (std::min)(m_lambdas[i], (SolverReal)0) * (SolverReal)warmStartFactor;
+    }
+
+    memset(m_lambdas.data() + warmStartCount, 0, sizeof(SolverReal) * (m_lambdas.size() - warmStartCount));
+
+    // 乘子作为初始解，对应的位置校正必须同时作用到粒子上
+    // 否则柔度项C + alpha_tilde * lambda中的lambda没有对应的位移，平衡状态会偏离C = -alpha_tilde * lambda
+    Cloth* cloth = m_cloth;
+
+    ApplyColoredWarmStart(m_distanceColoring,
+        [cloth](uint32_t index) { return &cloth->m_distanceConstraints[index]; });
+}
+
+template<typename GetConstraintFunc>
+void XPBDSolver::ApplyColoredWarmStart(const ConstraintColoring& coloring, GetConstraintFunc getConstraint)
 {
-    for (auto& particle : m_cloth->m_particles)
+    typedef typename std::remove_pointer<decltype(getConstraint(0u))>::type ConstraintT;
+
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    const uint32_t* order = coloring.activeOrder.data();
+    const SolverReal* lambdas = m_lambdas.data() + coloring.lambdaOffset;
+    const size_t colorCount = coloring.activeColorOffsets.empty() ? 0 : coloring.activeColorOffsets.size() - 1;
+
+    for (size_t color = 0; color < colorCount; ++color)
     {
-        particle.positionInitial = particle.position;
+        uint32_t begin = coloring.activeColorOffsets[color];
+        uint32_t end = coloring.activeColorOffsets[color + 1];
+
+        // 与求解相同，同一颜色内的约束不共享粒子，可以并行写入位置
+        bool serial = coloring.lastColorSerial && color == colorCount - 1;
+        uint32_t grainSize = serial ? UINT32_MAX : kConstraintGrainSize;
+
+        scheduler.ParallelFor(begin, end, grainSize, [order, lambdas, &getConstraint](uint32_t chunkBegin, uint32_t chunkEnd)
+        {
+            for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                uint32_t index = order[i];
+                ApplyWarmStartN<ConstraintT::kArity>(getConstraint(index), lambdas[index]);
+            }
+        });
     }
 }
 
-void XPBDSolver::PredictPositions(float deltaTime)
+template<uint32_t Arity, typename ConstraintT>
+void XPBDSolver::ApplyWarmStartN(ConstraintT* constraint, SolverReal lambda)
 {
-    for (auto& particle : m_cloth->m_particles)
+    if (lambda == 0)
     {
-        if (!particle.isStatic)
+        return;
+    }
+
+    Particle** constraintParticles = constraint->ConstraintT::GetParticles();
+    dx::XMFLOAT3 gradients[Arity];
+
+    constraint->ConstraintT::ComputeConstraintAndGradient(gradients);
+
+    for (uint32_t i = 0; i < Arity; ++i)
+    {
+        Particle* particle = constraintParticles[i];
+
+        if (!particle->isStatic && !particle->isSleeping)
+        {
+            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle->position);
+            dx::XMVECTOR correction = dx::XMVectorScale(dx::XMLoadFloat3(&gradients[i]), (float)(lambda * (SolverReal)particle->inverseMass));
+            dx::XMVECTOR newPos = dx::XMVectorAdd(pos, correction);
+
+            if (!dx::XMVector3IsNaN(newPos))
+            {
+                dx::XMStoreFloat3(&particle->position, newPos);
+            }
+        }
+    }
+}
+
+void XPBDSolver::BuildConstraintColoring(uint32_t constraintCount, const std::function<Constraint*(uint32_t)>& getConstraint,
+    ConstraintColoring& coloring)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const Particle* particlesBegin = particles.data();
+    const size_t particleCount = particles.size();
+
+    ScratchArena& arena = TaskScheduler::Get().GetScratchArena();
+    ScratchArenaScope arenaScope(arena);
+
+    // 每个粒子已被占用的颜色（位掩码）
+    uint64_t* usedColors = arena.AllocateArray<uint64_t>(particleCount);
+    memset(usedColors, 0, sizeof(uint64_t) * particleCount);
+
+    uint8_t* constraintColors = arena.AllocateArray<uint8_t>(constraintCount);
+    uint32_t colorCounts[kMaxColorCount + 1] = {};
+
+    for (uint32_t c = 0; c < constraintCount; ++c)
+    {
+        Constraint* constraint = getConstraint(c);
+        Particle** constraintParticles = constraint->GetParticles();
+        uint32_t constraintParticleCount = constraint->GetParticlesCount();
+
+        // 静态粒子不会被写入，不参与冲突判断
+        uint64_t used = 0;
+        bool outOfRange = false;
+        for (uint32_t i = 0; i < constraintParticleCount; ++i)
         {
-            // 保存当前位置作为旧位置
-            particle.oldPosition = particle.position;
+            const Particle* particle = constraintParticles[i];
+            if (particle->isStatic)
+            {
+                continue;
+            }
+
+            size_t particleIndex = particle - particlesBegin;
+            if (particle < particlesBegin || particleIndex >= particleCount)
+            {
+                outOfRange = true;
+                break;
+            }
 
-            // 应用重力
-            particle.ApplyForce(m_cloth->m_gravity);
+            used |= usedColors[particleIndex];
+        }
 
-            // 将粒子的位置和速度转换为XMVECTOR进行计算
-            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
-            dx::XMVECTOR vel = dx::XMLoadFloat3(&particle.velocity);
-            dx::XMVECTOR force = dx::XMLoadFloat3(&particle.force);
+        uint32_t color = kMaxColorCount;
+        if (!outOfRange)
+        {
+            for (uint32_t i = 0; i < kMaxColorCount; ++i)
+            {
+                if ((used & (1ull << i)) == 0)
+                {
+                    color = i;
+                    break;
+                }
+            }
+        }
 
-            // 预测新位置（使用显式欧拉积分）
-            pos = dx::XMVectorAdd(pos, dx::XMVectorScale(vel, deltaTime));
-            pos = dx::XMVectorAdd(pos, dx::XMVectorScale(dx::XMVectorScale(force, particle.inverseMass), 0.5f * deltaTime * deltaTime));
+        if (color < kMaxColorCount)
+        {
+            for (uint32_t i = 0; i < constraintParticleCount; ++i)
+            {
+                const Particle* particle = constraintParticles[i];
+                if (!particle->isStatic)
+                {
+                    usedColors[particle - particlesBegin] |= (1ull << color);
+                }
+            }
+        }
 
-            // 保存预测位置
-            dx::XMStoreFloat3(&particle.predPosition, pos);
+        constraintColors[c] = (uint8_t)color;
+        colorCounts[color]++;
+    }
+
+    // 计算每种颜色的起始位置，跳过空颜色
+    uint32_t colorStarts[kMaxColorCount + 1] = {};
+    uint32_t offset = 0;
 
-            // 初始位置设置为预测位置
-            dx::XMStoreFloat3(&particle.position, pos);
+    coloring.colorOffsets.clear();
+    for (uint32_t color = 0; color <= kMaxColorCount; ++color)
+    {
+        if (colorCounts[color] > 0)
+        {
+            coloring.colorOffsets.push_back(offset);
+            colorStarts[color] = offset;
+            offset += colorCounts[color];
         }
     }
+    coloring.colorOffsets.push_back(offset);
+    coloring.lastColorSerial = colorCounts[kMaxColorCount] > 0;
+
+    // 同一颜色内保持原有的约束顺序
+    coloring.order.resize(constraintCount);
+    for (uint32_t c = 0; c < constraintCount; ++c)
+    {
+        coloring.order[colorStarts[constraintColors[c]]++] = c;
+    }
+
+    logDebug("XPBDSolver constraint coloring: " + std::to_string(constraintCount) + " constraints, "
+        + std::to_string(coloring.colorOffsets.size() - 1) + " colors"
+        + (coloring.lastColorSerial ? " (with serial overflow group)" : ""));
 }
 
-void XPBDSolver::Step(float deltaTime)
+void XPBDSolver::FilterActiveConstraints(const std::function<Constraint*(uint32_t)>& getConstraint, ConstraintColoring& coloring)
 {
-    BeginStep();
+    const size_t colorCount = coloring.colorOffsets.empty() ? 0 : coloring.colorOffsets.size() - 1;
 
-    float subDeltaTime = deltaTime / m_cloth->m_subIteratorCount;
+    coloring.activeOrder.clear();
+    coloring.activeOrder.reserve(coloring.order.size());
+    coloring.activeColorOffsets.clear();
 
-    for (int i = 0; i < m_cloth->m_subIteratorCount; ++i)
+    // 保留空颜色，保证最后一种颜色仍然对应串行组
+    for (size_t color = 0; color < colorCount; ++color)
     {
-        // 1. 预测粒子的位置，考虑外力
-        PredictPositions(subDeltaTime);
+        coloring.activeColorOffsets.push_back((uint32_t)coloring.activeOrder.size());
 
-        // 2. 求解约束多次以获得更准确的结果
-        for (int i = 0; i < m_cloth->m_iteratorCount; ++i)
+        for (uint32_t i = coloring.colorOffsets[color]; i < coloring.colorOffsets[color + 1]; ++i)
         {
-            SolveConstraints(subDeltaTime);
+            Constraint* constraint = getConstraint(coloring.order[i]);
+            Particle** constraintParticles = constraint->GetParticles();
+
+            // 所有粒子都固定或休眠的约束不会产生任何修正，跳过
+            for (uint32_t p = 0; p < constraint->GetParticlesCount(); ++p)
+            {
+                if (!constraintParticles[p]->isStatic && !constraintParticles[p]->isSleeping)
+                {
+                    coloring.activeOrder.push_back(coloring.order[i]);
+                    break;
+                }
+            }
         }
+    }
+    coloring.activeColorOffsets.push_back((uint32_t)coloring.activeOrder.size());
+}
 
-        // 3. 更新速度和位置
-        UpdateVelocities(subDeltaTime);
+void XPBDSolver::UpdateActiveConstraints()
+{
+    Cloth* cloth = m_cloth;
+
+    FilterActiveConstraints([cloth](uint32_t index) -> Constraint* { return &cloth->m_distanceConstraints[index]; }, m_distanceColoring);
+    FilterActiveConstraints([cloth](uint32_t index) -> Constraint* { return &cloth->m_dihedralBendingConstraints[index]; }, m_dihedralBendingColoring);
+    FilterActiveConstraints([cloth](uint32_t index) -> Constraint* { return &cloth->m_isometricBendingConstraints[index]; }, m_isometricBendingColoring);
+    FilterActiveConstraints([cloth](uint32_t index) -> Constraint* { return &cloth->m_lraConstraints[index]; }, m_lraColoring);
+    FilterActiveConstraints([cloth](uint32_t index) -> Constraint* { return &cloth->m_CollisionConstraints[index]; }, m_collisionColoring);
+
+    m_dynamicParticleCount = 0;
+    for (const Particle& particle : cloth->m_particles)
+    {
+        if (!particle.isStatic)
+        {
+            m_dynamicParticleCount++;
+        }
     }
 
-    EndStep(deltaTime);
+    m_activeConstraintsDirty = false;
 }
 
-void XPBDSolver::SolveConstraints(float deltaTime)
+void XPBDSolver::ResetSleeping()
 {
-    // 处理距离约束
-    for (auto& constraint : m_cloth->m_distanceConstraints)
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const size_t particleCount = particles.size();
+
+    m_restFrameCounts.assign(particleCount, 0);
+    m_restAnchors.resize(particleCount);
+
+    for (size_t i = 0; i < particleCount; ++i)
     {
-        SolveConstraint(&constraint, deltaTime);
+        particles[i].isSleeping = false;
+        m_restAnchors[i] = particles[i].position;
     }
 
-    // 处理弯曲约束
-    for (auto& constraint : m_cloth->m_dihedralBendingConstraints)
+    m_sleepingParticleCount = 0;
+    m_activeConstraintsDirty = true;
+}
+
+void XPBDSolver::WakeParticle(uint32_t index)
+{
+    Particle& particle = m_cloth->m_particles[index];
+
+    particle.isSleeping = false;
+    particle.oldPosition = particle.position;
+    m_restFrameCounts[index] = 0;
+    m_restAnchors[index] = particle.position;
+}
+
+void XPBDSolver::WakeAll()
+{
+    if (m_sleepingParticleCount == 0)
     {
-        SolveConstraint(&constraint, deltaTime);
+        return;
     }
 
-    // 处理LRA约束
-    for (auto& constraint : m_cloth->m_lraConstraints)
+    for (uint32_t i = 0; i < (uint32_t)m_cloth->m_particles.size(); ++i)
+    {
+        if (m_cloth->m_particles[i].isSleeping)
+        {
+            WakeParticle(i);
+        }
+    }
+
+    m_sleepingParticleCount = 0;
+    m_activeConstraintsDirty = true;
+}
+
+void XPBDSolver::WakeInSphere(const dx::XMFLOAT3& center, float radius)
+{
+    if (m_sleepingParticleCount == 0)
     {
-        SolveConstraint(&constraint, deltaTime);
+        return;
     }
 
-    // 处理碰撞约束
-    for (auto& constraint : m_cloth->m_CollisionConstraints)
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const uint32_t particleCount = (uint32_t)particles.size();
+
+    ScratchArena& arena = TaskScheduler::Get().GetScratchArena();
+    ScratchArenaScope arenaScope(arena);
+
+    uint8_t* islandWakeFlags = arena.AllocateArray<uint8_t>(particleCount);
+    memset(islandWakeFlags, 0, particleCount);
+
+    dx::XMVECTOR sphereCenter = dx::XMLoadFloat3(&center);
+    bool anyWake = false;
+
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        if (!particles[i].isSleeping)
+        {
+            continue;
+        }
+
+        float distanceSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMVectorSubtract(dx::XMLoadFloat3(&particles[i].position), sphereCenter)));
+        if (distanceSquared <= radius * radius)
+        {
+            islandWakeFlags[m_particleIslands[i]] = 1;
+            anyWake = true;
+        }
+    }
+
+    if (anyWake)
+    {
+        WakeIslands(islandWakeFlags);
+    }
+}
+
+void XPBDSolver::WakeIslands(const uint8_t* islandWakeFlags)
+{
+    std::vector<Particle>& particles = m_cloth->m_particles;
+
+    for (uint32_t i = 0; i < (uint32_t)particles.size(); ++i)
     {
-        SolveConstraint(constraint, deltaTime);
+        if (particles[i].isSleeping && islandWakeFlags[m_particleIslands[i]])
+        {
+            WakeParticle(i);
+            m_sleepingParticleCount--;
+        }
     }
+
+    m_activeConstraintsDirty = true;
 }
 
-void XPBDSolver::SolveConstraint(Constraint* constraint, float deltaTime)
+void XPBDSolver::UpdateSleeping()
 {
-    uint32_t particleCount = constraint->GetParticlesCount();
+    std::vector<Particle>& particles = m_cloth->m_particles;
+    const uint32_t particleCount = (uint32_t)particles.size();
+
+    const float velocityThreshold = m_cloth->m_sleepVelocityThreshold;
+    const float velocityThresholdSquared = velocityThreshold * velocityThreshold;
+    const float displacementThreshold = m_cloth->m_sleepDisplacementThreshold;
+    const float displacementThresholdSquared = displacementThreshold * displacementThreshold;
+    const uint16_t sleepFrameCount = (uint16_t)(std::min)(m_cloth->m_sleepFrameCount, 0xFFFFu);
+
+    uint16_t* restFrameCounts = m_restFrameCounts.data();
+    dx::XMFLOAT3* restAnchors = m_restAnchors.data();
+
+    // 1. 统计每个活动粒子连续静止的帧数：速度和相对锚点的位移都低于阈值才算静止
+    std::atomic<uint32_t> readyCount(0);
+
+    TaskScheduler::Get().ParallelFor(0, particleCount, kParticleGrainSize,
+        [&particles, restFrameCounts, restAnchors, velocityThresholdSquared, displacementThresholdSquared, sleepFrameCount, &readyCount](uint32_t begin, uint32_t end)
+    {
+        uint32_t chunkReadyCount = 0;
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const Particle& particle = particles[i];
+
+            if (particle.isStatic || particle.isSleeping)
+            {
+                continue;
+            }
 
-    if (particleCount == 0)
+            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+            float speedSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMLoadFloat3(&particle.velocity)));
+            float displacementSquared = dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMVectorSubtract(pos, dx::XMLoadFloat3(&restAnchors[i]))));
+
+            if (speedSquared <= velocityThresholdSquared && displacementSquared <= displacementThresholdSquared)
+            {
+                if (restFrameCounts[i] < 0xFFFF)
+                {
+                    restFrameCounts[i]++;
+                }
+            }
+            else
+            {
+                restFrameCounts[i] = 0;
+                dx::XMStoreFloat3(&restAnchors[i], pos);
+            }
+
+            if (restFrameCounts[i] >= sleepFrameCount)
+            {
+                chunkReadyCount++;
+            }
+        }
+
+        readyCount.fetch_add(chunkReadyCount, std::memory_order_relaxed);
+    });
+
+    // 2. 休眠：岛屿内所有粒子都已静止足够多帧时整个岛屿进入休眠
+    //    只让部分区域休眠时，活动粒子会被冻结的邻居持续拉扯，反而无法静止下来
+    if (readyCount.load(std::memory_order_relaxed) == 0)
     {
         return;
     }
 
-    Particle** constraintParticles = constraint->GetParticles();
+    ScratchArena& arena = TaskScheduler::Get().GetScratchArena();
+    ScratchArenaScope arenaScope(arena);
+
+    uint32_t* settledCounts = arena.AllocateArray<uint32_t>(particleCount);
+    memset(settledCounts, 0, sizeof(uint32_t) * particleCount);
+
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        const Particle& particle = particles[i];
+        if (!particle.isStatic && (particle.isSleeping || restFrameCounts[i] >= sleepFrameCount))
+        {
+            settledCounts[m_particleIslands[i]]++;
+        }
+    }
+
+    for (uint32_t i = 0; i < particleCount; ++i)
+    {
+        Particle& particle = particles[i];
+        uint32_t island = m_particleIslands[i];
+
+        if (particle.isStatic || particle.isSleeping || settledCounts[island] != m_islandSizes[island])
+        {
+            continue;
+        }
+
+        particle.isSleeping = true;
+        particle.velocity = dx::XMFLOAT3(0.0f, 0.0f, 0.0f);
+        m_sleepingParticleCount++;
+        m_activeConstraintsDirty = true;
+    }
+}
+
+template<typename GetConstraintFunc>
+void XPBDSolver::SolveColoredConstraints(const ConstraintColoring& coloring, GetConstraintFunc getConstraint, float deltaTime,
+    ClothConstraintResidual& residual)
+{
+    // getConstraint返回具体的约束类型，求解按该类型的粒子数展开
+    typedef typename std::remove_pointer<decltype(getConstraint(0u))>::type ConstraintT;
+
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    ScratchArena& arena = scheduler.GetScratchArena();
+    // 只求解至少有一个可移动粒子的约束，顺序和颜色划分与完整的着色结果一致
+    const uint32_t* order = coloring.activeOrder.data();
+    SolverReal* lambdas = m_lambdas.data() + coloring.lambdaOffset;
+    const size_t colorCount = coloring.activeColorOffsets.empty() ? 0 : coloring.activeColorOffsets.size() - 1;
+
+    float maxError = 0.0f;
+    double sumSquares = 0.0;
+
+    for (size_t color = 0; color < colorCount; ++color)
+    {
+        uint32_t begin = coloring.activeColorOffsets[color];
+        uint32_t end = coloring.activeColorOffsets[color + 1];
+
+        if (begin == end)
+        {
+            continue;
+        }
+
+        // 着色失败的约束之间可能共享粒子，整组串行求解
+        bool serial = coloring.lastColorSerial && color == colorCount - 1;
+        uint32_t grainSize = serial ? UINT32_MAX : kConstraintGrainSize;
+
+        // 每个块写入自己的残差槽位，避免线程间竞争
+        ScratchArenaScope arenaScope(arena);
+        size_t chunkCount = (size_t)(((uint64_t)end - begin + grainSize - 1) / grainSize);
+        ChunkResidual* chunkResiduals = arena.AllocateArray<ChunkResidual>(chunkCount);
+
+        scheduler.ParallelFor(begin, end, grainSize, [this, order, lambdas, &getConstraint, deltaTime, begin, grainSize, chunkResiduals](uint32_t chunkBegin, uint32_t chunkEnd)
+        {
+            float chunkMaxError = 0.0f;
+            double chunkSumSquares = 0.0;
+
+            for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                uint32_t index = order[i];
+                float error = SolveConstraintN<ConstraintT::kArity>(getConstraint(index), lambdas[index], deltaTime);
+
+                chunkMaxError = (std::max)(chunkMaxError, error);
+                chunkSumSquares += (double)error * error;
+            }
+
+            ChunkResidual& chunkResidual = chunkResiduals[(chunkBegin - begin) / grainSize];
+            chunkResidual.maxError = chunkMaxError;
+            chunkResidual.sumSquares = chunkSumSquares;
+        });
+
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            maxError = (std::max)(maxError, chunkResiduals[chunk].maxError);
+            sumSquares += chunkResiduals[chunk].sumSquares;
+        }
+    }
+
+    residual.constraintCount = (uint32_t)coloring.activeOrder.size();
+    residual.maxError = maxError;
+    residual.rmsError = residual.constraintCount > 0 ? (float)std::sqrt(sumSquares / residual.constraintCount) : 0.0f;
+}
+
+void XPBDSolver::SolveConstraints(float deltaTime)
+{
+    Cloth* cloth = m_cloth;
+
+    // 处理距离约束，直接求解模式下已在迭代之前整体求解，残差保留直接求解的结果
+    if (cloth->m_distanceSolveMode != XPBDDistanceSolveMode::Direct || !m_directSolver.IsValid())
+    {
+        SolveColoredConstraints(m_distanceColoring,
+            [cloth](uint32_t index) { return &cloth->m_distanceConstraints[index]; }, deltaTime, m_stats.distance);
+    }
+
+    // 处理弯曲约束
+    SolveColoredConstraints(m_dihedralBendingColoring,
+        [cloth](uint32_t index) { return &cloth->m_dihedralBendingConstraints[index]; }, deltaTime, m_stats.dihedralBending);
+
+    // 处理等距弯曲约束
+    SolveColoredConstraints(m_isometricBendingColoring,
+        [cloth](uint32_t index) { return &cloth->m_isometricBendingConstraints[index]; }, deltaTime, m_stats.isometricBending);
+
+    // 处理LRA约束
+    SolveColoredConstraints(m_lraColoring,
+        [cloth](uint32_t index) { return &cloth->m_lraConstraints[index]; }, deltaTime, m_stats.lra);
+
+    // 处理碰撞约束
+    SolveColoredConstraints(m_collisionColoring,
+        [cloth](uint32_t index) { return &cloth->m_CollisionConstraints[index]; }, deltaTime, m_stats.collision);
+
+    // 汇总所有约束的残差
+    const ClothConstraintResidual* residuals[] = { &m_stats.distance, &m_stats.dihedralBending, &m_stats.isometricBending, &m_stats.lra, &m_stats.collision };
+    double sumSquares = 0.0;
+    uint32_t constraintCount = 0;
+
+    m_stats.maxError = 0.0f;
+    for (const ClothConstraintResidual* residual : residuals)
+    {
+        m_stats.maxError = (std::max)(m_stats.maxError, residual->maxError);
+        sumSquares += (double)residual->rmsError * residual->rmsError * residual->constraintCount;
+        constraintCount += residual->constraintCount;
+    }
+    m_stats.rmsError = constraintCount > 0 ? (float)std::sqrt(sumSquares / constraintCount) : 0.0f;
+}
+
+template<uint32_t Arity, typename ConstraintT>
+float XPBDSolver::SolveConstraintN(ConstraintT* constraint, SolverReal& lambda, float deltaTime)
+{
+    static_assert(Arity > 0, "constraint must affect at least one particle");
 
-    TAutoMem<dx::XMFLOAT3, 16> gradientsBuffer(particleCount);
-    dx::XMFLOAT3* gradients = gradientsBuffer.GetBuffer();
+    // 按具体类型调用，跳过虚函数分派，梯度放在栈上
+    Particle** constraintParticles = constraint->ConstraintT::GetParticles();
+    dx::XMFLOAT3 gradients[Arity];
 
     // 计算约束值和梯度
-    float C = constraint->ComputeConstraintAndGradient(gradients);
+    float C = constraint->ConstraintT::ComputeConstraintAndGradient(gradients);
 
 #ifdef DEBUG_SOLVER
     // 检查约束值是否有效
     if (isnan(C) || isinf(C))
     {
         logDebug("[DEBUG] InvalidConstraintValue)");
-        return;
+        return 0.0f;
     }
 #endif//DEBUG_SOLVER
 
-    if (std::abs(C) < 1e-9f)
+    float error = std::abs(C);
+
+    if (error < SolverPrecision::kNegligibleError)
     {
         // 如果约束值很小，可以忽略
-        return;
+        return error;
     }
 
-    // 计算分母项
-    double sum = 0.0;
-    double delta_pos_total = 0.0;
+    // 计算分母项，中间量统一使用SolverReal，float构建中没有精度转换
+    SolverReal sum = 0;
+    SolverReal delta_pos_total = 0;
 
-    for (uint32_t i = 0; i < particleCount; ++i)
+    for (uint32_t i = 0; i < Arity; ++i)
     {
         Particle* particle = constraintParticles[i];
 
-        if (!particle->isStatic)
+        if (!particle->isStatic && !particle->isSleeping)
         {
             // 将梯度转换为XMVECTOR进行点积计算
             dx::XMVECTOR gradient = dx::XMLoadFloat3(&gradients[i]);
 
             // 计算梯度的点积
             float dotProduct = dx::XMVectorGetX(dx::XMVector3Dot(gradient, gradient));
-            sum += dotProduct * particle->inverseMass;
+            sum += (SolverReal)dotProduct * (SolverReal)particle->inverseMass;
 
             // 计算梯度与delta_pos的点积
             dx::XMVECTOR delta_pos = dx::XMVectorSubtract(dx::XMLoadFloat3(&particle->position), 
                 dx::XMLoadFloat3(&particle->predPosition));
-            delta_pos_total += dx::XMVectorGetX(dx::XMVector3Dot(gradient, delta_pos));
+            delta_pos_total += (SolverReal)dx::XMVectorGetX(dx::XMVector3Dot(gradient, delta_pos));
         }
     }
 
     // 添加柔度项
-    double alpha_tilde = constraint->GetCompliance() / ((double)deltaTime * (double)deltaTime);
+    const SolverReal dt = (SolverReal)deltaTime;
+    const SolverReal constraintValue = (SolverReal)C;
+    SolverReal alpha_tilde = (SolverReal)constraint->GetCompliance() / (dt * dt);
 
-    if (alpha_tilde > 1e6f)
+    if (alpha_tilde > SolverPrecision::kMaxAlphaTilde)
     {
-        alpha_tilde = 1e6f;
+        alpha_tilde = SolverPrecision::kMaxAlphaTilde;
     }
 
-    double gamma = constraint->GetDamping() * (double)deltaTime;
+    // 柔性约束的平衡状态是C + alpha_tilde * lambda = 0，以此作为残差，刚性约束退化为|C|
+    error = (float)std::abs(constraintValue + alpha_tilde * lambda);
+
+    SolverReal gamma = (SolverReal)constraint->GetDamping() * dt;
 
     sum = (1 + gamma) * sum + alpha_tilde;
 
     // 防止除零
-    if (sum < 1e-9f)
+    if (sum < SolverPrecision::kMinDenominator)
     {
-        sum = 1e-9f;
+        sum = SolverPrecision::kMinDenominator;
     }
 
-    // 计算拉格朗日乘子增量
-    double deltaLambda = (double(-C - alpha_tilde * constraint->GetLambda() - gamma * delta_pos_total) / sum);
+    // 计算拉格朗日乘子增量，超松弛系数大于1时放大每次的修正量
+    SolverReal deltaLambda = ((-constraintValue - alpha_tilde * lambda - gamma * delta_pos_total) / sum) * (SolverReal)m_cloth->m_overRelaxationFactor;
 
 #ifdef DEBUG_SOLVER
     // 检查约束值是否有效
     if (isnan(deltaLambda) || isinf(deltaLambda))
     {
         char buffer[256];
-        sprintf_s(buffer, "[DEBUG] deltaLambda is invalid:%f C:%f alpha_tilde:%f Lambda:%f gamma:%f delta_pos_total:%f"
+        snprintf(buffer, sizeof(buffer), "[DEBUG] deltaLambda is invalid:%f C:%f alpha_tilde:%f Lambda:%f gamma:%f delta_pos_total:%f"
             , deltaLambda
             , C
             , alpha_tilde
-            , constraint->GetLambda()
+            , lambda
             , gamma
             , delta_pos_total);
         logDebug(buffer);
@@ -189,23 +1302,23 @@ void XPBDSolver::SolveConstraint(Constraint* constraint, float deltaTime)
 #endif//DEBUG_SOLVER
 
     // 应用位置校正
-    for (uint32_t i = 0; i < particleCount; ++i)
+    for (uint32_t i = 0; i < Arity; ++i)
     {
         Particle* particle = constraintParticles[i];
 
-        if (!particle->isStatic)
+        if (!particle->isStatic && !particle->isSleeping)
         {
             // 将粒子的位置和梯度转换为XMVECTOR进行计算
             dx::XMVECTOR pos = dx::XMLoadFloat3(&particle->position);
             dx::XMVECTOR gradient = dx::XMLoadFloat3(&gradients[i]);
 
             // 计算校正量
-            dx::XMVECTOR correction = dx::XMVectorScale(gradient, deltaLambda * particle->inverseMass);
+            dx::XMVECTOR correction = dx::XMVectorScale(gradient, (float)(deltaLambda * (SolverReal)particle->inverseMass));
 
 #ifdef DEBUG_SOLVER
             dx::XMVECTOR correctionLength = dx::XMVector3Length(correction);
             char buffer[256];
-            sprintf_s(buffer, "[DEBUG] constraintType:%s deltaTime:%f coordW:%d coordH:%d C:%f compliance:%f alpha_tilde:%f lambda:%f deltaLambda:%f gamma:%f delta_pos_total:%f correctionLength:%f"
+            snprintf(buffer, sizeof(buffer), "[DEBUG] constraintType:%s deltaTime:%f coordW:%d coordH:%d C:%f compliance:%f alpha_tilde:%f lambda:%f deltaLambda:%f gamma:%f delta_pos_total:%f correctionLength:%f"
                 , constraint->GetConstraintType()
                 , deltaTime
                 , particle->coordW
@@ -213,7 +1326,7 @@ void XPBDSolver::SolveConstraint(Constraint* constraint, float deltaTime)
                 , C
                 , constraint->GetCompliance()
                 , alpha_tilde
-                , constraint->GetLambda()
+                , lambda
                 , deltaLambda
                 , gamma
                 , delta_pos_total
@@ -233,48 +1346,136 @@ void XPBDSolver::SolveConstraint(Constraint* constraint, float deltaTime)
     }
 
     // 更新约束的拉格朗日乘子
-    constraint->SetLambda(constraint->GetLambda() + deltaLambda);
+    lambda += deltaLambda;
 
 #ifdef DEBUG_SOLVER
     constraint->Check();
 #endif//DEBUG_SOLVER
+
+    return error;
 }
 
 void XPBDSolver::UpdateVelocities(float deltaTime)
 {
-    for (auto& particle : m_cloth->m_particles)
+    std::vector<Particle>& particles = m_cloth->m_particles;
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, deltaTime](uint32_t begin, uint32_t end)
     {
-        if (!particle.isStatic)
+        for (uint32_t i = begin; i < end; ++i)
         {
-            // 将粒子的位置和旧位置转换为XMVECTOR进行计算
-            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
-            dx::XMVECTOR oldPos = dx::XMLoadFloat3(&particle.oldPosition);
+            Particle& particle = particles[i];
+
+            if (!particle.isStatic && !particle.isSleeping)
+            {
+                // 将粒子的位置和旧位置转换为XMVECTOR进行计算
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR oldPos = dx::XMLoadFloat3(&particle.oldPosition);
 
-            // 根据位置变化更新速度
-            dx::XMVECTOR vel = dx::XMVectorScale(dx::XMVectorSubtract(pos, oldPos), 1.0f / deltaTime);
+                // 根据位置变化更新速度
+                dx::XMVECTOR vel = dx::XMVectorScale(dx::XMVectorSubtract(pos, oldPos), 1.0f / deltaTime);
 
-            // 将结果转换回XMFLOAT3
-            dx::XMStoreFloat3(&particle.velocity, vel);
+                // 将结果转换回XMFLOAT3
+                dx::XMStoreFloat3(&particle.velocity, vel);
 
-			// 重置力
-            particle.ResetForce();
+                // 重置力
+                particle.ResetForce();
+            }
         }
-    }
+    });
 }
 
 void XPBDSolver::EndStep(float deltaTime)
 {
-    for (auto& particle : m_cloth->m_particles)
+    std::vector<Particle>& particles = m_cloth->m_particles;
+
+    // 速度阻尼，让没有摩擦的布料最终能够静止下来
+    const float dampingScale = (std::max)(0.0f, 1.0f - m_cloth->m_velocityDamping * deltaTime);
+
+    TaskScheduler::Get().ParallelFor(0, (uint32_t)particles.size(), kParticleGrainSize, [&particles, deltaTime, dampingScale](uint32_t begin, uint32_t end)
     {
-        if (!particle.isStatic)
+        for (uint32_t i = begin; i < end; ++i)
         {
-            dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
-            dx::XMVECTOR posInitial = dx::XMLoadFloat3(&particle.positionInitial);
+            Particle& particle = particles[i];
+
+            if (!particle.isStatic && !particle.isSleeping)
+            {
+                dx::XMVECTOR pos = dx::XMLoadFloat3(&particle.position);
+                dx::XMVECTOR posInitial = dx::XMLoadFloat3(&particle.positionInitial);
 
-            // 根据位置变化更新速度
-            dx::XMVECTOR velFinal = dx::XMVectorScale(dx::XMVectorSubtract(pos, posInitial), 1.0f / deltaTime);
+                // 根据位置变化更新速度
+                dx::XMVECTOR velFinal = dx::XMVectorScale(dx::XMVectorSubtract(pos, posInitial), dampingScale / deltaTime);
 
-            dx::XMStoreFloat3(&particle.velocity, velFinal);
+                dx::XMStoreFloat3(&particle.velocity, velFinal);
+            }
         }
+    });
+}
+
+void XPBDSolver::SaveState(std::vector<char>& state) const
+{
+    const uint32_t lambdaCount = (uint32_t)m_lambdas.size();
+    const uint32_t particleCount = (uint32_t)m_restFrameCounts.size();
+
+    ClothCheckpoint::Append(state, &lambdaCount, sizeof(lambdaCount));
+    ClothCheckpoint::Append(state, m_lambdas.data(), sizeof(SolverReal) * lambdaCount);
+    ClothCheckpoint::Append(state, &m_spectralRadiusEstimate, sizeof(m_spectralRadiusEstimate));
+    ClothCheckpoint::Append(state, &particleCount, sizeof(particleCount));
+    ClothCheckpoint::Append(state, m_restFrameCounts.data(), sizeof(uint16_t) * particleCount);
+    ClothCheckpoint::Append(state, m_restAnchors.data(), sizeof(dx::XMFLOAT3) * particleCount);
+    ClothCheckpoint::Append(state, &m_sleepingParticleCount, sizeof(m_sleepingParticleCount));
+    ClothCheckpoint::Append(state, &m_stats, sizeof(m_stats));
+}
+
+bool XPBDSolver::LoadState(const char* data, size_t size)
+{
+    // 着色只取决于约束，重新着色后拉格朗日乘子的布局与保存时相同
+    UpdateConstraintColoring();
+
+    size_t position = 0;
+    uint32_t lambdaCount = 0;
+    uint32_t particleCount = 0;
+
+    if (!ClothCheckpoint::Read(data, size, position, &lambdaCount, sizeof(lambdaCount)) || lambdaCount != m_lambdas.size())
+    {
+        logDebug("XPBDSolver::LoadState: lambda count mismatch");
+        ResetSleeping();
+        return false;
+    }
+
+    std::vector<SolverReal> lambdas(lambdaCount);
+    float spectralRadiusEstimate;
+    if (!ClothCheckpoint::Read(data, size, position, lambdas.data(), sizeof(SolverReal) * lambdaCount)
+        || !ClothCheckpoint::Read(data, size, position, &spectralRadiusEstimate, sizeof(spectralRadiusEstimate))
+        || !ClothCheckpoint::Read(data, size, position, &particleCount, sizeof(particleCount))
+        || particleCount != m_cloth->m_particles.size())
+    {
+        logDebug("XPBDSolver::LoadState: truncated state or particle count mismatch");
+        ResetSleeping();
+        return false;
+    }
+
+    std::vector<uint16_t> restFrameCounts(particleCount);
+    std::vector<dx::XMFLOAT3> restAnchors(particleCount);
+    uint32_t sleepingParticleCount;
+    ClothSolverStats stats;
+    if (!ClothCheckpoint::Read(data, size, position, restFrameCounts.data(), sizeof(uint16_t) * particleCount)
+        || !ClothCheckpoint::Read(data, size, position, restAnchors.data(), sizeof(dx::XMFLOAT3) * particleCount)
+        || !ClothCheckpoint::Read(data, size, position, &sleepingParticleCount, sizeof(sleepingParticleCount))
+        || !ClothCheckpoint::Read(data, size, position, &stats, sizeof(stats)))
+    {
+        logDebug("XPBDSolver::LoadState: truncated state");
+        ResetSleeping();
+        return false;
     }
-}
\ No newline at end of file
+
+    m_lambdas.swap(lambdas);
+    m_spectralRadiusEstimate = spectralRadiusEstimate;
+    m_restFrameCounts.swap(restFrameCounts);
+    m_restAnchors.swap(restAnchors);
+    m_sleepingParticleCount = sleepingParticleCount;
+    m_stats = stats;
+
+    // 粒子的休眠标记已经随粒子恢复，重新筛选需要求解的约束
+    m_activeConstraintsDirty = true;
+    return true;
+}
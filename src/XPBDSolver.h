@@ -7,8 +7,14 @@
 #include <sstream>
 #include <string>
 #include <iomanip>
+#include <functional>
+#include <cstring>
 
 #include "Particle.h"
+#include "IClothSolver.h"
+#include "SolverPrecision.h"
+#include "XPBDMultigrid.h"
+#include "XPBDDirectSolver.h"
 
 class Cloth;
 class Constraint;
@@ -16,9 +22,26 @@ class Constraint;
 // 为了方便使用，创建一个命名空间别名
 namespace dx = DirectX;
 
+// 求解器调度模式
+enum class XPBDScheduleMode
+{
+    Iterative,      // 每个子步内迭代多次（子步数 x 迭代次数）
+    SmallSteps,     // 小步长模式：大量子步，每个子步只迭代一次，粒子阶段融合成单次遍历
+};
+
+// SmallSteps模式下未指定子步数时使用的子步数
+static const uint32_t kSmallStepsDefaultSubIteratorCount = 10;
+
+// 距离约束的求解方式
+enum class XPBDDistanceSolveMode
+{
+    Iterative,      // 与其他约束一起按颜色做高斯-赛德尔迭代
+    Direct,         // 每个子步用稀疏Cholesky分解整体求解若干次，迭代只处理其他约束
+};
+
 // XPBD (Extended Position Based Dynamics) 求解器
 // 一种基于位置的物理模拟系统，特别适合处理约束
-class XPBDSolver
+class XPBDSolver : public IClothSolver
 {
 public:
     // 构造函数
@@ -26,30 +49,184 @@ public:
     //   cloth - 布料
     XPBDSolver(Cloth* cloth)
         : m_cloth(cloth)
+        , m_coloringDirty(true)
+        , m_spectralRadiusEstimate(0.9f)
+        , m_activeConstraintsDirty(true)
+        , m_sleepingParticleCount(0)
+        , m_dynamicParticleCount(0)
+        , m_directSolverDirty(true)
     {
+        memset(&m_stats, 0, sizeof(m_stats));
     }
     
     // 析构函数
-    ~XPBDSolver()
+    ~XPBDSolver() override
     {
     }
 
+    // 获取求解器名称
+    const char* GetName() const override
+    {
+        return "XPBD";
+    }
+
     // 模拟一步
     // 执行一次完整的XPBD模拟步骤，包括预测、约束求解和位置校正
-    void Step(float deltaTime);
+    void Step(float deltaTime) override;
+
+    // 标记约束着色失效，约束增删后需要调用，下一次Step时重新着色
+    void InvalidateConstraints() override
+    {
+        m_coloringDirty = true;
+    }
+
+    // 唤醒所有休眠的粒子
+    void WakeAll() override;
+
+    // 唤醒与球体相交的休眠岛屿（例如碰撞体移动后）
+    // 参数：
+    //   center - 球心
+    //   radius - 半径
+    void WakeInSphere(const dx::XMFLOAT3& center, float radius) override;
+
+    // 获取最近一帧的求解统计（残差和实际迭代次数）
+    const ClothSolverStats& GetStats() const override
+    {
+        return m_stats;
+    }
+
+    // 设置最近一帧的求解统计，由打包求解布料的ClothBatchSolver填写
+    void SetStats(const ClothSolverStats& stats)
+    {
+        m_stats = stats;
+    }
+
+    // 保存拉格朗日乘子、Chebyshev谱半径估计、休眠计数和统计
+    void SaveState(std::vector<char>& state) const override;
+
+    // 恢复SaveState保存的状态，先按当前约束重新着色，使拉格朗日乘子的布局与保存时一致
+    bool LoadState(const char* data, size_t size) override;
     
 private:
+    // 一类约束的着色结果
+    // 同一颜色内的约束不共享任何动态粒子，可以并行求解
+    struct ConstraintColoring
+    {
+        std::vector<uint32_t> order;        // 按颜色排序后的约束索引
+        std::vector<uint32_t> colorOffsets; // 每种颜色在order中的起始位置，末尾额外存放order.size()
+        bool lastColorSerial;               // 最后一种颜色是否为着色失败的约束，需要串行求解
+        uint32_t lambdaOffset;              // 该类约束在拉格朗日乘子缓冲区中的起始位置
+
+        // 去掉所有粒子都固定或休眠的约束后的求解列表，颜色划分与order相同
+        std::vector<uint32_t> activeOrder;
+        std::vector<uint32_t> activeColorOffsets;
+    };
+
+    // 对所有约束重新着色
+    void UpdateConstraintColoring();
+
+    // 对一类约束进行贪心着色
+    // 参数：
+    //   constraintCount - 约束数量
+    //   getConstraint - 按索引获取约束
+    //   coloring - 输出着色结果
+    void BuildConstraintColoring(uint32_t constraintCount, const std::function<Constraint*(uint32_t)>& getConstraint,
+        ConstraintColoring& coloring);
+
+    // 按颜色求解一类约束，颜色之间串行，颜色内部并行
+    // 参数：
+    //   getConstraint - 按索引返回具体约束类型的指针，求解按该类型的kArity展开
+    //   residual - 输出本次求解前的约束残差
+    template<typename GetConstraintFunc>
+    void SolveColoredConstraints(const ConstraintColoring& coloring, GetConstraintFunc getConstraint, float deltaTime,
+        ClothConstraintResidual& residual);
+
+    // 筛选一类约束中需要求解的约束
+    void FilterActiveConstraints(const std::function<Constraint*(uint32_t)>& getConstraint, ConstraintColoring& coloring);
+
+    // 休眠状态变化后重新筛选所有约束
+    void UpdateActiveConstraints();
+
+    // 重置所有粒子的休眠状态
+    void ResetSleeping();
+
+    // 唤醒单个粒子
+    void WakeParticle(uint32_t index);
+
+    // 唤醒标记的休眠岛屿
+    // 参数：
+    //   islandWakeFlags - 按岛屿编号索引的唤醒标记
+    void WakeIslands(const uint8_t* islandWakeFlags);
+
+    // 帧末更新休眠状态：统计静止帧数，岛屿内所有粒子都静止后让整个岛屿进入休眠
+    void UpdateSleeping();
+
+    // 按距离约束的连通关系划分粒子岛屿，约束变化后重新计算
+    void BuildParticleIslands();
+
+    // 迭代模式的一步
+    void StepIterative(float deltaTime);
+
+    // 小步长模式的一步
+    void StepSmallSteps(float deltaTime);
+
+    // 直接求解模式下对距离约束做若干次全局求解
+    void SolveDistanceConstraintsDirect(float deltaTime);
+
+    // 融合的粒子阶段标志
+    enum ParticlePassFlags
+    {
+        SaveInitialPosition = 1 << 0,   // 保存单帧初始位置
+        UpdateSubstepVelocity = 1 << 1, // 根据子步位移更新速度
+        UpdateFrameVelocity = 1 << 2,   // 根据整帧位移更新速度（最后一个子步）
+        PredictPosition = 1 << 3,       // 预测下一个子步的位置
+    };
+
+    // 在一次遍历中完成多个粒子阶段，按标志顺序执行：保存初始位置、更新速度、预测位置
+    void FusedParticlePass(uint32_t flags, float subDeltaTime, float deltaTime);
+
+    // 清零所有拉格朗日乘子
+    void ClearLambdas();
+
+    // 子步迭代开始前初始化Chebyshev加速的迭代历史
+    void BeginChebyshev();
+
+    // 根据延迟迭代的残差下降比例估计迭代矩阵的谱半径
+    float EstimateSpectralRadius(float previousRMSError, float rmsError);
+
+    // 对本次迭代的投影结果做Chebyshev外推，并更新迭代历史
+    // 参数：
+    //   omega - 外推系数，1表示不外推
+    void ApplyChebyshev(float omega);
+
     // 保存单帧初始位置（用于计算帧末总速度）
     void BeginStep();
 
     // 预测粒子的位置（考虑外力）
     void PredictPositions(float deltaTime);
     
-    // 求解所有约束
+    // 求解所有约束，残差记录到m_stats中
     void SolveConstraints(float deltaTime);
 
-    // 求解单个约束
-    void SolveConstraint(Constraint* constraint, float deltaTime);
+    // 求解单个约束，粒子数Arity在编译期确定，循环展开、梯度放在栈上，并直接调用具体类型的约束函数
+    // 参数：
+    //   constraint - 约束
+    //   lambda - 该约束在本子步中累积的拉格朗日乘子
+    //   deltaTime - 子步时间步长
+    // 返回：求解前的约束违反量|C|
+    template<uint32_t Arity, typename ConstraintT>
+    float SolveConstraintN(ConstraintT* constraint, SolverReal& lambda, float deltaTime);
+
+    // 在每个子步开始时重置拉格朗日乘子（或按热启动系数缩放上一子步的值，距离约束的拉伸乘子作为初始解，对应的位置校正作用到预测位置上）
+    void ResetLambdas();
+
+    // 按颜色把一类约束热启动的乘子作用到粒子位置上
+    template<typename GetConstraintFunc>
+    void ApplyColoredWarmStart(const ConstraintColoring& coloring, GetConstraintFunc getConstraint);
+
+    // 把单个约束热启动的乘子作用到粒子位置上：x += w * gradC * lambda
+    template<uint32_t Arity, typename ConstraintT>
+    static void ApplyWarmStartN(ConstraintT* constraint, SolverReal lambda);
     
     // 更新粒子的速度
     void UpdateVelocities(float deltaTime);
@@ -59,6 +236,45 @@ private:
 
 protected:
     Cloth* m_cloth;
+
+    // 约束着色
+    ConstraintColoring m_distanceColoring;
+    ConstraintColoring m_dihedralBendingColoring;
+    ConstraintColoring m_isometricBendingColoring;
+    ConstraintColoring m_lraColoring;
+    ConstraintColoring m_collisionColoring;
+    bool m_coloringDirty;
+
+    // 所有约束的拉格朗日乘子，按约束类型连续存放，与约束对象分离
+    // 约束在缓冲区中的位置为所属类型的lambdaOffset加上约束索引，精度由SolverReal决定
+    std::vector<SolverReal> m_lambdas;
+
+    // 最近一帧的求解统计
+    ClothSolverStats m_stats;
+
+    // Chebyshev加速：每个粒子最近两次迭代的位置，以及本子步是否发生过碰撞修正
+    std::vector<dx::XMFLOAT3> m_iterateCurrent;
+    std::vector<dx::XMFLOAT3> m_iteratePrevious;
+    std::vector<uint8_t> m_activeContacts;
+    float m_spectralRadiusEstimate;
+
+    // 休眠：每个粒子连续静止的帧数、静止判定的锚点位置
+    std::vector<uint16_t> m_restFrameCounts;
+    std::vector<dx::XMFLOAT3> m_restAnchors;
+
+    // 每个粒子所属的岛屿（以岛屿中最小的粒子索引编号），以及按编号索引的岛屿粒子数
+    std::vector<uint32_t> m_particleIslands;
+    std::vector<uint32_t> m_islandSizes;
+    bool m_activeConstraintsDirty;
+    uint32_t m_sleepingParticleCount;
+    uint32_t m_dynamicParticleCount;
+
+    // 粗网格层级，每个子步在细网格迭代之前求解
+    XPBDMultigrid m_multigrid;
+
+    // 距离约束的直接求解器，约束变化后重新做符号分析
+    XPBDDirectSolver m_directSolver;
+    bool m_directSolverDirty;
 };
 
 #endif // XPBD_SOLVER_H